@@ -11,8 +11,18 @@ public class MarkdownAsset : ModuleRules
         PublicDependencyModuleNames.AddRange( new string[] {
             "Core",
             "CoreUObject",
+            "Engine",
         });
 
+        // documents are drawn into render targets with a canvas
+        PrivateDependencyModuleNames.AddRange( new string[] {
+            "RenderCore",
+            "RHI",
+        });
+
+        // documentation archives are deflated with a shared preset dictionary, which FCompression does not expose
+        AddEngineThirdPartyPrivateStaticDependencies( Target, "zlib" );
+
         //PrivateIncludePaths.AddRange( new string[] {
         //    "Runtime/MarkdownAsset/Private",
         //});
@@ -0,0 +1,370 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "MarkdownArchive.h"
+
+#include "Algo/BinarySearch.h"
+#include "HAL/FileManager.h"
+#include "MarkdownTextCodec.h"
+#include "Misc/Crc.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+THIRD_PARTY_INCLUDES_START
+#include "zlib.h"
+THIRD_PARTY_INCLUDES_END
+
+namespace MarkdownArchive
+{
+	static constexpr uint32 Magic = 0x4B50444D; // "MDPK"
+	static constexpr uint32 Version = 1;
+
+	/** Deflate only looks back 32KB, a larger dictionary would never be referenced. */
+	static constexpr int32 MaxDictionarySize = 32 * 1024;
+
+	/** Length of the substrings counted while training, shorter matches gain little over plain deflate. */
+	static constexpr int32 GramLen = 12;
+
+	struct FGram
+	{
+		int32 Sample = 0;
+		int32 Offset = 0;
+		int32 LastSample = INDEX_NONE;
+		int32 NumSamples = 0;
+	};
+
+	/**
+	 * Builds a zlib preset dictionary from the substrings shared by the most documents.
+	 *
+	 * Every substring of GramLen bytes is counted once per document it appears in. The most common ones are grown
+	 * into longer phrases while the following substrings are about as common, and the phrases are concatenated with
+	 * the most common last, where deflate can reach them with the shortest distances.
+	 */
+	static TArray<uint8> TrainDictionary(const TArray<TArray<uint8>>& Samples, int32 MaxSize)
+	{
+		TMap<uint32, FGram> Grams;
+
+		for (int32 SampleIndex = 0; SampleIndex < Samples.Num(); ++SampleIndex)
+		{
+			const TArray<uint8>& Sample = Samples[SampleIndex];
+			for (int32 Offset = 0; Offset + GramLen <= Sample.Num(); ++Offset)
+			{
+				FGram& Gram = Grams.FindOrAdd(FCrc::MemCrc32(Sample.GetData() + Offset, GramLen));
+				if (Gram.LastSample != SampleIndex)
+				{
+					if (Gram.NumSamples == 0)
+					{
+						Gram.Sample = SampleIndex;
+						Gram.Offset = Offset;
+					}
+
+					Gram.LastSample = SampleIndex;
+					++Gram.NumSamples;
+				}
+			}
+		}
+
+		TArray<uint32> Ranked;
+		for (const TPair<uint32, FGram>& Gram : Grams)
+		{
+			if (Gram.Value.NumSamples > 1)
+			{
+				Ranked.Add(Gram.Key);
+			}
+		}
+
+		Ranked.Sort([&Grams](uint32 A, uint32 B) { return Grams[A].NumSamples > Grams[B].NumSamples; });
+
+		TArray<TArrayView<const uint8>> Phrases;
+		int32 Size = 0;
+
+		for (const uint32 Key : Ranked)
+		{
+			FGram& Gram = Grams[Key];
+			if (Gram.NumSamples == 0)
+			{
+				continue;
+			}
+
+			const TArray<uint8>& Sample = Samples[Gram.Sample];
+			const int32 Threshold = FMath::Max(2, Gram.NumSamples / 2);
+
+			// grow the phrase while the next substring is shared by a similar number of documents
+			int32 End = Gram.Offset + GramLen;
+			while (End < Sample.Num() && Size + (End - Gram.Offset) < MaxSize)
+			{
+				FGram* Next = Grams.Find(FCrc::MemCrc32(Sample.GetData() + End - GramLen + 1, GramLen));
+				if (!Next || Next->NumSamples < Threshold)
+				{
+					break;
+				}
+
+				Next->NumSamples = 0;
+				++End;
+			}
+
+			Gram.NumSamples = 0;
+
+			const int32 Len = FMath::Min(End - Gram.Offset, MaxSize - Size);
+			Phrases.Add(TArrayView<const uint8>(Sample.GetData() + Gram.Offset, Len));
+			Size += Len;
+
+			if (Size >= MaxSize)
+			{
+				break;
+			}
+		}
+
+		TArray<uint8> Dictionary;
+		Dictionary.Reserve(Size);
+
+		for (int32 Index = Phrases.Num() - 1; Index >= 0; --Index)
+		{
+			Dictionary.Append(Phrases[Index].GetData(), Phrases[Index].Num());
+		}
+
+		return Dictionary;
+	}
+
+	static bool Deflate(const TArray<uint8>& Dictionary, const TArray<uint8>& Raw, TArray<uint8>& OutPacked)
+	{
+		z_stream Stream = {};
+		if (deflateInit(&Stream, Z_BEST_COMPRESSION) != Z_OK)
+		{
+			return false;
+		}
+
+		if (!Dictionary.IsEmpty())
+		{
+			deflateSetDictionary(&Stream, Dictionary.GetData(), Dictionary.Num());
+		}
+
+		OutPacked.SetNumUninitialized(deflateBound(&Stream, Raw.Num()));
+
+		Stream.next_in = const_cast<Bytef*>(Raw.GetData());
+		Stream.avail_in = Raw.Num();
+		Stream.next_out = OutPacked.GetData();
+		Stream.avail_out = OutPacked.Num();
+
+		const int Result = deflate(&Stream, Z_FINISH);
+		OutPacked.SetNum(Stream.total_out);
+		deflateEnd(&Stream);
+
+		return Result == Z_STREAM_END;
+	}
+
+	static bool Inflate(const TArray<uint8>& Dictionary, const TArray<uint8>& Packed, TArray<uint8>& OutRaw)
+	{
+		z_stream Stream = {};
+		if (inflateInit(&Stream) != Z_OK)
+		{
+			return false;
+		}
+
+		Stream.next_in = const_cast<Bytef*>(Packed.GetData());
+		Stream.avail_in = Packed.Num();
+		Stream.next_out = OutRaw.GetData();
+		Stream.avail_out = OutRaw.Num();
+
+		int Result = inflate(&Stream, Z_FINISH);
+		if (Result == Z_NEED_DICT && inflateSetDictionary(&Stream, Dictionary.GetData(), Dictionary.Num()) == Z_OK)
+		{
+			Result = inflate(&Stream, Z_FINISH);
+		}
+
+		const bool bComplete = Result == Z_STREAM_END && Stream.total_out == uLong(OutRaw.Num());
+		inflateEnd(&Stream);
+
+		return bComplete;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+FString FMarkdownArchive::GetDefaultPath()
+{
+	return FPaths::ProjectContentDir() / TEXT("MarkdownAsset") / TEXT("Documentation.mdpack");
+}
+
+const FMarkdownArchive* FMarkdownArchive::GetDefault()
+{
+	static TUniquePtr<FMarkdownArchive> Default = []() -> TUniquePtr<FMarkdownArchive>
+	{
+		TUniquePtr<FMarkdownArchive> Archive = MakeUnique<FMarkdownArchive>();
+		return Archive->Open(GetDefaultPath()) ? MoveTemp(Archive) : nullptr;
+	}();
+
+	return Default.Get();
+}
+
+bool FMarkdownArchive::Write(const FString& FilePath, TArray<FDocument> Documents, FMarkdownArchiveStats* OutStats)
+{
+	using namespace MarkdownArchive;
+
+	Documents.Sort([](const FDocument& A, const FDocument& B) { return A.Path.ToString() < B.Path.ToString(); });
+
+	TArray<TArray<uint8>> Samples;
+	Samples.Reserve(Documents.Num());
+
+	for (const FDocument& Document : Documents)
+	{
+		MarkdownTextCodec::EncodeUtf8(Document.Text, Samples.Emplace_GetRef());
+	}
+
+	TArray<uint8> SharedDictionary = TrainDictionary(Samples, MaxDictionarySize);
+
+	TArray<FEntry> Index;
+	TArray<TArray<uint8>> Packed;
+	Index.Reserve(Documents.Num());
+	Packed.SetNum(Documents.Num());
+
+	uint64 Offset = 0;
+	for (int32 DocumentIndex = 0; DocumentIndex < Documents.Num(); ++DocumentIndex)
+	{
+		if (!Deflate(SharedDictionary, Samples[DocumentIndex], Packed[DocumentIndex]))
+		{
+			return false;
+		}
+
+		FEntry& Entry = Index.AddDefaulted_GetRef();
+		Entry.Path = Documents[DocumentIndex].Path.ToString();
+		Entry.Offset = Offset;
+		Entry.PackedSize = Packed[DocumentIndex].Num();
+		Entry.RawSize = Samples[DocumentIndex].Num();
+
+		Offset += Entry.PackedSize;
+	}
+
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*FilePath));
+	if (!Writer)
+	{
+		return false;
+	}
+
+	uint32 FileMagic = Magic;
+	uint32 FileVersion = Version;
+	*Writer << FileMagic << FileVersion << SharedDictionary << Index;
+
+	for (TArray<uint8>& Data : Packed)
+	{
+		Writer->Serialize(Data.GetData(), Data.Num());
+	}
+
+	if (OutStats)
+	{
+		OutStats->NumDocuments = Documents.Num();
+		OutStats->DictionarySize = SharedDictionary.Num();
+		OutStats->RawBytes = 0;
+
+		for (const FEntry& Entry : Index)
+		{
+			OutStats->RawBytes += Entry.RawSize;
+		}
+
+		OutStats->PackedBytes = Writer->Tell();
+	}
+
+	return Writer->Close();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool FMarkdownArchive::Open(const FString& FilePath)
+{
+	TUniquePtr<FArchive> File(IFileManager::Get().CreateFileReader(*FilePath));
+	if (!File)
+	{
+		return false;
+	}
+
+	uint32 FileMagic = 0;
+	uint32 FileVersion = 0;
+	*File << FileMagic << FileVersion;
+
+	if (FileMagic != MarkdownArchive::Magic || FileVersion != MarkdownArchive::Version)
+	{
+		return false;
+	}
+
+	*File << Dictionary << Entries;
+
+	if (File->IsError())
+	{
+		Dictionary.Empty();
+		Entries.Empty();
+		return false;
+	}
+
+	DataStart = File->Tell();
+
+	FScopeLock Lock(&ReaderLock);
+	Reader = MoveTemp(File);
+	return true;
+}
+
+bool FMarkdownArchive::Contains(const FSoftObjectPath& Document) const
+{
+	return FindEntry(Document) != nullptr;
+}
+
+bool FMarkdownArchive::ReadDocument(const FSoftObjectPath& Document, FString& OutText) const
+{
+	const FEntry* Entry = FindEntry(Document);
+	if (!Entry)
+	{
+		return false;
+	}
+
+	if (Entry->RawSize == 0)
+	{
+		OutText.Reset();
+		return true;
+	}
+
+	TArray<uint8> Packed;
+	Packed.SetNumUninitialized(Entry->PackedSize);
+
+	{
+		FScopeLock Lock(&ReaderLock);
+
+		Reader->Seek(DataStart + Entry->Offset);
+		Reader->Serialize(Packed.GetData(), Packed.Num());
+
+		if (Reader->IsError())
+		{
+			return false;
+		}
+	}
+
+	TArray<uint8> Raw;
+	Raw.SetNumUninitialized(Entry->RawSize);
+
+	if (!MarkdownArchive::Inflate(Dictionary, Packed, Raw))
+	{
+		return false;
+	}
+
+	return MarkdownTextCodec::DecodeUtf8(Raw, OutText);
+}
+
+void FMarkdownArchive::GetDocuments(TArray<FSoftObjectPath>& OutDocuments) const
+{
+	OutDocuments.Reserve(OutDocuments.Num() + Entries.Num());
+
+	for (const FEntry& Entry : Entries)
+	{
+		OutDocuments.Emplace(Entry.Path);
+	}
+}
+
+const FMarkdownArchive::FEntry* FMarkdownArchive::FindEntry(const FSoftObjectPath& Document) const
+{
+	if (!IsOpen())
+	{
+		return nullptr;
+	}
+
+	const FString Path = Document.ToString();
+	const int32 Index = Algo::LowerBoundBy(Entries, Path, &FEntry::Path);
+
+	return Entries.IsValidIndex(Index) && Entries[Index].Path.Equals(Path, ESearchCase::IgnoreCase) ? &Entries[Index] : nullptr;
+}
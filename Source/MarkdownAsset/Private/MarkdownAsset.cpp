@@ -0,0 +1,225 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "MarkdownAsset.h"
+#include "Async/Async.h"
+#include "Engine/StreamableManager.h"
+#include "MarkdownArchive.h"
+#include "Internationalization/Culture.h"
+#include "Internationalization/Internationalization.h"
+#include "Misc/Crc.h"
+#include "MarkdownScanner.h"
+#include "MarkdownTranslation.h"
+#include "MarkdownTrigramFilter.h"
+
+namespace MarkdownAsset
+{
+	static FStreamableManager& GetStreamableManager()
+	{
+		static FStreamableManager StreamableManager;
+		return StreamableManager;
+	}
+}
+
+const FName UMarkdownAsset::LinksTagName( TEXT( "MarkdownLinks" ) );
+const FName UMarkdownAsset::TrigramsTagName( TEXT( "MarkdownTrigrams" ) );
+const FName UMarkdownAsset::FingerprintsTagName( TEXT( "MarkdownFingerprints" ) );
+const FName UMarkdownAsset::ContentHashTagName( TEXT( "MarkdownContentHash" ) );
+const FName UMarkdownAsset::FormattedHashTagName( TEXT( "MarkdownFormattedHash" ) );
+
+#if WITH_EDITOR
+UMarkdownAsset::FIsEditorOnlyByDefault UMarkdownAsset::IsEditorOnlyByDefault;
+#endif
+
+TSharedPtr<FStreamableHandle> UMarkdownAsset::LoadDocumentAsync( const FSoftObjectPath& Path, FOnMarkdownDocumentLoaded OnLoaded )
+{
+	if( Path.IsNull() )
+	{
+		OnLoaded.ExecuteIfBound( nullptr );
+		return nullptr;
+	}
+
+	// packed documents are not packages, they are read from the archive on the worker thread
+	const FMarkdownArchive* Archive = FMarkdownArchive::GetDefault();
+	if( Archive && Archive->Contains( Path ) )
+	{
+		Async( EAsyncExecution::ThreadPool, [Archive, Path, OnLoaded = MoveTemp( OnLoaded )]() mutable
+		{
+			FString Text;
+			TSharedPtr<const FMarkdownDocument> Document;
+
+			if( Archive->ReadDocument( Path, Text ) )
+			{
+				Document = FMarkdownDocument::Parse( Path, MoveTemp( Text ) );
+			}
+
+			AsyncTask( ENamedThreads::GameThread, [Document = MoveTemp( Document ), OnLoaded = MoveTemp( OnLoaded )]()
+			{
+				OnLoaded.ExecuteIfBound( Document );
+			});
+		});
+
+		return nullptr;
+	}
+
+	return MarkdownAsset::GetStreamableManager().RequestAsyncLoad( Path, FStreamableDelegate::CreateLambda( [Path, OnLoaded = MoveTemp( OnLoaded )]()
+	{
+		const UMarkdownAsset* Document = Cast<UMarkdownAsset>( Path.ResolveObject() );
+		if( !Document )
+		{
+			OnLoaded.ExecuteIfBound( nullptr );
+			return;
+		}
+
+		const TSoftObjectPtr<UMarkdownTranslation> Translation = Document->FindTranslation();
+		if( Translation.IsNull() || Translation.IsValid() )
+		{
+			Document->ParseAsync( OnLoaded );
+			return;
+		}
+
+		// the translation is only known once the document is loaded, stream it in before parsing
+		MarkdownAsset::GetStreamableManager().RequestAsyncLoad( Translation.ToSoftObjectPath(), FStreamableDelegate::CreateLambda( [Path, OnLoaded]()
+		{
+			if( const UMarkdownAsset* Loaded = Cast<UMarkdownAsset>( Path.ResolveObject() ) )
+			{
+				Loaded->ParseAsync( OnLoaded );
+			}
+			else
+			{
+				OnLoaded.ExecuteIfBound( nullptr );
+			}
+		}));
+	}));
+}
+
+void UMarkdownAsset::ParseAsync( FOnMarkdownDocumentLoaded OnParsed ) const
+{
+	// FText is read here, on the game thread, the worker only sees the string
+	FMarkdownDocument::ParseAsync( FSoftObjectPath( this ), GetLocalizedText(), MoveTemp( OnParsed ) );
+}
+
+TSoftObjectPtr<UMarkdownTranslation> UMarkdownAsset::FindTranslation( const FString& Culture ) const
+{
+	if( Translations.IsEmpty() )
+	{
+		return nullptr;
+	}
+
+	const FCulturePtr Language = Culture.IsEmpty() ? FInternationalization::Get().GetCurrentLanguage() : FInternationalization::Get().GetCulture( Culture );
+	if( !Language.IsValid() )
+	{
+		const TSoftObjectPtr<UMarkdownTranslation>* Translation = Translations.Find( Culture );
+		return Translation ? *Translation : nullptr;
+	}
+
+	// e.g. "pt-BR", then "pt"
+	for( const FString& Name : Language->GetPrioritizedParentCultureNames() )
+	{
+		if( const TSoftObjectPtr<UMarkdownTranslation>* Translation = Translations.Find( Name ) )
+		{
+			return *Translation;
+		}
+	}
+
+	return nullptr;
+}
+
+FString UMarkdownAsset::GetLocalizedText() const
+{
+	const UMarkdownTranslation* Translation = FindTranslation().Get();
+	return Translation ? Translation->Translate( Text.ToString() ) : Text.ToString();
+}
+
+uint32 UMarkdownAsset::GetContentHash( const FString& InText )
+{
+	return FCrc::MemCrc32( *InText, InText.Len() * sizeof( TCHAR ) );
+}
+
+bool UMarkdownAsset::IsEditorOnly() const
+{
+	// the policy applies to documents, never to the class itself
+	if( HasAnyFlags( RF_ClassDefaultObject ) )
+	{
+		return Super::IsEditorOnly();
+	}
+
+	if( CookPolicy != EMarkdownCookPolicy::Default )
+	{
+		return CookPolicy != EMarkdownCookPolicy::Cook;
+	}
+
+#if WITH_EDITOR
+	if( IsEditorOnlyByDefault.IsBound() )
+	{
+		return IsEditorOnlyByDefault.Execute( *this );
+	}
+#endif
+
+	return Super::IsEditorOnly();
+}
+
+bool UMarkdownAsset::NeedsLoadForClient() const
+{
+	return !IsEditorOnly() && Super::NeedsLoadForClient();
+}
+
+bool UMarkdownAsset::NeedsLoadForServer() const
+{
+	return !IsEditorOnly() && Super::NeedsLoadForServer();
+}
+
+#if WITH_EDITOR
+
+#if UE_VERSION_OLDER_THAN(5, 4, 0)
+void UMarkdownAsset::GetAssetRegistryTags( TArray<FAssetRegistryTag>& OutTags ) const
+{
+	Super::GetAssetRegistryTags( OutTags );
+	GetMarkdownRegistryTags( OutTags );
+}
+#else
+void UMarkdownAsset::GetAssetRegistryTags( FAssetRegistryTagsContext Context ) const
+{
+	Super::GetAssetRegistryTags( Context );
+
+	TArray<FAssetRegistryTag> Tags;
+	GetMarkdownRegistryTags( Tags );
+
+	for( FAssetRegistryTag& Tag : Tags )
+	{
+		Context.AddTag( MoveTemp( Tag ) );
+	}
+}
+#endif
+
+void UMarkdownAsset::GetMarkdownRegistryTags( TArray<FAssetRegistryTag>& OutTags ) const
+{
+	const FString String = Text.ToString();
+
+	// the links are stored in the registry so editor tools can find the documents referencing an asset without loading them
+	TArray<FString> Links;
+	MarkdownScanner::ExtractAssetLinks( String, Links );
+
+	OutTags.Add( FAssetRegistryTag( LinksTagName, FString::Join( Links, TEXT( "," ) ), FAssetRegistryTag::TT_Hidden ) );
+	OutTags.Add( FAssetRegistryTag( TrigramsTagName, FMarkdownTrigramFilter::FromText( String ).ToString(), FAssetRegistryTag::TT_Hidden ) );
+	OutTags.Add( FAssetRegistryTag( ContentHashTagName, LexToString( GetContentHash( String ) ), FAssetRegistryTag::TT_Hidden ) );
+
+	if( FormattedHash != 0 )
+	{
+		OutTags.Add( FAssetRegistryTag( FormattedHashTagName, LexToString( FormattedHash ), FAssetRegistryTag::TT_Hidden ) );
+	}
+
+	if( !LinkFingerprints.IsEmpty() )
+	{
+		TArray<FString> Fingerprints;
+		Fingerprints.Reserve( LinkFingerprints.Num() );
+
+		for( const TPair<FString, FString>& Fingerprint : LinkFingerprints )
+		{
+			Fingerprints.Add( Fingerprint.Key + TEXT( "=" ) + Fingerprint.Value );
+		}
+
+		OutTags.Add( FAssetRegistryTag( FingerprintsTagName, FString::Join( Fingerprints, TEXT( "," ) ), FAssetRegistryTag::TT_Hidden ) );
+	}
+}
+
+#endif // WITH_EDITOR
@@ -0,0 +1,90 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "MarkdownDocument.h"
+
+#include "Async/Async.h"
+#include "MarkdownScanner.h"
+#include "MarkdownSyntaxTree.h"
+
+TSharedRef<const FMarkdownDocument> FMarkdownDocument::Parse(const FSoftObjectPath& Path, FString Text)
+{
+	TSharedRef<FMarkdownDocument> Document = MakeShared<FMarkdownDocument>();
+	Document->Path = Path;
+	Document->Text = MoveTemp(Text);
+
+	const FStringView View = Document->Text;
+
+	// headings are taken from the syntax tree so sections and anchors match what the viewer shows
+	const FMarkdownSyntaxTree Tree = FMarkdownSyntaxTree::Parse(Document->Text);
+	FMarkdownHeadingAnchors Anchors;
+
+	for (const FMarkdownNode& Node : Tree.GetNodes())
+	{
+		if (Node.Type != EMarkdownNodeType::Heading)
+		{
+			continue;
+		}
+
+		FMarkdownDocumentSection& Section = Document->Sections.AddDefaulted_GetRef();
+		Section.Title = FString(Tree.GetArg(Node));
+		Section.Anchor = Anchors.Add(Tree.GetInlineText(Node));
+		Section.Level = Node.Level;
+
+		// the heading line starts at the beginning of its line
+		int32 LineStart = Node.Start;
+		while (LineStart > 0 && View[LineStart - 1] != TEXT('\n'))
+		{
+			--LineStart;
+		}
+
+		Section.Start = LineStart;
+		Section.Len = View.Len() - LineStart;
+	}
+
+	// each section runs to the next heading of the same or a higher level
+	for (int32 Index = 0; Index < Document->Sections.Num(); ++Index)
+	{
+		FMarkdownDocumentSection& Section = Document->Sections[Index];
+
+		for (int32 Next = Index + 1; Next < Document->Sections.Num(); ++Next)
+		{
+			if (Document->Sections[Next].Level <= Section.Level)
+			{
+				Section.Len = Document->Sections[Next].Start - Section.Start;
+				break;
+			}
+		}
+	}
+
+	Document->Title = Document->Sections.IsEmpty() ? Path.GetAssetName() : Document->Sections[0].Title;
+
+	MarkdownScanner::ExtractAssetLinks(View, Document->Links);
+
+	return Document;
+}
+
+void FMarkdownDocument::ParseAsync(const FSoftObjectPath& Path, FString Text, FOnParsed OnParsed)
+{
+	Async(EAsyncExecution::ThreadPool, [Path, Text = MoveTemp(Text), OnParsed = MoveTemp(OnParsed)]() mutable
+	{
+		TSharedPtr<const FMarkdownDocument> Document = Parse(Path, MoveTemp(Text));
+
+		AsyncTask(ENamedThreads::GameThread, [Document = MoveTemp(Document), OnParsed = MoveTemp(OnParsed)]()
+		{
+			OnParsed.ExecuteIfBound(Document);
+		});
+	});
+}
+
+const FMarkdownDocumentSection* FMarkdownDocument::FindSection(FStringView TitleOrAnchor) const
+{
+	return Sections.FindByPredicate([TitleOrAnchor](const FMarkdownDocumentSection& Section)
+	{
+		return TitleOrAnchor.Equals(Section.Title, ESearchCase::IgnoreCase) || TitleOrAnchor.Equals(Section.Anchor, ESearchCase::IgnoreCase);
+	});
+}
+
+FStringView FMarkdownDocument::GetSectionText(const FMarkdownDocumentSection& Section) const
+{
+	return FStringView(Text).Mid(Section.Start, Section.Len);
+}
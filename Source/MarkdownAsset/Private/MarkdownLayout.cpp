@@ -0,0 +1,449 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "MarkdownLayout.h"
+
+#include "Engine/Engine.h"
+#include "Engine/Font.h"
+#include "Misc/Char.h"
+
+namespace MarkdownLayout
+{
+	enum class ERunStyle : uint8
+	{
+		Plain = 0,
+		Bold = 1 << 0,
+		Italic = 1 << 1, // tracked so the markers pair up, there is no italic font to draw it with
+		Code = 1 << 2,
+		Link = 1 << 3,
+	};
+
+	ENUM_CLASS_FLAGS(ERunStyle);
+
+	struct FRun
+	{
+		FString Text;
+		ERunStyle Style = ERunStyle::Plain;
+	};
+
+	static const float HeadingScales[] = { 2.0f, 1.6f, 1.35f, 1.2f, 1.1f, 1.0f };
+
+	/** Splits a block of text into styled runs, dropping the emphasis markers and link targets. */
+	static void ParseInline(FStringView Text, TArray<FRun>& OutRuns)
+	{
+		ERunStyle Style = ERunStyle::Plain;
+		FString Current;
+
+		auto Flush = [&OutRuns, &Current, &Style]()
+		{
+			if (!Current.IsEmpty())
+			{
+				OutRuns.Add({ MoveTemp(Current), Style });
+				Current.Reset();
+			}
+		};
+
+		for (int32 Index = 0; Index < Text.Len(); ++Index)
+		{
+			const TCHAR Char = Text[Index];
+			const TCHAR Next = Index + 1 < Text.Len() ? Text[Index + 1] : TEXT('\0');
+
+			if (Char == TEXT('\\') && Next != TEXT('\0') && FChar::IsPunct(Next))
+			{
+				Current.AppendChar(Next);
+				++Index;
+			}
+			else if (Char == TEXT('`'))
+			{
+				// code spans are literal up to the closing backtick
+				const int32 Close = Text.RightChop(Index + 1).Find(TEXTVIEW("`"));
+				if (Close == INDEX_NONE)
+				{
+					Current.AppendChar(Char);
+					continue;
+				}
+
+				Flush();
+				OutRuns.Add({ FString(Text.Mid(Index + 1, Close)), Style | ERunStyle::Code });
+				Index += Close + 1;
+			}
+			else if ((Char == TEXT('*') || Char == TEXT('_')) && Next == Char)
+			{
+				Flush();
+				Style ^= ERunStyle::Bold;
+				++Index;
+			}
+			else if (Char == TEXT('*'))
+			{
+				Flush();
+				Style ^= ERunStyle::Italic;
+			}
+			else if (Char == TEXT('[') || (Char == TEXT('!') && Next == TEXT('[')))
+			{
+				// [label](target) keeps the label, images keep their alt text
+				const int32 LabelStart = Index + (Char == TEXT('!') ? 2 : 1);
+				const int32 LabelEnd = Text.RightChop(LabelStart).Find(TEXTVIEW("]("));
+				const int32 TargetEnd = LabelEnd == INDEX_NONE ? INDEX_NONE : Text.RightChop(LabelStart + LabelEnd + 2).Find(TEXTVIEW(")"));
+
+				if (TargetEnd == INDEX_NONE)
+				{
+					Current.AppendChar(Char);
+					continue;
+				}
+
+				Flush();
+				OutRuns.Add({ FString(Text.Mid(LabelStart, LabelEnd)), Style | (Char == TEXT('!') ? ERunStyle::Italic : ERunStyle::Link) });
+				Index = LabelStart + LabelEnd + 2 + TargetEnd;
+			}
+			else
+			{
+				Current.AppendChar(Char);
+			}
+		}
+
+		Flush();
+	}
+
+	/** Places words left to right, wrapping at the right edge. */
+	class FFlow
+	{
+	public:
+
+		FFlow(FMarkdownLayout& InLayout, const FMarkdownRenderStyle& InStyle, float InWidth)
+			: Layout(InLayout)
+			, Style(InStyle)
+			, Right(InWidth - InStyle.Padding)
+			, Y(InStyle.Padding)
+		{
+			BodyFont = Style.Font ? Style.Font.Get() : GEngine->GetMediumFont();
+			BoldFont = Style.BoldFont ? Style.BoldFont.Get() : BodyFont;
+			CodeFont = Style.CodeFont ? Style.CodeFont.Get() : BodyFont;
+		}
+
+		float GetY() const { return Y; }
+		float GetRight() const { return Right; }
+
+		float GetLineHeight(const UFont* Font, float Scale) const
+		{
+			return Font->GetMaxCharHeight() * Scale * Style.FontScale * 1.2f;
+		}
+
+		/** Lays out the runs as one block, starting a new line at Left. */
+		void AddBlock(const TArray<FRun>& Runs, float Left, float Scale, const FLinearColor& Color, bool bWrap = true)
+		{
+			X = Left;
+			LineLeft = Left;
+			LineHeight = GetLineHeight(BodyFont, Scale);
+
+			for (const FRun& Run : Runs)
+			{
+				const UFont* Font = GetFont(Run.Style);
+				const FLinearColor& RunColor = EnumHasAnyFlags(Run.Style, ERunStyle::Code) ? Style.CodeColor : EnumHasAnyFlags(Run.Style, ERunStyle::Link) ? Style.LinkColor : Color;
+				const float RunScale = Scale * Style.FontScale;
+				const float SpaceWidth = Font->GetStringSize(TEXT(" ")) * RunScale;
+
+				LineHeight = FMath::Max(LineHeight, GetLineHeight(Font, Scale));
+
+				int32 Start = 0;
+				while (Start < Run.Text.Len())
+				{
+					if (FChar::IsWhitespace(Run.Text[Start]))
+					{
+						X += X > LineLeft ? SpaceWidth : 0.0f;
+						++Start;
+						continue;
+					}
+
+					int32 End = Start;
+					while (End < Run.Text.Len() && !FChar::IsWhitespace(Run.Text[End]))
+					{
+						++End;
+					}
+
+					FString Word = Run.Text.Mid(Start, End - Start);
+					const float WordWidth = Font->GetStringSize(*Word) * RunScale;
+
+					if (bWrap && X > LineLeft && X + WordWidth > Right)
+					{
+						NewLine();
+					}
+
+					FMarkdownLayoutText& Item = Layout.Texts.AddDefaulted_GetRef();
+					Item.Position = FVector2D(X, Y);
+					Item.Text = MoveTemp(Word);
+					Item.Font = Font;
+					Item.Color = RunColor;
+					Item.Scale = RunScale;
+
+					X += WordWidth;
+					Start = End;
+				}
+			}
+
+			NewLine();
+		}
+
+		/** Places a list bullet or number at the start of the next line. */
+		void AddMarker(FString Text, float Left, const FLinearColor& Color)
+		{
+			FMarkdownLayoutText& Item = Layout.Texts.AddDefaulted_GetRef();
+			Item.Position = FVector2D(Left, Y);
+			Item.Text = MoveTemp(Text);
+			Item.Font = BodyFont;
+			Item.Color = Color;
+			Item.Scale = Style.FontScale;
+		}
+
+		void AddSpacing()
+		{
+			Y += GetLineHeight(BodyFont, 1.0f) * Style.BlockSpacing;
+		}
+
+		void AddBox(float Left, float Top, float Width, float Height, const FLinearColor& Color)
+		{
+			Layout.Boxes.Add({ FVector2D(Left, Top), FVector2D(Width, Height), Color });
+		}
+
+		void AddRule()
+		{
+			const float Height = FMath::Max(1.0f, Style.FontScale);
+			AddBox(Style.Padding, Y + LineHeight * 0.5f, Right - Style.Padding, Height, Style.TextColor * 0.5f);
+			Y += GetLineHeight(BodyFont, 1.0f);
+		}
+
+	private:
+
+		const UFont* GetFont(ERunStyle RunStyle) const
+		{
+			return EnumHasAnyFlags(RunStyle, ERunStyle::Code) ? CodeFont : EnumHasAnyFlags(RunStyle, ERunStyle::Bold) ? BoldFont : BodyFont;
+		}
+
+		void NewLine()
+		{
+			Y += LineHeight;
+			X = LineLeft;
+		}
+
+		FMarkdownLayout& Layout;
+		const FMarkdownRenderStyle& Style;
+
+		const UFont* BodyFont = nullptr;
+		const UFont* BoldFont = nullptr;
+		const UFont* CodeFont = nullptr;
+
+		float Right = 0.0f;
+		float X = 0.0f;
+		float Y = 0.0f;
+		float LineLeft = 0.0f;
+		float LineHeight = 0.0f;
+	};
+
+	static bool IsRule(FStringView Line)
+	{
+		int32 Count = 0;
+
+		for (const TCHAR Char : Line)
+		{
+			if (Char == Line[0])
+			{
+				++Count;
+			}
+			else if (!FChar::IsWhitespace(Char))
+			{
+				return false;
+			}
+		}
+
+		return Count >= 3 && (Line[0] == TEXT('-') || Line[0] == TEXT('*') || Line[0] == TEXT('_'));
+	}
+
+	/** Returns the length of a list marker ("- ", "* ", "+ ", "1. "), or 0. */
+	static int32 GetListMarkerLen(FStringView Line)
+	{
+		if (Line.Len() >= 2 && (Line[0] == TEXT('-') || Line[0] == TEXT('*') || Line[0] == TEXT('+')) && Line[1] == TEXT(' '))
+		{
+			return 2;
+		}
+
+		int32 Digits = 0;
+		while (Digits < Line.Len() && FChar::IsDigit(Line[Digits]))
+		{
+			++Digits;
+		}
+
+		return Digits > 0 && Digits + 1 < Line.Len() && (Line[Digits] == TEXT('.') || Line[Digits] == TEXT(')')) && Line[Digits + 1] == TEXT(' ') ? Digits + 2 : 0;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+uint32 GetTypeHash(const FMarkdownRenderStyle& Style)
+{
+	uint32 Hash = HashCombine(GetTypeHash(Style.Font.Get()), GetTypeHash(Style.BoldFont.Get()));
+	Hash = HashCombine(Hash, GetTypeHash(Style.CodeFont.Get()));
+	Hash = HashCombine(Hash, GetTypeHash(Style.FontScale));
+	Hash = HashCombine(Hash, GetTypeHash(Style.BackgroundColor));
+	Hash = HashCombine(Hash, GetTypeHash(Style.TextColor));
+	Hash = HashCombine(Hash, GetTypeHash(Style.HeadingColor));
+	Hash = HashCombine(Hash, GetTypeHash(Style.LinkColor));
+	Hash = HashCombine(Hash, GetTypeHash(Style.CodeColor));
+	Hash = HashCombine(Hash, GetTypeHash(Style.CodeBackgroundColor));
+	Hash = HashCombine(Hash, GetTypeHash(Style.Padding));
+	return HashCombine(Hash, GetTypeHash(Style.BlockSpacing));
+}
+
+FMarkdownLayout FMarkdownLayout::Build(FStringView Markdown, float Width, float MaxHeight, const FMarkdownRenderStyle& Style)
+{
+	using namespace MarkdownLayout;
+
+	FMarkdownLayout Layout;
+	FFlow Flow(Layout, Style, Width);
+
+	const float Left = Style.Padding;
+	const float Indent = 24.0f * Style.FontScale;
+
+	FString Paragraph;
+	TArray<FRun> Runs;
+
+	auto FlushParagraph = [&]()
+	{
+		if (!Paragraph.IsEmpty())
+		{
+			Runs.Reset();
+			ParseInline(Paragraph, Runs);
+			Flow.AddBlock(Runs, Left, 1.0f, Style.TextColor);
+			Flow.AddSpacing();
+			Paragraph.Reset();
+		}
+	};
+
+	bool bInFence = false;
+	float FenceTop = 0.0f;
+
+	while (!Markdown.IsEmpty() && Flow.GetY() < MaxHeight)
+	{
+		int32 LineEnd = INDEX_NONE;
+		Markdown.FindChar(TEXT('\n'), LineEnd);
+
+		FStringView Line = LineEnd == INDEX_NONE ? Markdown : Markdown.Left(LineEnd);
+		Markdown.RightChopInline(LineEnd == INDEX_NONE ? Markdown.Len() : LineEnd + 1);
+
+		Line.TrimEndInline();
+		const FStringView Trimmed = Line.TrimStart();
+
+		if (Trimmed.StartsWith(TEXTVIEW("```")) || Trimmed.StartsWith(TEXTVIEW("~~~")))
+		{
+			FlushParagraph();
+
+			if (bInFence)
+			{
+				Flow.AddBox(Left, FenceTop, Flow.GetRight() - Left, Flow.GetY() - FenceTop, Style.CodeBackgroundColor);
+				Flow.AddSpacing();
+			}
+			else
+			{
+				FenceTop = Flow.GetY();
+			}
+
+			bInFence = !bInFence;
+			continue;
+		}
+
+		if (bInFence)
+		{
+			// code is drawn as written, long lines are clipped rather than wrapped
+			Runs.Reset();
+			Runs.Add({ FString(Line).Replace(TEXT("\t"), TEXT("    ")), ERunStyle::Code });
+			Flow.AddBlock(Runs, Left + Indent * 0.5f, 1.0f, Style.CodeColor, false);
+			continue;
+		}
+
+		if (Trimmed.IsEmpty())
+		{
+			FlushParagraph();
+			continue;
+		}
+
+		int32 Level = 0;
+		while (Level < Trimmed.Len() && Trimmed[Level] == TEXT('#'))
+		{
+			++Level;
+		}
+
+		if (Level >= 1 && Level <= 6 && (Level == Trimmed.Len() || Trimmed[Level] == TEXT(' ')))
+		{
+			FlushParagraph();
+
+			Runs.Reset();
+			ParseInline(Trimmed.RightChop(Level).TrimStart(), Runs);
+
+			for (FRun& Run : Runs)
+			{
+				Run.Style |= ERunStyle::Bold;
+			}
+
+			Flow.AddBlock(Runs, Left, HeadingScales[Level - 1], Style.HeadingColor);
+			Flow.AddSpacing();
+			continue;
+		}
+
+		if (IsRule(Trimmed))
+		{
+			FlushParagraph();
+			Flow.AddRule();
+			continue;
+		}
+
+		if (const int32 MarkerLen = GetListMarkerLen(Trimmed))
+		{
+			FlushParagraph();
+
+			const int32 Depth = (Line.Len() - Trimmed.Len()) / 2;
+			const float ItemLeft = Left + Indent * (Depth + 1);
+			const bool bOrdered = FChar::IsDigit(Trimmed[0]);
+
+			Flow.AddMarker(bOrdered ? FString(Trimmed.Left(MarkerLen - 1)) : FString(TEXT("\u2022")), ItemLeft - Indent * 0.75f, Style.TextColor);
+
+			Runs.Reset();
+			ParseInline(Trimmed.RightChop(MarkerLen), Runs);
+			Flow.AddBlock(Runs, ItemLeft, 1.0f, Style.TextColor);
+			continue;
+		}
+
+		if (Trimmed.StartsWith(TEXT('>')))
+		{
+			FlushParagraph();
+
+			const float Top = Flow.GetY();
+
+			Runs.Reset();
+			ParseInline(Trimmed.RightChop(1).TrimStart(), Runs);
+
+			for (FRun& Run : Runs)
+			{
+				Run.Style |= ERunStyle::Italic;
+			}
+
+			Flow.AddBlock(Runs, Left + Indent, 1.0f, Style.TextColor * 0.8f);
+			Flow.AddBox(Left + Indent * 0.25f, Top, FMath::Max(2.0f, 3.0f * Style.FontScale), Flow.GetY() - Top, Style.TextColor * 0.4f);
+			continue;
+		}
+
+		// consecutive lines join into a paragraph
+		if (!Paragraph.IsEmpty())
+		{
+			Paragraph.AppendChar(TEXT(' '));
+		}
+
+		Paragraph.Append(Trimmed);
+	}
+
+	FlushParagraph();
+
+	if (bInFence)
+	{
+		Flow.AddBox(Left, FenceTop, Flow.GetRight() - Left, Flow.GetY() - FenceTop, Style.CodeBackgroundColor);
+	}
+
+	Layout.Height = Flow.GetY() + Style.Padding;
+	return Layout;
+}
@@ -0,0 +1,46 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "MarkdownLoadDocumentAction.h"
+
+#include "Engine/StreamableManager.h"
+#include "MarkdownAsset.h"
+
+UMarkdownLoadDocumentAction* UMarkdownLoadDocumentAction::LoadMarkdownDocument(UObject* WorldContextObject, TSoftObjectPtr<UMarkdownAsset> Document, const FString& Section)
+{
+	UMarkdownLoadDocumentAction* Action = NewObject<UMarkdownLoadDocumentAction>();
+	Action->Path = Document.ToSoftObjectPath();
+	Action->Section = Section;
+	Action->RegisterWithGameInstance(WorldContextObject);
+
+	return Action;
+}
+
+void UMarkdownLoadDocumentAction::Activate()
+{
+	Handle = UMarkdownAsset::LoadDocumentAsync(Path, FOnMarkdownDocumentLoaded::CreateUObject(this, &UMarkdownLoadDocumentAction::OnDocumentLoaded));
+}
+
+void UMarkdownLoadDocumentAction::OnDocumentLoaded(TSharedPtr<const FMarkdownDocument> Document)
+{
+	Handle.Reset();
+
+	const FMarkdownDocumentSection* Found = Document.IsValid() && !Section.IsEmpty() ? Document->FindSection(Section) : nullptr;
+
+	if (!Document.IsValid() || (!Section.IsEmpty() && !Found))
+	{
+		Failed.Broadcast(FString(), FString(), TArray<FString>());
+		SetReadyToDestroy();
+		return;
+	}
+
+	TArray<FString> Sections;
+	Sections.Reserve(Document->GetSections().Num());
+
+	for (const FMarkdownDocumentSection& DocumentSection : Document->GetSections())
+	{
+		Sections.Add(DocumentSection.Title);
+	}
+
+	Loaded.Broadcast(Document->GetTitle(), Found ? FString(Document->GetSectionText(*Found)) : Document->GetText(), Sections);
+	SetReadyToDestroy();
+}
@@ -0,0 +1,766 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "MarkdownRender.h"
+
+#include "MarkdownScanner.h"
+#include "MarkdownSyntaxTree.h"
+
+namespace MarkdownRender
+{
+	/** Shared by the backends, which are not related through virtual functions. */
+	class FWriter
+	{
+	public:
+
+		FWriter(const FMarkdownSyntaxTree& InTree, FString& InOut)
+			: Tree(InTree)
+			, Out(InOut)
+		{
+		}
+
+	protected:
+
+		/** Escapes the characters with a meaning in HTML, which are also the ones SRichTextBlock markup unescapes. */
+		void AppendEscaped(FStringView Text)
+		{
+			int32 Copied = 0;
+
+			for (int32 Index = 0; Index < Text.Len(); ++Index)
+			{
+				const TCHAR* Entity = nullptr;
+
+				switch (Text[Index])
+				{
+					case TEXT('&'): Entity = TEXT("&amp;"); break;
+					case TEXT('<'): Entity = TEXT("&lt;"); break;
+					case TEXT('>'): Entity = TEXT("&gt;"); break;
+					case TEXT('"'): Entity = TEXT("&quot;"); break;
+					default: continue;
+				}
+
+				Out.Append(Text.Mid(Copied, Index - Copied));
+				Out.Append(Entity);
+				Copied = Index + 1;
+			}
+
+			Out.Append(Text.RightChop(Copied));
+		}
+
+		/**
+		 * The check markdown-it's validateLink makes, so an export does not link to script the viewer would refuse:
+		 * javascript:, vbscript:, file: and data: URLs are rejected, apart from data: images.
+		 */
+		static bool IsSafeUrl(FStringView Url)
+		{
+			// browsers ignore tabs and newlines anywhere in a URL and control characters in front of it, so
+			// " java\tscript:" still runs script. Only the scheme matters, which is never longer than this
+			TCHAR Scheme[32];
+			int32 SchemeLen = 0;
+
+			for (const TCHAR Char : Url)
+			{
+				if (Char == TEXT('\t') || Char == TEXT('\n') || Char == TEXT('\r') || (SchemeLen == 0 && Char <= TEXT(' ')))
+				{
+					continue;
+				}
+
+				Scheme[SchemeLen++] = FChar::ToLower(Char);
+
+				if (SchemeLen == UE_ARRAY_COUNT(Scheme))
+				{
+					break;
+				}
+			}
+
+			const FStringView Prefix(Scheme, SchemeLen);
+
+			if (Prefix.StartsWith(TEXT("data:")))
+			{
+				return Prefix.StartsWith(TEXT("data:image/gif;")) || Prefix.StartsWith(TEXT("data:image/png;"))
+					|| Prefix.StartsWith(TEXT("data:image/jpeg;")) || Prefix.StartsWith(TEXT("data:image/webp;"));
+			}
+
+			return !Prefix.StartsWith(TEXT("javascript:")) && !Prefix.StartsWith(TEXT("vbscript:")) && !Prefix.StartsWith(TEXT("file:"));
+		}
+
+		bool IsAtLineStart() const
+		{
+			return Out.IsEmpty() || Out[Out.Len() - 1] == TEXT('\n');
+		}
+
+		void EndLine()
+		{
+			if (!IsAtLineStart())
+			{
+				Out.AppendChar(TEXT('\n'));
+			}
+		}
+
+		/** The number an ordered list starts at. */
+		int32 GetListStart(const FMarkdownNode& List) const
+		{
+			int32 Start = 0;
+			for (const TCHAR Digit : Tree.GetArg(List))
+			{
+				Start = Start * 10 + (Digit - TEXT('0'));
+			}
+			return Start;
+		}
+
+		const FMarkdownSyntaxTree& Tree;
+		FString& Out;
+	};
+
+	//-----------------------------------------------------------------------------------------------------------------
+
+	class FHtmlWriter : public FWriter
+	{
+	public:
+
+		using FWriter::FWriter;
+
+		bool Enter(const FMarkdownNode& Node)
+		{
+			switch (Node.Type)
+			{
+				case EMarkdownNodeType::Document:
+					break;
+
+				case EMarkdownNodeType::Heading:
+					Out.Appendf(TEXT("<h%d id=\""), Node.Level);
+					AppendEscaped(Anchors.Add(Tree.GetInlineText(Node)));
+					Out.Append(TEXT("\">"));
+					break;
+
+				case EMarkdownNodeType::Paragraph:
+					Out.Append(TEXT("<p>"));
+					break;
+
+				case EMarkdownNodeType::List:
+					if (!EnumHasAnyFlags(Node.Flags, EMarkdownNodeFlags::Ordered))
+					{
+						Out.Append(TEXT("<ul>\n"));
+					}
+					else if (GetListStart(Node) != 1)
+					{
+						Out.Appendf(TEXT("<ol start=\"%d\">\n"), GetListStart(Node));
+					}
+					else
+					{
+						Out.Append(TEXT("<ol>\n"));
+					}
+					break;
+
+				case EMarkdownNodeType::ListItem:
+					Out.Append(TEXT("<li>"));
+					break;
+
+				case EMarkdownNodeType::Quote:
+					Out.Append(TEXT("<blockquote>\n"));
+					break;
+
+				case EMarkdownNodeType::CodeBlock:
+				{
+					FStringView Language = Tree.GetArg(Node);
+					int32 Space = INDEX_NONE;
+					Language = Language.FindChar(TEXT(' '), Space) ? Language.Left(Space) : Language;
+
+					Out.Append(TEXT("<pre><code"));
+					if (!Language.IsEmpty())
+					{
+						Out.Append(TEXT(" class=\"language-"));
+						AppendEscaped(Language);
+						Out.AppendChar(TEXT('"'));
+					}
+					Out.AppendChar(TEXT('>'));
+
+					bInCode = true;
+					break;
+				}
+
+				case EMarkdownNodeType::Rule:
+					Out.Append(TEXT("<hr />\n"));
+					break;
+
+				case EMarkdownNodeType::Table:
+					Out.Append(TEXT("<table>\n"));
+					bInTableBody = false;
+					break;
+
+				case EMarkdownNodeType::TableRow:
+					bInHeader = EnumHasAnyFlags(Node.Flags, EMarkdownNodeFlags::Header);
+					Out.Append(bInHeader ? TEXT("<thead>\n") : bInTableBody ? TEXT("") : TEXT("<tbody>\n"));
+					Out.Append(TEXT("<tr>\n"));
+					bInTableBody |= !bInHeader;
+					break;
+
+				case EMarkdownNodeType::TableCell:
+				{
+					const bool bLeft = EnumHasAnyFlags(Node.Flags, EMarkdownNodeFlags::AlignLeft);
+					const bool bRight = EnumHasAnyFlags(Node.Flags, EMarkdownNodeFlags::AlignRight);
+
+					Out.Append(bInHeader ? TEXT("<th") : TEXT("<td"));
+					Out.Append(bLeft && bRight ? TEXT(" align=\"center\"") : bLeft ? TEXT(" align=\"left\"") : bRight ? TEXT(" align=\"right\"") : TEXT(""));
+					Out.AppendChar(TEXT('>'));
+					break;
+				}
+
+				case EMarkdownNodeType::Text:
+					AppendEscaped(Tree.GetSpan(Node));
+					break;
+
+				case EMarkdownNodeType::Code:
+					Out.Append(TEXT("<code>"));
+					AppendEscaped(Tree.GetSpan(Node));
+					Out.Append(TEXT("</code>"));
+					break;
+
+				case EMarkdownNodeType::Emphasis:
+					Out.Append(TEXT("<em>"));
+					break;
+
+				case EMarkdownNodeType::Strong:
+					Out.Append(TEXT("<strong>"));
+					break;
+
+				case EMarkdownNodeType::Strikethrough:
+					Out.Append(TEXT("<del>"));
+					break;
+
+				case EMarkdownNodeType::Link:
+					// a rejected link keeps its text, like markdown-it leaves it unlinked
+					bRejectedLink = !IsSafeUrl(Tree.GetArg(Node));
+					if (!bRejectedLink)
+					{
+						Out.Append(TEXT("<a href=\""));
+						AppendEscaped(Tree.GetArg(Node));
+						Out.Append(TEXT("\">"));
+					}
+					break;
+
+				case EMarkdownNodeType::Image:
+					if (!IsSafeUrl(Tree.GetArg(Node)))
+					{
+						AppendEscaped(Tree.GetSpan(Node));
+						break;
+					}
+					Out.Append(TEXT("<img src=\""));
+					AppendEscaped(Tree.GetArg(Node));
+					Out.Append(TEXT("\" alt=\""));
+					AppendEscaped(Tree.GetSpan(Node));
+					Out.Append(TEXT("\" />"));
+					break;
+
+				case EMarkdownNodeType::Break:
+					Out.Append(!bInCode && EnumHasAnyFlags(Node.Flags, EMarkdownNodeFlags::HardBreak) ? TEXT("<br />\n") : TEXT("\n"));
+					break;
+			}
+
+			return true;
+		}
+
+		void Leave(const FMarkdownNode& Node)
+		{
+			switch (Node.Type)
+			{
+				case EMarkdownNodeType::Heading:
+					Out.Appendf(TEXT("</h%d>\n"), Node.Level);
+					break;
+
+				case EMarkdownNodeType::Paragraph:
+					Out.Append(TEXT("</p>\n"));
+					break;
+
+				case EMarkdownNodeType::List:
+					Out.Append(EnumHasAnyFlags(Node.Flags, EMarkdownNodeFlags::Ordered) ? TEXT("</ol>\n") : TEXT("</ul>\n"));
+					break;
+
+				case EMarkdownNodeType::ListItem:
+					Out.Append(TEXT("</li>\n"));
+					break;
+
+				case EMarkdownNodeType::Quote:
+					Out.Append(TEXT("</blockquote>\n"));
+					break;
+
+				case EMarkdownNodeType::CodeBlock:
+					Out.Append(TEXT("\n</code></pre>\n"));
+					bInCode = false;
+					break;
+
+				case EMarkdownNodeType::Table:
+					Out.Append(bInTableBody ? TEXT("</tbody>\n</table>\n") : TEXT("</table>\n"));
+					break;
+
+				case EMarkdownNodeType::TableRow:
+					Out.Append(bInHeader ? TEXT("</tr>\n</thead>\n") : TEXT("</tr>\n"));
+					break;
+
+				case EMarkdownNodeType::TableCell:
+					Out.Append(bInHeader ? TEXT("</th>\n") : TEXT("</td>\n"));
+					break;
+
+				case EMarkdownNodeType::Emphasis:
+					Out.Append(TEXT("</em>"));
+					break;
+
+				case EMarkdownNodeType::Strong:
+					Out.Append(TEXT("</strong>"));
+					break;
+
+				case EMarkdownNodeType::Strikethrough:
+					Out.Append(TEXT("</del>"));
+					break;
+
+				case EMarkdownNodeType::Link:
+					Out.Append(bRejectedLink ? TEXT("") : TEXT("</a>"));
+					bRejectedLink = false;
+					break;
+
+				default:
+					break;
+			}
+		}
+
+	private:
+
+		FMarkdownHeadingAnchors Anchors;
+
+		bool bInCode = false;
+		bool bRejectedLink = false;
+		bool bInHeader = false;
+		bool bInTableBody = false;
+	};
+
+	//-----------------------------------------------------------------------------------------------------------------
+
+	class FPlainTextWriter : public FWriter
+	{
+	public:
+
+		using FWriter::FWriter;
+
+		bool Enter(const FMarkdownNode& Node)
+		{
+			switch (Node.Type)
+			{
+				case EMarkdownNodeType::ListItem:
+					EndLine();
+					break;
+
+				case EMarkdownNodeType::CodeBlock:
+					bInCode = true;
+					break;
+
+				case EMarkdownNodeType::TableCell:
+					Out.Append(IsAtLineStart() ? TEXT("") : TEXT("\t"));
+					break;
+
+				case EMarkdownNodeType::Text:
+				case EMarkdownNodeType::Code:
+				case EMarkdownNodeType::Image:
+					Out.Append(Tree.GetSpan(Node));
+					break;
+
+				case EMarkdownNodeType::Break:
+					Out.AppendChar(bInCode || EnumHasAnyFlags(Node.Flags, EMarkdownNodeFlags::HardBreak) ? TEXT('\n') : TEXT(' '));
+					break;
+
+				default:
+					break;
+			}
+
+			return true;
+		}
+
+		void Leave(const FMarkdownNode& Node)
+		{
+			switch (Node.Type)
+			{
+				case EMarkdownNodeType::CodeBlock:
+					bInCode = false;
+					EndLine();
+					break;
+
+				case EMarkdownNodeType::Heading:
+				case EMarkdownNodeType::Paragraph:
+				case EMarkdownNodeType::ListItem:
+				case EMarkdownNodeType::TableRow:
+					EndLine();
+					break;
+
+				default:
+					break;
+			}
+		}
+
+	private:
+
+		bool bInCode = false;
+	};
+
+	//-----------------------------------------------------------------------------------------------------------------
+
+	/** SRichTextBlock runs cannot nest, so the styles in effect are tracked and each text run gets a single tag. */
+	class FRichTextWriter : public FWriter
+	{
+	public:
+
+		using FWriter::FWriter;
+
+		bool Enter(const FMarkdownNode& Node)
+		{
+			switch (Node.Type)
+			{
+				case EMarkdownNodeType::Heading:
+				case EMarkdownNodeType::Paragraph:
+				case EMarkdownNodeType::CodeBlock:
+				case EMarkdownNodeType::Table:
+				case EMarkdownNodeType::Rule:
+					BeginBlock();
+					HeadingLevel = Node.Type == EMarkdownNodeType::Heading ? Node.Level : 0;
+					bInCode = Node.Type == EMarkdownNodeType::CodeBlock;
+					Out.Append(Node.Type == EMarkdownNodeType::Rule ? TEXT("\u2014\u2014\u2014") : TEXT(""));
+					break;
+
+				case EMarkdownNodeType::List:
+					BeginBlock();
+					ListCounters.Add(EnumHasAnyFlags(Node.Flags, EMarkdownNodeFlags::Ordered) ? GetListStart(Node) : INDEX_NONE);
+					break;
+
+				case EMarkdownNodeType::ListItem:
+				{
+					EndLine();
+
+					for (int32 Depth = 1; Depth < ListCounters.Num(); ++Depth)
+					{
+						Out.Append(TEXT("    "));
+					}
+
+					int32& Counter = ListCounters.Last();
+					if (Counter == INDEX_NONE)
+					{
+						Out.Append(TEXT("\u2022 "));
+					}
+					else
+					{
+						Out.Appendf(TEXT("%d. "), Counter++);
+					}
+					break;
+				}
+
+				case EMarkdownNodeType::Quote:
+					BeginBlock();
+					++Italic;
+					break;
+
+				case EMarkdownNodeType::TableRow:
+					EndLine();
+					Bold += EnumHasAnyFlags(Node.Flags, EMarkdownNodeFlags::Header) ? 1 : 0;
+					break;
+
+				case EMarkdownNodeType::TableCell:
+					Out.Append(IsAtLineStart() ? TEXT("") : TEXT("\t"));
+					break;
+
+				case EMarkdownNodeType::Text:
+					AppendRun(Tree.GetSpan(Node), bInCode ? TEXT("code") : GetStyle());
+					break;
+
+				case EMarkdownNodeType::Code:
+					AppendRun(Tree.GetSpan(Node), TEXT("code"));
+					break;
+
+				case EMarkdownNodeType::Emphasis:
+					++Italic;
+					break;
+
+				case EMarkdownNodeType::Strong:
+					++Bold;
+					break;
+
+				case EMarkdownNodeType::Strikethrough:
+					++Strike;
+					break;
+
+				case EMarkdownNodeType::Link:
+					Out.Append(TEXT("<a id=\"link\" href=\""));
+					AppendEscaped(Tree.GetArg(Node));
+					Out.Append(TEXT("\">"));
+					bInLink = true;
+					break;
+
+				case EMarkdownNodeType::Image:
+					AppendRun(Tree.GetSpan(Node), TEXT("italic"));
+					break;
+
+				case EMarkdownNodeType::Break:
+					Out.AppendChar(bInCode || EnumHasAnyFlags(Node.Flags, EMarkdownNodeFlags::HardBreak) ? TEXT('\n') : TEXT(' '));
+					break;
+
+				default:
+					break;
+			}
+
+			return true;
+		}
+
+		void Leave(const FMarkdownNode& Node)
+		{
+			switch (Node.Type)
+			{
+				case EMarkdownNodeType::Heading:
+				case EMarkdownNodeType::CodeBlock:
+					HeadingLevel = 0;
+					bInCode = false;
+					break;
+
+				case EMarkdownNodeType::List:
+					ListCounters.Pop();
+					break;
+
+				case EMarkdownNodeType::Quote:
+				case EMarkdownNodeType::Emphasis:
+					--Italic;
+					break;
+
+				case EMarkdownNodeType::TableRow:
+					Bold -= EnumHasAnyFlags(Node.Flags, EMarkdownNodeFlags::Header) ? 1 : 0;
+					break;
+
+				case EMarkdownNodeType::Strong:
+					--Bold;
+					break;
+
+				case EMarkdownNodeType::Strikethrough:
+					--Strike;
+					break;
+
+				case EMarkdownNodeType::Link:
+					Out.Append(TEXT("</>"));
+					bInLink = false;
+					break;
+
+				default:
+					break;
+			}
+		}
+
+	private:
+
+		/** Blocks are separated by a blank line, except inside lists where every block is an item line. */
+		void BeginBlock()
+		{
+			EndLine();
+
+			if (!Out.IsEmpty() && ListCounters.IsEmpty() && !Out.EndsWith(TEXT("\n\n")))
+			{
+				Out.AppendChar(TEXT('\n'));
+			}
+		}
+
+		const TCHAR* GetStyle() const
+		{
+			static const TCHAR* Headings[] = { TEXT("h1"), TEXT("h2"), TEXT("h3"), TEXT("h4"), TEXT("h5"), TEXT("h6") };
+
+			return HeadingLevel > 0 ? Headings[HeadingLevel - 1]
+				: Bold > 0 && Italic > 0 ? TEXT("bolditalic")
+				: Bold > 0 ? TEXT("bold")
+				: Italic > 0 ? TEXT("italic")
+				: Strike > 0 ? TEXT("strike")
+				: nullptr;
+		}
+
+		/** Text inside a link is already inside its tag. */
+		void AppendRun(FStringView Text, const TCHAR* Style)
+		{
+			if (Style && !bInLink)
+			{
+				Out.AppendChar(TEXT('<'));
+				Out.Append(Style);
+				Out.AppendChar(TEXT('>'));
+				AppendEscaped(Text);
+				Out.Append(TEXT("</>"));
+			}
+			else
+			{
+				AppendEscaped(Text);
+			}
+		}
+
+		TArray<int32, TInlineAllocator<8>> ListCounters;
+		int32 HeadingLevel = 0;
+		int32 Bold = 0;
+		int32 Italic = 0;
+		int32 Strike = 0;
+		bool bInCode = false;
+		bool bInLink = false;
+	};
+
+	//-----------------------------------------------------------------------------------------------------------------
+
+	class FJsonWriter : public FWriter
+	{
+	public:
+
+		using FWriter::FWriter;
+
+		bool Enter(const FMarkdownNode& Node)
+		{
+			Out.Append(bNeedComma ? TEXT(",{\"type\":\"") : TEXT("{\"type\":\""));
+			Out.Append(LexToString(Node.Type));
+			Out.Append(TEXT("\",\"line\":"));
+			Out.AppendInt(Node.Line);
+
+			switch (Node.Type)
+			{
+				case EMarkdownNodeType::Heading:
+					AppendField(TEXT("level"), Node.Level);
+					break;
+
+				case EMarkdownNodeType::List:
+					Out.Append(EnumHasAnyFlags(Node.Flags, EMarkdownNodeFlags::Ordered) ? TEXT(",\"ordered\":true") : TEXT(",\"ordered\":false"));
+					if (EnumHasAnyFlags(Node.Flags, EMarkdownNodeFlags::Ordered))
+					{
+						AppendField(TEXT("start"), GetListStart(Node));
+					}
+					break;
+
+				case EMarkdownNodeType::CodeBlock:
+					AppendField(TEXT("info"), Tree.GetArg(Node));
+					break;
+
+				case EMarkdownNodeType::Table:
+					AppendField(TEXT("columns"), Node.Level);
+					break;
+
+				case EMarkdownNodeType::TableRow:
+					Out.Append(EnumHasAnyFlags(Node.Flags, EMarkdownNodeFlags::Header) ? TEXT(",\"header\":true") : TEXT(""));
+					break;
+
+				case EMarkdownNodeType::TableCell:
+				{
+					const bool bLeft = EnumHasAnyFlags(Node.Flags, EMarkdownNodeFlags::AlignLeft);
+					const bool bRight = EnumHasAnyFlags(Node.Flags, EMarkdownNodeFlags::AlignRight);
+					Out.Append(bLeft && bRight ? TEXT(",\"align\":\"center\"") : bLeft ? TEXT(",\"align\":\"left\"") : bRight ? TEXT(",\"align\":\"right\"") : TEXT(""));
+					break;
+				}
+
+				case EMarkdownNodeType::Text:
+				case EMarkdownNodeType::Code:
+					AppendField(TEXT("text"), Tree.GetSpan(Node));
+					break;
+
+				case EMarkdownNodeType::Link:
+					AppendField(TEXT("url"), Tree.GetArg(Node));
+					break;
+
+				case EMarkdownNodeType::Image:
+					AppendField(TEXT("url"), Tree.GetArg(Node));
+					AppendField(TEXT("alt"), Tree.GetSpan(Node));
+					break;
+
+				case EMarkdownNodeType::Break:
+					Out.Append(EnumHasAnyFlags(Node.Flags, EMarkdownNodeFlags::HardBreak) ? TEXT(",\"hard\":true") : TEXT(""));
+					break;
+
+				default:
+					break;
+			}
+
+			Out.Append(Node.HasChildren() ? TEXT(",\"children\":[") : TEXT(""));
+			bNeedComma = false;
+			return true;
+		}
+
+		void Leave(const FMarkdownNode& Node)
+		{
+			Out.Append(Node.HasChildren() ? TEXT("]}") : TEXT("}"));
+			bNeedComma = true;
+		}
+
+	private:
+
+		void AppendName(const TCHAR* Name)
+		{
+			Out.Append(TEXT(",\""));
+			Out.Append(Name);
+			Out.Append(TEXT("\":"));
+		}
+
+		void AppendField(const TCHAR* Name, int32 Value)
+		{
+			AppendName(Name);
+			Out.AppendInt(Value);
+		}
+
+		void AppendField(const TCHAR* Name, FStringView Value)
+		{
+			AppendName(Name);
+			Out.AppendChar(TEXT('"'));
+
+			int32 Copied = 0;
+
+			for (int32 Index = 0; Index < Value.Len(); ++Index)
+			{
+				const TCHAR Char = Value[Index];
+				if (Char >= 0x20 && Char != TEXT('"') && Char != TEXT('\\'))
+				{
+					continue;
+				}
+
+				Out.Append(Value.Mid(Copied, Index - Copied));
+				Copied = Index + 1;
+
+				switch (Char)
+				{
+					case TEXT('"'): Out.Append(TEXT("\\\"")); break;
+					case TEXT('\\'): Out.Append(TEXT("\\\\")); break;
+					case TEXT('\n'): Out.Append(TEXT("\\n")); break;
+					case TEXT('\r'): Out.Append(TEXT("\\r")); break;
+					case TEXT('\t'): Out.Append(TEXT("\\t")); break;
+					default: Out.Appendf(TEXT("\\u%04x"), int32(Char)); break;
+				}
+			}
+
+			Out.Append(Value.RightChop(Copied));
+			Out.AppendChar(TEXT('"'));
+		}
+
+		bool bNeedComma = false;
+	};
+
+	//-----------------------------------------------------------------------------------------------------------------
+
+	template <typename TWriter>
+	static FString Render(const FMarkdownSyntaxTree& Tree, int32 ExpectedLen)
+	{
+		FString Out;
+		Out.Reserve(ExpectedLen);
+
+		TWriter Writer(Tree, Out);
+		Tree.Walk(Writer);
+
+		return Out;
+	}
+
+	FString ToHtml(const FMarkdownSyntaxTree& Tree)
+	{
+		return Render<FHtmlWriter>(Tree, Tree.GetText().Len() * 5 / 4 + 256);
+	}
+
+	FString ToPlainText(const FMarkdownSyntaxTree& Tree)
+	{
+		return Render<FPlainTextWriter>(Tree, Tree.GetText().Len());
+	}
+
+	FString ToRichText(const FMarkdownSyntaxTree& Tree)
+	{
+		return Render<FRichTextWriter>(Tree, Tree.GetText().Len() * 3 / 2 + 256);
+	}
+
+	FString ToJson(const FMarkdownSyntaxTree& Tree)
+	{
+		return Render<FJsonWriter>(Tree, Tree.GetText().Len() * 2 + Tree.GetNodes().Num() * 48);
+	}
+}
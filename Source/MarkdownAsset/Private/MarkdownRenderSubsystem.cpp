@@ -0,0 +1,157 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "MarkdownRenderSubsystem.h"
+
+#include "CanvasItem.h"
+#include "CanvasTypes.h"
+#include "Engine/TextureRenderTarget2D.h"
+#include "HAL/IConsoleManager.h"
+#include "MarkdownAsset.h"
+#include "Misc/App.h"
+#include "Misc/Crc.h"
+#include "RenderingThread.h"
+#include "RenderUtils.h"
+#include "TextureResource.h"
+
+namespace MarkdownRenderSubsystem
+{
+	static TAutoConsoleVariable<float> CVarBudgetMs(
+		TEXT("Markdown.Render.BudgetMs"),
+		2.0f,
+		TEXT("Game thread time spent drawing markdown documents into render targets each frame, in milliseconds. At least one document is drawn per frame."));
+
+	static TAutoConsoleVariable<int32> CVarMaxCachedTargets(
+		TEXT("Markdown.Render.MaxCachedTargets"),
+		64,
+		TEXT("Number of markdown render targets kept for reuse. Targets still referenced elsewhere stay alive when they are dropped from the cache."));
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void UMarkdownRenderSubsystem::Deinitialize()
+{
+	Pending.Empty();
+	Cache.Empty();
+	CacheOrder.Empty();
+
+	Super::Deinitialize();
+}
+
+UTextureRenderTarget2D* UMarkdownRenderSubsystem::Render(UMarkdownAsset* Document, int32 Width, int32 Height, const FMarkdownRenderStyle& Style)
+{
+	if (!Document || Width <= 0 || Height <= 0 || !FApp::CanEverRender())
+	{
+		return nullptr;
+	}
+
+	// the text is part of the key, so a document edited while playing in the editor is drawn again
+	uint32 Key = HashCombine(GetTypeHash(Document), FCrc::StrCrc32(*Document->GetLocalizedText()));
+	Key = HashCombine(Key, HashCombine(GetTypeHash(Width), GetTypeHash(Height)));
+	Key = HashCombine(Key, GetTypeHash(Style));
+
+	if (UTextureRenderTarget2D* Cached = Cache.FindRef(Key))
+	{
+		Touch(Key);
+		return Cached;
+	}
+
+	UTextureRenderTarget2D* Target = NewObject<UTextureRenderTarget2D>(this);
+	Target->RenderTargetFormat = RTF_RGBA8;
+	Target->ClearColor = Style.BackgroundColor;
+	Target->InitAutoFormat(Width, Height);
+	Target->UpdateResourceImmediate(true);
+
+	Cache.Add(Key, Target);
+	Touch(Key);
+
+	const int32 MaxCachedTargets = FMath::Max(1, MarkdownRenderSubsystem::CVarMaxCachedTargets.GetValueOnGameThread());
+	while (CacheOrder.Num() > MaxCachedTargets)
+	{
+		Cache.Remove(CacheOrder[0]);
+		CacheOrder.RemoveAt(0);
+	}
+
+	FMarkdownRenderJob& Job = Pending.AddDefaulted_GetRef();
+	Job.Document = Document;
+	Job.Target = Target;
+	Job.Style = Style;
+	Job.Key = Key;
+
+	return Target;
+}
+
+void UMarkdownRenderSubsystem::Touch(uint32 Key)
+{
+	CacheOrder.Remove(Key);
+	CacheOrder.Add(Key);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void UMarkdownRenderSubsystem::Tick(float DeltaTime)
+{
+	const double Budget = MarkdownRenderSubsystem::CVarBudgetMs.GetValueOnGameThread() / 1000.0;
+	const double Start = FPlatformTime::Seconds();
+
+	int32 NumDrawn = 0;
+
+	while (NumDrawn < Pending.Num() && (NumDrawn == 0 || FPlatformTime::Seconds() - Start < Budget))
+	{
+		Draw(Pending[NumDrawn++]);
+	}
+
+	// the delegate may have queued more documents, they are at the end
+	Pending.RemoveAt(0, NumDrawn);
+}
+
+void UMarkdownRenderSubsystem::Draw(const FMarkdownRenderJob& Job)
+{
+	if (!Job.Document || !Job.Target)
+	{
+		return;
+	}
+
+	FTextureRenderTargetResource* Resource = Job.Target->GameThread_GetRenderTargetResource();
+	if (!Resource)
+	{
+		return;
+	}
+
+	const FMarkdownLayout Layout = FMarkdownLayout::Build(Job.Document->GetLocalizedText(), Job.Target->SizeX, Job.Target->SizeY, Job.Style);
+
+	FCanvas Canvas(Resource, nullptr, FGameTime::GetTimeSinceAppStart(), GMaxRHIFeatureLevel);
+	Canvas.Clear(Job.Style.BackgroundColor);
+
+	for (const FMarkdownLayoutBox& Box : Layout.Boxes)
+	{
+		FCanvasTileItem Tile(Box.Position, GWhiteTexture, Box.Size, Box.Color);
+		Tile.BlendMode = SE_BLEND_Translucent;
+		Canvas.DrawItem(Tile);
+	}
+
+	for (const FMarkdownLayoutText& Text : Layout.Texts)
+	{
+		FCanvasTextItem Item(Text.Position, FText::FromString(Text.Text), Text.Font, Text.Color);
+		Item.Scale = FVector2D(Text.Scale);
+		Canvas.DrawItem(Item);
+	}
+
+	Canvas.Flush_GameThread();
+
+	ENQUEUE_RENDER_COMMAND(FlushMarkdownRenderTarget)([Resource](FRHICommandListImmediate& RHICmdList)
+	{
+		Resource->FlushDeferredResourceUpdate(RHICmdList);
+	});
+
+	OnRendered.Broadcast(Job.Document, Job.Target);
+}
+
+TStatId UMarkdownRenderSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UMarkdownRenderSubsystem, STATGROUP_Tickables);
+}
+
+ETickableTickType UMarkdownRenderSubsystem::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
@@ -0,0 +1,595 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "MarkdownScanner.h"
+
+#include "Containers/StringConv.h"
+#include "Internationalization/Text.h"
+#include "MarkdownVectorIntrinsics.h"
+#include "Misc/CString.h"
+#include "Misc/Char.h"
+
+namespace MarkdownScanner
+{
+	static const FStringView ScriptPrefix = TEXTVIEW("/Script");
+	static const FStringView GamePrefix = TEXTVIEW("/Game/");
+
+	/** Finds the quoted part following From on the same line. Returns false if there is no closing quote. */
+	static bool FindQuoted(FStringView Text, int32 From, int32& OutOpenQuote, int32& OutCloseQuote)
+	{
+		OutOpenQuote = INDEX_NONE;
+		for (int32 i = From; i < Text.Len() && Text[i] != TEXT('\n'); ++i)
+		{
+			if (Text[i] == TEXT('\''))
+			{
+				OutOpenQuote = i;
+				break;
+			}
+		}
+
+		if (OutOpenQuote == INDEX_NONE)
+		{
+			return false;
+		}
+
+		for (int32 i = OutOpenQuote + 1; i < Text.Len() && Text[i] != TEXT('\n'); ++i)
+		{
+			if (Text[i] == TEXT('\''))
+			{
+				OutCloseQuote = i;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	void FindAssetLinks(FStringView Text, TArray<FMarkdownAssetLinkRef>& OutLinks)
+	{
+		int32 Index = 0;
+
+		while (Index < Text.Len())
+		{
+			const int32 Found = Text.RightChop(Index).Find(ScriptPrefix);
+			if (Found == INDEX_NONE)
+			{
+				break;
+			}
+
+			const int32 PrefixStart = Index + Found;
+			Index = PrefixStart + ScriptPrefix.Len();
+
+			// the path is the quoted part that follows on the same line
+			int32 OpenQuote = INDEX_NONE;
+			int32 CloseQuote = INDEX_NONE;
+
+			if (!FindQuoted(Text, Index, OpenQuote, CloseQuote))
+			{
+				continue;
+			}
+
+			if (CloseQuote > OpenQuote + 1 && Text[OpenQuote + 1] == TEXT('/'))
+			{
+				FMarkdownAssetLinkRef& Link = OutLinks.AddDefaulted_GetRef();
+				Link.PathStart = OpenQuote + 1;
+				Link.PathLen = CloseQuote - OpenQuote - 1;
+			}
+
+			Index = CloseQuote + 1;
+		}
+	}
+
+	//-----------------------------------------------------------------------------------------------------------------
+
+	/** Links and code blocks can only start at one of these, every other character is skipped a block at a time. */
+	static bool IsLinkCandidate(TCHAR Char)
+	{
+		return Char == TEXT('\n') || Char == TEXT('/') || Char == TEXT(':') || Char == TEXT('`');
+	}
+
+	/** Returns a bit per character of the 16 character block, set for the link candidates. */
+	static uint32 FindLinkCandidates(const TCHAR* Block)
+	{
+#if MARKDOWN_VECTOR_SSE || MARKDOWN_VECTOR_NEON
+		if constexpr (sizeof(TCHAR) == 2)
+		{
+#if MARKDOWN_VECTOR_SSE
+			auto Classify = [](__m128i Chars)
+			{
+				return _mm_or_si128(
+					_mm_or_si128(_mm_cmpeq_epi16(Chars, _mm_set1_epi16('\n')), _mm_cmpeq_epi16(Chars, _mm_set1_epi16('/'))),
+					_mm_or_si128(_mm_cmpeq_epi16(Chars, _mm_set1_epi16(':')), _mm_cmpeq_epi16(Chars, _mm_set1_epi16('`'))));
+			};
+
+			const __m128i Low = Classify(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Block)));
+			const __m128i High = Classify(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Block + 8)));
+
+			return uint32(_mm_movemask_epi8(_mm_packs_epi16(Low, High)));
+#else
+			auto Classify = [](uint16x8_t Chars)
+			{
+				return vorrq_u16(
+					vorrq_u16(vceqq_u16(Chars, vdupq_n_u16('\n')), vceqq_u16(Chars, vdupq_n_u16('/'))),
+					vorrq_u16(vceqq_u16(Chars, vdupq_n_u16(':')), vceqq_u16(Chars, vdupq_n_u16('`'))));
+			};
+
+			const uint16x8_t Low = Classify(vld1q_u16(reinterpret_cast<const uint16*>(Block)));
+			const uint16x8_t High = Classify(vld1q_u16(reinterpret_cast<const uint16*>(Block + 8)));
+			const uint8x16_t Matches = vcombine_u8(vmovn_u16(Low), vmovn_u16(High));
+
+			if (vmaxvq_u8(Matches) == 0)
+			{
+				return 0;
+			}
+
+			// there is no movemask on NEON, weight each lane by its bit and add the halves up
+			static const uint8 LaneBits[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+			const uint8x16_t Bits = vandq_u8(Matches, vld1q_u8(LaneBits));
+
+			return uint32(vaddv_u8(vget_low_u8(Bits))) | (uint32(vaddv_u8(vget_high_u8(Bits))) << 8);
+#endif
+		}
+		else
+#endif
+		{
+			uint32 Mask = 0;
+			for (int32 Index = 0; Index < 16; ++Index)
+			{
+				Mask |= IsLinkCandidate(Block[Index]) ? 1u << Index : 0u;
+			}
+			return Mask;
+		}
+	}
+
+	struct FLinkScanState
+	{
+		int32 Line = 1;
+
+		/** Candidates before this are part of a link or code span already handled. */
+		int32 Resume = 0;
+
+		TCHAR FenceChar = 0;
+		int32 FenceLen = 0;
+	};
+
+	/** Opens or closes a fenced code block at the start of a line. */
+	static void BeginLine(FStringView Text, int32 LineStart, FLinkScanState& State)
+	{
+		int32 Pos = LineStart;
+		while (Pos < Text.Len() && Pos - LineStart < 3 && Text[Pos] == TEXT(' '))
+		{
+			++Pos;
+		}
+
+		if (Pos == Text.Len() || (Text[Pos] != TEXT('`') && Text[Pos] != TEXT('~')))
+		{
+			return;
+		}
+
+		const TCHAR Marker = Text[Pos];
+		int32 MarkerEnd = Pos;
+		while (MarkerEnd < Text.Len() && Text[MarkerEnd] == Marker)
+		{
+			++MarkerEnd;
+		}
+
+		const int32 MarkerLen = MarkerEnd - Pos;
+		if (MarkerLen < 3)
+		{
+			return;
+		}
+
+		if (State.FenceChar == 0)
+		{
+			State.FenceChar = Marker;
+			State.FenceLen = MarkerLen;
+			return;
+		}
+
+		if (Marker != State.FenceChar || MarkerLen < State.FenceLen)
+		{
+			return;
+		}
+
+		int32 LineEnd = MarkerEnd;
+		while (LineEnd < Text.Len() && Text[LineEnd] != TEXT('\n'))
+		{
+			if (!FChar::IsWhitespace(Text[LineEnd]))
+			{
+				return;
+			}
+			++LineEnd;
+		}
+
+		State.FenceChar = 0;
+		State.Resume = MarkerEnd;
+	}
+
+	/** Returns the end of the inline code span starting at Start, or of the backticks if it is not closed on the line. */
+	static int32 SkipCodeSpan(FStringView Text, int32 Start)
+	{
+		int32 OpenEnd = Start;
+		while (OpenEnd < Text.Len() && Text[OpenEnd] == TEXT('`'))
+		{
+			++OpenEnd;
+		}
+
+		const int32 RunLen = OpenEnd - Start;
+
+		for (int32 Pos = OpenEnd; Pos < Text.Len() && Text[Pos] != TEXT('\n'); )
+		{
+			if (Text[Pos] != TEXT('`'))
+			{
+				++Pos;
+				continue;
+			}
+
+			const int32 RunStart = Pos;
+			while (Pos < Text.Len() && Text[Pos] == TEXT('`'))
+			{
+				++Pos;
+			}
+
+			if (Pos - RunStart == RunLen)
+			{
+				return Pos;
+			}
+		}
+
+		return OpenEnd;
+	}
+
+	static bool EndsLink(TCHAR Char)
+	{
+		return FChar::IsWhitespace(Char) || Char == TEXT('<') || Char == TEXT('>') || Char == TEXT('"') || Char == TEXT('\'') || Char == TEXT('`') || Char == TEXT(']');
+	}
+
+	/** Returns the end of the link starting at Start, leaving out closing parentheses it did not open and trailing punctuation. */
+	static int32 FindLinkEnd(FStringView Text, int32 Start)
+	{
+		int32 End = Start;
+		int32 Depth = 0;
+
+		for (; End < Text.Len() && !EndsLink(Text[End]); ++End)
+		{
+			if (Text[End] == TEXT('('))
+			{
+				++Depth;
+			}
+			else if (Text[End] == TEXT(')') && Depth-- == 0)
+			{
+				break;
+			}
+		}
+
+		while (End > Start && FCString::Strchr(TEXT(".,;:!?*_~"), Text[End - 1]))
+		{
+			--End;
+		}
+
+		return End;
+	}
+
+	static void AddLinkSpan(int32 Start, int32 End, EMarkdownLinkKind Kind, FLinkScanState& State, TArray<FMarkdownLinkSpan>& OutLinks)
+	{
+		FMarkdownLinkSpan& Link = OutLinks.AddDefaulted_GetRef();
+		Link.Start = Start;
+		Link.Len = End - Start;
+		Link.Line = State.Line;
+		Link.Kind = Kind;
+	}
+
+	static void ScanPath(FStringView Text, int32 Index, FLinkScanState& State, TArray<FMarkdownLinkSpan>& OutLinks)
+	{
+		const FStringView Rest = Text.RightChop(Index);
+
+		if (Rest.StartsWith(ScriptPrefix, ESearchCase::CaseSensitive))
+		{
+			int32 OpenQuote = INDEX_NONE;
+			int32 CloseQuote = INDEX_NONE;
+
+			if (FindQuoted(Text, Index + ScriptPrefix.Len(), OpenQuote, CloseQuote))
+			{
+				if (CloseQuote > OpenQuote + 1 && Text[OpenQuote + 1] == TEXT('/'))
+				{
+					AddLinkSpan(OpenQuote + 1, CloseQuote, EMarkdownLinkKind::Asset, State, OutLinks);
+				}
+
+				State.Resume = CloseQuote + 1;
+			}
+			return;
+		}
+
+		// a bare path has to start a word, "docs/Game/..." is not one
+		if (Rest.StartsWith(GamePrefix, ESearchCase::CaseSensitive) && (Index == 0 || !FChar::IsAlnum(Text[Index - 1])))
+		{
+			const int32 End = FindLinkEnd(Text, Index);
+			if (End > Index + GamePrefix.Len())
+			{
+				AddLinkSpan(Index, End, EMarkdownLinkKind::ContentPath, State, OutLinks);
+				State.Resume = End;
+			}
+		}
+	}
+
+	static void ScanUrl(FStringView Text, int32 Index, FLinkScanState& State, TArray<FMarkdownLinkSpan>& OutLinks)
+	{
+		if (!Text.RightChop(Index).StartsWith(TEXTVIEW("://")))
+		{
+			return;
+		}
+
+		// the scheme is a letter followed by letters, digits, '+', '-' or '.'
+		int32 Start = Index;
+		while (Start > State.Resume && (FChar::IsAlnum(Text[Start - 1]) || Text[Start - 1] == TEXT('+') || Text[Start - 1] == TEXT('-') || Text[Start - 1] == TEXT('.')))
+		{
+			--Start;
+		}
+
+		while (Start < Index && !FChar::IsAlpha(Text[Start]))
+		{
+			++Start;
+		}
+
+		if (Start == Index)
+		{
+			return;
+		}
+
+		const int32 End = FindLinkEnd(Text, Index + 3);
+		if (End > Index + 3)
+		{
+			AddLinkSpan(Start, End, EMarkdownLinkKind::Url, State, OutLinks);
+			State.Resume = End;
+		}
+	}
+
+	static void ScanLinkCandidate(FStringView Text, int32 Index, FLinkScanState& State, TArray<FMarkdownLinkSpan>& OutLinks)
+	{
+		const TCHAR Char = Text[Index];
+
+		// links and code spans end on the line they start on, so lines are never skipped
+		if (Char == TEXT('\n'))
+		{
+			++State.Line;
+			BeginLine(Text, Index + 1, State);
+			return;
+		}
+
+		if (State.FenceChar != 0 || Index < State.Resume)
+		{
+			return;
+		}
+
+		switch (Char)
+		{
+			case TEXT('`'): State.Resume = SkipCodeSpan(Text, Index); break;
+			case TEXT('/'): ScanPath(Text, Index, State, OutLinks); break;
+			case TEXT(':'): ScanUrl(Text, Index, State, OutLinks); break;
+			default: break;
+		}
+	}
+
+	void FindLinks(FStringView Text, TArray<FMarkdownLinkSpan>& OutLinks)
+	{
+		FLinkScanState State;
+		BeginLine(Text, 0, State);
+
+		const TCHAR* Data = Text.GetData();
+		const int32 NumBlocks = Text.Len() / 16;
+
+		for (int32 Block = 0; Block < NumBlocks; ++Block)
+		{
+			for (uint32 Mask = FindLinkCandidates(Data + Block * 16); Mask != 0; Mask &= Mask - 1)
+			{
+				ScanLinkCandidate(Text, Block * 16 + int32(FMath::CountTrailingZeros(Mask)), State, OutLinks);
+			}
+		}
+
+		for (int32 Index = NumBlocks * 16; Index < Text.Len(); ++Index)
+		{
+			if (IsLinkCandidate(Data[Index]))
+			{
+				ScanLinkCandidate(Text, Index, State, OutLinks);
+			}
+		}
+	}
+
+	/** The asset links of the text outside of code, a path in a code sample is an example and not a reference. */
+	static void FindAssetLinksOutsideCode(FStringView Text, TArray<FMarkdownLinkSpan>& OutLinks)
+	{
+		FindLinks(Text, OutLinks);
+		OutLinks.RemoveAll([](const FMarkdownLinkSpan& Link) { return Link.Kind != EMarkdownLinkKind::Asset; });
+	}
+
+	void ExtractAssetLinks(FStringView Text, TArray<FString>& OutPaths)
+	{
+		TArray<FMarkdownLinkSpan> Links;
+		FindAssetLinksOutsideCode(Text, Links);
+
+		for (const FMarkdownLinkSpan& Link : Links)
+		{
+			OutPaths.AddUnique(FString(Text.Mid(Link.Start, Link.Len)));
+		}
+	}
+
+	bool RewriteAssetLinks(FString& Text, TFunctionRef<bool(FStringView Path, FString& OutNewPath)> Rewrite)
+	{
+		TArray<FMarkdownLinkSpan> Links;
+		FindAssetLinksOutsideCode(Text, Links);
+
+		if (Links.IsEmpty())
+		{
+			return false;
+		}
+
+		FString Result;
+		Result.Reserve(Text.Len());
+
+		int32 Copied = 0;
+		bool bChanged = false;
+		FString NewPath;
+
+		for (const FMarkdownLinkSpan& Link : Links)
+		{
+			const FStringView Path = FStringView(Text).Mid(Link.Start, Link.Len);
+
+			NewPath.Reset();
+			if (Rewrite(Path, NewPath) && !Path.Equals(NewPath, ESearchCase::CaseSensitive))
+			{
+				Result.Append(FStringView(Text).Mid(Copied, Link.Start - Copied));
+				Result.Append(NewPath);
+				Copied = Link.Start + Link.Len;
+				bChanged = true;
+			}
+		}
+
+		if (bChanged)
+		{
+			Result.Append(FStringView(Text).RightChop(Copied));
+			Text = MoveTemp(Result);
+		}
+
+		return bChanged;
+	}
+
+	void FindFencedBlocks(FStringView Text, TArray<FMarkdownFenceRef>& OutFences)
+	{
+		int32 LineStart = 0;
+		TCHAR FenceChar = 0;
+		int32 FenceLen = 0;
+		FMarkdownFenceRef Fence;
+
+		while (LineStart < Text.Len())
+		{
+			int32 LineEnd = LineStart;
+			while (LineEnd < Text.Len() && Text[LineEnd] != TEXT('\n'))
+			{
+				++LineEnd;
+			}
+
+			const FStringView LineText = Text.Mid(LineStart, LineEnd - LineStart);
+
+			int32 Indent = 0;
+			while (Indent < LineText.Len() && Indent < 3 && LineText[Indent] == TEXT(' '))
+			{
+				++Indent;
+			}
+
+			const FStringView Trimmed = LineText.RightChop(Indent);
+
+			int32 MarkerLen = 0;
+			if (!Trimmed.IsEmpty() && (Trimmed[0] == TEXT('`') || Trimmed[0] == TEXT('~')))
+			{
+				while (MarkerLen < Trimmed.Len() && Trimmed[MarkerLen] == Trimmed[0])
+				{
+					++MarkerLen;
+				}
+			}
+
+			if (FenceChar == 0 && MarkerLen >= 3)
+			{
+				FenceChar = Trimmed[0];
+				FenceLen = MarkerLen;
+
+				const FStringView Info = Trimmed.RightChop(MarkerLen).TrimStartAndEnd();
+
+				Fence = FMarkdownFenceRef();
+				Fence.Start = LineStart;
+				Fence.InfoStart = Info.IsEmpty() ? LineEnd : int32(Info.GetData() - Text.GetData());
+				Fence.InfoLen = Info.Len();
+				Fence.BodyStart = FMath::Min(LineEnd + 1, Text.Len());
+			}
+			else if (FenceChar != 0 && MarkerLen >= FenceLen && Trimmed[0] == FenceChar && Trimmed.RightChop(MarkerLen).TrimStartAndEnd().IsEmpty())
+			{
+				Fence.BodyLen = FMath::Max(LineStart - 1 - Fence.BodyStart, 0);
+				Fence.Len = LineEnd - Fence.Start;
+				OutFences.Add(Fence);
+				FenceChar = 0;
+			}
+
+			LineStart = LineEnd + 1;
+		}
+
+		if (FenceChar != 0)
+		{
+			Fence.BodyLen = Text.Len() - Fence.BodyStart;
+			Fence.Len = Text.Len() - Fence.Start;
+			OutFences.Add(Fence);
+		}
+	}
+
+	/** Characters encodeURIComponent leaves as they are. */
+	static bool IsUriUnreserved(ANSICHAR Char)
+	{
+		return (Char >= 'a' && Char <= 'z') || (Char >= 'A' && Char <= 'Z') || (Char >= '0' && Char <= '9') || (Char != 0 && FCStringAnsi::Strchr("-_.!~*'()", Char));
+	}
+
+	FString MakeHeadingAnchor(FStringView Title)
+	{
+		// String(s).trim().toLowerCase().replace(/\s+/g, '-')
+		FString Slug;
+		Slug.Reserve(Title.Len());
+
+		bool bInWhitespace = false;
+		bool bAscii = true;
+		for (const TCHAR Char : Title.TrimStartAndEnd())
+		{
+			if (FChar::IsWhitespace(Char))
+			{
+				bInWhitespace = true;
+				continue;
+			}
+
+			if (bInWhitespace)
+			{
+				Slug.AppendChar(TEXT('-'));
+				bInWhitespace = false;
+			}
+
+			Slug.AppendChar(Char);
+			bAscii &= uint32(Char) < 0x80;
+		}
+
+		// FChar and FString only lower case ASCII, FText goes through ICU like toLowerCase does, e.g. "\u00DC" to "\u00FC"
+		Slug = bAscii ? Slug.ToLower() : FText::FromString(MoveTemp(Slug)).ToLower().ToString();
+
+		// encodeURIComponent, anything but the unreserved characters is written as the percent encoded UTF-8 bytes
+		const FTCHARToUTF8 Utf8(*Slug, Slug.Len());
+
+		FString Anchor;
+		Anchor.Reserve(Utf8.Length());
+
+		for (int32 Index = 0; Index < Utf8.Length(); ++Index)
+		{
+			const ANSICHAR Char = Utf8.Get()[Index];
+
+			if (IsUriUnreserved(Char))
+			{
+				Anchor.AppendChar(TCHAR(Char));
+			}
+			else
+			{
+				Anchor.Appendf(TEXT("%%%02X"), uint8(Char));
+			}
+		}
+
+		return Anchor;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+FString FMarkdownHeadingAnchors::Add(FStringView Title)
+{
+	const FString Slug = MarkdownScanner::MakeHeadingAnchor(Title);
+
+	// uniqueSlug() of markdown-it-anchor, the numbers start at 1 and skip anchors already taken
+	FString Anchor = Slug;
+	for (int32 Suffix = 1; Used.Contains(Anchor); ++Suffix)
+	{
+		Anchor = FString::Printf(TEXT("%s-%d"), *Slug, Suffix);
+	}
+
+	Used.Add(Anchor);
+	return Anchor;
+}
@@ -0,0 +1,603 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "MarkdownSearchIndex.h"
+
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace MarkdownSearchIndex
+{
+	static constexpr uint32 Magic = 0x4953444D; // "MDSI"
+	static constexpr uint32 Version = 1;
+
+	/** Shorter terms are mostly noise, longer ones are hashes, paths and the like. */
+	static constexpr int32 MinTermLen = 2;
+	static constexpr int32 MaxTermLen = 32;
+
+	/** Occurrences in the title count as this many occurrences in the text. */
+	static constexpr int32 TitleWeight = 3;
+
+	/** BM25 parameters, the usual defaults. */
+	static constexpr float K1 = 1.2f;
+	static constexpr float B = 0.75f;
+
+	// the file is read in place, so these are laid out as they are in memory (all supported platforms are little endian)
+
+	struct FHeader
+	{
+		uint32 Magic;
+		uint32 Version;
+		uint32 NumDocuments;
+		uint32 NumTerms;
+		float AverageLength;
+		uint32 DocumentsOffset;
+		uint32 TermsOffset;
+		uint32 StringsOffset;
+		uint32 PostingsOffset;
+		uint32 FileSize;
+	};
+
+	struct FDocumentRecord
+	{
+		uint32 Path;
+		uint32 PathLen;
+		uint32 Title;
+		uint32 TitleLen;
+		uint32 Length;
+	};
+
+	/** Terms are sorted by their UTF-8 bytes, postings are (document delta, frequency) varint pairs. */
+	struct FTermRecord
+	{
+		uint32 Term;
+		uint32 TermLen;
+		uint32 Postings;
+		uint32 NumPostings;
+	};
+
+	/** Calls Visit with each lower case term of the text. The view is only valid during the call. */
+	template<typename FunctorType>
+	static void ForEachTerm(FStringView Text, FunctorType&& Visit)
+	{
+		TCHAR Term[MaxTermLen];
+		int32 Len = 0;
+		bool bTooLong = false;
+
+		for (int32 Index = 0; Index <= Text.Len(); ++Index)
+		{
+			const TCHAR Char = Index < Text.Len() ? Text[Index] : TEXT('\0');
+
+			if (Char != TEXT('\0') && FChar::IsAlnum(Char))
+			{
+				if (Len < MaxTermLen)
+				{
+					Term[Len++] = FChar::ToLower(Char);
+				}
+				else
+				{
+					bTooLong = true;
+				}
+
+				continue;
+			}
+
+			if (Len >= MinTermLen && !bTooLong)
+			{
+				Visit(FStringView(Term, Len));
+			}
+
+			Len = 0;
+			bTooLong = false;
+		}
+	}
+
+	/** Encodes a term, which is at most MaxTermLen characters, into a buffer of MaxTermLen * 4 bytes. */
+	static int32 EncodeTerm(FStringView Term, uint8* Out)
+	{
+		int32 Len = 0;
+
+		for (const TCHAR Char : Term)
+		{
+			const uint32 Code = uint32(Char);
+
+			if (Code < 0x80)
+			{
+				Out[Len++] = uint8(Code);
+			}
+			else if (Code < 0x800)
+			{
+				Out[Len++] = uint8(0xC0 | (Code >> 6));
+				Out[Len++] = uint8(0x80 | (Code & 0x3F));
+			}
+			else if (Code < 0x10000)
+			{
+				Out[Len++] = uint8(0xE0 | (Code >> 12));
+				Out[Len++] = uint8(0x80 | ((Code >> 6) & 0x3F));
+				Out[Len++] = uint8(0x80 | (Code & 0x3F));
+			}
+			else
+			{
+				Out[Len++] = uint8(0xF0 | ((Code >> 18) & 0x07));
+				Out[Len++] = uint8(0x80 | ((Code >> 12) & 0x3F));
+				Out[Len++] = uint8(0x80 | ((Code >> 6) & 0x3F));
+				Out[Len++] = uint8(0x80 | (Code & 0x3F));
+			}
+		}
+
+		return Len;
+	}
+
+	static int32 CompareBytes(const uint8* A, int32 LenA, const uint8* B, int32 LenB)
+	{
+		const int32 Result = FMemory::Memcmp(A, B, FMath::Min(LenA, LenB));
+		return Result != 0 ? Result : LenA - LenB;
+	}
+
+	static void WriteVarint(TArray<uint8>& Out, uint32 Value)
+	{
+		while (Value >= 0x80)
+		{
+			Out.Add(uint8(Value | 0x80));
+			Value >>= 7;
+		}
+
+		Out.Add(uint8(Value));
+	}
+
+	static bool ReadVarint(const uint8*& Cursor, const uint8* End, uint32& OutValue)
+	{
+		OutValue = 0;
+
+		for (int32 Shift = 0; Shift < 35 && Cursor < End; Shift += 7)
+		{
+			const uint8 Byte = *Cursor++;
+			OutValue |= uint32(Byte & 0x7F) << Shift;
+
+			if ((Byte & 0x80) == 0)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	template<typename RecordType>
+	static void AppendRecord(TArray<uint8>& Out, const RecordType& Record)
+	{
+		Out.Append(reinterpret_cast<const uint8*>(&Record), sizeof(RecordType));
+	}
+
+	static uint32 AppendString(TArray<uint8>& Strings, FStringView Text, uint32& OutLen)
+	{
+		const uint32 Offset = Strings.Num();
+		const FTCHARToUTF8 Utf8(Text.GetData(), Text.Len());
+
+		Strings.Append(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+		OutLen = Utf8.Length();
+
+		return Offset;
+	}
+
+	static const FHeader& GetHeader(TArrayView<const uint8> Data)
+	{
+		return *reinterpret_cast<const FHeader*>(Data.GetData());
+	}
+
+	static const FDocumentRecord* GetDocuments(TArrayView<const uint8> Data)
+	{
+		return reinterpret_cast<const FDocumentRecord*>(Data.GetData() + GetHeader(Data).DocumentsOffset);
+	}
+
+	static const FTermRecord* GetTerms(TArrayView<const uint8> Data)
+	{
+		return reinterpret_cast<const FTermRecord*>(Data.GetData() + GetHeader(Data).TermsOffset);
+	}
+
+	static FString GetString(TArrayView<const uint8> Data, uint32 Offset, uint32 Len)
+	{
+		const FUTF8ToTCHAR Text(reinterpret_cast<const ANSICHAR*>(Data.GetData() + GetHeader(Data).StringsOffset + Offset), Len);
+		return FString(Text.Length(), Text.Get());
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+FMarkdownSearchIndex::FMarkdownSearchIndex() = default;
+
+FMarkdownSearchIndex::~FMarkdownSearchIndex()
+{
+	Close();
+}
+
+FString FMarkdownSearchIndex::GetDefaultPath()
+{
+	return FPaths::ProjectContentDir() / TEXT("MarkdownAsset") / TEXT("Documentation.mdindex");
+}
+
+bool FMarkdownSearchIndex::Write(const FString& FilePath, const TArray<FDocument>& Documents)
+{
+	using namespace MarkdownSearchIndex;
+
+	struct FPosting
+	{
+		int32 Document;
+		int32 Frequency;
+	};
+
+	TArray<const FDocument*> Sorted;
+	for (const FDocument& Document : Documents)
+	{
+		Sorted.Add(&Document);
+	}
+
+	Sorted.Sort([](const FDocument& A, const FDocument& B) { return A.Path.ToString() < B.Path.ToString(); });
+
+	TMap<FString, TArray<FPosting>> Postings;
+	TArray<uint8> Strings;
+	TArray<FDocumentRecord> DocumentRecords;
+	uint64 TotalLength = 0;
+
+	for (int32 DocumentIndex = 0; DocumentIndex < Sorted.Num(); ++DocumentIndex)
+	{
+		const FDocument& Document = *Sorted[DocumentIndex];
+
+		TMap<FString, int32> Frequencies;
+		int32 Length = 0;
+
+		ForEachTerm(Document.Title, [&Frequencies, &Length](FStringView Term)
+		{
+			Frequencies.FindOrAdd(FString(Term)) += TitleWeight;
+			Length += TitleWeight;
+		});
+
+		ForEachTerm(Document.Text, [&Frequencies, &Length](FStringView Term)
+		{
+			++Frequencies.FindOrAdd(FString(Term));
+			++Length;
+		});
+
+		for (const TPair<FString, int32>& Frequency : Frequencies)
+		{
+			Postings.FindOrAdd(Frequency.Key).Add({ DocumentIndex, Frequency.Value });
+		}
+
+		FDocumentRecord& Record = DocumentRecords.AddZeroed_GetRef();
+		Record.Path = AppendString(Strings, Document.Path.ToString(), Record.PathLen);
+		Record.Title = AppendString(Strings, Document.Title, Record.TitleLen);
+		Record.Length = Length;
+
+		TotalLength += Length;
+	}
+
+	// encode the terms and sort them by their bytes, the order the query binary searches in
+
+	struct FTerm
+	{
+		uint8 Utf8[MaxTermLen * 4];
+		int32 Len;
+		const TArray<FPosting>* Postings;
+	};
+
+	TArray<FTerm> Terms;
+	Terms.Reserve(Postings.Num());
+
+	for (const TPair<FString, TArray<FPosting>>& Term : Postings)
+	{
+		FTerm& Encoded = Terms.AddUninitialized_GetRef();
+		Encoded.Len = EncodeTerm(Term.Key, Encoded.Utf8);
+		Encoded.Postings = &Term.Value;
+	}
+
+	Terms.Sort([](const FTerm& A, const FTerm& B) { return CompareBytes(A.Utf8, A.Len, B.Utf8, B.Len) < 0; });
+
+	TArray<FTermRecord> TermRecords;
+	TArray<uint8> PostingData;
+	TermRecords.Reserve(Terms.Num());
+
+	for (const FTerm& Term : Terms)
+	{
+		FTermRecord& Record = TermRecords.AddZeroed_GetRef();
+		Record.Term = Strings.Num();
+		Record.TermLen = Term.Len;
+		Record.Postings = PostingData.Num();
+		Record.NumPostings = Term.Postings->Num();
+
+		Strings.Append(Term.Utf8, Term.Len);
+
+		// postings are in document order, so only the gaps are stored
+		int32 Previous = 0;
+		for (const FPosting& Posting : *Term.Postings)
+		{
+			WriteVarint(PostingData, Posting.Document - Previous);
+			WriteVarint(PostingData, Posting.Frequency);
+			Previous = Posting.Document;
+		}
+	}
+
+	FHeader Header = {};
+	Header.Magic = Magic;
+	Header.Version = Version;
+	Header.NumDocuments = DocumentRecords.Num();
+	Header.NumTerms = TermRecords.Num();
+	Header.AverageLength = DocumentRecords.IsEmpty() ? 0.0f : float(double(TotalLength) / DocumentRecords.Num());
+	Header.DocumentsOffset = sizeof(FHeader);
+	Header.TermsOffset = Header.DocumentsOffset + DocumentRecords.Num() * sizeof(FDocumentRecord);
+	Header.StringsOffset = Header.TermsOffset + TermRecords.Num() * sizeof(FTermRecord);
+	Header.PostingsOffset = Header.StringsOffset + Strings.Num();
+	Header.FileSize = Header.PostingsOffset + PostingData.Num();
+
+	TArray<uint8> File;
+	File.Reserve(Header.FileSize);
+
+	AppendRecord(File, Header);
+
+	for (const FDocumentRecord& Record : DocumentRecords)
+	{
+		AppendRecord(File, Record);
+	}
+
+	for (const FTermRecord& Record : TermRecords)
+	{
+		AppendRecord(File, Record);
+	}
+
+	File.Append(Strings);
+	File.Append(PostingData);
+
+	return FFileHelper::SaveArrayToFile(File, *FilePath);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool FMarkdownSearchIndex::Open(const FString& FilePath)
+{
+	Close();
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+
+	MappedFile.Reset(PlatformFile.OpenMapped(*FilePath));
+	if (MappedFile)
+	{
+		MappedRegion.Reset(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+	}
+
+	if (MappedRegion)
+	{
+		Data = TArrayView<const uint8>(MappedRegion->GetMappedPtr(), int32(MappedRegion->GetMappedSize()));
+	}
+	else if (FFileHelper::LoadFileToArray(Buffer, *FilePath, FILEREAD_Silent))
+	{
+		Data = Buffer;
+	}
+
+	if (!Validate())
+	{
+		Close();
+		return false;
+	}
+
+	// sized once, so searching never allocates
+	Scores.SetNumZeroed(GetNumDocuments());
+	Touched.Reserve(GetNumDocuments());
+
+	return true;
+}
+
+void FMarkdownSearchIndex::Close()
+{
+	Data = TArrayView<const uint8>();
+	MappedRegion.Reset();
+	MappedFile.Reset();
+	Buffer.Empty();
+	Scores.Empty();
+	Touched.Empty();
+}
+
+int32 FMarkdownSearchIndex::GetNumDocuments() const
+{
+	return IsOpen() ? MarkdownSearchIndex::GetHeader(Data).NumDocuments : 0;
+}
+
+bool FMarkdownSearchIndex::Validate() const
+{
+	using namespace MarkdownSearchIndex;
+
+	if (Data.Num() < int32(sizeof(FHeader)))
+	{
+		return false;
+	}
+
+	const FHeader& Header = GetHeader(Data);
+
+	if (Header.Magic != Magic || Header.Version != Version || Header.FileSize != uint64(Data.Num()))
+	{
+		return false;
+	}
+
+	// the records are read in place, check everything they point at is inside the file once rather than per query
+	if (Header.DocumentsOffset != sizeof(FHeader)
+		|| uint64(Header.TermsOffset) != Header.DocumentsOffset + uint64(Header.NumDocuments) * sizeof(FDocumentRecord)
+		|| uint64(Header.StringsOffset) != Header.TermsOffset + uint64(Header.NumTerms) * sizeof(FTermRecord)
+		|| Header.PostingsOffset < Header.StringsOffset
+		|| Header.PostingsOffset > Header.FileSize)
+	{
+		return false;
+	}
+
+	const uint64 StringsSize = Header.PostingsOffset - Header.StringsOffset;
+	const uint64 PostingsSize = Header.FileSize - Header.PostingsOffset;
+
+	const FDocumentRecord* Documents = GetDocuments(Data);
+	for (uint32 Index = 0; Index < Header.NumDocuments; ++Index)
+	{
+		if (uint64(Documents[Index].Path) + Documents[Index].PathLen > StringsSize || uint64(Documents[Index].Title) + Documents[Index].TitleLen > StringsSize)
+		{
+			return false;
+		}
+	}
+
+	const FTermRecord* Terms = GetTerms(Data);
+	for (uint32 Index = 0; Index < Header.NumTerms; ++Index)
+	{
+		if (uint64(Terms[Index].Term) + Terms[Index].TermLen > StringsSize || Terms[Index].Postings > PostingsSize)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+int32 FMarkdownSearchIndex::Search(FStringView Query, TArrayView<FMarkdownSearchHit> OutHits) const
+{
+	if (!IsOpen() || OutHits.IsEmpty())
+	{
+		return 0;
+	}
+
+	MarkdownSearchIndex::ForEachTerm(Query, [this](FStringView Term) { ScoreTerm(Term); });
+
+	// keep the best hits in order, the list is short so an insertion sort beats anything cleverer
+	int32 NumHits = 0;
+
+	for (const int32 Document : Touched)
+	{
+		const float Score = Scores[Document];
+		Scores[Document] = 0.0f;
+
+		if (NumHits == OutHits.Num() && Score <= OutHits[NumHits - 1].Score)
+		{
+			continue;
+		}
+
+		int32 Slot = FMath::Min(NumHits, OutHits.Num() - 1);
+		while (Slot > 0 && OutHits[Slot - 1].Score < Score)
+		{
+			OutHits[Slot] = OutHits[Slot - 1];
+			--Slot;
+		}
+
+		OutHits[Slot].Document = Document;
+		OutHits[Slot].Score = Score;
+
+		NumHits = FMath::Min(NumHits + 1, OutHits.Num());
+	}
+
+	Touched.Reset();
+	ScoredTerms.Reset();
+
+	return NumHits;
+}
+
+void FMarkdownSearchIndex::ScoreTerm(FStringView Term) const
+{
+	using namespace MarkdownSearchIndex;
+
+	uint8 Utf8[MaxTermLen * 4];
+	const int32 Len = EncodeTerm(Term, Utf8);
+
+	const FHeader& Header = GetHeader(Data);
+	const FTermRecord* Terms = GetTerms(Data);
+	const uint8* Strings = Data.GetData() + Header.StringsOffset;
+
+	int32 First = 0;
+	int32 Count = Header.NumTerms;
+
+	while (Count > 0)
+	{
+		const int32 Step = Count / 2;
+		const FTermRecord& Record = Terms[First + Step];
+
+		if (CompareBytes(Strings + Record.Term, Record.TermLen, Utf8, Len) < 0)
+		{
+			First += Step + 1;
+			Count -= Step + 1;
+		}
+		else
+		{
+			Count = Step;
+		}
+	}
+
+	if (First >= int32(Header.NumTerms) || CompareBytes(Strings + Terms[First].Term, Terms[First].TermLen, Utf8, Len) != 0)
+	{
+		return;
+	}
+
+	// BM25 scores the set of query terms, "light light" must not rank twice as high as "light"
+	if (ScoredTerms.Contains(First))
+	{
+		return;
+	}
+
+	ScoredTerms.Add(First);
+
+	const FTermRecord& Record = Terms[First];
+	const FDocumentRecord* Documents = GetDocuments(Data);
+
+	const float NumDocuments = float(Header.NumDocuments);
+	const float DocumentFrequency = float(Record.NumPostings);
+	const float Idf = FMath::Loge(1.0f + (NumDocuments - DocumentFrequency + 0.5f) / (DocumentFrequency + 0.5f));
+	const float AverageLength = FMath::Max(Header.AverageLength, 1.0f);
+
+	const uint8* Cursor = Data.GetData() + Header.PostingsOffset + Record.Postings;
+	const uint8* End = Data.GetData() + Header.FileSize;
+
+	uint32 Document = 0;
+
+	for (uint32 Index = 0; Index < Record.NumPostings; ++Index)
+	{
+		uint32 Delta = 0;
+		uint32 Frequency = 0;
+
+		if (!ReadVarint(Cursor, End, Delta) || !ReadVarint(Cursor, End, Frequency))
+		{
+			break;
+		}
+
+		Document += Delta;
+		if (Document >= Header.NumDocuments)
+		{
+			break;
+		}
+
+		const float Tf = float(Frequency);
+		const float Norm = K1 * (1.0f - B + B * float(Documents[Document].Length) / AverageLength);
+
+		if (Scores[Document] == 0.0f)
+		{
+			Touched.Add(int32(Document));
+		}
+
+		Scores[Document] += Idf * Tf * (K1 + 1.0f) / (Tf + Norm);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+FSoftObjectPath FMarkdownSearchIndex::GetDocumentPath(int32 Document) const
+{
+	if (Document < 0 || Document >= GetNumDocuments())
+	{
+		return FSoftObjectPath();
+	}
+
+	const MarkdownSearchIndex::FDocumentRecord& Record = MarkdownSearchIndex::GetDocuments(Data)[Document];
+	return FSoftObjectPath(MarkdownSearchIndex::GetString(Data, Record.Path, Record.PathLen));
+}
+
+FString FMarkdownSearchIndex::GetDocumentTitle(int32 Document) const
+{
+	if (Document < 0 || Document >= GetNumDocuments())
+	{
+		return FString();
+	}
+
+	const MarkdownSearchIndex::FDocumentRecord& Record = MarkdownSearchIndex::GetDocuments(Data)[Document];
+	return MarkdownSearchIndex::GetString(Data, Record.Title, Record.TitleLen);
+}
@@ -0,0 +1,71 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "MarkdownSearchSubsystem.h"
+
+#include "MarkdownArchive.h"
+#include "Misc/PackageName.h"
+
+void UMarkdownSearchSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Index.Open(FMarkdownSearchIndex::GetDefaultPath());
+
+	const FMarkdownArchive* Archive = FMarkdownArchive::GetDefault();
+
+	Shipped.Init(false, Index.GetNumDocuments());
+	NumNotShipped = 0;
+
+	for (int32 Document = 0; Document < Index.GetNumDocuments(); ++Document)
+	{
+		const FSoftObjectPath Path = Index.GetDocumentPath(Document);
+
+		Shipped[Document] = (Archive && Archive->Contains(Path)) || FPackageName::DoesPackageExist(Path.GetLongPackageName());
+		NumNotShipped += Shipped[Document] ? 0 : 1;
+	}
+}
+
+void UMarkdownSearchSubsystem::Deinitialize()
+{
+	Index.Close();
+	Shipped.Empty();
+
+	Super::Deinitialize();
+}
+
+TArray<FMarkdownSearchResult> UMarkdownSearchSubsystem::Search(const FString& Query, int32 MaxResults) const
+{
+	TArray<FMarkdownSearchResult> Results;
+
+	if (MaxResults <= 0 || !Index.IsOpen())
+	{
+		return Results;
+	}
+
+	// enough hits that MaxResults are left after dropping the documents that did not ship
+	TArray<FMarkdownSearchHit, TInlineAllocator<32>> Hits;
+	Hits.SetNum(FMath::Min(MaxResults + NumNotShipped, FMath::Max(Index.GetNumDocuments(), 1)));
+	Hits.SetNum(Index.Search(Query, Hits));
+
+	Results.Reserve(FMath::Min(Hits.Num(), MaxResults));
+
+	for (const FMarkdownSearchHit& Hit : Hits)
+	{
+		if (!IsShipped(Hit.Document))
+		{
+			continue;
+		}
+
+		if (Results.Num() == MaxResults)
+		{
+			break;
+		}
+
+		FMarkdownSearchResult& Result = Results.AddDefaulted_GetRef();
+		Result.Document = Index.GetDocumentPath(Hit.Document);
+		Result.Title = Index.GetDocumentTitle(Hit.Document);
+		Result.Score = Hit.Score;
+	}
+
+	return Results;
+}
@@ -0,0 +1,1228 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "MarkdownSyntaxTree.h"
+
+#include "Misc/Char.h"
+
+namespace MarkdownSyntaxTree
+{
+	/** Emphasis nested deeper than this is left as text, so hostile input cannot run the parser out of stack. */
+	static constexpr int32 MaxInlineDepth = 32;
+
+	struct FLine
+	{
+		int32 Start = 0;
+
+		/** Excludes the line break. */
+		int32 End = 0;
+
+		/** Columns of leading whitespace, tabs stop every four columns. */
+		int32 Indent = 0;
+
+		/** The first character that is not whitespace, End for blank lines. */
+		int32 ContentStart = 0;
+
+		bool IsBlank() const { return ContentStart == End; }
+	};
+
+	static bool IsRule(FStringView Line)
+	{
+		int32 Count = 0;
+
+		for (const TCHAR Char : Line)
+		{
+			if (Char == Line[0])
+			{
+				++Count;
+			}
+			else if (!FChar::IsWhitespace(Char))
+			{
+				return false;
+			}
+		}
+
+		return Count >= 3 && (Line[0] == TEXT('-') || Line[0] == TEXT('*') || Line[0] == TEXT('_'));
+	}
+
+	/** Returns the length of a list marker ("- ", "* ", "+ ", "1. ", "1) "), or 0. */
+	static int32 GetListMarkerLen(FStringView Line)
+	{
+		if (!Line.IsEmpty() && (Line[0] == TEXT('-') || Line[0] == TEXT('*') || Line[0] == TEXT('+')) && (Line.Len() == 1 || Line[1] == TEXT(' ') || Line[1] == TEXT('\t')))
+		{
+			return 1;
+		}
+
+		int32 Digits = 0;
+		while (Digits < Line.Len() && Digits < 9 && FChar::IsDigit(Line[Digits]))
+		{
+			++Digits;
+		}
+
+		if (Digits == 0 || Digits == Line.Len() || (Line[Digits] != TEXT('.') && Line[Digits] != TEXT(')')))
+		{
+			return 0;
+		}
+
+		return Digits + 1 == Line.Len() || Line[Digits + 1] == TEXT(' ') || Line[Digits + 1] == TEXT('\t') ? Digits + 1 : 0;
+	}
+
+	/** A run of '=' or '-' under a paragraph, turning it into a heading. */
+	static int32 GetUnderlineLevel(FStringView Line)
+	{
+		const FStringView Trimmed = Line.TrimEnd();
+
+		for (const TCHAR Char : Trimmed)
+		{
+			if (Char != Trimmed[0])
+			{
+				return 0;
+			}
+		}
+
+		return Trimmed[0] == TEXT('=') ? 1 : Trimmed[0] == TEXT('-') ? 2 : 0;
+	}
+
+	/** The row under a table header, "| --- | :-: |". */
+	static bool IsDelimiterRow(FStringView Line)
+	{
+		bool bDash = false;
+
+		for (const TCHAR Char : Line)
+		{
+			if (Char == TEXT('-'))
+			{
+				bDash = true;
+			}
+			else if (Char != TEXT('|') && Char != TEXT(':') && !FChar::IsWhitespace(Char))
+			{
+				return false;
+			}
+		}
+
+		// "---" alone underlines a heading
+		return bDash && Line.Contains(TEXT("|"));
+	}
+
+	static bool IsAsciiPunct(TCHAR Char)
+	{
+		return Char < 128 && FChar::IsPunct(Char);
+	}
+
+	class FParser
+	{
+	public:
+
+		FParser(const FString& InText, TArray<FMarkdownNode>& InNodes)
+			: Text(InText)
+			, Nodes(InNodes)
+		{
+			SplitLines();
+		}
+
+		void Parse()
+		{
+			AddNode(EMarkdownNodeType::Document, 0, 1);
+
+			for (int32 Index = 0; Index < Lines.Num(); ++Index)
+			{
+				Index = ParseLine(Index);
+			}
+
+			CloseLists(0);
+			CloseNode(0, Text.Len());
+		}
+
+	private:
+
+		struct FOpenList
+		{
+			int32 List = INDEX_NONE;
+			int32 Item = INDEX_NONE;
+			int32 MarkerIndent = 0;
+			int32 ContentIndent = 0;
+			TCHAR Marker = 0;
+		};
+
+		void SplitLines()
+		{
+			Lines.Reserve(Text.Len() / 32 + 1);
+
+			// a line break ends the line before it, it does not start an empty one
+			int32 Start = 0;
+			while (Start < Text.Len())
+			{
+				FLine& Line = Lines.AddDefaulted_GetRef();
+				Line.Start = Start;
+
+				int32 End = Start;
+				while (End < Text.Len() && Text[End] != TEXT('\n'))
+				{
+					++End;
+				}
+
+				Start = End + 1;
+				Line.End = End > Line.Start && Text[End - 1] == TEXT('\r') ? End - 1 : End;
+
+				int32 Pos = Line.Start;
+				for (; Pos < Line.End && (Text[Pos] == TEXT(' ') || Text[Pos] == TEXT('\t')); ++Pos)
+				{
+					Line.Indent = Text[Pos] == TEXT('\t') ? Line.Indent + 4 - Line.Indent % 4 : Line.Indent + 1;
+				}
+
+				Line.ContentStart = Pos;
+			}
+		}
+
+		FStringView GetContent(const FLine& Line) const
+		{
+			return FStringView(Text).Mid(Line.ContentStart, Line.End - Line.ContentStart);
+		}
+
+		int32 AddNode(EMarkdownNodeType Type, int32 Start, int32 Line)
+		{
+			const int32 Index = Nodes.Num();
+
+			FMarkdownNode& Node = Nodes.AddDefaulted_GetRef();
+			Node.Type = Type;
+			Node.Start = Start;
+			Node.Line = Line;
+
+			return Index;
+		}
+
+		int32 AddLeaf(EMarkdownNodeType Type, int32 Start, int32 End, int32 Line)
+		{
+			const int32 Index = AddNode(Type, Start, Line);
+			Nodes[Index].Len = End - Start;
+			return Index;
+		}
+
+		void CloseNode(int32 Index, int32 End)
+		{
+			FMarkdownNode& Node = Nodes[Index];
+			Node.NumDescendants = Nodes.Num() - Index - 1;
+			Node.Len = End - Node.Start;
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// blocks
+
+		/** Parses the pending text of the open paragraph or list item, which has to happen before any child block. */
+		void FlushInline()
+		{
+			if (InlineOwner != INDEX_NONE)
+			{
+				ParseInline(InlineStart, InlineEnd, Nodes[InlineOwner].Line, bInlineQuote, 0);
+				InlineOwner = INDEX_NONE;
+			}
+		}
+
+		void CloseParagraph()
+		{
+			FlushInline();
+
+			if (OpenParagraph != INDEX_NONE)
+			{
+				CloseNode(OpenParagraph, ParagraphEnd);
+				OpenParagraph = INDEX_NONE;
+			}
+		}
+
+		void CloseQuote()
+		{
+			CloseParagraph();
+
+			if (OpenQuote != INDEX_NONE)
+			{
+				CloseNode(OpenQuote, ContentEnd);
+				OpenQuote = INDEX_NONE;
+			}
+		}
+
+		void CloseTopList()
+		{
+			const FOpenList Top = Lists.Pop();
+			CloseNode(Top.Item, ContentEnd);
+			CloseNode(Top.List, ContentEnd);
+		}
+
+		void CloseLists(int32 Keep)
+		{
+			CloseQuote();
+
+			while (Lists.Num() > Keep)
+			{
+				CloseTopList();
+			}
+		}
+
+		/** Closes the open blocks before a new block, leaving the list items it is indented under open. */
+		void BeginBlock(const FLine& Line)
+		{
+			CloseQuote();
+
+			while (!Lists.IsEmpty() && Line.Indent < Lists.Last().ContentIndent)
+			{
+				CloseTopList();
+			}
+		}
+
+		void StartParagraph(int32 Start, int32 End, int32 Line, bool bQuote)
+		{
+			OpenParagraph = AddNode(EMarkdownNodeType::Paragraph, Start, Line);
+			ParagraphEnd = End;
+			StartInline(OpenParagraph, Start, End, bQuote);
+		}
+
+		void StartInline(int32 Owner, int32 Start, int32 End, bool bQuote)
+		{
+			InlineOwner = Owner;
+			InlineStart = Start;
+			InlineEnd = End;
+			bInlineQuote = bQuote;
+		}
+
+		void ExtendInline(int32 End)
+		{
+			InlineEnd = End;
+			ParagraphEnd = End;
+		}
+
+		/** Parses the block starting at the line, returning the last line it took. */
+		int32 ParseLine(int32 Index)
+		{
+			const FLine& Line = Lines[Index];
+			const FStringView Content = GetContent(Line);
+			const int32 LineNumber = Index + 1;
+
+			if (Line.IsBlank())
+			{
+				CloseQuote();
+				return Index;
+			}
+
+			const int32 LastLine = ParseBlock(Index, Line, Content, LineNumber);
+			ContentEnd = FMath::Max(ContentEnd, Lines[LastLine].End);
+			return LastLine;
+		}
+
+		int32 ParseBlock(int32 Index, const FLine& Line, FStringView Content, int32 LineNumber)
+		{
+			const bool bPending = InlineOwner != INDEX_NONE;
+
+			// code indented by four spaces, which cannot interrupt a paragraph
+			if (Line.Indent >= 4 && !bPending && Lists.IsEmpty() && OpenQuote == INDEX_NONE)
+			{
+				return ParseIndentedCode(Index);
+			}
+
+			if (Content[0] == TEXT('`') || Content[0] == TEXT('~'))
+			{
+				const int32 LastLine = ParseFence(Index);
+				if (LastLine != INDEX_NONE)
+				{
+					return LastLine;
+				}
+			}
+
+			if (Content[0] == TEXT('#') && ParseHeading(Line, Content, LineNumber))
+			{
+				return Index;
+			}
+
+			if (OpenParagraph != INDEX_NONE && InlineOwner == OpenParagraph && OpenQuote == INDEX_NONE)
+			{
+				if (const int32 Level = GetUnderlineLevel(Content))
+				{
+					FMarkdownNode& Heading = Nodes[OpenParagraph];
+					const FStringView Title = FStringView(Text).Mid(InlineStart, InlineEnd - InlineStart).TrimEnd();
+
+					Heading.Type = EMarkdownNodeType::Heading;
+					Heading.Flags |= EMarkdownNodeFlags::Underlined;
+					Heading.Level = uint8(Level);
+					Heading.ArgStart = InlineStart;
+					Heading.ArgLen = Title.Len();
+
+					ParagraphEnd = Line.End;
+					CloseParagraph();
+					return Index;
+				}
+			}
+
+			if (IsRule(Content))
+			{
+				CloseParagraph();
+				BeginBlock(Line);
+				AddLeaf(EMarkdownNodeType::Rule, Line.ContentStart, Line.End, LineNumber);
+				return Index;
+			}
+
+			if (const int32 MarkerLen = GetListMarkerLen(Content))
+			{
+				ParseListItem(Line, Content, MarkerLen, LineNumber);
+				return Index;
+			}
+
+			if (Content[0] == TEXT('>'))
+			{
+				ParseQuote(Line, LineNumber);
+				return Index;
+			}
+
+			if (Index + 1 < Lines.Num() && Content.Contains(TEXT("|")) && IsDelimiterRow(GetContent(Lines[Index + 1])))
+			{
+				return ParseTable(Index);
+			}
+
+			// lines of text continue the open paragraph, even without the indentation or quote marker
+			if (bPending)
+			{
+				ExtendInline(Line.End);
+				return Index;
+			}
+
+			CloseParagraph();
+			BeginBlock(Line);
+			StartParagraph(Line.ContentStart, Line.End, LineNumber, false);
+			return Index;
+		}
+
+		bool ParseHeading(const FLine& Line, FStringView Content, int32 LineNumber)
+		{
+			int32 Level = 0;
+			while (Level < Content.Len() && Content[Level] == TEXT('#'))
+			{
+				++Level;
+			}
+
+			if (Level > 6 || (Level < Content.Len() && !FChar::IsWhitespace(Content[Level])))
+			{
+				return false;
+			}
+
+			FStringView Title = Content.RightChop(Level).TrimStartAndEnd();
+
+			// optional closing sequence ("## Title ##"), which has to be separated by whitespace
+			int32 ClosingStart = Title.Len();
+			while (ClosingStart > 0 && Title[ClosingStart - 1] == TEXT('#'))
+			{
+				--ClosingStart;
+			}
+
+			if (ClosingStart == 0 || (ClosingStart < Title.Len() && FChar::IsWhitespace(Title[ClosingStart - 1])))
+			{
+				Title = Title.Left(ClosingStart).TrimEnd();
+			}
+
+			CloseParagraph();
+			BeginBlock(Line);
+
+			const int32 Heading = AddNode(EMarkdownNodeType::Heading, Line.ContentStart, LineNumber);
+			const int32 TitleStart = Title.IsEmpty() ? Line.End : int32(Title.GetData() - *Text);
+
+			Nodes[Heading].Level = uint8(Level);
+			Nodes[Heading].ArgStart = TitleStart;
+			Nodes[Heading].ArgLen = Title.Len();
+
+			ParseInline(TitleStart, TitleStart + Title.Len(), LineNumber, false, 0);
+			CloseNode(Heading, Line.End);
+			return true;
+		}
+
+		/** Returns INDEX_NONE if the line is not an opening fence. */
+		int32 ParseFence(int32 Index)
+		{
+			const FLine& Open = Lines[Index];
+			const FStringView Content = GetContent(Open);
+			const TCHAR Marker = Content[0];
+
+			int32 MarkerLen = 0;
+			while (MarkerLen < Content.Len() && Content[MarkerLen] == Marker)
+			{
+				++MarkerLen;
+			}
+
+			const FStringView Info = Content.RightChop(MarkerLen).TrimStartAndEnd();
+
+			// "```code``` text" is a code span
+			if (MarkerLen < 3 || (Marker == TEXT('`') && Info.Contains(TEXT("`"))))
+			{
+				return INDEX_NONE;
+			}
+
+			CloseParagraph();
+			BeginBlock(Open);
+
+			const int32 Block = AddNode(EMarkdownNodeType::CodeBlock, Open.ContentStart, Index + 1);
+			Nodes[Block].ArgStart = Info.IsEmpty() ? Open.End : int32(Info.GetData() - *Text);
+			Nodes[Block].ArgLen = Info.Len();
+
+			// the content is unindented by as much as the fence is
+			const int32 FenceIndent = Open.Indent - (Lists.IsEmpty() ? 0 : Lists.Last().ContentIndent);
+
+			int32 Close = Index + 1;
+			for (; Close < Lines.Num(); ++Close)
+			{
+				const FLine& Line = Lines[Close];
+				const FStringView Closing = GetContent(Line);
+
+				int32 ClosingLen = 0;
+				while (ClosingLen < Closing.Len() && Closing[ClosingLen] == Marker)
+				{
+					++ClosingLen;
+				}
+
+				if (ClosingLen >= MarkerLen && Closing.RightChop(ClosingLen).TrimStartAndEnd().IsEmpty())
+				{
+					break;
+				}
+
+				AddCodeLine(Line, FMath::Max(FenceIndent, 0), Close > Index + 1, Close + 1);
+			}
+
+			if (Close == Lines.Num())
+			{
+				Nodes[Block].Flags |= EMarkdownNodeFlags::Unclosed;
+				CloseNode(Block, Text.Len());
+				return Lines.Num() - 1;
+			}
+
+			CloseNode(Block, Lines[Close].End);
+			return Close;
+		}
+
+		int32 ParseIndentedCode(int32 Index)
+		{
+			CloseParagraph();
+			BeginBlock(Lines[Index]);
+
+			int32 Last = Index;
+			for (int32 Next = Index + 1; Next < Lines.Num() && (Lines[Next].IsBlank() || Lines[Next].Indent >= 4); ++Next)
+			{
+				Last = Lines[Next].IsBlank() ? Last : Next;
+			}
+
+			const int32 Block = AddNode(EMarkdownNodeType::CodeBlock, Lines[Index].Start, Index + 1);
+			Nodes[Block].Flags |= EMarkdownNodeFlags::Indented;
+
+			for (int32 Line = Index; Line <= Last; ++Line)
+			{
+				AddCodeLine(Lines[Line], 4, Line > Index, Line + 1);
+			}
+
+			CloseNode(Block, Lines[Last].End);
+			return Last;
+		}
+
+		void AddCodeLine(const FLine& Line, int32 Unindent, bool bBreak, int32 LineNumber)
+		{
+			if (bBreak)
+			{
+				AddBreak(Line.Start - 1, true, LineNumber);
+			}
+
+			int32 Start = Line.Start;
+			for (int32 Column = 0; Start < Line.End && Column < Unindent && (Text[Start] == TEXT(' ') || Text[Start] == TEXT('\t')); ++Start)
+			{
+				Column = Text[Start] == TEXT('\t') ? Column + 4 - Column % 4 : Column + 1;
+			}
+
+			if (Line.End > Start)
+			{
+				AddLeaf(EMarkdownNodeType::Text, Start, Line.End, LineNumber);
+			}
+		}
+
+		void ParseListItem(const FLine& Line, FStringView Content, int32 MarkerLen, int32 LineNumber)
+		{
+			CloseParagraph();
+			CloseQuote();
+
+			while (!Lists.IsEmpty() && Line.Indent < Lists.Last().MarkerIndent)
+			{
+				CloseTopList();
+			}
+
+			const TCHAR Marker = Content[MarkerLen - 1];
+			const bool bOrdered = FChar::IsDigit(Content[0]);
+
+			// up to four spaces between the marker and the text, more than that and the text is indented code
+			int32 Spaces = 0;
+			while (MarkerLen + Spaces < Content.Len() && Content[MarkerLen + Spaces] == TEXT(' '))
+			{
+				++Spaces;
+			}
+
+			const bool bBlankItem = MarkerLen + Spaces == Content.Len();
+			Spaces = bBlankItem || Spaces > 4 ? 1 : Spaces;
+
+			if (!Lists.IsEmpty() && Line.Indent < Lists.Last().ContentIndent)
+			{
+				if (Lists.Last().Marker == Marker)
+				{
+					FOpenList& Sibling = Lists.Last();
+					CloseNode(Sibling.Item, ContentEnd);
+
+					Sibling.Item = AddNode(EMarkdownNodeType::ListItem, Line.ContentStart, LineNumber);
+					Sibling.MarkerIndent = Line.Indent;
+					Sibling.ContentIndent = Line.Indent + MarkerLen + Spaces;
+
+					StartItemText(Sibling.Item, Line, MarkerLen + Spaces, bBlankItem);
+					return;
+				}
+
+				// a different marker starts a new list
+				CloseTopList();
+			}
+
+			FOpenList& Open = Lists.AddDefaulted_GetRef();
+			Open.List = AddNode(EMarkdownNodeType::List, Line.ContentStart, LineNumber);
+			Open.MarkerIndent = Line.Indent;
+			Open.ContentIndent = Line.Indent + MarkerLen + Spaces;
+			Open.Marker = Marker;
+
+			FMarkdownNode& List = Nodes[Open.List];
+			List.Level = uint8(FMath::Min(Lists.Num(), 255));
+
+			if (bOrdered)
+			{
+				List.Flags |= EMarkdownNodeFlags::Ordered;
+				List.ArgStart = Line.ContentStart;
+				List.ArgLen = MarkerLen - 1;
+			}
+
+			Open.Item = AddNode(EMarkdownNodeType::ListItem, Line.ContentStart, LineNumber);
+			StartItemText(Open.Item, Line, MarkerLen + Spaces, bBlankItem);
+		}
+
+		void StartItemText(int32 Item, const FLine& Line, int32 TextOffset, bool bBlankItem)
+		{
+			if (!bBlankItem)
+			{
+				StartInline(Item, Line.ContentStart + TextOffset, Line.End, false);
+			}
+		}
+
+		void ParseQuote(const FLine& Line, int32 LineNumber)
+		{
+			int32 Start = Line.ContentStart + 1;
+			Start += Start < Line.End && Text[Start] == TEXT(' ') ? 1 : 0;
+
+			if (OpenQuote == INDEX_NONE)
+			{
+				CloseParagraph();
+				BeginBlock(Line);
+				OpenQuote = AddNode(EMarkdownNodeType::Quote, Line.ContentStart, LineNumber);
+			}
+
+			if (FStringView(Text).Mid(Start, Line.End - Start).TrimStart().IsEmpty())
+			{
+				CloseParagraph();
+			}
+			else if (InlineOwner != INDEX_NONE && bInlineQuote)
+			{
+				ExtendInline(Line.End);
+			}
+			else
+			{
+				CloseParagraph();
+				StartParagraph(Start, Line.End, LineNumber, true);
+			}
+		}
+
+		int32 ParseTable(int32 Index)
+		{
+			CloseParagraph();
+			BeginBlock(Lines[Index]);
+
+			// the delimiter row gives the columns and their alignment, it is not a row itself
+			TArray<EMarkdownNodeFlags, TInlineAllocator<16>> Alignments;
+
+			const FLine& Delimiter = Lines[Index + 1];
+			ForEachCell(Delimiter, [this, &Alignments](int32 Start, int32 End)
+			{
+				const FStringView Cell = FStringView(Text).Mid(Start, End - Start);
+
+				EMarkdownNodeFlags Alignment = EMarkdownNodeFlags::None;
+				Alignment |= Cell.StartsWith(TEXT(':')) ? EMarkdownNodeFlags::AlignLeft : EMarkdownNodeFlags::None;
+				Alignment |= Cell.EndsWith(TEXT(':')) ? EMarkdownNodeFlags::AlignRight : EMarkdownNodeFlags::None;
+				Alignments.Add(Alignment);
+			});
+
+			const int32 Table = AddNode(EMarkdownNodeType::Table, Lines[Index].ContentStart, Index + 1);
+			Nodes[Table].Level = uint8(FMath::Min(Alignments.Num(), 255));
+
+			AddTableRow(Index, Alignments, EMarkdownNodeFlags::Header);
+
+			int32 Last = Index + 1;
+			while (Last + 1 < Lines.Num() && !Lines[Last + 1].IsBlank() && GetContent(Lines[Last + 1]).Contains(TEXT("|")))
+			{
+				AddTableRow(++Last, Alignments, EMarkdownNodeFlags::None);
+			}
+
+			CloseNode(Table, Lines[Last].End);
+			return Last;
+		}
+
+		void AddTableRow(int32 Index, TConstArrayView<EMarkdownNodeFlags> Alignments, EMarkdownNodeFlags Flags)
+		{
+			const FLine& Line = Lines[Index];
+
+			const int32 Row = AddNode(EMarkdownNodeType::TableRow, Line.ContentStart, Index + 1);
+			Nodes[Row].Flags = Flags;
+
+			int32 Column = 0;
+			ForEachCell(Line, [this, Alignments, Index, &Column](int32 Start, int32 End)
+			{
+				const int32 Cell = AddNode(EMarkdownNodeType::TableCell, Start, Index + 1);
+				Nodes[Cell].Flags = Alignments.IsValidIndex(Column) ? Alignments[Column] : EMarkdownNodeFlags::None;
+				++Column;
+
+				ParseInline(Start, End, Index + 1, false, 0);
+				CloseNode(Cell, End);
+			});
+
+			CloseNode(Row, Line.End);
+		}
+
+		/** Calls Visit with the trimmed text of each cell, splitting at pipes that are not escaped or in code. */
+		template <typename TVisit>
+		void ForEachCell(const FLine& Line, TVisit Visit) const
+		{
+			int32 End = Line.End;
+			while (End > Line.ContentStart && FChar::IsWhitespace(Text[End - 1]))
+			{
+				--End;
+			}
+
+			int32 Pos = Line.ContentStart;
+			Pos += Pos < End && Text[Pos] == TEXT('|') ? 1 : 0;
+
+			while (Pos < End)
+			{
+				const int32 CellStart = Pos;
+
+				for (; Pos < End && Text[Pos] != TEXT('|'); ++Pos)
+				{
+					if (Text[Pos] == TEXT('\\'))
+					{
+						++Pos;
+					}
+					else if (Text[Pos] == TEXT('`'))
+					{
+						Pos = FMath::Max(Pos, SkipCodeSpan(Pos, End) - 1);
+					}
+				}
+
+				const FStringView Cell = FStringView(Text).Mid(CellStart, FMath::Min(Pos, End) - CellStart).TrimStartAndEnd();
+				const int32 TrimmedStart = Cell.IsEmpty() ? CellStart : int32(Cell.GetData() - *Text);
+				Visit(TrimmedStart, TrimmedStart + Cell.Len());
+
+				++Pos;
+			}
+		}
+
+		//-------------------------------------------------------------------------------------------------------------
+		// inline
+
+		int32 CountRun(int32 Pos, int32 End, TCHAR Char) const
+		{
+			int32 Run = Pos;
+			while (Run < End && Text[Run] == Char)
+			{
+				++Run;
+			}
+			return Run - Pos;
+		}
+
+		int32 CountLines(int32 Start, int32 End) const
+		{
+			int32 Count = 0;
+			for (int32 Pos = Start; Pos < End; ++Pos)
+			{
+				Count += Text[Pos] == TEXT('\n') ? 1 : 0;
+			}
+			return Count;
+		}
+
+		/** Returns the position after the code span opening at Pos, or after its backticks if it is never closed. */
+		int32 SkipCodeSpan(int32 Pos, int32 End) const
+		{
+			int32 CloseStart = INDEX_NONE;
+			return FindCodeSpanClose(Pos, End, CountRun(Pos, End, TEXT('`')), CloseStart);
+		}
+
+		int32 FindCodeSpanClose(int32 Pos, int32 End, int32 RunLen, int32& OutCloseStart) const
+		{
+			for (int32 Search = Pos + RunLen; Search < End; )
+			{
+				if (Text[Search] != TEXT('`'))
+				{
+					++Search;
+					continue;
+				}
+
+				const int32 Run = CountRun(Search, End, TEXT('`'));
+				if (Run == RunLen)
+				{
+					OutCloseStart = Search;
+					return Search + Run;
+				}
+
+				Search += Run;
+			}
+
+			OutCloseStart = INDEX_NONE;
+			return Pos + RunLen;
+		}
+
+		/** Finds the closing emphasis delimiter, returning the start of the Count characters that close it. */
+		int32 FindEmphasisClose(TCHAR Char, int32 Count, int32 From, int32 End) const
+		{
+			for (int32 Pos = From; Pos < End; )
+			{
+				const TCHAR Current = Text[Pos];
+
+				if (Current == TEXT('\\'))
+				{
+					Pos += 2;
+				}
+				else if (Current == TEXT('`'))
+				{
+					Pos = SkipCodeSpan(Pos, End);
+				}
+				else if (Current == Char)
+				{
+					const int32 Run = CountRun(Pos, End, Char);
+					const bool bRunMatches = Count == 1 ? Run != 2 : Run >= 2;
+					const bool bRightFlanking = !FChar::IsWhitespace(Text[Pos - 1]);
+					const bool bWordEnd = Char != TEXT('_') || Pos + Run == End || !FChar::IsAlnum(Text[Pos + Run]);
+
+					if (bRunMatches && bRightFlanking && bWordEnd)
+					{
+						return Pos + Run - Count;
+					}
+
+					Pos += Run;
+				}
+				else
+				{
+					++Pos;
+				}
+			}
+
+			return INDEX_NONE;
+		}
+
+		/** Parses "[label](target)" or "![alt](source)" at Pos, which is the '['. */
+		bool FindLink(int32 Pos, int32 End, int32& OutLabelEnd, int32& OutTargetStart, int32& OutTargetEnd, int32& OutLinkEnd) const
+		{
+			int32 Depth = 0;
+			int32 Label = Pos + 1;
+
+			for (; Label < End; ++Label)
+			{
+				const TCHAR Char = Text[Label];
+
+				if (Char == TEXT('\\'))
+				{
+					++Label;
+				}
+				else if (Char == TEXT('`'))
+				{
+					Label = SkipCodeSpan(Label, End) - 1;
+				}
+				else if (Char == TEXT('['))
+				{
+					++Depth;
+				}
+				else if (Char == TEXT(']') && Depth-- == 0)
+				{
+					break;
+				}
+			}
+
+			if (Label + 1 >= End || Text[Label + 1] != TEXT('('))
+			{
+				return false;
+			}
+
+			int32 Target = Label + 2;
+			while (Target < End && (Text[Target] == TEXT(' ') || Text[Target] == TEXT('\t')))
+			{
+				++Target;
+			}
+
+			int32 TargetEnd = Target;
+
+			if (Target < End && Text[Target] == TEXT('<'))
+			{
+				TargetEnd = ++Target;
+				while (TargetEnd < End && Text[TargetEnd] != TEXT('>') && Text[TargetEnd] != TEXT('\n'))
+				{
+					++TargetEnd;
+				}
+
+				if (TargetEnd == End || Text[TargetEnd] != TEXT('>'))
+				{
+					return false;
+				}
+			}
+			else
+			{
+				int32 Parens = 0;
+				for (; TargetEnd < End && !FChar::IsWhitespace(Text[TargetEnd]); ++TargetEnd)
+				{
+					if (Text[TargetEnd] == TEXT('('))
+					{
+						++Parens;
+					}
+					else if (Text[TargetEnd] == TEXT(')') && Parens-- == 0)
+					{
+						break;
+					}
+				}
+			}
+
+			// an optional title, which is dropped
+			int32 Close = TargetEnd + (TargetEnd < End && Text[TargetEnd] == TEXT('>') ? 1 : 0);
+			while (Close < End && Text[Close] != TEXT(')') && Text[Close] != TEXT('\n'))
+			{
+				++Close;
+			}
+
+			if (Close == End || Text[Close] != TEXT(')'))
+			{
+				return false;
+			}
+
+			OutLabelEnd = Label;
+			OutTargetStart = Target;
+			OutTargetEnd = TargetEnd;
+			OutLinkEnd = Close + 1;
+			return true;
+		}
+
+		/** Parses "<scheme://...>" at Pos, which is the '<'. */
+		int32 FindAutolinkEnd(int32 Pos, int32 End) const
+		{
+			int32 Scheme = Pos + 1;
+			if (Scheme == End || !FChar::IsAlpha(Text[Scheme]))
+			{
+				return INDEX_NONE;
+			}
+
+			while (Scheme < End && (FChar::IsAlnum(Text[Scheme]) || Text[Scheme] == TEXT('+') || Text[Scheme] == TEXT('-') || Text[Scheme] == TEXT('.')))
+			{
+				++Scheme;
+			}
+
+			if (Scheme == End || Text[Scheme] != TEXT(':'))
+			{
+				return INDEX_NONE;
+			}
+
+			for (int32 Close = Scheme + 1; Close < End; ++Close)
+			{
+				if (Text[Close] == TEXT('>'))
+				{
+					return Close;
+				}
+
+				if (FChar::IsWhitespace(Text[Close]) || Text[Close] == TEXT('<'))
+				{
+					break;
+				}
+			}
+
+			return INDEX_NONE;
+		}
+
+		void ParseInline(int32 Start, int32 End, int32 Line, bool bQuote, int32 Depth)
+		{
+			int32 TextStart = Start;
+			int32 TextLine = Line;
+			int32 Pos = Start;
+
+			auto FlushText = [this, &TextStart, &TextLine](int32 TextEnd)
+			{
+				if (TextEnd > TextStart)
+				{
+					AddLeaf(EMarkdownNodeType::Text, TextStart, TextEnd, TextLine);
+				}
+			};
+
+			auto Resume = [&](int32 Next)
+			{
+				Line += CountLines(Pos, Next);
+				Pos = TextStart = Next;
+				TextLine = Line;
+			};
+
+			while (Pos < End)
+			{
+				const TCHAR Char = Text[Pos];
+				const TCHAR Next = Pos + 1 < End ? Text[Pos + 1] : TEXT('\0');
+
+				switch (Char)
+				{
+					case TEXT('\\'):
+					{
+						if (IsAsciiPunct(Next))
+						{
+							FlushText(Pos);
+							TextStart = Pos + 1;
+							Pos += 2;
+						}
+						else if (Next == TEXT('\n'))
+						{
+							FlushText(Pos);
+							AddBreak(Pos + 1, true, Line);
+							Resume(SkipLineStart(Pos + 2, End, bQuote));
+						}
+						else
+						{
+							++Pos;
+						}
+						break;
+					}
+
+					case TEXT('\n'):
+					{
+						int32 TextEnd = Pos;
+						int32 Spaces = 0;
+
+						while (TextEnd > TextStart && FChar::IsWhitespace(Text[TextEnd - 1]))
+						{
+							Spaces += Text[--TextEnd] == TEXT(' ') ? 1 : 0;
+						}
+
+						FlushText(TextEnd);
+						AddBreak(Pos, Spaces >= 2, Line);
+						Resume(SkipLineStart(Pos + 1, End, bQuote));
+						break;
+					}
+
+					case TEXT('`'):
+					{
+						const int32 RunLen = CountRun(Pos, End, TEXT('`'));
+
+						int32 CloseStart = INDEX_NONE;
+						const int32 SpanEnd = FindCodeSpanClose(Pos, End, RunLen, CloseStart);
+
+						if (CloseStart == INDEX_NONE)
+						{
+							Pos = SpanEnd;
+							break;
+						}
+
+						// one space each side is padding, so code can start or end with a backtick
+						int32 CodeStart = Pos + RunLen;
+						int32 CodeEnd = CloseStart;
+						if (CodeEnd - CodeStart >= 2 && Text[CodeStart] == TEXT(' ') && Text[CodeEnd - 1] == TEXT(' ') && !FStringView(Text).Mid(CodeStart, CodeEnd - CodeStart).TrimStart().IsEmpty())
+						{
+							++CodeStart;
+							--CodeEnd;
+						}
+
+						FlushText(Pos);
+						AddLeaf(EMarkdownNodeType::Code, CodeStart, CodeEnd, Line);
+						Resume(SpanEnd);
+						break;
+					}
+
+					case TEXT('!'):
+					case TEXT('['):
+					{
+						const bool bImage = Char == TEXT('!');
+						const int32 Open = bImage ? Pos + 1 : Pos;
+
+						int32 LabelEnd, TargetStart, TargetEnd, LinkEnd;
+						if ((bImage && Next != TEXT('[')) || Depth >= MaxInlineDepth || !FindLink(Open, End, LabelEnd, TargetStart, TargetEnd, LinkEnd))
+						{
+							++Pos;
+							break;
+						}
+
+						FlushText(Pos);
+
+						// images keep their alt text as their span, links their label as children
+						const int32 Link = AddNode(bImage ? EMarkdownNodeType::Image : EMarkdownNodeType::Link, bImage ? Open + 1 : Pos, Line);
+						Nodes[Link].ArgStart = TargetStart;
+						Nodes[Link].ArgLen = TargetEnd - TargetStart;
+
+						if (!bImage)
+						{
+							ParseInline(Open + 1, LabelEnd, Line, bQuote, Depth + 1);
+						}
+
+						CloseNode(Link, bImage ? LabelEnd : LinkEnd);
+
+						Resume(LinkEnd);
+						break;
+					}
+
+					case TEXT('<'):
+					{
+						const int32 Close = FindAutolinkEnd(Pos, End);
+						if (Close == INDEX_NONE)
+						{
+							++Pos;
+							break;
+						}
+
+						FlushText(Pos);
+
+						const int32 Link = AddNode(EMarkdownNodeType::Link, Pos, Line);
+						Nodes[Link].ArgStart = Pos + 1;
+						Nodes[Link].ArgLen = Close - Pos - 1;
+
+						AddLeaf(EMarkdownNodeType::Text, Pos + 1, Close, Line);
+						CloseNode(Link, Close + 1);
+						Resume(Close + 1);
+						break;
+					}
+
+					case TEXT('*'):
+					case TEXT('_'):
+					case TEXT('~'):
+					{
+						const int32 RunLen = CountRun(Pos, End, Char);
+						const int32 Count = Char == TEXT('~') ? 2 : FMath::Min(RunLen, 2);
+
+						const bool bLeftFlanking = Pos + RunLen < End && !FChar::IsWhitespace(Text[Pos + RunLen]);
+						const bool bWordStart = Char != TEXT('_') || Pos == Start || !FChar::IsAlnum(Text[Pos - 1]);
+						const bool bCanOpen = bLeftFlanking && bWordStart && Depth < MaxInlineDepth && (Char != TEXT('~') || RunLen == 2);
+
+						const int32 Close = bCanOpen ? FindEmphasisClose(Char, Count, Pos + RunLen, End) : INDEX_NONE;
+						if (Close == INDEX_NONE)
+						{
+							Pos += RunLen;
+							break;
+						}
+
+						const EMarkdownNodeType Type = Char == TEXT('~') ? EMarkdownNodeType::Strikethrough : Count == 2 ? EMarkdownNodeType::Strong : EMarkdownNodeType::Emphasis;
+
+						FlushText(Pos);
+
+						const int32 Span = AddNode(Type, Pos, Line);
+						ParseInline(Pos + Count, Close, Line, bQuote, Depth + 1);
+						CloseNode(Span, Close + Count);
+						Resume(Close + Count);
+						break;
+					}
+
+					default:
+					{
+						++Pos;
+						break;
+					}
+				}
+			}
+
+			FlushText(End);
+		}
+
+		void AddBreak(int32 Pos, bool bHard, int32 Line)
+		{
+			const int32 Break = AddLeaf(EMarkdownNodeType::Break, Pos, Pos + 1, Line);
+			Nodes[Break].Flags = bHard ? EMarkdownNodeFlags::HardBreak : EMarkdownNodeFlags::None;
+		}
+
+		/** Skips the indentation at the start of a continuation line, and its quote marker inside quotes. */
+		int32 SkipLineStart(int32 Pos, int32 End, bool bQuote) const
+		{
+			while (Pos < End && (Text[Pos] == TEXT(' ') || Text[Pos] == TEXT('\t')))
+			{
+				++Pos;
+			}
+
+			if (bQuote && Pos < End && Text[Pos] == TEXT('>'))
+			{
+				++Pos;
+				Pos += Pos < End && Text[Pos] == TEXT(' ') ? 1 : 0;
+			}
+
+			return Pos;
+		}
+
+		const FString& Text;
+		TArray<FMarkdownNode>& Nodes;
+		TArray<FLine> Lines;
+
+		TArray<FOpenList, TInlineAllocator<8>> Lists;
+		int32 OpenParagraph = INDEX_NONE;
+		int32 OpenQuote = INDEX_NONE;
+		int32 ParagraphEnd = 0;
+
+		/** End of the last line that was not blank, where open lists and quotes end. */
+		int32 ContentEnd = 0;
+
+		/** Text of the open paragraph or list item, parsed once it is complete. */
+		int32 InlineOwner = INDEX_NONE;
+		int32 InlineStart = 0;
+		int32 InlineEnd = 0;
+		bool bInlineQuote = false;
+	};
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+const TCHAR* LexToString(EMarkdownNodeType Type)
+{
+	switch (Type)
+	{
+		case EMarkdownNodeType::Document: return TEXT("document");
+		case EMarkdownNodeType::Heading: return TEXT("heading");
+		case EMarkdownNodeType::Paragraph: return TEXT("paragraph");
+		case EMarkdownNodeType::List: return TEXT("list");
+		case EMarkdownNodeType::ListItem: return TEXT("list_item");
+		case EMarkdownNodeType::Quote: return TEXT("quote");
+		case EMarkdownNodeType::CodeBlock: return TEXT("code_block");
+		case EMarkdownNodeType::Rule: return TEXT("rule");
+		case EMarkdownNodeType::Table: return TEXT("table");
+		case EMarkdownNodeType::TableRow: return TEXT("table_row");
+		case EMarkdownNodeType::TableCell: return TEXT("table_cell");
+		case EMarkdownNodeType::Text: return TEXT("text");
+		case EMarkdownNodeType::Code: return TEXT("code");
+		case EMarkdownNodeType::Emphasis: return TEXT("emphasis");
+		case EMarkdownNodeType::Strong: return TEXT("strong");
+		case EMarkdownNodeType::Strikethrough: return TEXT("strikethrough");
+		case EMarkdownNodeType::Link: return TEXT("link");
+		case EMarkdownNodeType::Image: return TEXT("image");
+		case EMarkdownNodeType::Break: return TEXT("break");
+	}
+
+	return TEXT("unknown");
+}
+
+FMarkdownSyntaxTree FMarkdownSyntaxTree::Parse(FString Text)
+{
+	FMarkdownSyntaxTree Tree;
+	Tree.Text = MoveTemp(Text);
+
+	// nodes are allocated in one block, documents average a node every dozen or so characters
+	Tree.Nodes.Reserve(Tree.Text.Len() / 12 + 16);
+
+	MarkdownSyntaxTree::FParser Parser(Tree.Text, Tree.Nodes);
+	Parser.Parse();
+
+	return Tree;
+}
+
+FString FMarkdownSyntaxTree::GetInlineText(const FMarkdownNode& Node) const
+{
+	FString Result;
+
+	const int32 First = int32(&Node - Nodes.GetData()) + 1;
+
+	for (int32 Index = First; Index < First + Node.NumDescendants; ++Index)
+	{
+		if (Nodes[Index].Type == EMarkdownNodeType::Text || Nodes[Index].Type == EMarkdownNodeType::Code)
+		{
+			Result.Append(GetSpan(Nodes[Index]));
+		}
+	}
+
+	return Result;
+}
@@ -0,0 +1,614 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "MarkdownTextCodec.h"
+
+#include "MarkdownVectorIntrinsics.h"
+#include "Misc/FileHelper.h"
+
+namespace MarkdownTextCodec
+{
+	static constexpr uint8 Utf8Bom[] = { 0xEF, 0xBB, 0xBF };
+	static constexpr uint8 Utf16LEBom[] = { 0xFF, 0xFE };
+	static constexpr uint8 Utf16BEBom[] = { 0xFE, 0xFF };
+	static constexpr uint32 ReplacementCharacter = 0xFFFD;
+
+	/** The vector paths widen and narrow ASCII to UTF-16, platforms with 32 bit TCHARs take the scalar path. */
+	static constexpr bool bUtf16Chars = sizeof(TCHAR) == 2;
+
+	template<int32 Len>
+	static bool StartsWith(TArrayView<const uint8> Bytes, const uint8 (&Prefix)[Len])
+	{
+		return Bytes.Num() >= Len && FMemory::Memcmp(Bytes.GetData(), Prefix, Len) == 0;
+	}
+
+	/** Returns the number of leading ASCII bytes. */
+	static int32 SkipAscii(const uint8* In, int32 Num)
+	{
+		int32 Index = 0;
+
+#if MARKDOWN_VECTOR_AVX2
+		for (; Index + 32 <= Num; Index += 32)
+		{
+			if (_mm256_movemask_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(In + Index))) != 0)
+			{
+				break;
+			}
+		}
+#endif
+
+#if MARKDOWN_VECTOR_SSE
+		for (; Index + 16 <= Num; Index += 16)
+		{
+			if (_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(In + Index))) != 0)
+			{
+				break;
+			}
+		}
+#elif MARKDOWN_VECTOR_NEON
+		for (; Index + 16 <= Num; Index += 16)
+		{
+			if (vmaxvq_u8(vld1q_u8(In + Index)) >= 0x80)
+			{
+				break;
+			}
+		}
+#endif
+
+		while (Index < Num && In[Index] < 0x80)
+		{
+			++Index;
+		}
+
+		return Index;
+	}
+
+	/** Copies the leading ASCII bytes to Out as characters. Returns how many were copied. */
+	static int32 WidenAscii(const uint8* In, int32 Num, TCHAR* Out)
+	{
+		int32 Index = 0;
+
+		if constexpr (bUtf16Chars)
+		{
+#if MARKDOWN_VECTOR_AVX2
+			for (; Index + 32 <= Num; Index += 32)
+			{
+				const __m256i Block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(In + Index));
+				if (_mm256_movemask_epi8(Block) != 0)
+				{
+					break;
+				}
+
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(Out + Index), _mm256_cvtepu8_epi16(_mm256_castsi256_si128(Block)));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(Out + Index + 16), _mm256_cvtepu8_epi16(_mm256_extracti128_si256(Block, 1)));
+			}
+#endif
+
+#if MARKDOWN_VECTOR_SSE
+			const __m128i Zero = _mm_setzero_si128();
+
+			for (; Index + 16 <= Num; Index += 16)
+			{
+				const __m128i Block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(In + Index));
+				if (_mm_movemask_epi8(Block) != 0)
+				{
+					break;
+				}
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(Out + Index), _mm_unpacklo_epi8(Block, Zero));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(Out + Index + 8), _mm_unpackhi_epi8(Block, Zero));
+			}
+#elif MARKDOWN_VECTOR_NEON
+			for (; Index + 16 <= Num; Index += 16)
+			{
+				const uint8x16_t Block = vld1q_u8(In + Index);
+				if (vmaxvq_u8(Block) >= 0x80)
+				{
+					break;
+				}
+
+				vst1q_u16(reinterpret_cast<uint16*>(Out + Index), vmovl_u8(vget_low_u8(Block)));
+				vst1q_u16(reinterpret_cast<uint16*>(Out + Index + 8), vmovl_high_u8(Block));
+			}
+#endif
+		}
+
+		for (; Index < Num && In[Index] < 0x80; ++Index)
+		{
+			Out[Index] = TCHAR(In[Index]);
+		}
+
+		return Index;
+	}
+
+	/** Copies the leading ASCII characters to Out as bytes. Returns how many were copied. */
+	static int32 NarrowAscii(const TCHAR* In, int32 Num, uint8* Out)
+	{
+		int32 Index = 0;
+
+		if constexpr (bUtf16Chars)
+		{
+#if MARKDOWN_VECTOR_SSE
+			const __m128i NonAscii = _mm_set1_epi16(short(0xFF80));
+			const __m128i Zero = _mm_setzero_si128();
+
+			for (; Index + 16 <= Num; Index += 16)
+			{
+				const __m128i Low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(In + Index));
+				const __m128i High = _mm_loadu_si128(reinterpret_cast<const __m128i*>(In + Index + 8));
+
+				if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(_mm_or_si128(Low, High), NonAscii), Zero)) != 0xFFFF)
+				{
+					break;
+				}
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(Out + Index), _mm_packus_epi16(Low, High));
+			}
+#elif MARKDOWN_VECTOR_NEON
+			for (; Index + 16 <= Num; Index += 16)
+			{
+				const uint16x8_t Low = vld1q_u16(reinterpret_cast<const uint16*>(In + Index));
+				const uint16x8_t High = vld1q_u16(reinterpret_cast<const uint16*>(In + Index + 8));
+
+				if (vmaxvq_u16(vorrq_u16(Low, High)) >= 0x80)
+				{
+					break;
+				}
+
+				vst1q_u8(Out + Index, vcombine_u8(vmovn_u16(Low), vmovn_u16(High)));
+			}
+#endif
+		}
+
+		for (; Index < Num && uint32(In[Index]) < 0x80; ++Index)
+		{
+			Out[Index] = uint8(In[Index]);
+		}
+
+		return Index;
+	}
+
+	/** Decodes the multi byte sequence at In. Returns its length, or 0 if it is not valid UTF-8. */
+	static int32 DecodeSequence(const uint8* In, int32 Num, uint32& OutCodepoint)
+	{
+		const uint8 Lead = In[0];
+
+		int32 Len = 0;
+		uint32 Min = 0;
+		uint32 Codepoint = 0;
+
+		if (Lead >= 0xC2 && Lead <= 0xDF)
+		{
+			Len = 2;
+			Min = 0x80;
+			Codepoint = Lead & 0x1F;
+		}
+		else if ((Lead & 0xF0) == 0xE0)
+		{
+			Len = 3;
+			Min = 0x800;
+			Codepoint = Lead & 0x0F;
+		}
+		else if (Lead >= 0xF0 && Lead <= 0xF4)
+		{
+			Len = 4;
+			Min = 0x10000;
+			Codepoint = Lead & 0x07;
+		}
+		else
+		{
+			return 0;
+		}
+
+		if (Num < Len)
+		{
+			return 0;
+		}
+
+		for (int32 Index = 1; Index < Len; ++Index)
+		{
+			if ((In[Index] & 0xC0) != 0x80)
+			{
+				return 0;
+			}
+
+			Codepoint = (Codepoint << 6) | (In[Index] & 0x3F);
+		}
+
+		if (Codepoint < Min || Codepoint > 0x10FFFF || (Codepoint >= 0xD800 && Codepoint <= 0xDFFF))
+		{
+			return 0;
+		}
+
+		OutCodepoint = Codepoint;
+		return Len;
+	}
+
+	static int32 WriteChars(uint32 Codepoint, TCHAR* Out)
+	{
+		if constexpr (bUtf16Chars)
+		{
+			if (Codepoint >= 0x10000)
+			{
+				Codepoint -= 0x10000;
+				Out[0] = TCHAR(0xD800 + (Codepoint >> 10));
+				Out[1] = TCHAR(0xDC00 + (Codepoint & 0x3FF));
+				return 2;
+			}
+		}
+
+		Out[0] = TCHAR(Codepoint);
+		return 1;
+	}
+
+	static int32 WriteUtf8(uint32 Codepoint, uint8* Out)
+	{
+		if (Codepoint < 0x80)
+		{
+			Out[0] = uint8(Codepoint);
+			return 1;
+		}
+
+		if (Codepoint < 0x800)
+		{
+			Out[0] = uint8(0xC0 | (Codepoint >> 6));
+			Out[1] = uint8(0x80 | (Codepoint & 0x3F));
+			return 2;
+		}
+
+		if (Codepoint < 0x10000)
+		{
+			Out[0] = uint8(0xE0 | (Codepoint >> 12));
+			Out[1] = uint8(0x80 | ((Codepoint >> 6) & 0x3F));
+			Out[2] = uint8(0x80 | (Codepoint & 0x3F));
+			return 3;
+		}
+
+		Out[0] = uint8(0xF0 | (Codepoint >> 18));
+		Out[1] = uint8(0x80 | ((Codepoint >> 12) & 0x3F));
+		Out[2] = uint8(0x80 | ((Codepoint >> 6) & 0x3F));
+		Out[3] = uint8(0x80 | (Codepoint & 0x3F));
+		return 4;
+	}
+
+	/** Appends the text as UTF-8, at most three bytes per UTF-16 character. */
+	static void AppendUtf8(FStringView Text, TArray<uint8>& OutBytes)
+	{
+		const TCHAR* In = Text.GetData();
+		const int32 Num = Text.Len();
+
+		const int32 Start = OutBytes.Num();
+		OutBytes.AddUninitialized(Num * (bUtf16Chars ? 3 : 4));
+
+		uint8* Out = OutBytes.GetData() + Start;
+		int32 InPos = 0;
+		int32 OutPos = 0;
+
+		while (InPos < Num)
+		{
+			const int32 Ascii = NarrowAscii(In + InPos, Num - InPos, Out + OutPos);
+			InPos += Ascii;
+			OutPos += Ascii;
+
+			if (InPos == Num)
+			{
+				break;
+			}
+
+			uint32 Codepoint = uint32(In[InPos++]);
+
+			if (Codepoint >= 0xD800 && Codepoint <= 0xDBFF && InPos < Num && uint32(In[InPos]) >= 0xDC00 && uint32(In[InPos]) <= 0xDFFF)
+			{
+				Codepoint = 0x10000 + ((Codepoint - 0xD800) << 10) + (uint32(In[InPos++]) - 0xDC00);
+			}
+			else if ((Codepoint >= 0xD800 && Codepoint <= 0xDFFF) || Codepoint > 0x10FFFF)
+			{
+				Codepoint = ReplacementCharacter;
+			}
+
+			OutPos += WriteUtf8(Codepoint, Out + OutPos);
+		}
+
+		OutBytes.SetNumUninitialized(Start + OutPos);
+	}
+
+	static void DecodeLatin1(TArrayView<const uint8> Bytes, FString& OutText)
+	{
+		auto& Chars = OutText.GetCharArray();
+		Chars.SetNumUninitialized(Bytes.Num() + 1);
+
+		const int32 Ascii = WidenAscii(Bytes.GetData(), Bytes.Num(), Chars.GetData());
+		for (int32 Index = Ascii; Index < Bytes.Num(); ++Index)
+		{
+			Chars[Index] = TCHAR(Bytes[Index]);
+		}
+
+		Chars[Bytes.Num()] = TCHAR(0);
+	}
+
+	static void DecodeUtf16(TArrayView<const uint8> Bytes, bool bBigEndian, FString& OutText)
+	{
+		const int32 NumUnits = Bytes.Num() / 2;
+
+		auto& Chars = OutText.GetCharArray();
+		Chars.SetNumUninitialized(NumUnits + 1);
+
+		if (bUtf16Chars && bBigEndian == !PLATFORM_LITTLE_ENDIAN)
+		{
+			FMemory::Memcpy(Chars.GetData(), Bytes.GetData(), NumUnits * 2);
+		}
+		else
+		{
+			// the units are kept as they are, unpaired surrogates included, so they are written back unchanged
+			for (int32 Index = 0; Index < NumUnits; ++Index)
+			{
+				const uint8 First = Bytes[Index * 2];
+				const uint8 Second = Bytes[Index * 2 + 1];
+				Chars[Index] = TCHAR(bBigEndian ? (First << 8) | Second : (Second << 8) | First);
+			}
+		}
+
+		Chars[NumUnits] = TCHAR(0);
+	}
+
+	static void AppendUtf16(FStringView Text, bool bBigEndian, TArray<uint8>& OutBytes)
+	{
+		const int32 Start = OutBytes.Num();
+
+		if (bUtf16Chars && bBigEndian == !PLATFORM_LITTLE_ENDIAN)
+		{
+			OutBytes.Append(reinterpret_cast<const uint8*>(Text.GetData()), Text.Len() * 2);
+			return;
+		}
+
+		OutBytes.AddUninitialized(Text.Len() * 2);
+
+		for (int32 Index = 0; Index < Text.Len(); ++Index)
+		{
+			const uint16 Unit = uint16(Text[Index]);
+			OutBytes[Start + Index * 2] = uint8(bBigEndian ? Unit >> 8 : Unit & 0xFF);
+			OutBytes[Start + Index * 2 + 1] = uint8(bBigEndian ? Unit & 0xFF : Unit >> 8);
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool MarkdownTextCodec::IsValidUtf8(TArrayView<const uint8> Bytes)
+{
+	const uint8* In = Bytes.GetData();
+	const int32 Num = Bytes.Num();
+
+	int32 Pos = 0;
+	while (true)
+	{
+		Pos += SkipAscii(In + Pos, Num - Pos);
+		if (Pos == Num)
+		{
+			return true;
+		}
+
+		uint32 Codepoint = 0;
+		const int32 Len = DecodeSequence(In + Pos, Num - Pos, Codepoint);
+		if (Len == 0)
+		{
+			return false;
+		}
+
+		Pos += Len;
+	}
+}
+
+bool MarkdownTextCodec::DecodeUtf8(TArrayView<const uint8> Bytes, FString& OutText)
+{
+	if (Bytes.IsEmpty())
+	{
+		OutText.Reset();
+		return true;
+	}
+
+	const uint8* In = Bytes.GetData();
+	const int32 Num = Bytes.Num();
+
+	// never more characters than bytes, plus the terminator
+	auto& Chars = OutText.GetCharArray();
+	Chars.SetNumUninitialized(Num + 1);
+
+	TCHAR* Out = Chars.GetData();
+	int32 InPos = 0;
+	int32 OutPos = 0;
+
+	while (true)
+	{
+		const int32 Ascii = WidenAscii(In + InPos, Num - InPos, Out + OutPos);
+		InPos += Ascii;
+		OutPos += Ascii;
+
+		if (InPos == Num)
+		{
+			break;
+		}
+
+		uint32 Codepoint = 0;
+		const int32 Len = DecodeSequence(In + InPos, Num - InPos, Codepoint);
+		if (Len == 0)
+		{
+			return false;
+		}
+
+		InPos += Len;
+		OutPos += WriteChars(Codepoint, Out + OutPos);
+	}
+
+	Out[OutPos] = TCHAR(0);
+	Chars.SetNumUninitialized(OutPos + 1);
+	return true;
+}
+
+void MarkdownTextCodec::EncodeUtf8(FStringView Text, TArray<uint8>& OutBytes)
+{
+	OutBytes.Reset();
+	AppendUtf8(Text, OutBytes);
+}
+
+FMarkdownTextFormat MarkdownTextCodec::DetectFormat(TArrayView<const uint8> Bytes)
+{
+	FMarkdownTextFormat Format;
+
+	if (StartsWith(Bytes, Utf16LEBom) && Bytes.Num() % 2 == 0)
+	{
+		Format.Encoding = EMarkdownTextEncoding::Utf16LE;
+		Format.bByteOrderMark = true;
+	}
+	else if (StartsWith(Bytes, Utf16BEBom) && Bytes.Num() % 2 == 0)
+	{
+		Format.Encoding = EMarkdownTextEncoding::Utf16BE;
+		Format.bByteOrderMark = true;
+	}
+	else if (StartsWith(Bytes, Utf8Bom) && IsValidUtf8(Bytes.Slice(UE_ARRAY_COUNT(Utf8Bom), Bytes.Num() - UE_ARRAY_COUNT(Utf8Bom))))
+	{
+		Format.bByteOrderMark = true;
+	}
+	else if (!IsValidUtf8(Bytes))
+	{
+		Format.Encoding = EMarkdownTextEncoding::Latin1;
+	}
+
+	return Format;
+}
+
+void MarkdownTextCodec::Decode(TArrayView<const uint8> Bytes, FString& OutText, FMarkdownTextFormat* OutFormat)
+{
+	FMarkdownTextFormat Format;
+
+	// an odd number of UTF-16 bytes or invalid UTF-8 is only found out while decoding, so this validates once
+	if (StartsWith(Bytes, Utf16LEBom) || StartsWith(Bytes, Utf16BEBom))
+	{
+		Format = DetectFormat(Bytes);
+	}
+	else
+	{
+		Format.bByteOrderMark = StartsWith(Bytes, Utf8Bom);
+
+		if (!DecodeUtf8(Format.bByteOrderMark ? Bytes.Slice(UE_ARRAY_COUNT(Utf8Bom), Bytes.Num() - UE_ARRAY_COUNT(Utf8Bom)) : Bytes, OutText))
+		{
+			Format.Encoding = EMarkdownTextEncoding::Latin1;
+			Format.bByteOrderMark = false;
+		}
+	}
+
+	switch (Format.Encoding)
+	{
+		case EMarkdownTextEncoding::Utf16LE:
+		case EMarkdownTextEncoding::Utf16BE:
+			DecodeUtf16(Bytes.Slice(UE_ARRAY_COUNT(Utf16LEBom), Bytes.Num() - UE_ARRAY_COUNT(Utf16LEBom)), Format.Encoding == EMarkdownTextEncoding::Utf16BE, OutText);
+			break;
+
+		case EMarkdownTextEncoding::Latin1:
+			DecodeLatin1(Bytes, OutText);
+			break;
+
+		default:
+			break;
+	}
+
+	if (OutFormat)
+	{
+		*OutFormat = Format;
+	}
+}
+
+void MarkdownTextCodec::Encode(FStringView Text, const FMarkdownTextFormat& Format, TArray<uint8>& OutBytes)
+{
+	OutBytes.Reset();
+
+	switch (Format.Encoding)
+	{
+		case EMarkdownTextEncoding::Utf16LE:
+		case EMarkdownTextEncoding::Utf16BE:
+		{
+			const bool bBigEndian = Format.Encoding == EMarkdownTextEncoding::Utf16BE;
+			if (Format.bByteOrderMark)
+			{
+				OutBytes.Append(bBigEndian ? Utf16BEBom : Utf16LEBom, UE_ARRAY_COUNT(Utf16LEBom));
+			}
+
+			AppendUtf16(Text, bBigEndian, OutBytes);
+			return;
+		}
+
+		case EMarkdownTextEncoding::Latin1:
+		{
+			bool bFits = true;
+			for (const TCHAR Char : Text)
+			{
+				if (uint32(Char) > 0xFF)
+				{
+					bFits = false;
+					break;
+				}
+			}
+
+			if (bFits)
+			{
+				OutBytes.SetNumUninitialized(Text.Len());
+				const int32 Ascii = NarrowAscii(Text.GetData(), Text.Len(), OutBytes.GetData());
+
+				for (int32 Index = Ascii; Index < Text.Len(); ++Index)
+				{
+					OutBytes[Index] = uint8(Text[Index]);
+				}
+				return;
+			}
+
+			AppendUtf8(Text, OutBytes);
+			return;
+		}
+
+		default:
+			if (Format.bByteOrderMark)
+			{
+				OutBytes.Append(Utf8Bom, UE_ARRAY_COUNT(Utf8Bom));
+			}
+
+			AppendUtf8(Text, OutBytes);
+			return;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool MarkdownTextCodec::LoadFile(const FString& FilePath, FString& OutText, FMarkdownTextFormat* OutFormat)
+{
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *FilePath))
+	{
+		return false;
+	}
+
+	Decode(Bytes, OutText, OutFormat);
+	return true;
+}
+
+bool MarkdownTextCodec::SaveFile(const FString& FilePath, FStringView Text)
+{
+	FMarkdownTextFormat Format;
+
+	TArray<uint8> Existing;
+	const bool bExists = FFileHelper::LoadFileToArray(Existing, *FilePath, FILEREAD_Silent);
+
+	if (bExists)
+	{
+		Format = DetectFormat(Existing);
+	}
+
+	TArray<uint8> Bytes;
+	Encode(Text, Format, Bytes);
+
+	// rewriting identical bytes would only touch the timestamp and wake up source control
+	if (bExists && Bytes == Existing)
+	{
+		return true;
+	}
+
+	return FFileHelper::SaveArrayToFile(Bytes, *FilePath);
+}
@@ -0,0 +1,237 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "MarkdownTranslation.h"
+
+#include "Misc/Crc.h"
+
+namespace MarkdownTranslation
+{
+	static uint32 HashBlock(FStringView Block)
+	{
+		// line endings are not part of the text, a document saved with CRLF keeps its translations
+		int32 CarriageReturn = INDEX_NONE;
+		if (!Block.FindChar(TEXT('\r'), CarriageReturn))
+		{
+			return FCrc::StrCrc32Len(Block.GetData(), Block.Len());
+		}
+
+		FString Normalized(Block);
+		Normalized.ReplaceInline(TEXT("\r"), TEXT(""), ESearchCase::CaseSensitive);
+		return FCrc::StrCrc32Len(*Normalized, Normalized.Len());
+	}
+
+	/** "# Title", indented by up to three spaces, with one to six '#'. */
+	static bool IsHeading(FStringView Line)
+	{
+		int32 Index = 0;
+		while (Index < 3 && Index < Line.Len() && Line[Index] == TEXT(' '))
+		{
+			++Index;
+		}
+
+		const int32 HashStart = Index;
+		while (Index < Line.Len() && Line[Index] == TEXT('#'))
+		{
+			++Index;
+		}
+
+		const int32 Level = Index - HashStart;
+		return Level >= 1 && Level <= 6 && (Index == Line.Len() || FChar::IsWhitespace(Line[Index]));
+	}
+
+	/** "- item", "* item", "+ item", "1. item" or "1) item", at any depth. */
+	static bool IsListItem(FStringView Line)
+	{
+		const FStringView Trimmed = Line.TrimStart();
+
+		int32 Index = 0;
+		if (Trimmed.Len() > 0 && (Trimmed[0] == TEXT('-') || Trimmed[0] == TEXT('*') || Trimmed[0] == TEXT('+')))
+		{
+			Index = 1;
+		}
+		else
+		{
+			while (Index < Trimmed.Len() && Index < 9 && FChar::IsDigit(Trimmed[Index]))
+			{
+				++Index;
+			}
+
+			if (Index == 0 || Index == Trimmed.Len() || (Trimmed[Index] != TEXT('.') && Trimmed[Index] != TEXT(')')))
+			{
+				return false;
+			}
+
+			++Index;
+		}
+
+		return Index < Trimmed.Len() && FChar::IsWhitespace(Trimmed[Index]);
+	}
+
+	static bool IsFence(FStringView Line)
+	{
+		const FStringView Trimmed = Line.TrimStart();
+		return Trimmed.StartsWith(TEXTVIEW("```")) || Trimmed.StartsWith(TEXTVIEW("~~~"));
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void UMarkdownTranslation::SplitBlocks(FStringView Text, TArray<FMarkdownTranslationBlock>& OutBlocks)
+{
+	int32 BlockStart = INDEX_NONE;
+	int32 BlockEnd = 0;
+	bool bInFence = false;
+
+	auto EndBlock = [&]()
+	{
+		if (BlockStart != INDEX_NONE)
+		{
+			const FStringView Block = Text.Mid(BlockStart, BlockEnd - BlockStart);
+			OutBlocks.Add({ BlockStart, Block.Len(), MarkdownTranslation::HashBlock(Block) });
+			BlockStart = INDEX_NONE;
+		}
+	};
+
+	int32 LineStart = 0;
+	while (LineStart < Text.Len())
+	{
+		int32 LineEnd = LineStart;
+		while (LineEnd < Text.Len() && Text[LineEnd] != TEXT('\n'))
+		{
+			++LineEnd;
+		}
+
+		// the block excludes the line break and trailing whitespace, so line ending changes do not invalidate it
+		const FStringView Line = Text.Mid(LineStart, LineEnd - LineStart).TrimEnd();
+
+		if (bInFence)
+		{
+			// code is one block, blank lines included
+			BlockEnd = LineStart + Line.Len();
+
+			if (MarkdownTranslation::IsFence(Line))
+			{
+				bInFence = false;
+				EndBlock();
+			}
+		}
+		else if (MarkdownTranslation::IsFence(Line))
+		{
+			EndBlock();
+
+			BlockStart = LineStart;
+			BlockEnd = LineStart + Line.Len();
+			bInFence = true;
+		}
+		else if (Line.IsEmpty())
+		{
+			EndBlock();
+		}
+		else if (MarkdownTranslation::IsHeading(Line))
+		{
+			// a heading is a block of its own, even without blank lines around it
+			EndBlock();
+
+			BlockStart = LineStart;
+			BlockEnd = LineStart + Line.Len();
+			EndBlock();
+		}
+		else if (MarkdownTranslation::IsListItem(Line))
+		{
+			// each item is a block, with the lines that continue it
+			EndBlock();
+
+			BlockStart = LineStart;
+			BlockEnd = LineStart + Line.Len();
+		}
+		else
+		{
+			BlockStart = BlockStart == INDEX_NONE ? LineStart : BlockStart;
+			BlockEnd = LineStart + Line.Len();
+		}
+
+		LineStart = LineEnd + 1;
+	}
+
+	EndBlock();
+}
+
+FString UMarkdownTranslation::Translate(FStringView SourceText) const
+{
+	if (Blocks.IsEmpty())
+	{
+		return FString(SourceText);
+	}
+
+	TArray<FMarkdownTranslationBlock> Parts;
+	SplitBlocks(SourceText, Parts);
+
+	FString Result;
+	Result.Reserve(SourceText.Len());
+
+	int32 Copied = 0;
+	for (const FMarkdownTranslationBlock& Block : Parts)
+	{
+		if (const FString* Translation = Blocks.Find(Block.Hash))
+		{
+			Result.Append(SourceText.Mid(Copied, Block.Start - Copied));
+			Result.Append(*Translation);
+			Copied = Block.Start + Block.Len;
+		}
+	}
+
+	Result.Append(SourceText.RightChop(Copied));
+	return Result;
+}
+
+void UMarkdownTranslation::GetUntranslatedBlocks(FStringView SourceText, TArray<FMarkdownTranslationBlock>& OutBlocks) const
+{
+	TArray<FMarkdownTranslationBlock> Parts;
+	SplitBlocks(SourceText, Parts);
+
+	for (const FMarkdownTranslationBlock& Block : Parts)
+	{
+		if (!Blocks.Contains(Block.Hash))
+		{
+			OutBlocks.Add(Block);
+		}
+	}
+}
+
+#if WITH_EDITOR
+
+void UMarkdownTranslation::SetBlock(FStringView SourceBlock, FString Translation)
+{
+	SourceBlock.TrimEndInline();
+	const uint32 Hash = MarkdownTranslation::HashBlock(SourceBlock);
+
+	Blocks.Add(Hash, MoveTemp(Translation));
+	SourceBlocks.Add(Hash, FString(SourceBlock));
+}
+
+int32 UMarkdownTranslation::RemoveUnusedBlocks(FStringView SourceText)
+{
+	TArray<FMarkdownTranslationBlock> Used;
+	SplitBlocks(SourceText, Used);
+
+	TSet<uint32> UsedHashes;
+	for (const FMarkdownTranslationBlock& Block : Used)
+	{
+		UsedHashes.Add(Block.Hash);
+	}
+
+	const int32 NumRemoved = Blocks.Num();
+
+	for (auto It = Blocks.CreateIterator(); It; ++It)
+	{
+		if (!UsedHashes.Contains(It.Key()))
+		{
+			SourceBlocks.Remove(It.Key());
+			It.RemoveCurrent();
+		}
+	}
+
+	return NumRemoved - Blocks.Num();
+}
+
+#endif // WITH_EDITOR
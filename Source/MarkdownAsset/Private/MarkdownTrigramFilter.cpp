@@ -0,0 +1,143 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "MarkdownTrigramFilter.h"
+
+#include "Containers/Set.h"
+#include "Math/UnrealMathUtility.h"
+#include "Misc/Base64.h"
+#include "Misc/Char.h"
+
+namespace MarkdownTrigramFilter
+{
+	// ~10 bits per entry with 4 probes gives about a 1% false positive rate
+	constexpr int32 BitsPerTrigram = 10;
+	constexpr int32 NumProbes = 4;
+	constexpr uint32 MinBits = 512;
+
+	// the tag is loaded with every asset in the editor, so long documents get a fuller filter (2 KB, under 3 KB of
+	// base64) with more false positives rather than a bigger one
+	constexpr uint32 MaxBits = 1u << 14;
+
+	static uint64 Mix(uint64 Key)
+	{
+		Key ^= Key >> 33;
+		Key *= 0xff51afd7ed558ccdull;
+		Key ^= Key >> 33;
+		Key *= 0xc4ceb9fe1a85ec53ull;
+		Key ^= Key >> 33;
+		return Key;
+	}
+
+	template<typename CallbackType>
+	static void ForEachTrigram(FStringView Text, CallbackType&& Callback)
+	{
+		if (Text.Len() < 3)
+		{
+			return;
+		}
+
+		uint64 Window = (uint64(uint16(FChar::ToLower(Text[0]))) << 16) | uint16(FChar::ToLower(Text[1]));
+
+		for (int32 i = 2; i < Text.Len(); ++i)
+		{
+			Window = ((Window << 16) | uint16(FChar::ToLower(Text[i]))) & 0xffffffffffffull;
+			Callback(Window);
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+FMarkdownTrigramFilter FMarkdownTrigramFilter::FromText(FStringView Text)
+{
+	TSet<uint64> Trigrams;
+	MarkdownTrigramFilter::ForEachTrigram(Text, [&Trigrams](uint64 Trigram) { Trigrams.Add(Trigram); });
+
+	const uint32 WantedBits = FMath::Clamp<uint32>(uint32(Trigrams.Num()) * MarkdownTrigramFilter::BitsPerTrigram, MarkdownTrigramFilter::MinBits, MarkdownTrigramFilter::MaxBits);
+	const uint32 NumBits = FMath::RoundUpToPowerOfTwo(WantedBits);
+
+	FMarkdownTrigramFilter Filter;
+	Filter.Bits.SetNumZeroed(NumBits / 64);
+	Filter.BitMask = NumBits - 1;
+
+	for (uint64 Trigram : Trigrams)
+	{
+		Filter.AddTrigram(Trigram);
+	}
+
+	return Filter;
+}
+
+bool FMarkdownTrigramFilter::FromString(FStringView String, FMarkdownTrigramFilter& OutFilter)
+{
+	TArray<uint8> Bytes;
+	if (!FBase64::Decode(FString(String), Bytes))
+	{
+		return false;
+	}
+
+	const int32 NumWords = Bytes.Num() / sizeof(uint64);
+	if (NumWords == 0 || !FMath::IsPowerOfTwo(NumWords) || Bytes.Num() % sizeof(uint64) != 0)
+	{
+		return false;
+	}
+
+	OutFilter.Bits.SetNumUninitialized(NumWords);
+	FMemory::Memcpy(OutFilter.Bits.GetData(), Bytes.GetData(), Bytes.Num());
+	OutFilter.BitMask = uint64(NumWords) * 64 - 1;
+	return true;
+}
+
+FString FMarkdownTrigramFilter::ToString() const
+{
+	return FBase64::Encode(reinterpret_cast<const uint8*>(Bits.GetData()), Bits.Num() * sizeof(uint64));
+}
+
+bool FMarkdownTrigramFilter::MayContain(FStringView String) const
+{
+	if (!IsValid())
+	{
+		return true;
+	}
+
+	bool bMayContain = true;
+	MarkdownTrigramFilter::ForEachTrigram(String, [this, &bMayContain](uint64 Trigram)
+	{
+		bMayContain = bMayContain && MayContainTrigram(Trigram);
+	});
+
+	return bMayContain;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void FMarkdownTrigramFilter::AddTrigram(uint64 Trigram)
+{
+	const uint64 Hash = MarkdownTrigramFilter::Mix(Trigram);
+	const uint64 H1 = Hash & 0xffffffff;
+	const uint64 H2 = (Hash >> 32) | 1;
+
+	for (int32 Probe = 0; Probe < MarkdownTrigramFilter::NumProbes; ++Probe)
+	{
+		const uint64 Bit = (H1 + Probe * H2) & BitMask;
+		Bits[Bit >> 6] |= 1ull << (Bit & 63);
+	}
+}
+
+bool FMarkdownTrigramFilter::MayContainTrigram(uint64 Trigram) const
+{
+	const uint64 Hash = MarkdownTrigramFilter::Mix(Trigram);
+	const uint64 H1 = Hash & 0xffffffff;
+	const uint64 H2 = (Hash >> 32) | 1;
+
+	for (int32 Probe = 0; Probe < MarkdownTrigramFilter::NumProbes; ++Probe)
+	{
+		const uint64 Bit = (H1 + Probe * H2) & BitMask;
+		if ((Bits[Bit >> 6] & (1ull << (Bit & 63))) == 0)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
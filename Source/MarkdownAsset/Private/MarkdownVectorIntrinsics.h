@@ -0,0 +1,31 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "HAL/Platform.h"
+
+// SSE2 is always there on x64, AVX2 only when the build targets it. NEON is used on 64 bit ARM.
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS && PLATFORM_CPU_X86_FAMILY
+	#include <immintrin.h>
+	#define MARKDOWN_VECTOR_SSE 1
+	#define MARKDOWN_VECTOR_NEON 0
+	#if defined(__AVX2__)
+		#define MARKDOWN_VECTOR_AVX2 1
+	#else
+		#define MARKDOWN_VECTOR_AVX2 0
+	#endif
+#elif PLATFORM_ENABLE_VECTORINTRINSICS_NEON && PLATFORM_CPU_ARM_FAMILY && PLATFORM_64BITS
+	#if PLATFORM_WINDOWS
+		#include <arm64_neon.h>
+	#else
+		#include <arm_neon.h>
+	#endif
+	#define MARKDOWN_VECTOR_SSE 0
+	#define MARKDOWN_VECTOR_AVX2 0
+	#define MARKDOWN_VECTOR_NEON 1
+#else
+	#define MARKDOWN_VECTOR_SSE 0
+	#define MARKDOWN_VECTOR_AVX2 0
+	#define MARKDOWN_VECTOR_NEON 0
+#endif
@@ -0,0 +1,24 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "MarkdownScanner.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMarkdownHeadingAnchorTest, "MarkdownAsset.Scanner.HeadingAnchors", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+bool FMarkdownHeadingAnchorTest::RunTest(const FString& Parameters)
+{
+	// expected anchors are what markdown-it-anchor gives in the viewer
+	TestEqual(TEXT("ASCII"), MarkdownScanner::MakeHeadingAnchor(TEXT("  Hello   World ")), FString(TEXT("hello-world")));
+	TestEqual(TEXT("Non-ASCII capitals"), MarkdownScanner::MakeHeadingAnchor(TEXT("\u00DCber Gr\u00F6\u00DFe")), FString(TEXT("%C3%BCber-gr%C3%B6%C3%9Fe")));
+	TestEqual(TEXT("Accented capitals"), MarkdownScanner::MakeHeadingAnchor(TEXT("\u00C9T\u00C9 Notes")), FString(TEXT("%C3%A9t%C3%A9-notes")));
+
+	FMarkdownHeadingAnchors Anchors;
+	TestEqual(TEXT("First"), Anchors.Add(TEXT("\u00C9t\u00E9")), FString(TEXT("%C3%A9t%C3%A9")));
+	TestEqual(TEXT("Repeated with other case"), Anchors.Add(TEXT("\u00C9T\u00C9")), FString(TEXT("%C3%A9t%C3%A9-1")));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,85 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "Containers/Array.h"
+#include "Containers/UnrealString.h"
+#include "HAL/CriticalSection.h"
+#include "Serialization/Archive.h"
+#include "Templates/UniquePtr.h"
+#include "UObject/SoftObjectPath.h"
+
+/** Sizes reported when an archive is written. */
+struct FMarkdownArchiveStats
+{
+	int32 NumDocuments = 0;
+	int32 DictionarySize = 0;
+	int64 RawBytes = 0;
+	int64 PackedBytes = 0;
+};
+
+/**
+ * A single file holding many markdown documents, for shipping help pages without a package per document.
+ *
+ * Small documents compress poorly on their own, so every document is deflated against a dictionary trained on the
+ * common phrases of the whole set. The dictionary and a sorted index are read once when the archive is opened, after
+ * which reading a document is one seek, one read and one inflate. Documents are stored by object path.
+ *
+ * Layout: header, dictionary, index (name, offset, sizes), then the compressed documents.
+ */
+class MARKDOWNASSET_API FMarkdownArchive
+{
+public:
+
+	struct FDocument
+	{
+		FSoftObjectPath Path;
+		FString Text;
+	};
+
+	/** Where the pack commandlet writes the archive, stage this folder with the game to ship it. */
+	static FString GetDefaultPath();
+
+	/** The archive at the default path, opened on first use. Null if the game was shipped without one. */
+	static const FMarkdownArchive* GetDefault();
+
+	/** Packs the documents into an archive, training the shared dictionary on them. */
+	static bool Write(const FString& FilePath, TArray<FDocument> Documents, FMarkdownArchiveStats* OutStats = nullptr);
+
+	bool Open(const FString& FilePath);
+	bool IsOpen() const { return Reader.IsValid(); }
+
+	bool Contains(const FSoftObjectPath& Document) const;
+
+	/** Reads and decompresses a document, safe to call from any thread. */
+	bool ReadDocument(const FSoftObjectPath& Document, FString& OutText) const;
+
+	void GetDocuments(TArray<FSoftObjectPath>& OutDocuments) const;
+
+private:
+
+	struct FEntry
+	{
+		FString Path;
+		uint64 Offset = 0;
+		uint32 PackedSize = 0;
+		uint32 RawSize = 0;
+
+		friend FArchive& operator<<(FArchive& Ar, FEntry& Entry)
+		{
+			return Ar << Entry.Path << Entry.Offset << Entry.PackedSize << Entry.RawSize;
+		}
+	};
+
+	const FEntry* FindEntry(const FSoftObjectPath& Document) const;
+
+	TArray<uint8> Dictionary;
+
+	/** Sorted by path. */
+	TArray<FEntry> Entries;
+
+	int64 DataStart = 0;
+
+	TUniquePtr<FArchive> Reader;
+	mutable FCriticalSection ReaderLock;
+};
@@ -3,11 +3,33 @@
 #pragma once
 
 #include "Internationalization/Text.h"
+#include "MarkdownDocument.h"
+#include "Misc/EngineVersionComparison.h"
 #include "UObject/Object.h"
 #include "UObject/ObjectMacros.h"
+#include "UObject/SoftObjectPtr.h"
 
 #include "MarkdownAsset.generated.h"
 
+struct FStreamableHandle;
+class UMarkdownTranslation;
+
+/** Whether a document is included in cooked builds. */
+UENUM()
+enum class EMarkdownCookPolicy : uint8
+{
+	/** Follows the project settings, i.e. the editor only folders. */
+	Default,
+
+	/** Never cooked, even when cooked content references it. */
+	EditorOnly,
+
+	/** Cooked when referenced, whatever the project settings say. */
+	Cook,
+
+	/** Left out of the cook and shipped in the packed documentation archive instead, see FMarkdownArchive. */
+	Packed,
+};
 
 UCLASS( BlueprintType, hidecategories = ( Object ) )
 class MARKDOWNASSET_API UMarkdownAsset : public UObject
@@ -18,6 +40,82 @@ public:
 
 	UPROPERTY( BlueprintReadOnly, EditAnywhere, Category = "MarkdownAsset" )
 	FText Text;
+
+	/** Whether this document ships in cooked builds. Editor only documents are stripped even when cooked content references them. */
+	UPROPERTY( EditAnywhere, AssetRegistrySearchable, Category = "Packaging" )
+	EMarkdownCookPolicy CookPolicy = EMarkdownCookPolicy::Default;
+
+	/** Translations of this document by culture name, only the translation for the current culture is loaded. */
+	UPROPERTY( EditAnywhere, Category = "Localization" )
+	TMap<FString, TSoftObjectPtr<UMarkdownTranslation>> Translations;
+
+	/** Asset registry tag holding the comma separated object paths this document links to. */
+	static const FName LinksTagName;
+
+	/** Asset registry tag holding the trigram filter used to skip documents during text searches. */
+	static const FName TrigramsTagName;
+
+	/** Asset registry tag holding the fingerprints of the linked assets, taken when the document was last saved. */
+	static const FName FingerprintsTagName;
+
+	/** Asset registry tag holding the hash of the text, see GetContentHash. */
+	static const FName ContentHashTagName;
+
+	/** Asset registry tag holding the formatted hash, documents whose content hash still matches it need no formatting. */
+	static const FName FormattedHashTagName;
+
+	/** Hash of a document text, cheap enough to take on every save. */
+	static uint32 GetContentHash( const FString& InText );
+
+	/** Returns the translation for the culture, or its closest parent culture. Empty culture means the current language. */
+	TSoftObjectPtr<UMarkdownTranslation> FindTranslation( const FString& Culture = FString() ) const;
+
+	/** Returns the text in the current language, if its translation is loaded, or the source text. */
+	FString GetLocalizedText() const;
+
+	/**
+	 * Loads a document without blocking and parses it on a worker thread. OnLoaded is called on the game thread, with
+	 * null if the document could not be loaded. The translation for the current language is loaded with it. Packed
+	 * documents are read from the documentation archive instead.
+	 * Returns the streaming handle, which is null when there is nothing to stream.
+	 */
+	static TSharedPtr<FStreamableHandle> LoadDocumentAsync( const FSoftObjectPath& Path, FOnMarkdownDocumentLoaded OnLoaded );
+
+	/** Parses this document on a worker thread, OnParsed is called on the game thread. */
+	void ParseAsync( FOnMarkdownDocumentLoaded OnParsed ) const;
+
+	virtual bool IsEditorOnly() const override;
+	virtual bool NeedsLoadForClient() const override;
+	virtual bool NeedsLoadForServer() const override;
+
+#if WITH_EDITOR
+	/** Decides whether documents with the default cook policy are editor only, bound by the editor module. */
+	DECLARE_DELEGATE_RetVal_OneParam( bool, FIsEditorOnlyByDefault, const UMarkdownAsset& );
+	static FIsEditorOnlyByDefault IsEditorOnlyByDefault;
+#endif
+
+#if WITH_EDITORONLY_DATA
+	/** Linked asset path to the fingerprint it had when this document was saved, used to detect outdated docs. */
+	UPROPERTY()
+	TMap<FString, FString> LinkFingerprints;
+
+	/** Content hash of the text the formatter last produced, combined with the options it used, 0 if never formatted. */
+	UPROPERTY()
+	uint32 FormattedHash = 0;
+#endif
+
+#if WITH_EDITOR
+#if UE_VERSION_OLDER_THAN(5, 4, 0)
+	virtual void GetAssetRegistryTags( TArray<FAssetRegistryTag>& OutTags ) const override;
+#else
+	virtual void GetAssetRegistryTags( FAssetRegistryTagsContext Context ) const override;
+#endif
+
+protected:
+
+	/** Collects the markdown specific tags, shared by both registry tag signatures. */
+	void GetMarkdownRegistryTags( TArray<FAssetRegistryTag>& OutTags ) const;
+#endif
 };
 
 //this markdown asset asset is used to link to an external file or URL
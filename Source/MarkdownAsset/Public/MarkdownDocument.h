@@ -0,0 +1,65 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "Containers/Array.h"
+#include "Containers/StringView.h"
+#include "Containers/UnrealString.h"
+#include "Delegates/Delegate.h"
+#include "Templates/SharedPointer.h"
+#include "UObject/SoftObjectPath.h"
+
+/** A heading and the text under it, up to the next heading of the same or a higher level. */
+struct FMarkdownDocumentSection
+{
+	FString Title;
+	FString Anchor;
+	int32 Level = 0;
+
+	/** The section text, heading line included, as offsets into the document text. */
+	int32 Start = 0;
+	int32 Len = 0;
+};
+
+/**
+ * A document parsed for runtime use. It never changes once parsed, so it is shared between threads and consumers
+ * without copying, see UMarkdownAsset::LoadDocumentAsync.
+ */
+class MARKDOWNASSET_API FMarkdownDocument
+{
+public:
+
+	DECLARE_DELEGATE_OneParam(FOnParsed, TSharedPtr<const FMarkdownDocument>);
+
+	/** Parses the text on the calling thread. */
+	static TSharedRef<const FMarkdownDocument> Parse(const FSoftObjectPath& Path, FString Text);
+
+	/** Parses the text on a worker thread and calls OnParsed on the game thread. */
+	static void ParseAsync(const FSoftObjectPath& Path, FString Text, FOnParsed OnParsed);
+
+	const FSoftObjectPath& GetPath() const { return Path; }
+	const FString& GetText() const { return Text; }
+
+	/** The first heading, or the asset name for documents without one. */
+	const FString& GetTitle() const { return Title; }
+
+	const TArray<FMarkdownDocumentSection>& GetSections() const { return Sections; }
+
+	/** Object paths of the assets the document links to. */
+	const TArray<FString>& GetLinks() const { return Links; }
+
+	/** Finds a section by heading title or anchor, ignoring case. */
+	const FMarkdownDocumentSection* FindSection(FStringView TitleOrAnchor) const;
+
+	FStringView GetSectionText(const FMarkdownDocumentSection& Section) const;
+
+private:
+
+	FSoftObjectPath Path;
+	FString Text;
+	FString Title;
+	TArray<FMarkdownDocumentSection> Sections;
+	TArray<FString> Links;
+};
+
+using FOnMarkdownDocumentLoaded = FMarkdownDocument::FOnParsed;
@@ -0,0 +1,101 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "Containers/Array.h"
+#include "Containers/StringView.h"
+#include "Containers/UnrealString.h"
+#include "Math/Color.h"
+#include "Math/Vector2D.h"
+#include "UObject/ObjectMacros.h"
+#include "UObject/ObjectPtr.h"
+
+#include "MarkdownLayout.generated.h"
+
+class UFont;
+
+/** How a document is drawn by UMarkdownRenderSubsystem. Fonts left empty use the engine defaults. */
+USTRUCT(BlueprintType)
+struct MARKDOWNASSET_API FMarkdownRenderStyle
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Fonts")
+	TObjectPtr<const UFont> Font;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Fonts")
+	TObjectPtr<const UFont> BoldFont;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Fonts")
+	TObjectPtr<const UFont> CodeFont;
+
+	/** Scales every font, e.g. to fit the same document on a smaller sign. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Fonts", meta = (ClampMin = "0.1"))
+	float FontScale = 1.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Colors")
+	FLinearColor BackgroundColor = FLinearColor(0.02f, 0.02f, 0.02f);
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Colors")
+	FLinearColor TextColor = FLinearColor(0.85f, 0.85f, 0.85f);
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Colors")
+	FLinearColor HeadingColor = FLinearColor::White;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Colors")
+	FLinearColor LinkColor = FLinearColor(0.3f, 0.6f, 1.0f);
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Colors")
+	FLinearColor CodeColor = FLinearColor(0.9f, 0.75f, 0.5f);
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Colors")
+	FLinearColor CodeBackgroundColor = FLinearColor(0.08f, 0.08f, 0.08f);
+
+	/** Space around the document, in pixels. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Layout", meta = (ClampMin = "0"))
+	float Padding = 16.0f;
+
+	/** Space between blocks, as a fraction of the line height. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Layout", meta = (ClampMin = "0"))
+	float BlockSpacing = 0.5f;
+};
+
+MARKDOWNASSET_API uint32 GetTypeHash(const FMarkdownRenderStyle& Style);
+
+/** A run of text placed by FMarkdownLayout, in pixels from the top left of the page. */
+struct FMarkdownLayoutText
+{
+	FVector2D Position;
+	FString Text;
+	const UFont* Font = nullptr;
+	FLinearColor Color;
+	float Scale = 1.0f;
+};
+
+/** A filled rectangle placed by FMarkdownLayout, e.g. a code block background or a horizontal rule. */
+struct FMarkdownLayoutBox
+{
+	FVector2D Position;
+	FVector2D Size;
+	FLinearColor Color;
+};
+
+/**
+ * A document laid out for drawing without the web viewer, i.e. at runtime.
+ *
+ * Covers the common subset of markdown: headings, paragraphs, lists, quotes, rules and fenced code, with bold,
+ * italic, code spans and links inside text. Anything else is drawn as plain text. Fonts are measured, so this must
+ * run on the game thread.
+ */
+struct MARKDOWNASSET_API FMarkdownLayout
+{
+	/** Drawn first, under the text. */
+	TArray<FMarkdownLayoutBox> Boxes;
+	TArray<FMarkdownLayoutText> Texts;
+
+	/** Height of the laid out document, which may be more than the height it was clipped to. */
+	float Height = 0.0f;
+
+	/** Lays out the text to fit the width, stopping once it runs past MaxHeight. */
+	static FMarkdownLayout Build(FStringView Markdown, float Width, float MaxHeight, const FMarkdownRenderStyle& Style);
+};
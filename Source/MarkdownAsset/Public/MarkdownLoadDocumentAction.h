@@ -0,0 +1,47 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "Kismet/BlueprintAsyncActionBase.h"
+#include "MarkdownDocument.h"
+#include "UObject/SoftObjectPtr.h"
+
+#include "MarkdownLoadDocumentAction.generated.h"
+
+class UMarkdownAsset;
+struct FStreamableHandle;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnMarkdownDocumentLoadedPin, const FString&, Title, const FString&, Text, const TArray<FString>&, Sections);
+
+/** Blueprint node loading a document in the background, see UMarkdownAsset::LoadDocumentAsync. */
+UCLASS()
+class MARKDOWNASSET_API UMarkdownLoadDocumentAction : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+
+public:
+
+	/**
+	 * Loads and parses a document without blocking the game, e.g. to open a help page mid-gameplay.
+	 * When Section is set, Text is only that section of the document (a heading title or anchor).
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Markdown", meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"))
+	static UMarkdownLoadDocumentAction* LoadMarkdownDocument(UObject* WorldContextObject, TSoftObjectPtr<UMarkdownAsset> Document, const FString& Section);
+
+	/** Called with the document title, its text and the titles of its sections. */
+	UPROPERTY(BlueprintAssignable)
+	FOnMarkdownDocumentLoadedPin Loaded;
+
+	UPROPERTY(BlueprintAssignable)
+	FOnMarkdownDocumentLoadedPin Failed;
+
+	virtual void Activate() override;
+
+private:
+
+	void OnDocumentLoaded(TSharedPtr<const FMarkdownDocument> Document);
+
+	FSoftObjectPath Path;
+	FString Section;
+	TSharedPtr<FStreamableHandle> Handle;
+};
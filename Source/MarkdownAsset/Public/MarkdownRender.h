@@ -0,0 +1,33 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "Containers/UnrealString.h"
+
+class FMarkdownSyntaxTree;
+
+/**
+ * Renders a parsed document to the formats used outside the web viewer. Each backend is a visitor compiled into its
+ * own tree walk and appends to a single preallocated string, so nothing is allocated per node.
+ */
+namespace MarkdownRender
+{
+	/**
+	 * HTML fragment for export and generated sites. Headings get the ids the viewer gives them, and links and images
+	 * with a URL the viewer refuses (javascript:, vbscript:, file: and data: other than images) are left as text.
+	 */
+	MARKDOWNASSET_API FString ToHtml(const FMarkdownSyntaxTree& Tree);
+
+	/** The readable text without markup, one block per line, e.g. for search indexing. */
+	MARKDOWNASSET_API FString ToPlainText(const FMarkdownSyntaxTree& Tree);
+
+	/**
+	 * Markup for SRichTextBlock. Text is tagged with the style names "h1" to "h6", "bold", "italic", "bolditalic",
+	 * "strike" and "code", which the text style set has to provide. Links are <a id="link" href="..."> for a
+	 * hyperlink decorator.
+	 */
+	MARKDOWNASSET_API FString ToRichText(const FMarkdownSyntaxTree& Tree);
+
+	/** The tree as nested JSON objects, { "type": "heading", "line": 1, "level": 2, "children": [ ... ] }. */
+	MARKDOWNASSET_API FString ToJson(const FMarkdownSyntaxTree& Tree);
+}
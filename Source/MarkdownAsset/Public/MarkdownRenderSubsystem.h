@@ -0,0 +1,82 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "MarkdownLayout.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Tickable.h"
+
+#include "MarkdownRenderSubsystem.generated.h"
+
+class UMarkdownAsset;
+class UTextureRenderTarget2D;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnMarkdownRendered, UMarkdownAsset*, Document, UTextureRenderTarget2D*, Target);
+
+/** A document waiting to be drawn, see UMarkdownRenderSubsystem. */
+USTRUCT()
+struct FMarkdownRenderJob
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TObjectPtr<UMarkdownAsset> Document;
+
+	UPROPERTY()
+	TObjectPtr<UTextureRenderTarget2D> Target;
+
+	UPROPERTY()
+	FMarkdownRenderStyle Style;
+
+	uint32 Key = 0;
+};
+
+/**
+ * Draws documents into render targets, for in-world signs, tutorial panels and UI atlases.
+ *
+ * Documents are laid out natively (see FMarkdownLayout) and drawn with a canvas, so this works in cooked games
+ * without the web viewer. Requests for the same document, size and style share one render target. Drawing is
+ * queued and spread across frames, each frame draws documents until Markdown.Render.BudgetMs is spent, so many
+ * signs appearing at once do not cause a hitch.
+ */
+UCLASS()
+class MARKDOWNASSET_API UMarkdownRenderSubsystem : public UGameInstanceSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Deinitialize() override;
+
+	/**
+	 * Returns a render target showing the document. A new target is cleared to the background color until it is
+	 * drawn, OnRendered is broadcast then. Returns null on platforms that cannot render, e.g. dedicated servers.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Markdown|Render")
+	UTextureRenderTarget2D* Render(UMarkdownAsset* Document, int32 Width, int32 Height, const FMarkdownRenderStyle& Style);
+
+	UPROPERTY(BlueprintAssignable, Category = "Markdown|Render")
+	FOnMarkdownRendered OnRendered;
+
+	//~ Begin FTickableGameObject Interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual bool IsTickable() const override { return !Pending.IsEmpty(); }
+	virtual bool IsTickableWhenPaused() const override { return true; }
+	//~ End FTickableGameObject Interface
+
+private:
+
+	void Draw(const FMarkdownRenderJob& Job);
+	void Touch(uint32 Key);
+
+	UPROPERTY(Transient)
+	TArray<FMarkdownRenderJob> Pending;
+
+	UPROPERTY(Transient)
+	TMap<uint32, TObjectPtr<UTextureRenderTarget2D>> Cache;
+
+	/** Cache keys, least recently requested first. */
+	TArray<uint32> CacheOrder;
+};
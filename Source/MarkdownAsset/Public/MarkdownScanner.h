@@ -0,0 +1,108 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "Containers/Array.h"
+#include "Containers/Set.h"
+#include "Containers/StringView.h"
+#include "Containers/UnrealString.h"
+#include "Templates/Function.h"
+
+/**
+ * A reference to an engine object inside the markdown text, i.e. the quoted part of
+ * "/Script/Engine.Blueprint'/Game/Foo/Bar.Bar'". Offsets are into the scanned text.
+ */
+struct FMarkdownAssetLinkRef
+{
+	int32 PathStart = 0;
+	int32 PathLen = 0;
+};
+
+/** A fenced code block ("```info ... ```"). Offsets are into the scanned text. */
+struct FMarkdownFenceRef
+{
+	/** The whole block, from the opening fence to the end of the closing fence line. */
+	int32 Start = 0;
+	int32 Len = 0;
+
+	/** The info string following the opening fence, trimmed. */
+	int32 InfoStart = 0;
+	int32 InfoLen = 0;
+
+	/** The lines between the fences. */
+	int32 BodyStart = 0;
+	int32 BodyLen = 0;
+};
+
+enum class EMarkdownLinkKind : uint8
+{
+	/** A copied reference, "/Script/Engine.Blueprint'/Game/Foo/Bar.Bar'". The span is the quoted object path. */
+	Asset,
+
+	/** A bare content path, "/Game/Foo/Bar". */
+	ContentPath,
+
+	/** An absolute URL, "https://example.com/page". */
+	Url,
+};
+
+/** A link found by FindLinks. Offsets are into the scanned text. */
+struct FMarkdownLinkSpan
+{
+	int32 Start = 0;
+	int32 Len = 0;
+
+	/** One based line number. */
+	int32 Line = 0;
+
+	EMarkdownLinkKind Kind = EMarkdownLinkKind::Asset;
+};
+
+namespace MarkdownScanner
+{
+	/** Finds every "/Script ... '<path>'" link in the text, matching the rules used by the viewer. */
+	MARKDOWNASSET_API void FindAssetLinks(FStringView Text, TArray<FMarkdownAssetLinkRef>& OutLinks);
+
+	/**
+	 * Finds the asset references, content paths and URLs in the text, skipping fenced code blocks and inline code.
+	 *
+	 * The text is searched 16 characters at a time for the few characters a link or code block can start at, so
+	 * only those positions are looked at. Meant for bulk processing, e.g. listing the links of every document.
+	 */
+	MARKDOWNASSET_API void FindLinks(FStringView Text, TArray<FMarkdownLinkSpan>& OutLinks);
+
+	/** Returns the unique object paths referenced by the text, leaving out the ones in code blocks and inline code. */
+	MARKDOWNASSET_API void ExtractAssetLinks(FStringView Text, TArray<FString>& OutPaths);
+
+	/**
+	 * Calls Rewrite for each linked path outside of code, replacing it in place when the callback returns true.
+	 * Returns true if the text was modified.
+	 */
+	MARKDOWNASSET_API bool RewriteAssetLinks(FString& Text, TFunctionRef<bool(FStringView Path, FString& OutNewPath)> Rewrite);
+
+	/** Finds the fenced code blocks of the document. An unclosed fence runs to the end of the text. */
+	MARKDOWNASSET_API void FindFencedBlocks(FStringView Text, TArray<FMarkdownFenceRef>& OutFences);
+
+	/**
+	 * Returns the anchor the viewer (markdown-it-anchor) generates for a heading: the title trimmed, lower case,
+	 * whitespace runs replaced by '-' and URI encoded. Title is the rendered text, see FMarkdownSyntaxTree::GetInlineText.
+	 * Repeated titles get numbered anchors, see FMarkdownHeadingAnchors.
+	 */
+	MARKDOWNASSET_API FString MakeHeadingAnchor(FStringView Title);
+}
+
+/**
+ * Gives the headings of a document their anchors in document order, numbering repeated ones the way the viewer does
+ * ("title", "title-1", "title-2").
+ */
+class MARKDOWNASSET_API FMarkdownHeadingAnchors
+{
+public:
+
+	/** Returns the anchor of the next heading, Title being its rendered text. */
+	FString Add(FStringView Title);
+
+private:
+
+	TSet<FString> Used;
+};
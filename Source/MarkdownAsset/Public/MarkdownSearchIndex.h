@@ -0,0 +1,81 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "Containers/Array.h"
+#include "Containers/ArrayView.h"
+#include "Containers/StringView.h"
+#include "Containers/UnrealString.h"
+#include "Templates/UniquePtr.h"
+#include "UObject/SoftObjectPath.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/** A document matching a search, see FMarkdownSearchIndex::Search. */
+struct FMarkdownSearchHit
+{
+	int32 Document = INDEX_NONE;
+	float Score = 0.0f;
+};
+
+/**
+ * Full text index of the documents shipped with the game, built at cook time and memory mapped at runtime.
+ *
+ * The file holds a sorted term dictionary and, for each term, the documents it appears in as delta and varint
+ * encoded postings. Queries binary search the dictionary and walk the postings in place, ranking documents with
+ * BM25, so a search touches only the postings of the query terms and never allocates. Scores are accumulated in
+ * scratch buffers owned by the index, so searches must not run on several threads at once.
+ */
+class MARKDOWNASSET_API FMarkdownSearchIndex
+{
+public:
+
+	struct FDocument
+	{
+		FSoftObjectPath Path;
+		FString Title;
+		FString Text;
+	};
+
+	FMarkdownSearchIndex();
+	~FMarkdownSearchIndex();
+
+	/** Where the pack commandlet writes the index, next to the documentation archive. */
+	static FString GetDefaultPath();
+
+	/** Builds the index file for the documents. */
+	static bool Write(const FString& FilePath, const TArray<FDocument>& Documents);
+
+	bool Open(const FString& FilePath);
+	void Close();
+
+	bool IsOpen() const { return !Data.IsEmpty(); }
+	int32 GetNumDocuments() const;
+
+	/** Finds the best matches for the query terms, best first. Returns the number of hits written. */
+	int32 Search(FStringView Query, TArrayView<FMarkdownSearchHit> OutHits) const;
+
+	/** Documents are stored as UTF-8, these convert on demand. */
+	FSoftObjectPath GetDocumentPath(int32 Document) const;
+	FString GetDocumentTitle(int32 Document) const;
+
+private:
+
+	bool Validate() const;
+
+	/** Accumulates the BM25 contribution of one query term, once however often the query repeats it. */
+	void ScoreTerm(FStringView Term) const;
+
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+
+	/** Used when the platform cannot map the file, e.g. from a compressed pak. */
+	TArray<uint8> Buffer;
+
+	TArrayView<const uint8> Data;
+
+	mutable TArray<float> Scores;
+	mutable TArray<int32> Touched;
+	mutable TArray<int32, TInlineAllocator<16>> ScoredTerms;
+};
@@ -0,0 +1,63 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "MarkdownSearchIndex.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+
+#include "MarkdownSearchSubsystem.generated.h"
+
+USTRUCT(BlueprintType)
+struct MARKDOWNASSET_API FMarkdownSearchResult
+{
+	GENERATED_BODY()
+
+	/** The matching document, read it with FMarkdownArchive when it was packed or load it when it was cooked. */
+	UPROPERTY(BlueprintReadOnly, Category = "Markdown|Search")
+	FSoftObjectPath Document;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Markdown|Search")
+	FString Title;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Markdown|Search")
+	float Score = 0.0f;
+};
+
+/**
+ * Full text search over the documents shipped with the game, e.g. for an in-game help browser.
+ *
+ * Queries the index written by the MarkdownPackArchive commandlet, see FMarkdownSearchIndex. C++ callers that search
+ * as the player types can use GetIndex() directly with a fixed hit buffer, which does not allocate, and IsShipped()
+ * to skip hits on documents the game was packaged without.
+ */
+UCLASS()
+class MARKDOWNASSET_API UMarkdownSearchSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/** Returns the documents best matching the words of the query, best first. */
+	UFUNCTION(BlueprintCallable, Category = "Markdown|Search")
+	TArray<FMarkdownSearchResult> Search(const FString& Query, int32 MaxResults = 10) const;
+
+	/** False when the game was packaged without a search index. */
+	UFUNCTION(BlueprintPure, Category = "Markdown|Search")
+	bool IsAvailable() const { return Index.IsOpen(); }
+
+	const FMarkdownSearchIndex& GetIndex() const { return Index; }
+
+	/** False for an index document that is neither packed nor cooked, e.g. with an index older than the cook. */
+	bool IsShipped(int32 Document) const { return Shipped.IsValidIndex(Document) && Shipped[Document]; }
+
+private:
+
+	FMarkdownSearchIndex Index;
+
+	/** By index document, checked once when the index is opened. */
+	TBitArray<> Shipped;
+	int32 NumNotShipped = 0;
+};
@@ -0,0 +1,189 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "Containers/Array.h"
+#include "Containers/StringView.h"
+#include "Containers/UnrealString.h"
+#include "Misc/EnumClassFlags.h"
+
+enum class EMarkdownNodeType : uint8
+{
+	/** The root, always the first node. */
+	Document,
+
+	/** Level is 1 to 6. The span is the heading line (or lines, for underlined headings), the argument the title. */
+	Heading,
+
+	Paragraph,
+
+	/** The argument is the number of the first item of an ordered list. */
+	List,
+
+	/** The text on the marker line is held directly, anything after it (nested lists, paragraphs) as blocks. */
+	ListItem,
+
+	Quote,
+
+	/** The argument is the info string of a fenced block. The lines of code are Text children separated by breaks. */
+	CodeBlock,
+
+	Rule,
+
+	/** Level is the number of columns given by the delimiter row. */
+	Table,
+
+	TableRow,
+
+	/** The span is the trimmed cell text. */
+	TableCell,
+
+	/** The span is the literal text, escapes already removed. */
+	Text,
+
+	/** The span is the code, without the backticks. */
+	Code,
+
+	Emphasis,
+	Strong,
+	Strikethrough,
+
+	/** The argument is the link target. */
+	Link,
+
+	/** The span is the alt text, the argument the image source. Images have no children. */
+	Image,
+
+	/** A line break inside a block, see EMarkdownNodeFlags::HardBreak. */
+	Break,
+};
+
+MARKDOWNASSET_API const TCHAR* LexToString(EMarkdownNodeType Type);
+
+enum class EMarkdownNodeFlags : uint8
+{
+	None = 0,
+
+	/** List */
+	Ordered = 1 << 0,
+
+	/** CodeBlock, the closing fence is missing so the block runs to the end of the document. */
+	Unclosed = 1 << 1,
+
+	/** CodeBlock, indented by four spaces rather than fenced. */
+	Indented = 1 << 2,
+
+	/** Heading, underlined with '=' or '-' rather than starting with '#'. */
+	Underlined = 1 << 3,
+
+	/** TableRow */
+	Header = 1 << 4,
+
+	/** TableCell, both are set for centered columns. */
+	AlignLeft = 1 << 5,
+	AlignRight = 1 << 6,
+
+	/** Break, ends the line when rendered rather than being a space. */
+	HardBreak = 1 << 7,
+};
+
+ENUM_CLASS_FLAGS(EMarkdownNodeFlags);
+
+/**
+ * A node of FMarkdownSyntaxTree. Nodes hold no strings, text is referenced by offsets into the parsed text.
+ *
+ * Nodes are stored depth first, so the children of a node follow it directly and its whole subtree is the
+ * NumDescendants nodes after it.
+ */
+struct FMarkdownNode
+{
+	EMarkdownNodeType Type = EMarkdownNodeType::Document;
+	EMarkdownNodeFlags Flags = EMarkdownNodeFlags::None;
+	uint8 Level = 0;
+
+	int32 NumDescendants = 0;
+
+	/** One based line number of the start of the node. */
+	int32 Line = 0;
+
+	/** The source text of the node, see EMarkdownNodeType for the nodes where it is something else. */
+	int32 Start = 0;
+	int32 Len = 0;
+
+	/** Link target, image source, info string, etc. See EMarkdownNodeType. */
+	int32 ArgStart = 0;
+	int32 ArgLen = 0;
+
+	bool HasChildren() const { return NumDescendants > 0; }
+};
+
+/**
+ * A markdown document parsed into one flat array of nodes, to be rendered by any number of backends without each of
+ * them parsing the text again, see MarkdownRender.
+ *
+ * Covers CommonMark blocks (ATX and underlined headings, paragraphs, nested lists, quotes, fenced and indented code,
+ * rules) and GitHub tables, with emphasis, strong, strikethrough, code spans, links, autolinks and images inline.
+ * HTML blocks and reference links are kept as text.
+ */
+class MARKDOWNASSET_API FMarkdownSyntaxTree
+{
+public:
+
+	static FMarkdownSyntaxTree Parse(FString Text);
+
+	const FString& GetText() const { return Text; }
+	const TArray<FMarkdownNode>& GetNodes() const { return Nodes; }
+	const FMarkdownNode& GetRoot() const { return Nodes[0]; }
+
+	FStringView GetSpan(const FMarkdownNode& Node) const { return FStringView(Text).Mid(Node.Start, Node.Len); }
+	FStringView GetArg(const FMarkdownNode& Node) const { return FStringView(Text).Mid(Node.ArgStart, Node.ArgLen); }
+
+	/** The text and code below the node without any markup, images or line breaks, e.g. "Bold title" for "**Bold** title". */
+	FString GetInlineText(const FMarkdownNode& Node) const;
+
+	/**
+	 * Visits the nodes depth first, calling Visitor.Enter(Node) before the children of a node and Visitor.Leave(Node)
+	 * after them. The children are skipped when Enter returns false. The visitor is called directly, so backends are
+	 * compiled for the tree walk rather than called through virtual functions for every node.
+	 */
+	template <typename TVisitor>
+	void Walk(TVisitor& Visitor) const
+	{
+		WalkNode(0, Visitor);
+	}
+
+	/** Calls Visit(Node) for each child of the node, which must be one of the nodes of this tree. */
+	template <typename TVisit>
+	void ForEachChild(const FMarkdownNode& Parent, TVisit Visit) const
+	{
+		const int32 End = int32(&Parent - Nodes.GetData()) + 1 + Parent.NumDescendants;
+
+		for (int32 Child = int32(&Parent - Nodes.GetData()) + 1; Child < End; Child += 1 + Nodes[Child].NumDescendants)
+		{
+			Visit(Nodes[Child]);
+		}
+	}
+
+private:
+
+	template <typename TVisitor>
+	void WalkNode(int32 Index, TVisitor& Visitor) const
+	{
+		const FMarkdownNode& Node = Nodes[Index];
+
+		if (Visitor.Enter(Node))
+		{
+			const int32 End = Index + 1 + Node.NumDescendants;
+
+			for (int32 Child = Index + 1; Child < End; Child += 1 + Nodes[Child].NumDescendants)
+			{
+				WalkNode(Child, Visitor);
+			}
+		}
+
+		Visitor.Leave(Node);
+	}
+
+	FString Text;
+	TArray<FMarkdownNode> Nodes;
+};
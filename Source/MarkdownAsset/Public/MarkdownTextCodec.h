@@ -0,0 +1,58 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "Containers/Array.h"
+#include "Containers/ArrayView.h"
+#include "Containers/StringView.h"
+#include "Containers/UnrealString.h"
+
+enum class EMarkdownTextEncoding : uint8
+{
+	Utf8,
+	Utf16LE,
+	Utf16BE,
+
+	/** Bytes that are not valid UTF-8, read one character per byte so they are written back unchanged. */
+	Latin1,
+};
+
+/** How a markdown file is stored on disk, kept so saving it does not change anything but the edited text. */
+struct FMarkdownTextFormat
+{
+	EMarkdownTextEncoding Encoding = EMarkdownTextEncoding::Utf8;
+	bool bByteOrderMark = false;
+};
+
+/**
+ * Reads and writes markdown text. Unlike FFileHelper, files are written back in the encoding they were read in and
+ * new files are UTF-8 without a byte order mark, so reading and writing a file leaves it byte for byte the same.
+ *
+ * Runs of ASCII, i.e. most of any markdown document, are validated and converted 16 or 32 bytes at a time with
+ * SSE2, AVX2 or NEON, the rest is decoded one character at a time with full validation.
+ */
+namespace MarkdownTextCodec
+{
+	/** True if the bytes are well formed UTF-8 (no overlong forms, surrogates or code points past U+10FFFF). */
+	MARKDOWNASSET_API bool IsValidUtf8(TArrayView<const uint8> Bytes);
+
+	/** Decodes UTF-8 without a byte order mark. Returns false, leaving OutText undefined, if the bytes are not valid. */
+	MARKDOWNASSET_API bool DecodeUtf8(TArrayView<const uint8> Bytes, FString& OutText);
+
+	/** Encodes the text as UTF-8 without a byte order mark. Unpaired surrogates are written as U+FFFD. */
+	MARKDOWNASSET_API void EncodeUtf8(FStringView Text, TArray<uint8>& OutBytes);
+
+	/** Works out the encoding of the bytes from their byte order mark, or whether they are valid UTF-8 without one. */
+	MARKDOWNASSET_API FMarkdownTextFormat DetectFormat(TArrayView<const uint8> Bytes);
+
+	/** Decodes bytes in any of the supported encodings. */
+	MARKDOWNASSET_API void Decode(TArrayView<const uint8> Bytes, FString& OutText, FMarkdownTextFormat* OutFormat = nullptr);
+
+	/** Encodes the text in the format. Latin-1 text that no longer fits in Latin-1 is written as UTF-8 instead. */
+	MARKDOWNASSET_API void Encode(FStringView Text, const FMarkdownTextFormat& Format, TArray<uint8>& OutBytes);
+
+	MARKDOWNASSET_API bool LoadFile(const FString& FilePath, FString& OutText, FMarkdownTextFormat* OutFormat = nullptr);
+
+	/** Writes the text in the format of the existing file, or as UTF-8. A file that would not change is left alone. */
+	MARKDOWNASSET_API bool SaveFile(const FString& FilePath, FStringView Text);
+}
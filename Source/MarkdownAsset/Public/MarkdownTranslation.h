@@ -0,0 +1,75 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "Containers/Map.h"
+#include "Containers/StringView.h"
+#include "UObject/Object.h"
+#include "UObject/SoftObjectPtr.h"
+
+#include "MarkdownTranslation.generated.h"
+
+class UMarkdownAsset;
+
+/** A block of a document, the unit of translation. Offsets are into the source text. */
+struct FMarkdownTranslationBlock
+{
+	int32 Start = 0;
+	int32 Len = 0;
+
+	/** Hash of the block text, translations are stored against it. */
+	uint32 Hash = 0;
+};
+
+/**
+ * The translation of a document into one culture, see UMarkdownAsset::Translations.
+ *
+ * Documents are translated block by block (paragraphs, headings, list items, code blocks, ...) and each translated
+ * block is stored against the hash of its source text. Blocks nobody translated, e.g. code, are not stored at all,
+ * and editing the source only leaves the edited blocks without a translation, the rest still match. Each culture
+ * is its own asset, so only the cultures that are used are loaded.
+ */
+UCLASS(BlueprintType)
+class MARKDOWNASSET_API UMarkdownTranslation : public UObject
+{
+	GENERATED_BODY()
+
+public:
+
+	/** The document this translates. */
+	UPROPERTY(VisibleAnywhere, Category = "Translation")
+	TSoftObjectPtr<UMarkdownAsset> Source;
+
+	UPROPERTY(VisibleAnywhere, AssetRegistrySearchable, Category = "Translation")
+	FString Culture;
+
+	/** Translated text by source block hash. */
+	UPROPERTY()
+	TMap<uint32, FString> Blocks;
+
+#if WITH_EDITORONLY_DATA
+	/** The source text each block was translated from, so translators can see what changed. Not cooked. */
+	UPROPERTY()
+	TMap<uint32, FString> SourceBlocks;
+#endif
+
+	/**
+	 * Splits a document into blocks: runs of non blank lines, broken before each heading and list item. A heading is
+	 * always a block of its own and a fenced code block is always one block. Hashes ignore carriage returns.
+	 */
+	static void SplitBlocks(FStringView Text, TArray<FMarkdownTranslationBlock>& OutBlocks);
+
+	/** Returns the source text with each translated block replaced, untranslated blocks are kept as they are. */
+	FString Translate(FStringView SourceText) const;
+
+	/** Returns the blocks of the source that have no translation, e.g. because they were edited since. */
+	void GetUntranslatedBlocks(FStringView SourceText, TArray<FMarkdownTranslationBlock>& OutBlocks) const;
+
+#if WITH_EDITOR
+	/** Stores the translation of a source block. */
+	void SetBlock(FStringView SourceBlock, FString Translation);
+
+	/** Removes the translations of blocks that are no longer in the source. Returns the number removed. */
+	int32 RemoveUnusedBlocks(FStringView SourceText);
+#endif
+};
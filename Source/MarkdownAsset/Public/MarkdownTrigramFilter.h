@@ -0,0 +1,40 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "Containers/Array.h"
+#include "Containers/StringView.h"
+#include "Containers/UnrealString.h"
+
+/**
+ * Bloom filter over the lower case character trigrams of a document.
+ *
+ * Stored as an asset registry tag so text searches can skip documents that cannot contain the search string
+ * without loading them. False positives are possible, false negatives are not: any substring of three or more
+ * characters that occurs in the text has all of its trigrams in the filter.
+ */
+class MARKDOWNASSET_API FMarkdownTrigramFilter
+{
+public:
+
+	/** Builds a filter sized for the number of unique trigrams in the text. */
+	static FMarkdownTrigramFilter FromText(FStringView Text);
+
+	/** Parses a filter written by ToString(), returns false if the string is not a valid filter. */
+	static bool FromString(FStringView String, FMarkdownTrigramFilter& OutFilter);
+
+	FString ToString() const;
+
+	bool IsValid() const { return !Bits.IsEmpty(); }
+
+	/** Returns false if the text can not contain the given string (case insensitive). Strings under three characters always pass. */
+	bool MayContain(FStringView String) const;
+
+private:
+
+	void AddTrigram(uint64 Trigram);
+	bool MayContainTrigram(uint64 Trigram) const;
+
+	TArray<uint64> Bits;
+	uint64 BitMask = 0;
+};
@@ -23,13 +23,21 @@ public class MarkdownAssetEditor : ModuleRules
         });
 
         PrivateDependencyModuleNames.AddRange( new string[] {
+            "AssetRegistry",
+            "AssetSearch",
             "ContentBrowser",
             "Core",
             "CoreUObject",
+            "DataValidation",
             "DesktopWidgets",
+            "DirectoryWatcher",
             "EditorStyle",
             "Engine",
+            "ImageCore",
+            "ImageWrapper",
             "InputCore",
+            "Json",
+            "MessageLog",
             "Projects",
             "Slate",
             "SlateCore",
@@ -40,6 +48,7 @@ public class MarkdownAssetEditor : ModuleRules
             "ToolMenus",
             "AssetDefinition",
             "HTTP",
+            "WorkspaceMenuStructure",
         });
 
         PrivateIncludePathModuleNames.AddRange( new string[] {
@@ -6,6 +6,8 @@
 #include "DesktopPlatformModule.h"
 #include "MarkdownAsset.h"
 #include "MarkdownAssetEditorToolkit.h"
+#include "MarkdownTextCodec.h"
+#include "HelperFunctions/MarkdownAssetEditorStatics.h"
 #include "Icons/Icons.h"
 
 #define LOCTEXT_NAMESPACE "AssetTypeActions"
@@ -14,6 +16,11 @@ namespace MarkdownMenuNames
 {
 	const FName MenuCustomActionsSectionName = TEXT("Markdown");
 	const FName ExportAsMDActionName = TEXT("ExportAsMDFile");
+	const FName ValidateLinksActionName = TEXT("ValidateLinks");
+	const FName LintActionName = TEXT("Lint");
+	const FName ReportTranslationsActionName = TEXT("ReportTranslations");
+	const FName FormatActionName = TEXT("Format");
+	const FName FormatFolderActionName = TEXT("FormatMarkdownFolder");
 }
 
 TSoftClassPtr<UObject> UAssetDefinition_MarkdownAsset::GetAssetClass() const
@@ -96,13 +103,45 @@ namespace MenuExtension_MarkdownAsset
 
 					if (OutFilenames.Num() > 0)
 					{
-						FFileHelper::SaveStringToFile(MarkdownAsset->Text.ToString(), *OutFilenames[0]);
+						MarkdownTextCodec::SaveFile(OutFilenames[0], MarkdownAsset->Text.ToString());
 					}
 				}
 			}
 		}
 	}
 
+	void ExecuteValidateLinks(const FToolMenuContext& InContext)
+	{
+		const UContentBrowserAssetContextMenuContext* Context = UContentBrowserAssetContextMenuContext::FindContextWithAssets(InContext);
+		MarkdownAssetStatics::ValidateDocumentLinks(Context->LoadSelectedObjects<UMarkdownAsset>());
+	}
+
+	void ExecuteLint(const FToolMenuContext& InContext)
+	{
+		const UContentBrowserAssetContextMenuContext* Context = UContentBrowserAssetContextMenuContext::FindContextWithAssets(InContext);
+		MarkdownAssetStatics::LintDocuments(Context->LoadSelectedObjects<UMarkdownAsset>());
+	}
+
+	void ExecuteReportTranslations(const FToolMenuContext& InContext)
+	{
+		const UContentBrowserAssetContextMenuContext* Context = UContentBrowserAssetContextMenuContext::FindContextWithAssets(InContext);
+		MarkdownAssetStatics::ReportUntranslatedBlocks(Context->LoadSelectedObjects<UMarkdownAsset>());
+	}
+
+	void ExecuteFormat(const FToolMenuContext& InContext)
+	{
+		const UContentBrowserAssetContextMenuContext* Context = UContentBrowserAssetContextMenuContext::FindContextWithAssets(InContext);
+		MarkdownAssetStatics::FormatDocuments(Context->LoadSelectedObjects<UMarkdownAsset>());
+	}
+
+	void ExecuteFormatFolder(const FToolMenuContext& InContext)
+	{
+		if (const UContentBrowserFolderContext* Context = InContext.FindContext<UContentBrowserFolderContext>())
+		{
+			MarkdownAssetStatics::FormatFolders(Context->GetSelectedPackagePaths());
+		}
+	}
+
 	static FDelayedAutoRegisterHelper DelayedAutoRegister(EDelayedRegisterRunPhase::EndOfEngineInit, []{ 
 		UToolMenus::RegisterStartupCallback(FSimpleMulticastDelegate::FDelegate::CreateLambda([]()
 		{
@@ -122,6 +161,66 @@ namespace MenuExtension_MarkdownAsset
 					InSection.AddMenuEntry("MarkdownAsset_ExportAsMD", Label, ToolTip, Icon, UIAction);
 				}
 			}));
+			Section.AddDynamicEntry(MarkdownMenuNames::ValidateLinksActionName, FNewToolMenuSectionDelegate::CreateLambda([](FToolMenuSection& InSection)
+			{
+				{
+					const TAttribute<FText> Label = LOCTEXT("MarkdownAsset_ValidateLinks", "Validate Links");
+					const TAttribute<FText> ToolTip = LOCTEXT("MarkdownAsset_ValidateLinksTooltip", "Check that every asset link in the selected documents still points at an existing asset.");
+					const FSlateIcon Icon = MarkdownIcons::DocumentationIcon;
+
+					FToolUIAction UIAction = FToolMenuExecuteAction::CreateStatic(&ExecuteValidateLinks);
+					InSection.AddMenuEntry("MarkdownAsset_ValidateLinks", Label, ToolTip, Icon, UIAction);
+				}
+			}));
+			Section.AddDynamicEntry(MarkdownMenuNames::LintActionName, FNewToolMenuSectionDelegate::CreateLambda([](FToolMenuSection& InSection)
+			{
+				{
+					const TAttribute<FText> Label = LOCTEXT("MarkdownAsset_Lint", "Lint");
+					const TAttribute<FText> ToolTip = LOCTEXT("MarkdownAsset_LintTooltip", "Check the selected documents for skipped heading levels, malformed tables, unclosed code fences, large inline images and trailing whitespace.");
+					const FSlateIcon Icon = MarkdownIcons::DocumentationIcon;
+
+					FToolUIAction UIAction = FToolMenuExecuteAction::CreateStatic(&ExecuteLint);
+					InSection.AddMenuEntry("MarkdownAsset_Lint", Label, ToolTip, Icon, UIAction);
+				}
+			}));
+			Section.AddDynamicEntry(MarkdownMenuNames::ReportTranslationsActionName, FNewToolMenuSectionDelegate::CreateLambda([](FToolMenuSection& InSection)
+			{
+				{
+					const TAttribute<FText> Label = LOCTEXT("MarkdownAsset_ReportTranslations", "Check Translations");
+					const TAttribute<FText> ToolTip = LOCTEXT("MarkdownAsset_ReportTranslationsTooltip", "List the blocks of the selected documents that were added or edited since they were translated.");
+					const FSlateIcon Icon = MarkdownIcons::DocumentationIcon;
+
+					FToolUIAction UIAction = FToolMenuExecuteAction::CreateStatic(&ExecuteReportTranslations);
+					InSection.AddMenuEntry("MarkdownAsset_ReportTranslations", Label, ToolTip, Icon, UIAction);
+				}
+			}));
+			Section.AddDynamicEntry(MarkdownMenuNames::FormatActionName, FNewToolMenuSectionDelegate::CreateLambda([](FToolMenuSection& InSection)
+			{
+				{
+					const TAttribute<FText> Label = LOCTEXT("MarkdownAsset_Format", "Format");
+					const TAttribute<FText> ToolTip = LOCTEXT("MarkdownAsset_FormatTooltip", "Align tables, normalize lists and headings and remove trailing whitespace in the selected documents.");
+					const FSlateIcon Icon = MarkdownIcons::DocumentationIcon;
+
+					FToolUIAction UIAction = FToolMenuExecuteAction::CreateStatic(&ExecuteFormat);
+					InSection.AddMenuEntry("MarkdownAsset_Format", Label, ToolTip, Icon, UIAction);
+				}
+			}));
+
+			// whole folders are formatted from the folder menu, documents already formatted are skipped without loading
+			UToolMenu* FolderMenu = UToolMenus::Get()->ExtendMenu("ContentBrowser.FolderContextMenu");
+
+			FToolMenuSection& FolderSection = FolderMenu->FindOrAddSection(MarkdownMenuNames::MenuCustomActionsSectionName);
+			FolderSection.AddDynamicEntry(MarkdownMenuNames::FormatFolderActionName, FNewToolMenuSectionDelegate::CreateLambda([](FToolMenuSection& InSection)
+			{
+				{
+					const TAttribute<FText> Label = LOCTEXT("MarkdownAsset_FormatFolder", "Format Markdown Documents");
+					const TAttribute<FText> ToolTip = LOCTEXT("MarkdownAsset_FormatFolderTooltip", "Format every markdown document in the selected folders and their subfolders.");
+					const FSlateIcon Icon = MarkdownIcons::DocumentationIcon;
+
+					FToolUIAction UIAction = FToolMenuExecuteAction::CreateStatic(&ExecuteFormatFolder);
+					InSection.AddMenuEntry("MarkdownAsset_FormatFolder", Label, ToolTip, Icon, UIAction);
+				}
+			}));
 		}));
 	});
 }
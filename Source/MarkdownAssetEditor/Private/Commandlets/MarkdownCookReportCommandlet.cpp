@@ -0,0 +1,111 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Commandlets/MarkdownCookReportCommandlet.h"
+
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/AssetRegistryState.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "DeveloperSettings/MarkdownAssetDeveloperSettings.h"
+#include "HelperFunctions/MarkdownAssetEditorStatics.h"
+#include "LogChannels/MarkdownLogChannels.h"
+#include "MarkdownAsset.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace MarkdownCookReportCommandlet
+{
+	static EMarkdownCookPolicy GetCookPolicy(const FAssetData& Document)
+	{
+		FString Value;
+		if (!Document.GetTagValue(GET_MEMBER_NAME_CHECKED(UMarkdownAsset, CookPolicy), Value))
+		{
+			return EMarkdownCookPolicy::Default;
+		}
+
+		const int64 Policy = StaticEnum<EMarkdownCookPolicy>()->GetValueByNameString(Value);
+		return Policy == INDEX_NONE ? EMarkdownCookPolicy::Default : static_cast<EMarkdownCookPolicy>(Policy);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+UMarkdownCookReportCommandlet::UMarkdownCookReportCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UMarkdownCookReportCommandlet::Main(const FString& Params)
+{
+	FString OutputPath = FPaths::ProjectSavedDir() / TEXT("MarkdownAsset") / TEXT("CookReport.csv");
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+	FAssetRegistryState CookedRegistry;
+	FString CookedRegistryPath;
+	const bool bHasCookedRegistry = FParse::Value(*Params, TEXT("CookedRegistry="), CookedRegistryPath);
+
+	if (bHasCookedRegistry && !MarkdownAssetStatics::LoadCookedAssetRegistry(CookedRegistryPath, CookedRegistry))
+	{
+		UE_LOG(MarkdownStaticsLog, Error, TEXT("Could not read the cooked asset registry '%s'."), *CookedRegistryPath);
+		return 1;
+	}
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	AssetRegistry.SearchAllAssets(true);
+
+	TArray<FAssetData> Documents;
+	AssetRegistry.GetAssetsByClass(UMarkdownAsset::StaticClass()->GetClassPathName(), Documents, true);
+
+	const UMarkdownAssetDeveloperSettings* Settings = UMarkdownAssetDeveloperSettings::Get();
+	const UEnum* PolicyEnum = StaticEnum<EMarkdownCookPolicy>();
+
+	int32 NumStripped = 0;
+	int32 NumPacked = 0;
+	int32 NumUnreferenced = 0;
+	int64 StrippedBytes = 0;
+	int64 TotalBytes = 0;
+
+	TArray<FString> Lines;
+	Lines.Add(TEXT("Document,Policy,Packaging,Bytes"));
+
+	for (const FAssetData& Document : Documents)
+	{
+		const EMarkdownCookPolicy Policy = MarkdownCookReportCommandlet::GetCookPolicy(Document);
+		const EMarkdownCookPolicy Resolved = Settings->ResolveCookPolicy(Policy, Document.PackageName);
+
+		const TOptional<FAssetPackageData> PackageData = AssetRegistry.GetAssetPackageDataCopy(Document.PackageName);
+		const int64 Bytes = PackageData.IsSet() ? FMath::Max<int64>(PackageData->DiskSize, 0) : 0;
+
+		TotalBytes += Bytes;
+
+		// the Cook policy only lets the cooker take the document, it still has to be referenced by something it cooks
+		const bool bUnreferenced = Resolved == EMarkdownCookPolicy::Cook
+			&& !MarkdownAssetStatics::IsDocumentCooked(Document, AssetRegistry, bHasCookedRegistry ? &CookedRegistry : nullptr);
+
+		if (Resolved != EMarkdownCookPolicy::Cook || bUnreferenced)
+		{
+			++NumStripped;
+			NumPacked += Resolved == EMarkdownCookPolicy::Packed;
+			NumUnreferenced += bUnreferenced;
+			StrippedBytes += Bytes;
+		}
+
+		const FString Packaging = bUnreferenced ? TEXT("Unreferenced") : PolicyEnum->GetNameStringByValue(static_cast<int64>(Resolved));
+		Lines.Add(FString::Printf(TEXT("%s,%s,%s,%lld"), *Document.GetObjectPathString(), *PolicyEnum->GetNameStringByValue(static_cast<int64>(Policy)), *Packaging, Bytes));
+	}
+
+	if (!FFileHelper::SaveStringArrayToFile(Lines, *OutputPath))
+	{
+		UE_LOG(MarkdownStaticsLog, Error, TEXT("Could not write the markdown cook report to '%s'."), *OutputPath);
+		return 1;
+	}
+
+	UE_LOG(MarkdownStaticsLog, Display, TEXT("%d of %d markdown documents are not cooked (%d of them packed, %d not referenced), %s of %s stripped from cooked builds."),
+		NumStripped, Documents.Num(), NumPacked, NumUnreferenced, *FText::AsMemory(StrippedBytes).ToString(), *FText::AsMemory(TotalBytes).ToString());
+
+	UE_LOG(MarkdownStaticsLog, Display, TEXT("Markdown cook report written to '%s'."), *OutputPath);
+
+	return 0;
+}
@@ -0,0 +1,27 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "MarkdownCookReportCommandlet.generated.h"
+
+/**
+ * Reports which markdown documents are stripped from cooked builds and how many bytes that saves.
+ *
+ *     UnrealEditor-Cmd.exe MyGame.uproject -run=MarkdownCookReport [-Output=Path/To/Report.csv]
+ *
+ * Works from the asset registry alone, so it is cheap enough to run before every cook. The report lists every
+ * document with its policy, whether it ships and its package size; the totals are written to the log.
+ */
+UCLASS()
+class UMarkdownCookReportCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UMarkdownCookReportCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
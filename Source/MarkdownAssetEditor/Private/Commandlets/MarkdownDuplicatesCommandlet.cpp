@@ -0,0 +1,56 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Commandlets/MarkdownDuplicatesCommandlet.h"
+
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Duplicates/MarkdownDuplicateFinder.h"
+#include "LogChannels/MarkdownLogChannels.h"
+#include "MarkdownAsset.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+UMarkdownDuplicatesCommandlet::UMarkdownDuplicatesCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UMarkdownDuplicatesCommandlet::Main(const FString& Params)
+{
+	FString OutputPath = FPaths::ProjectSavedDir() / TEXT("MarkdownAsset") / TEXT("Duplicates.csv");
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+	float Threshold = 0.7f;
+	FParse::Value(*Params, TEXT("Threshold="), Threshold);
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	AssetRegistry.SearchAllAssets(true);
+
+	TArray<FAssetData> Documents;
+	AssetRegistry.GetAssetsByClass(UMarkdownAsset::StaticClass()->GetClassPathName(), Documents, true);
+
+	FMarkdownDuplicateFinder Finder;
+	const TArray<FMarkdownDuplicatePair> Pairs = Finder.Find(Documents, Threshold);
+
+	TArray<FString> Lines;
+	Lines.Add(TEXT("DocumentA,DocumentB,Similarity"));
+
+	for (const FMarkdownDuplicatePair& Pair : Pairs)
+	{
+		Lines.Add(FString::Printf(TEXT("%s,%s,%.2f"), *Pair.A.ToString(), *Pair.B.ToString(), Pair.Similarity));
+	}
+
+	if (!FFileHelper::SaveStringArrayToFile(Lines, *OutputPath))
+	{
+		UE_LOG(MarkdownStaticsLog, Error, TEXT("Could not write the duplicate report to '%s'."), *OutputPath);
+		return 1;
+	}
+
+	UE_LOG(MarkdownStaticsLog, Display, TEXT("Found %d pairs of markdown documents at least %d%% similar among %d documents, written to '%s'."),
+		Pairs.Num(), FMath::RoundToInt(Threshold * 100.0f), Documents.Num(), *OutputPath);
+
+	return 0;
+}
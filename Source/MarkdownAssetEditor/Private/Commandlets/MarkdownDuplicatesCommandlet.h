@@ -0,0 +1,26 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "MarkdownDuplicatesCommandlet.generated.h"
+
+/**
+ * Lists pairs of markdown documents that are mostly the same text, see FMarkdownDuplicateFinder.
+ *
+ *     UnrealEditor-Cmd.exe MyGame.uproject -run=MarkdownDuplicates [-Threshold=0.7] [-Output=Path/To/Duplicates.csv]
+ *
+ * Pairs at least Threshold similar are written with their similarity to Saved/MarkdownAsset/Duplicates.csv by default.
+ */
+UCLASS()
+class UMarkdownDuplicatesCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UMarkdownDuplicatesCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,142 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Commandlets/MarkdownFormatCommandlet.h"
+
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Async/ParallelFor.h"
+#include "DeveloperSettings/MarkdownAssetDeveloperSettings.h"
+#include "Engine/StreamableManager.h"
+#include "FileHelpers.h"
+#include "Formatting/MarkdownFormatter.h"
+#include "LogChannels/MarkdownLogChannels.h"
+#include "MarkdownAsset.h"
+
+namespace MarkdownFormatCommandlet
+{
+	/** Logs the documents under the paths that are not formatted, without changing them. Returns how many there are. */
+	static int32 CheckFolders(const TArray<FString>& PackagePaths, const FMarkdownFormatOptions& Options)
+	{
+		IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+
+		FARFilter Filter;
+		Filter.ClassPaths.Add(UMarkdownAsset::StaticClass()->GetClassPathName());
+		Filter.bRecursiveClasses = true;
+		Filter.bRecursivePaths = true;
+
+		for (const FString& PackagePath : PackagePaths)
+		{
+			Filter.PackagePaths.Add(FName(*PackagePath));
+		}
+
+		TArray<FAssetData> Assets;
+		AssetRegistry.GetAssets(Filter, Assets);
+
+		TArray<FSoftObjectPath> ToLoad;
+		for (const FAssetData& Asset : Assets)
+		{
+			if (!MarkdownFormatter::IsFormatted(Asset, Options))
+			{
+				ToLoad.Add(Asset.GetSoftObjectPath());
+			}
+		}
+
+		FStreamableManager StreamableManager;
+		TSharedPtr<FStreamableHandle> Handle;
+		if (!ToLoad.IsEmpty())
+		{
+			Handle = StreamableManager.RequestSyncLoad(ToLoad);
+		}
+
+		// objects and their FText are only touched here, the workers format plain copies
+		TArray<FString> Texts;
+		Texts.SetNum(ToLoad.Num());
+
+		for (int32 Index = 0; Index < ToLoad.Num(); ++Index)
+		{
+			if (const UMarkdownAsset* Document = Cast<UMarkdownAsset>(ToLoad[Index].ResolveObject()))
+			{
+				Texts[Index] = Document->Text.ToString();
+			}
+		}
+
+		// documents never stamped may be formatted by hand already, only a changed text counts
+		TArray<bool> Changed;
+		Changed.SetNumZeroed(ToLoad.Num());
+
+		ParallelFor(Texts.Num(), [&Texts, &Changed, &Options](int32 Index)
+		{
+			Changed[Index] = !MarkdownFormatter::Format(Texts[Index], Options).Equals(Texts[Index], ESearchCase::CaseSensitive);
+		}, EParallelForFlags::Unbalanced);
+
+		int32 NumChanged = 0;
+
+		for (int32 Index = 0; Index < ToLoad.Num(); ++Index)
+		{
+			if (Changed[Index])
+			{
+				UE_LOG(MarkdownStaticsLog, Warning, TEXT("%s is not formatted."), *ToLoad[Index].ToString());
+				++NumChanged;
+			}
+		}
+
+		UE_LOG(MarkdownStaticsLog, Display, TEXT("%d of %d markdown documents need formatting, %d were skipped by their hashes."),
+			NumChanged, Assets.Num(), Assets.Num() - ToLoad.Num());
+
+		return NumChanged;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+UMarkdownFormatCommandlet::UMarkdownFormatCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UMarkdownFormatCommandlet::Main(const FString& Params)
+{
+	using namespace MarkdownFormatCommandlet;
+
+	FString Paths = TEXT("/Game");
+	FParse::Value(*Params, TEXT("Path="), Paths, false);
+
+	TArray<FString> PackagePaths;
+	Paths.ParseIntoArray(PackagePaths, TEXT(","));
+
+	const bool bCheck = FParse::Param(*Params, TEXT("Check"));
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	AssetRegistry.SearchAllAssets(true);
+
+	const FMarkdownFormatOptions Options = UMarkdownAssetDeveloperSettings::Get()->GetFormatOptions();
+
+	if (bCheck)
+	{
+		return CheckFolders(PackagePaths, Options) > 0 ? 1 : 0;
+	}
+
+	TArray<UMarkdownAsset*> Modified;
+	FMarkdownFormatStats Stats;
+	MarkdownFormatter::FormatFolders(PackagePaths, Options, &Modified, &Stats);
+
+	TArray<UPackage*> Packages;
+	for (UMarkdownAsset* Document : Modified)
+	{
+		Packages.AddUnique(Document->GetPackage());
+	}
+
+	if (!Packages.IsEmpty() && !UEditorLoadingAndSavingUtils::SavePackages(Packages, true))
+	{
+		UE_LOG(MarkdownStaticsLog, Error, TEXT("Could not save the formatted markdown documents."));
+		return 1;
+	}
+
+	UE_LOG(MarkdownStaticsLog, Display, TEXT("Formatted %d of %d markdown documents, %d were skipped by their hashes, %d saved (%.3f seconds)."),
+		Stats.NumChanged, Stats.NumDocuments, Stats.NumSkipped, Packages.Num(), Stats.Seconds);
+
+	return 0;
+}
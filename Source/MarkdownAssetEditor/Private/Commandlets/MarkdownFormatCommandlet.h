@@ -0,0 +1,27 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "MarkdownFormatCommandlet.generated.h"
+
+/**
+ * Formats every markdown document and saves the ones that changed, see MarkdownFormatter.
+ *
+ *     UnrealEditor-Cmd.exe MyGame.uproject -run=MarkdownFormat [-Path=/Game/Docs,/Game/Manual] [-Check]
+ *
+ * Documents under /Game are formatted by default. With -Check nothing is saved, the documents that are not formatted
+ * are logged and the commandlet returns 1 if there are any. Formatting is configured in the project settings.
+ */
+UCLASS()
+class UMarkdownFormatCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UMarkdownFormatCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,112 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Commandlets/MarkdownLinksCommandlet.h"
+
+#include "Async/ParallelFor.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Engine/StreamableManager.h"
+#include "LogChannels/MarkdownLogChannels.h"
+#include "MarkdownAsset.h"
+#include "MarkdownScanner.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace MarkdownLinksCommandlet
+{
+	static const TCHAR* KindNames[] = { TEXT("Asset"), TEXT("ContentPath"), TEXT("Url") };
+
+	/** Urls can have commas and quotes in them. */
+	static FString QuoteCsv(FStringView Value)
+	{
+		return FString::Printf(TEXT("\"%s\""), *FString(Value).Replace(TEXT("\""), TEXT("\"\"")));
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+UMarkdownLinksCommandlet::UMarkdownLinksCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UMarkdownLinksCommandlet::Main(const FString& Params)
+{
+	using namespace MarkdownLinksCommandlet;
+
+	FString OutputPath = FPaths::ProjectSavedDir() / TEXT("MarkdownAsset") / TEXT("Links.csv");
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	AssetRegistry.SearchAllAssets(true);
+
+	TArray<FAssetData> Documents;
+	AssetRegistry.GetAssetsByClass(UMarkdownAsset::StaticClass()->GetClassPathName(), Documents, true);
+
+	TArray<FSoftObjectPath> ToLoad;
+	for (const FAssetData& Document : Documents)
+	{
+		ToLoad.Add(Document.GetSoftObjectPath());
+	}
+
+	FStreamableManager StreamableManager;
+	TSharedPtr<FStreamableHandle> Handle = StreamableManager.RequestSyncLoad(ToLoad);
+
+	TArray<FString> Texts;
+	Texts.SetNum(ToLoad.Num());
+
+	for (int32 Index = 0; Index < ToLoad.Num(); ++Index)
+	{
+		if (const UMarkdownAsset* Document = Cast<UMarkdownAsset>(ToLoad[Index].ResolveObject()))
+		{
+			Texts[Index] = Document->Text.ToString();
+		}
+	}
+
+	// only the scan is timed, loading the documents takes far longer and is not what this measures
+	TArray<TArray<FMarkdownLinkSpan>> Links;
+	Links.SetNum(Texts.Num());
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	ParallelFor(Texts.Num(), [&](int32 Index)
+	{
+		MarkdownScanner::FindLinks(Texts[Index], Links[Index]);
+	});
+
+	const double ScanSeconds = FPlatformTime::Seconds() - StartTime;
+
+	TArray<FString> Lines;
+	Lines.Add(TEXT("Document,Kind,Line,Target"));
+
+	int64 NumChars = 0;
+
+	for (int32 Index = 0; Index < Texts.Num(); ++Index)
+	{
+		NumChars += Texts[Index].Len();
+
+		const FString DocumentPath = ToLoad[Index].ToString();
+
+		for (const FMarkdownLinkSpan& Link : Links[Index])
+		{
+			const FStringView Target = FStringView(Texts[Index]).Mid(Link.Start, Link.Len);
+			Lines.Add(FString::Printf(TEXT("%s,%s,%d,%s"), *DocumentPath, KindNames[int32(Link.Kind)], Link.Line, *QuoteCsv(Target)));
+		}
+	}
+
+	if (!FFileHelper::SaveStringArrayToFile(Lines, *OutputPath))
+	{
+		UE_LOG(MarkdownStaticsLog, Error, TEXT("Could not write the link report to '%s'."), *OutputPath);
+		return 1;
+	}
+
+	const double MegaBytes = double(NumChars * sizeof(TCHAR)) / (1024.0 * 1024.0);
+
+	UE_LOG(MarkdownStaticsLog, Display, TEXT("Found %d links in %d markdown documents (%.1f MB scanned in %.3f seconds, %.0f MB/s), written to '%s'."),
+		Lines.Num() - 1, Documents.Num(), MegaBytes, ScanSeconds, ScanSeconds > 0.0 ? MegaBytes / ScanSeconds : 0.0, *OutputPath);
+
+	return 0;
+}
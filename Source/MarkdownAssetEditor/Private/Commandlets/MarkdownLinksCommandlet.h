@@ -0,0 +1,26 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "MarkdownLinksCommandlet.generated.h"
+
+/**
+ * Lists every link in every markdown document, see MarkdownScanner::FindLinks.
+ *
+ *     UnrealEditor-Cmd.exe MyGame.uproject -run=MarkdownLinks [-Output=Path/To/Links.csv]
+ *
+ * Links are written with their kind and line to Saved/MarkdownAsset/Links.csv by default. Links in code are left out.
+ */
+UCLASS()
+class UMarkdownLinksCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UMarkdownLinksCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,120 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Commandlets/MarkdownLintCommandlet.h"
+
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "DeveloperSettings/MarkdownAssetDeveloperSettings.h"
+#include "Engine/StreamableManager.h"
+#include "Lint/MarkdownLinter.h"
+#include "LogChannels/MarkdownLogChannels.h"
+#include "MarkdownAsset.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace MarkdownLintCommandlet
+{
+	static const TCHAR* SeverityNames[] = { TEXT("Warning"), TEXT("Error") };
+
+	/** Messages can have commas and quotes in them. */
+	static FString QuoteCsv(FStringView Value)
+	{
+		return FString::Printf(TEXT("\"%s\""), *FString(Value).Replace(TEXT("\""), TEXT("\"\"")));
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+UMarkdownLintCommandlet::UMarkdownLintCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UMarkdownLintCommandlet::Main(const FString& Params)
+{
+	using namespace MarkdownLintCommandlet;
+
+	FString OutputPath = FPaths::ProjectSavedDir() / TEXT("MarkdownAsset") / TEXT("Lint.csv");
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+	const bool bWarningsAsErrors = FParse::Param(*Params, TEXT("WarningsAsErrors"));
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	AssetRegistry.SearchAllAssets(true);
+
+	TArray<FAssetData> Documents;
+	AssetRegistry.GetAssetsByClass(UMarkdownAsset::StaticClass()->GetClassPathName(), Documents, true);
+
+	TArray<FSoftObjectPath> ToLoad;
+	for (const FAssetData& Document : Documents)
+	{
+		ToLoad.Add(Document.GetSoftObjectPath());
+	}
+
+	FStreamableManager StreamableManager;
+	TSharedPtr<FStreamableHandle> Handle = StreamableManager.RequestSyncLoad(ToLoad);
+
+	TArray<FString> Texts;
+	Texts.SetNum(ToLoad.Num());
+
+	for (int32 Index = 0; Index < ToLoad.Num(); ++Index)
+	{
+		if (const UMarkdownAsset* Document = Cast<UMarkdownAsset>(ToLoad[Index].ResolveObject()))
+		{
+			Texts[Index] = Document->Text.ToString();
+		}
+	}
+
+	// only parsing and linting is timed, loading the documents depends on the disk and the editor start up
+	TArray<TArray<FMarkdownLintIssue>> Issues;
+
+	const double StartTime = FPlatformTime::Seconds();
+	MarkdownLinter::LintAll(Texts, UMarkdownAssetDeveloperSettings::Get()->GetLintOptions(), Issues);
+	const double LintSeconds = FPlatformTime::Seconds() - StartTime;
+
+	TArray<FString> Lines;
+	Lines.Add(TEXT("Document,Severity,Rule,Line,Message"));
+
+	int32 NumErrors = 0;
+	int32 NumWarnings = 0;
+	int64 NumChars = 0;
+
+	for (int32 Index = 0; Index < Texts.Num(); ++Index)
+	{
+		NumChars += Texts[Index].Len();
+
+		const FString DocumentPath = ToLoad[Index].ToString();
+
+		for (const FMarkdownLintIssue& Issue : Issues[Index])
+		{
+			if (Issue.Severity == EMarkdownLintSeverity::Error)
+			{
+				UE_LOG(MarkdownStaticsLog, Error, TEXT("%s(%d): %s [%s]"), *DocumentPath, Issue.Line, *Issue.Message, LexToString(Issue.Rule));
+				++NumErrors;
+			}
+			else
+			{
+				UE_LOG(MarkdownStaticsLog, Warning, TEXT("%s(%d): %s [%s]"), *DocumentPath, Issue.Line, *Issue.Message, LexToString(Issue.Rule));
+				++NumWarnings;
+			}
+
+			Lines.Add(FString::Printf(TEXT("%s,%s,%s,%d,%s"), *DocumentPath, SeverityNames[int32(Issue.Severity)], LexToString(Issue.Rule), Issue.Line, *QuoteCsv(Issue.Message)));
+		}
+	}
+
+	if (!FFileHelper::SaveStringArrayToFile(Lines, *OutputPath))
+	{
+		UE_LOG(MarkdownStaticsLog, Error, TEXT("Could not write the lint report to '%s'."), *OutputPath);
+		return 1;
+	}
+
+	const double MegaBytes = double(NumChars * sizeof(TCHAR)) / (1024.0 * 1024.0);
+
+	UE_LOG(MarkdownStaticsLog, Display, TEXT("Found %d error(s) and %d warning(s) in %d markdown documents (%.1f MB linted in %.3f seconds, %.0f MB/s), written to '%s'."),
+		NumErrors, NumWarnings, Documents.Num(), MegaBytes, LintSeconds, LintSeconds > 0.0 ? MegaBytes / LintSeconds : 0.0, *OutputPath);
+
+	return NumErrors > 0 || (bWarningsAsErrors && NumWarnings > 0) ? 1 : 0;
+}
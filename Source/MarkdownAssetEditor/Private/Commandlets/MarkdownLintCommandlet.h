@@ -0,0 +1,27 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "MarkdownLintCommandlet.generated.h"
+
+/**
+ * Lints every markdown document for CI, see MarkdownLinter.
+ *
+ *     UnrealEditor-Cmd.exe MyGame.uproject -run=MarkdownLint [-Output=Path/To/Lint.csv] [-WarningsAsErrors]
+ *
+ * Issues are logged and written with their rule and line to Saved/MarkdownAsset/Lint.csv by default. Returns 1 if any
+ * document has an error, or a warning with -WarningsAsErrors. Rules are configured in the project settings.
+ */
+UCLASS()
+class UMarkdownLintCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UMarkdownLintCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,128 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Commandlets/MarkdownPackArchiveCommandlet.h"
+
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/AssetRegistryState.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "DeveloperSettings/MarkdownAssetDeveloperSettings.h"
+#include "HelperFunctions/MarkdownAssetEditorStatics.h"
+#include "LogChannels/MarkdownLogChannels.h"
+#include "MarkdownArchive.h"
+#include "MarkdownAsset.h"
+#include "MarkdownSearchIndex.h"
+#include "MarkdownSyntaxTree.h"
+
+namespace MarkdownPackArchiveCommandlet
+{
+	/** The first heading, or the asset name for documents without one. */
+	static FString GetTitle(const FAssetData& AssetData, const FString& Text)
+	{
+		const FMarkdownSyntaxTree Tree = FMarkdownSyntaxTree::Parse(Text);
+
+		for (const FMarkdownNode& Node : Tree.GetNodes())
+		{
+			if (Node.Type == EMarkdownNodeType::Heading)
+			{
+				return Tree.GetInlineText(Node);
+			}
+		}
+
+		return AssetData.AssetName.ToString();
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+UMarkdownPackArchiveCommandlet::UMarkdownPackArchiveCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UMarkdownPackArchiveCommandlet::Main(const FString& Params)
+{
+	FString OutputPath = FMarkdownArchive::GetDefaultPath();
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+	FString IndexPath = FMarkdownSearchIndex::GetDefaultPath();
+	FParse::Value(*Params, TEXT("Index="), IndexPath);
+
+	FAssetRegistryState CookedRegistry;
+	FString CookedRegistryPath;
+	const bool bHasCookedRegistry = FParse::Value(*Params, TEXT("CookedRegistry="), CookedRegistryPath);
+
+	if (bHasCookedRegistry && !MarkdownAssetStatics::LoadCookedAssetRegistry(CookedRegistryPath, CookedRegistry))
+	{
+		UE_LOG(MarkdownStaticsLog, Error, TEXT("Could not read the cooked asset registry '%s'."), *CookedRegistryPath);
+		return 1;
+	}
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	AssetRegistry.SearchAllAssets(true);
+
+	TArray<FAssetData> Documents;
+	AssetRegistry.GetAssetsByClass(UMarkdownAsset::StaticClass()->GetClassPathName(), Documents, true);
+
+	const UMarkdownAssetDeveloperSettings* Settings = UMarkdownAssetDeveloperSettings::Get();
+
+	TArray<FMarkdownArchive::FDocument> Packed;
+	TArray<FMarkdownSearchIndex::FDocument> Searchable;
+	int32 NumNotCooked = 0;
+
+	for (const FAssetData& AssetData : Documents)
+	{
+		// the registry tag may be stale for documents saved before the policy existed, the loaded asset is not
+		const UMarkdownAsset* Document = Cast<UMarkdownAsset>(AssetData.GetAsset());
+		if (!Document)
+		{
+			continue;
+		}
+
+		const EMarkdownCookPolicy Policy = Settings->ResolveCookPolicy(Document->CookPolicy, AssetData.PackageName);
+		if (Policy == EMarkdownCookPolicy::EditorOnly)
+		{
+			continue;
+		}
+
+		// only documents that ship are searchable, a hit on a document the cooker left out would lead nowhere
+		if (Policy != EMarkdownCookPolicy::Packed && !MarkdownAssetStatics::IsDocumentCooked(AssetData, AssetRegistry, bHasCookedRegistry ? &CookedRegistry : nullptr))
+		{
+			++NumNotCooked;
+			continue;
+		}
+
+		FString Text = Document->Text.ToString();
+		FString Title = MarkdownPackArchiveCommandlet::GetTitle(AssetData, Text);
+
+		if (Policy == EMarkdownCookPolicy::Packed)
+		{
+			Packed.Add({ AssetData.GetSoftObjectPath(), Text });
+		}
+
+		Searchable.Add({ AssetData.GetSoftObjectPath(), MoveTemp(Title), MoveTemp(Text) });
+	}
+
+	FMarkdownArchiveStats Stats;
+	if (!FMarkdownArchive::Write(OutputPath, MoveTemp(Packed), &Stats))
+	{
+		UE_LOG(MarkdownStaticsLog, Error, TEXT("Could not write the markdown archive to '%s'."), *OutputPath);
+		return 1;
+	}
+
+	UE_LOG(MarkdownStaticsLog, Display, TEXT("Packed %d markdown documents, %s of text into %s (%d byte shared dictionary), written to '%s'."),
+		Stats.NumDocuments, *FText::AsMemory(Stats.RawBytes).ToString(), *FText::AsMemory(Stats.PackedBytes).ToString(), Stats.DictionarySize, *OutputPath);
+
+	if (!FMarkdownSearchIndex::Write(IndexPath, Searchable))
+	{
+		UE_LOG(MarkdownStaticsLog, Error, TEXT("Could not write the markdown search index to '%s'."), *IndexPath);
+		return 1;
+	}
+
+	UE_LOG(MarkdownStaticsLog, Display, TEXT("Indexed %d shipped markdown documents for search, written to '%s'. %d documents are not cooked and were left out."),
+		Searchable.Num(), *IndexPath, NumNotCooked);
+
+	return 0;
+}
@@ -0,0 +1,32 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "MarkdownPackArchiveCommandlet.generated.h"
+
+/**
+ * Packs the documents with the Packed cook policy into the documentation archive read by FMarkdownArchive, and
+ * indexes every document that ships, packed or cooked, into the search index read by FMarkdownSearchIndex.
+ *
+ *     UnrealEditor-Cmd.exe MyGame.uproject -run=MarkdownPackArchive [-Output=Path/To/Documentation.mdpack] [-Index=Path/To/Documentation.mdindex]
+ *         [-CookedRegistry=Saved/Cooked/Windows/MyGame/Metadata/DevelopmentAssetRegistry.bin]
+ *
+ * Run it before cooking. Both files are written to Content/MarkdownAsset by default; add that folder to the
+ * "Additional Non-Asset Directories to Package" project setting so it is staged with the game.
+ *
+ * Cooked documents are only indexed when the cooker ships them. Given the asset registry of a previous cook that is
+ * exact, otherwise documents nothing in the game references are left out.
+ */
+UCLASS()
+class UMarkdownPackArchiveCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UMarkdownPackArchiveCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
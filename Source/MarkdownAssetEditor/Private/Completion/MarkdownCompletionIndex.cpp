@@ -0,0 +1,535 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Completion/MarkdownCompletionIndex.h"
+
+#include "Algo/BinarySearch.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "LogChannels/MarkdownLogChannels.h"
+#include "MarkdownAsset.h"
+#include "MarkdownAssetEditorModule.h"
+#include "MarkdownScanner.h"
+#include "MarkdownSyntaxTree.h"
+#include "Scheduling/MarkdownTaskScheduler.h"
+#include "String/Find.h"
+#include "UObject/NameTypes.h"
+
+namespace MarkdownCompletionIndex
+{
+	/** Name queries stop looking after this many matches, which is plenty to rank documents first. */
+	static constexpr int32 MaxScannedNames = 1024;
+
+	static IAssetRegistry* GetAssetRegistry()
+	{
+		FAssetRegistryModule* AssetRegistryModule = FModuleManager::GetModulePtr<FAssetRegistryModule>("AssetRegistry");
+		return AssetRegistryModule ? &AssetRegistryModule->Get() : nullptr;
+	}
+
+	static bool ShouldIndex(const FAssetData& AssetData)
+	{
+		if (AssetData.IsRedirector() || !AssetData.IsTopLevelAsset())
+		{
+			return false;
+		}
+
+		// one file per actor packages can outnumber every other asset and are never linked to
+		FNameBuilder PackageName(AssetData.PackageName);
+		return UE::String::FindFirst(PackageName.ToView(), TEXT("/__External"), ESearchCase::IgnoreCase) == INDEX_NONE;
+	}
+
+	static bool IsMarkdownClass(const FTopLevelAssetPath& ClassPath)
+	{
+		return ClassPath == UMarkdownAsset::StaticClass()->GetClassPathName() || ClassPath == UMarkdownLinkAsset::StaticClass()->GetClassPathName();
+	}
+
+	static int32 CompareName(FName Name, FStringView Text)
+	{
+		FNameBuilder Builder(Name);
+		return Builder.ToView().Compare(Text, ESearchCase::IgnoreCase);
+	}
+
+	static bool NameStartsWith(FName Name, FStringView Prefix)
+	{
+		FNameBuilder Builder(Name);
+		return Builder.ToView().StartsWith(Prefix, ESearchCase::IgnoreCase);
+	}
+
+	static bool NameLess(FName A, FName B)
+	{
+		FNameBuilder BuilderA(A);
+		FNameBuilder BuilderB(B);
+		return BuilderA.ToView().Compare(BuilderB.ToView(), ESearchCase::IgnoreCase) < 0;
+	}
+
+	/** Calls Visit for each non-empty segment of a "/Root/Folder/Package" path, stopping when it returns false. */
+	template<typename FunctorType>
+	static void ForEachSegment(FStringView Path, FunctorType&& Visit)
+	{
+		int32 Start = 0;
+		while (Start < Path.Len())
+		{
+			int32 End = Start;
+			while (End < Path.Len() && Path[End] != TEXT('/'))
+			{
+				++End;
+			}
+
+			if (End > Start && !Visit(Path.Mid(Start, End - Start)))
+			{
+				return;
+			}
+
+			Start = End + 1;
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void FMarkdownCompletionIndex::Initialize()
+{
+	IAssetRegistry* AssetRegistry = MarkdownCompletionIndex::GetAssetRegistry();
+	if (!AssetRegistry)
+	{
+		return;
+	}
+
+	AssetRegistry->OnAssetAdded().AddRaw(this, &FMarkdownCompletionIndex::HandleAssetAdded);
+	AssetRegistry->OnAssetRemoved().AddRaw(this, &FMarkdownCompletionIndex::HandleAssetRemoved);
+	AssetRegistry->OnAssetRenamed().AddRaw(this, &FMarkdownCompletionIndex::HandleAssetRenamed);
+
+	if (AssetRegistry->IsLoadingAssets())
+	{
+		AssetRegistry->OnFilesLoaded().AddRaw(this, &FMarkdownCompletionIndex::HandleFilesLoaded);
+	}
+	else
+	{
+		BuildFromRegistry();
+	}
+}
+
+void FMarkdownCompletionIndex::Shutdown()
+{
+	if (IAssetRegistry* AssetRegistry = MarkdownCompletionIndex::GetAssetRegistry())
+	{
+		AssetRegistry->OnAssetAdded().RemoveAll(this);
+		AssetRegistry->OnAssetRemoved().RemoveAll(this);
+		AssetRegistry->OnAssetRenamed().RemoveAll(this);
+		AssetRegistry->OnFilesLoaded().RemoveAll(this);
+	}
+
+	Nodes.Empty();
+	FreeNodes.Empty();
+	Names.Empty();
+	ChangedWhileBuilding.Empty();
+	bBuilding = false;
+	bBuilt = false;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void FMarkdownCompletionIndex::Suggest(FStringView Prefix, int32 MaxResults, TArray<FMarkdownCompletion>& OutResults) const
+{
+	if (!bBuilt || MaxResults <= 0)
+	{
+		return;
+	}
+
+	// "/Game/Characters/He" completes the children of /Game/Characters that start with "He"
+	if (Prefix.StartsWith(TEXT('/')))
+	{
+		int32 LastSlash = INDEX_NONE;
+		Prefix.FindLastChar(TEXT('/'), LastSlash);
+
+		const int32 Folder = FindNode(Prefix.Left(LastSlash));
+		if (Folder == INDEX_NONE)
+		{
+			return;
+		}
+
+		const FStringView Partial = Prefix.RightChop(LastSlash + 1);
+		const FString FolderPath = GetNodePath(Folder);
+		const TArray<int32>& Children = Nodes[Folder].Children;
+
+		for (int32 Index = LowerBoundChild(Nodes[Folder], Partial); Index < Children.Num() && OutResults.Num() < MaxResults; ++Index)
+		{
+			const FNode& Child = Nodes[Children[Index]];
+			if (!MarkdownCompletionIndex::NameStartsWith(Child.Segment, Partial))
+			{
+				break;
+			}
+
+			if (!Child.Children.IsEmpty())
+			{
+				const FString Segment = Child.Segment.ToString();
+				OutResults.Add({ Segment + TEXT("/"), FolderPath + TEXT("/") + Segment + TEXT("/"), TEXT("Folder") });
+			}
+
+			if (Child.HasAsset() && OutResults.Num() < MaxResults)
+			{
+				OutResults.Add(MakeAssetCompletion(Children[Index]));
+			}
+		}
+
+		return;
+	}
+
+	// anything else is the start of an asset name, in any folder
+	TArray<int32, TInlineAllocator<64>> Documents;
+	TArray<int32, TInlineAllocator<64>> Assets;
+
+	const int32 First = LowerBoundName(Prefix);
+	const int32 Last = FMath::Min(Names.Num(), First + MarkdownCompletionIndex::MaxScannedNames);
+
+	for (int32 Index = First; Index < Last; ++Index)
+	{
+		const FNameEntry& Entry = Names[Index];
+		if (!MarkdownCompletionIndex::NameStartsWith(Entry.Name, Prefix) || Documents.Num() >= MaxResults)
+		{
+			break;
+		}
+
+		if (MarkdownCompletionIndex::IsMarkdownClass(Nodes[Entry.Node].AssetClass))
+		{
+			Documents.Add(Entry.Node);
+		}
+		else if (Assets.Num() < MaxResults)
+		{
+			Assets.Add(Entry.Node);
+		}
+	}
+
+	for (const int32 Node : Documents)
+	{
+		OutResults.Add(MakeAssetCompletion(Node));
+	}
+
+	for (int32 Index = 0; Index < Assets.Num() && OutResults.Num() < MaxResults; ++Index)
+	{
+		OutResults.Add(MakeAssetCompletion(Assets[Index]));
+	}
+}
+
+void FMarkdownCompletionIndex::SuggestAnchors(FStringView DocumentText, FStringView Prefix, int32 MaxResults, TArray<FMarkdownCompletion>& OutResults)
+{
+	const FMarkdownSyntaxTree Tree = FMarkdownSyntaxTree::Parse(FString(DocumentText));
+
+	// every heading takes an anchor, so repeated titles are numbered like the viewer numbers them
+	FMarkdownHeadingAnchors Anchors;
+
+	for (const FMarkdownNode& Node : Tree.GetNodes())
+	{
+		if (OutResults.Num() >= MaxResults)
+		{
+			break;
+		}
+
+		if (Node.Type != EMarkdownNodeType::Heading)
+		{
+			continue;
+		}
+
+		const FString Anchor = Anchors.Add(Tree.GetInlineText(Node));
+
+		if (FStringView(Anchor).StartsWith(Prefix, ESearchCase::IgnoreCase))
+		{
+			OutResults.Add({ FString(Tree.GetArg(Node)), TEXT("#") + Anchor, FString::Printf(TEXT("H%d"), Node.Level) });
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void FMarkdownCompletionIndex::BuildFromRegistry()
+{
+	IAssetRegistry* AssetRegistry = MarkdownCompletionIndex::GetAssetRegistry();
+	if (!AssetRegistry)
+	{
+		return;
+	}
+
+	bBuilding = true;
+
+	TWeakPtr<FMarkdownCompletionIndex, ESPMode::ThreadSafe> WeakThis = AsShared();
+
+	// every asset of the project goes through the trie, nobody is waiting on it so it does not hold up the editor
+	FMarkdownAssetEditorModule::Get().GetTaskScheduler().Launch(TEXT("MarkdownCompletionIndexBuild"), EMarkdownTaskPriority::Background,
+		[WeakThis, AssetRegistry](const FMarkdownTask& Task) -> TUniqueFunction<void()>
+	{
+		const double StartTime = FPlatformTime::Seconds();
+
+		// only assets on disk, listing the loaded ones needs the game thread
+		TArray<FAssetData> Assets;
+		AssetRegistry->GetAllAssets(Assets, true);
+
+		TUniquePtr<FMarkdownCompletionIndex> Built = MakeUnique<FMarkdownCompletionIndex>();
+		Built->Nodes.AddDefaulted();
+		Built->Names.Reserve(Assets.Num());
+
+		for (const FAssetData& AssetData : Assets)
+		{
+			if (Task.IsCancelled())
+			{
+				return nullptr;
+			}
+
+			Built->AddAsset(AssetData, false);
+		}
+
+		Built->Names.Sort([](const FNameEntry& A, const FNameEntry& B) { return MarkdownCompletionIndex::NameLess(A.Name, B.Name); });
+
+		return [WeakThis, Built = MoveTemp(Built), BuildSeconds = FPlatformTime::Seconds() - StartTime]()
+		{
+			if (TSharedPtr<FMarkdownCompletionIndex, ESPMode::ThreadSafe> This = WeakThis.Pin())
+			{
+				This->FinishBuild(*Built, BuildSeconds);
+			}
+		};
+	});
+}
+
+void FMarkdownCompletionIndex::FinishBuild(FMarkdownCompletionIndex& Built, double BuildSeconds)
+{
+	Nodes = MoveTemp(Built.Nodes);
+	FreeNodes = MoveTemp(Built.FreeNodes);
+	Names = MoveTemp(Built.Names);
+
+	// the registry may have moved on since the task read it, these assets are looked up as they are now
+	IAssetRegistry* AssetRegistry = MarkdownCompletionIndex::GetAssetRegistry();
+
+	for (const FSoftObjectPath& Asset : ChangedWhileBuilding)
+	{
+		RemoveAsset(Asset.GetLongPackageFName(), Asset.GetAssetFName());
+
+		const FAssetData AssetData = AssetRegistry ? AssetRegistry->GetAssetByObjectPath(Asset) : FAssetData();
+		if (AssetData.IsValid())
+		{
+			AddAsset(AssetData, true);
+		}
+	}
+
+	ChangedWhileBuilding.Empty();
+	bBuilding = false;
+	bBuilt = true;
+
+	UE_LOG(MarkdownStaticsLog, Log, TEXT("Markdown completion index built: %d assets, %d paths (%.2f ms)."),
+		Names.Num(), Nodes.Num() - FreeNodes.Num(), BuildSeconds * 1000.0);
+}
+
+bool FMarkdownCompletionIndex::DeferUntilBuilt(const FSoftObjectPath& Asset)
+{
+	if (bBuilding)
+	{
+		ChangedWhileBuilding.Add(Asset);
+	}
+
+	return !bBuilt;
+}
+
+void FMarkdownCompletionIndex::AddAsset(const FAssetData& AssetData, bool bSortNames)
+{
+	if (!MarkdownCompletionIndex::ShouldIndex(AssetData))
+	{
+		return;
+	}
+
+	FNameBuilder PackageName(AssetData.PackageName);
+
+	int32 Node = 0;
+	MarkdownCompletionIndex::ForEachSegment(PackageName.ToView(), [this, &Node](FStringView Segment)
+	{
+		Node = FindOrAddChild(Node, FName(Segment.Len(), Segment.GetData()));
+		return true;
+	});
+
+	// packages holding more than one asset are listed under the first
+	if (Node == 0 || Nodes[Node].HasAsset())
+	{
+		return;
+	}
+
+	Nodes[Node].AssetName = AssetData.AssetName;
+	Nodes[Node].AssetClass = AssetData.AssetClassPath;
+
+	if (bSortNames)
+	{
+		FNameBuilder AssetName(AssetData.AssetName);
+		Names.Insert({ AssetData.AssetName, Node }, LowerBoundName(AssetName.ToView()));
+	}
+	else
+	{
+		Names.Add({ AssetData.AssetName, Node });
+	}
+}
+
+void FMarkdownCompletionIndex::RemoveAsset(FName PackageName, FName AssetName)
+{
+	FNameBuilder PackageNameBuilder(PackageName);
+
+	const int32 Node = FindNode(PackageNameBuilder.ToView());
+	if (Node == INDEX_NONE || Nodes[Node].AssetName != AssetName)
+	{
+		return;
+	}
+
+	FNameBuilder AssetNameBuilder(AssetName);
+	for (int32 Index = LowerBoundName(AssetNameBuilder.ToView()); Index < Names.Num() && Names[Index].Name == AssetName; ++Index)
+	{
+		if (Names[Index].Node == Node)
+		{
+			Names.RemoveAt(Index);
+			break;
+		}
+	}
+
+	Nodes[Node].AssetName = NAME_None;
+	Nodes[Node].AssetClass.Reset();
+
+	PruneNode(Node);
+}
+
+int32 FMarkdownCompletionIndex::FindNode(FStringView PackageName) const
+{
+	if (Nodes.IsEmpty())
+	{
+		return INDEX_NONE;
+	}
+
+	int32 Node = 0;
+	MarkdownCompletionIndex::ForEachSegment(PackageName, [this, &Node](FStringView Segment)
+	{
+		const FNode& Parent = Nodes[Node];
+		const int32 Index = LowerBoundChild(Parent, Segment);
+
+		if (Index < Parent.Children.Num() && MarkdownCompletionIndex::CompareName(Nodes[Parent.Children[Index]].Segment, Segment) == 0)
+		{
+			Node = Parent.Children[Index];
+			return true;
+		}
+
+		Node = INDEX_NONE;
+		return false;
+	});
+
+	return Node;
+}
+
+int32 FMarkdownCompletionIndex::FindOrAddChild(int32 Parent, FName Segment)
+{
+	FNameBuilder SegmentBuilder(Segment);
+
+	const int32 Index = LowerBoundChild(Nodes[Parent], SegmentBuilder.ToView());
+	if (Index < Nodes[Parent].Children.Num() && Nodes[Nodes[Parent].Children[Index]].Segment == Segment)
+	{
+		return Nodes[Parent].Children[Index];
+	}
+
+	const int32 Child = FreeNodes.IsEmpty() ? Nodes.AddDefaulted() : FreeNodes.Pop();
+	Nodes[Child].Segment = Segment;
+	Nodes[Child].Parent = Parent;
+
+	Nodes[Parent].Children.Insert(Child, Index);
+	return Child;
+}
+
+void FMarkdownCompletionIndex::PruneNode(int32 Node)
+{
+	// drop folders that no longer lead to an asset, but never the root
+	while (Node > 0 && Nodes[Node].Children.IsEmpty() && !Nodes[Node].HasAsset())
+	{
+		const int32 Parent = Nodes[Node].Parent;
+		Nodes[Parent].Children.Remove(Node);
+
+		Nodes[Node] = FNode();
+		FreeNodes.Add(Node);
+
+		Node = Parent;
+	}
+}
+
+int32 FMarkdownCompletionIndex::LowerBoundChild(const FNode& Parent, FStringView Segment) const
+{
+	return Algo::LowerBound(Parent.Children, Segment, [this](int32 Child, FStringView Value)
+	{
+		return MarkdownCompletionIndex::CompareName(Nodes[Child].Segment, Value) < 0;
+	});
+}
+
+int32 FMarkdownCompletionIndex::LowerBoundName(FStringView Name) const
+{
+	return Algo::LowerBound(Names, Name, [](const FNameEntry& Entry, FStringView Value)
+	{
+		return MarkdownCompletionIndex::CompareName(Entry.Name, Value) < 0;
+	});
+}
+
+FString FMarkdownCompletionIndex::GetNodePath(int32 Node) const
+{
+	TArray<FName, TInlineAllocator<16>> Segments;
+	for (; Node > 0; Node = Nodes[Node].Parent)
+	{
+		Segments.Add(Nodes[Node].Segment);
+	}
+
+	TStringBuilder<256> Path;
+	for (int32 Index = Segments.Num() - 1; Index >= 0; --Index)
+	{
+		Path << TEXT('/');
+		Segments[Index].AppendString(Path);
+	}
+
+	return FString(Path.ToView());
+}
+
+FMarkdownCompletion FMarkdownCompletionIndex::MakeAssetCompletion(int32 Node) const
+{
+	const FNode& Asset = Nodes[Node];
+	const FString ObjectPath = GetNodePath(Node) + TEXT(".") + Asset.AssetName.ToString();
+
+	// the same form as a reference copied from the Content Browser
+	FMarkdownCompletion Completion;
+	Completion.Label = Asset.AssetName.ToString();
+	Completion.Insert = FString::Printf(TEXT("%s'%s'"), *Asset.AssetClass.ToString(), *ObjectPath);
+	Completion.Detail = Asset.AssetClass.GetAssetName().ToString();
+	return Completion;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void FMarkdownCompletionIndex::HandleFilesLoaded()
+{
+	if (IAssetRegistry* AssetRegistry = MarkdownCompletionIndex::GetAssetRegistry())
+	{
+		AssetRegistry->OnFilesLoaded().RemoveAll(this);
+	}
+
+	BuildFromRegistry();
+}
+
+void FMarkdownCompletionIndex::HandleAssetAdded(const FAssetData& AssetData)
+{
+	if (!DeferUntilBuilt(AssetData.GetSoftObjectPath()))
+	{
+		AddAsset(AssetData, true);
+	}
+}
+
+void FMarkdownCompletionIndex::HandleAssetRemoved(const FAssetData& AssetData)
+{
+	if (!DeferUntilBuilt(AssetData.GetSoftObjectPath()))
+	{
+		RemoveAsset(AssetData.PackageName, AssetData.AssetName);
+	}
+}
+
+void FMarkdownCompletionIndex::HandleAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath)
+{
+	const FSoftObjectPath OldPath(OldObjectPath);
+	DeferUntilBuilt(OldPath);
+
+	if (!DeferUntilBuilt(AssetData.GetSoftObjectPath()))
+	{
+		RemoveAsset(OldPath.GetLongPackageFName(), OldPath.GetAssetFName());
+		AddAsset(AssetData, true);
+	}
+}
@@ -0,0 +1,113 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/SoftObjectPath.h"
+#include "UObject/TopLevelAssetPath.h"
+
+struct FAssetData;
+
+/** A single autocomplete suggestion for the markdown editor. */
+struct FMarkdownCompletion
+{
+	/** Shown in the suggestion list. */
+	FString Label;
+
+	/** Replaces the partial link that was typed. */
+	FString Insert;
+
+	/** Short hint shown next to the label, e.g. the asset class. */
+	FString Detail;
+};
+
+/**
+ * Prefix index over the asset registry, used to autocomplete links while typing in the markdown editor.
+ *
+ * Package paths are stored as a trie of path segments, each segment an FName, so shared folders are stored once and
+ * completing "/Game/Char" only looks at the children of "/Game". Asset names are kept in a sorted array next to it so
+ * "BP_He" finds assets in any folder with a binary search. Both are built once when the asset registry has finished
+ * scanning and then kept up to date from registry events, so a query never touches the registry itself.
+ *
+ * The build is a background task of FMarkdownTaskScheduler filling a separate index, which replaces this one when it
+ * finishes. Assets the registry reports changes for in the meantime are looked up again then.
+ */
+class FMarkdownCompletionIndex : public TSharedFromThis<FMarkdownCompletionIndex, ESPMode::ThreadSafe>
+{
+public:
+
+	void Initialize();
+	void Shutdown();
+
+	/**
+	 * Completes a partial link. A prefix starting with '/' is completed one folder at a time, anything else matches the
+	 * start of asset names, listing markdown documents before other assets.
+	 */
+	void Suggest(FStringView Prefix, int32 MaxResults, TArray<FMarkdownCompletion>& OutResults) const;
+
+	/** Completes a "#heading" anchor from the headings of the document text. */
+	static void SuggestAnchors(FStringView DocumentText, FStringView Prefix, int32 MaxResults, TArray<FMarkdownCompletion>& OutResults);
+
+private:
+
+	struct FNode
+	{
+		FName Segment;
+		int32 Parent = INDEX_NONE;
+
+		/** Sorted by segment, case insensitive. */
+		TArray<int32> Children;
+
+		/** Set when the package at this path holds an indexed asset. */
+		FName AssetName;
+		FTopLevelAssetPath AssetClass;
+
+		bool HasAsset() const { return !AssetName.IsNone(); }
+	};
+
+	struct FNameEntry
+	{
+		FName Name;
+		int32 Node = INDEX_NONE;
+	};
+
+	void BuildFromRegistry();
+	void FinishBuild(FMarkdownCompletionIndex& Built, double BuildSeconds);
+
+	/** Remembers an asset changed while the index is built. Returns true if the index is not built yet. */
+	bool DeferUntilBuilt(const FSoftObjectPath& Asset);
+
+	void AddAsset(const FAssetData& AssetData, bool bSortNames);
+	void RemoveAsset(FName PackageName, FName AssetName);
+
+	int32 FindNode(FStringView PackageName) const;
+	int32 FindOrAddChild(int32 Parent, FName Segment);
+	void PruneNode(int32 Node);
+
+	/** Returns the index of the first child not ordered before the text. */
+	int32 LowerBoundChild(const FNode& Parent, FStringView Segment) const;
+	int32 LowerBoundName(FStringView Name) const;
+
+	FString GetNodePath(int32 Node) const;
+	FMarkdownCompletion MakeAssetCompletion(int32 Node) const;
+
+	void HandleFilesLoaded();
+	void HandleAssetAdded(const FAssetData& AssetData);
+	void HandleAssetRemoved(const FAssetData& AssetData);
+	void HandleAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath);
+
+private:
+
+	/** Node 0 is the root, freed nodes are recycled. */
+	TArray<FNode> Nodes;
+	TArray<int32> FreeNodes;
+
+	/** Every indexed asset, sorted by name, case insensitive. */
+	TArray<FNameEntry> Names;
+
+	/** Assets the registry reported changes for while the build task ran. */
+	TSet<FSoftObjectPath> ChangedWhileBuilding;
+
+	bool bBuilding = false;
+	bool bBuilt = false;
+};
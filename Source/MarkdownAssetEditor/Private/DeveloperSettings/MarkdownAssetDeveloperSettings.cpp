@@ -2,13 +2,96 @@
 
 #include "DeveloperSettings/MarkdownAssetDeveloperSettings.h"
 
+#include "Formatting/MarkdownFormatter.h"
 #include "ISettingsModule.h"
+#include "Lint/MarkdownLinter.h"
+#include "LogChannels/MarkdownLogChannels.h"
 
 const UMarkdownAssetDeveloperSettings* UMarkdownAssetDeveloperSettings::Get()
 {
 	return GetDefault<UMarkdownAssetDeveloperSettings>();
 }
 
+EMarkdownCookPolicy UMarkdownAssetDeveloperSettings::ResolveCookPolicy(EMarkdownCookPolicy Policy, FName PackageName) const
+{
+	if (Policy != EMarkdownCookPolicy::Default)
+	{
+		return Policy;
+	}
+
+	const FString PackagePath = PackageName.ToString();
+	auto IsUnderAny = [&PackagePath](const TArray<FDirectoryPath>& Directories)
+	{
+		return Directories.ContainsByPredicate([&PackagePath](const FDirectoryPath& Directory)
+		{
+			return !Directory.Path.IsEmpty() && FPaths::IsUnderDirectory(PackagePath, Directory.Path);
+		});
+	};
+
+	if (IsUnderAny(EditorOnlyDirectories))
+	{
+		return EMarkdownCookPolicy::EditorOnly;
+	}
+
+	if (IsUnderAny(PackedDirectories))
+	{
+		return EMarkdownCookPolicy::Packed;
+	}
+
+	return bDocumentsEditorOnlyByDefault ? EMarkdownCookPolicy::EditorOnly : EMarkdownCookPolicy::Cook;
+}
+
+bool UMarkdownAssetDeveloperSettings::RedirectAssetPaths(const TMap<FSoftObjectPath, FSoftObjectPath>& OldToNewPaths)
+{
+	bool bChanged = false;
+	TMap<FSoftObjectPath, FSoftObjectPath> Redirected;
+	Redirected.Reserve(MarkdownFilesPerAssets.Num());
+
+	for (const TPair<FSoftObjectPath, FSoftObjectPath>& Entry : MarkdownFilesPerAssets)
+	{
+		const FSoftObjectPath* NewAsset = OldToNewPaths.Find(Entry.Key);
+		const FSoftObjectPath* NewMarkdown = OldToNewPaths.Find(Entry.Value);
+
+		bChanged |= NewAsset || NewMarkdown;
+		Redirected.Add(NewAsset ? *NewAsset : Entry.Key, NewMarkdown ? *NewMarkdown : Entry.Value);
+	}
+
+	if (bChanged)
+	{
+		MarkdownFilesPerAssets = MoveTemp(Redirected);
+	}
+
+	return bChanged;
+}
+
+FMarkdownLintOptions UMarkdownAssetDeveloperSettings::GetLintOptions() const
+{
+	FMarkdownLintOptions Options;
+	Options.MaxInlineImageBytes = int64(MaxInlineImageSize) * 1024;
+
+	for (const FString& Name : DisabledLintRules)
+	{
+		EMarkdownLintRule Rule;
+		if (LexTryParseString(Rule, *Name.TrimStartAndEnd()))
+		{
+			Options.Disable(Rule);
+		}
+		else
+		{
+			UE_LOG(MarkdownStaticsLog, Warning, TEXT("Unknown lint rule '%s' in the disabled lint rules."), *Name);
+		}
+	}
+
+	return Options;
+}
+
+FMarkdownFormatOptions UMarkdownAssetDeveloperSettings::GetFormatOptions() const
+{
+	FMarkdownFormatOptions Options;
+	Options.WrapColumn = WrapColumn;
+	return Options;
+}
+
 #if WITH_EDITOR
 void UMarkdownAssetDeveloperSettings::OpenEditorSettingWindow() const
 {
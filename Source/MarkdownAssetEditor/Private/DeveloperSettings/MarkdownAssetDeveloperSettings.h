@@ -7,6 +7,17 @@
 #include "Engine/DeveloperSettingsBackedByCVars.h"
 #include "MarkdownAssetDeveloperSettings.generated.h"
 
+struct FMarkdownFormatOptions;
+struct FMarkdownLintOptions;
+
+/** File format images pasted into documents are encoded to. */
+UENUM()
+enum class EMarkdownPastedImageFormat : uint8
+{
+	PNG,
+	JPEG,
+};
+
 UCLASS(Config=DocumentationSettings, DefaultConfig)
 class MARKDOWNASSETEDITOR_API UMarkdownAssetDeveloperSettings : public UDeveloperSettingsBackedByCVars
 {
@@ -42,6 +53,33 @@ public:
 		MarkdownFilesPerAssets.Add(Asset, MarkdownAsset);
 	}
 
+	EMarkdownPastedImageFormat GetPastedImageFormat() const { return PastedImageFormat; }
+	int32 GetPastedImageQuality() const { return PastedImageQuality; }
+	int32 GetMaxPastedImageWidth() const { return MaxPastedImageWidth; }
+	const FString& GetPastedImageFolder() const { return PastedImageFolder; }
+
+	bool ShouldLintOnValidate() const { return bLintOnValidate; }
+
+	/** The lint rules and limits to check documents with, see MarkdownLinter. */
+	FMarkdownLintOptions GetLintOptions() const;
+
+	bool ShouldFormatOnSave() const { return bFormatOnSave; }
+
+	/** The options documents are formatted with, see MarkdownFormatter. */
+	FMarkdownFormatOptions GetFormatOptions() const;
+
+	/** Resolves the default cook policy of a document from the packed and editor only folders, never returns Default. */
+	EMarkdownCookPolicy ResolveCookPolicy(EMarkdownCookPolicy Policy, FName PackageName) const;
+
+	/** True if the document is left out of the cook, either editor only or packed into the documentation archive. */
+	bool IsDocumentEditorOnly(EMarkdownCookPolicy Policy, FName PackageName) const
+	{
+		return ResolveCookPolicy(Policy, PackageName) != EMarkdownCookPolicy::Cook;
+	}
+
+	/** Updates the asset to documentation mapping after assets have been renamed. Returns true if anything changed. */
+	bool RedirectAssetPaths(const TMap<FSoftObjectPath, FSoftObjectPath>& OldToNewPaths);
+
 protected:
 
 	virtual FName GetCategoryName() const override { return FName(TEXT("Markdown")); }
@@ -68,4 +106,55 @@ protected:
 	UPROPERTY(Config, EditDefaultsOnly, Category=AssetCreation)
 	FString DefaultPrefix = FString(TEXT("MD_"));
 
+	// Documents in these folders are never cooked, unless the document itself opts in.
+	UPROPERTY(Config, EditDefaultsOnly, Category=Packaging, meta=(ContentDir))
+	TArray<FDirectoryPath> EditorOnlyDirectories;
+
+	// Documents in these folders are packed into the documentation archive instead of being cooked, unless the
+	// document itself says otherwise. Run the MarkdownPackArchive commandlet to build the archive.
+	UPROPERTY(Config, EditDefaultsOnly, Category=Packaging, meta=(ContentDir))
+	TArray<FDirectoryPath> PackedDirectories;
+
+	// If enabled, every document is editor only unless it opts in to cooking.
+	UPROPERTY(Config, EditDefaultsOnly, Category=Packaging)
+	bool bDocumentsEditorOnlyByDefault = false;
+
+	// Format of the image files pasted into linked markdown files. PNG is lossless, JPEG is much smaller for scene captures.
+	UPROPERTY(Config, EditDefaultsOnly, Category=PastedImages)
+	EMarkdownPastedImageFormat PastedImageFormat = EMarkdownPastedImageFormat::PNG;
+
+	UPROPERTY(Config, EditDefaultsOnly, Category=PastedImages, meta=(ClampMin=1, ClampMax=100, EditCondition="PastedImageFormat==EMarkdownPastedImageFormat::JPEG"))
+	int32 PastedImageQuality = 85;
+
+	// Pasted images wider than this are scaled down, 0 keeps them at their original size.
+	UPROPERTY(Config, EditDefaultsOnly, Category=PastedImages, meta=(ClampMin=0))
+	int32 MaxPastedImageWidth = 1920;
+
+	// Folder, relative to the document, pasted images are stored in. Linked markdown files get image files next to
+	// them, markdown assets get texture assets.
+	UPROPERTY(Config, EditDefaultsOnly, Category=PastedImages)
+	FString PastedImageFolder = FString(TEXT("Images"));
+
+	// If enabled, documents are linted whenever they are validated, e.g. on save or from Tools -> Validate Data.
+	UPROPERTY(Config, EditDefaultsOnly, Category=Lint)
+	bool bLintOnValidate = true;
+
+	// Lint rules that are not checked, any of heading-increment, table-columns, unclosed-fence, inline-image-size
+	// and trailing-whitespace.
+	UPROPERTY(Config, EditDefaultsOnly, Category=Lint)
+	TArray<FString> DisabledLintRules;
+
+	// Images embedded in a document as data URIs bigger than this are reported.
+	UPROPERTY(Config, EditDefaultsOnly, Category=Lint, meta=(ClampMin=1, Units="Kilobytes"))
+	int32 MaxInlineImageSize = 64;
+
+	// If enabled, documents are formatted when they are saved from the markdown editor. Whole folders can be formatted
+	// from the content browser or with the MarkdownFormat commandlet.
+	UPROPERTY(Config, EditDefaultsOnly, Category=Formatting)
+	bool bFormatOnSave = false;
+
+	// Paragraphs and list items are wrapped at this column, 0 leaves line breaks where they are.
+	UPROPERTY(Config, EditDefaultsOnly, Category=Formatting, meta=(ClampMin=0))
+	int32 WrapColumn = 0;
+
 };
@@ -0,0 +1,328 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Duplicates/MarkdownDuplicateFinder.h"
+
+#include "Async/ParallelFor.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Engine/StreamableManager.h"
+#include "HAL/FileManager.h"
+#include "LogChannels/MarkdownLogChannels.h"
+#include "MarkdownAsset.h"
+#include "Misc/Paths.h"
+
+namespace MarkdownDuplicateFinder
+{
+	static constexpr uint32 CacheMagic = 0x484E4D4D; // "MMNH"
+
+	/** Bump when the shingles or hash functions change, old signatures are not comparable. */
+	static constexpr uint32 CacheVersion = 1;
+
+	/** Buckets this full are boilerplate shared by many documents, comparing all of them would be quadratic so they are skipped. */
+	static constexpr int32 MaxBucketSize = 512;
+
+	static uint64 Mix(uint64 Value)
+	{
+		// splitmix64 finalizer
+		Value ^= Value >> 30;
+		Value *= 0xBF58476D1CE4E5B9ull;
+		Value ^= Value >> 27;
+		Value *= 0x94D049BB133111EBull;
+		return Value ^ (Value >> 31);
+	}
+
+	/** Multiply shift hash functions, one per signature slot. Fixed so signatures can be cached. */
+	struct FHashFunctions
+	{
+		uint64 Multipliers[FMarkdownDuplicateFinder::NumHashes];
+		uint64 Offsets[FMarkdownDuplicateFinder::NumHashes];
+
+		FHashFunctions()
+		{
+			uint64 State = 0x6D61726B646F776Eull;
+
+			for (int32 Index = 0; Index < FMarkdownDuplicateFinder::NumHashes; ++Index)
+			{
+				Multipliers[Index] = Mix(State += 0x9E3779B97F4A7C15ull) | 1;
+				Offsets[Index] = Mix(State += 0x9E3779B97F4A7C15ull);
+			}
+		}
+	};
+
+	static const FHashFunctions& GetHashFunctions()
+	{
+		static const FHashFunctions Functions;
+		return Functions;
+	}
+
+	static uint64 MakePairKey(int32 A, int32 B)
+	{
+		return A < B ? (uint64(A) << 32) | uint32(B) : (uint64(B) << 32) | uint32(A);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+FMarkdownDuplicateFinder::FMarkdownDuplicateFinder()
+{
+	LoadCache();
+}
+
+FString FMarkdownDuplicateFinder::GetCachePath()
+{
+	return FPaths::ProjectSavedDir() / TEXT("MarkdownAsset") / TEXT("MinHash.cache");
+}
+
+void FMarkdownDuplicateFinder::LoadCache()
+{
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*GetCachePath(), FILEREAD_Silent));
+	if (!Reader)
+	{
+		return;
+	}
+
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	*Reader << Magic << Version;
+
+	if (Magic == MarkdownDuplicateFinder::CacheMagic && Version == MarkdownDuplicateFinder::CacheVersion)
+	{
+		*Reader << Cache;
+	}
+
+	if (Reader->IsError())
+	{
+		Cache.Empty();
+	}
+}
+
+void FMarkdownDuplicateFinder::SaveCache()
+{
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*GetCachePath()));
+	if (!Writer)
+	{
+		return;
+	}
+
+	uint32 Magic = MarkdownDuplicateFinder::CacheMagic;
+	uint32 Version = MarkdownDuplicateFinder::CacheVersion;
+	*Writer << Magic << Version << Cache;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+FMarkdownDuplicateFinder::FSignature FMarkdownDuplicateFinder::ComputeSignature(FStringView Text)
+{
+	using namespace MarkdownDuplicateFinder;
+
+	const FHashFunctions& Functions = GetHashFunctions();
+
+	FSignature Signature;
+	Signature.Init(MAX_uint32, NumHashes);
+
+	uint64 Window[ShingleLen] = {};
+	int32 NumWords = 0;
+	int32 Index = 0;
+
+	while (Index < Text.Len())
+	{
+		if (!FChar::IsAlnum(Text[Index]))
+		{
+			++Index;
+			continue;
+		}
+
+		// FNV-1a of the lower case word, so case and punctuation changes do not count as edits
+		uint64 WordHash = 0xCBF29CE484222325ull;
+		while (Index < Text.Len() && FChar::IsAlnum(Text[Index]))
+		{
+			WordHash = (WordHash ^ uint64(FChar::ToLower(Text[Index++]))) * 0x100000001B3ull;
+		}
+
+		Window[NumWords++ % ShingleLen] = WordHash;
+
+		if (NumWords < ShingleLen)
+		{
+			continue;
+		}
+
+		uint64 Shingle = 0;
+		for (int32 Word = NumWords - ShingleLen; Word < NumWords; ++Word)
+		{
+			Shingle = Mix(Shingle ^ Window[Word % ShingleLen]);
+		}
+
+		for (int32 Slot = 0; Slot < NumHashes; ++Slot)
+		{
+			Signature[Slot] = FMath::Min(Signature[Slot], uint32((Functions.Multipliers[Slot] * Shingle + Functions.Offsets[Slot]) >> 32));
+		}
+	}
+
+	if (NumWords < ShingleLen)
+	{
+		Signature.Empty();
+	}
+
+	return Signature;
+}
+
+float FMarkdownDuplicateFinder::EstimateSimilarity(const FSignature& A, const FSignature& B)
+{
+	int32 NumEqual = 0;
+
+	for (int32 Slot = 0; Slot < NumHashes; ++Slot)
+	{
+		NumEqual += A[Slot] == B[Slot] ? 1 : 0;
+	}
+
+	return float(NumEqual) / NumHashes;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+TArray<FMarkdownDuplicatePair> FMarkdownDuplicateFinder::Find(const TArray<FAssetData>& Documents, float MinSimilarity)
+{
+	using namespace MarkdownDuplicateFinder;
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+
+	TArray<FString> Keys;
+	TArray<FSignature> Signatures;
+	Keys.SetNum(Documents.Num());
+	Signatures.SetNum(Documents.Num());
+
+	// documents saved since their signature was cached, or never cached, are the only ones loaded
+	TArray<int32> Missing;
+	TArray<FSoftObjectPath> ToLoad;
+
+	for (int32 Index = 0; Index < Documents.Num(); ++Index)
+	{
+		const FAssetData& Document = Documents[Index];
+
+		const UPackage* Package = FindPackage(nullptr, *Document.PackageName.ToString());
+		const TOptional<FAssetPackageData> PackageData = AssetRegistry.GetAssetPackageDataCopy(Document.PackageName);
+
+		// unsaved edits are not in the saved hash, those documents are hashed every time
+		if (PackageData.IsSet() && !(Package && Package->IsDirty()))
+		{
+			Keys[Index] = LexToString(PackageData->GetPackageSavedHash());
+
+			if (const FSignature* Cached = Cache.Find(Keys[Index]))
+			{
+				Signatures[Index] = *Cached;
+				continue;
+			}
+		}
+
+		Missing.Add(Index);
+		ToLoad.Add(Document.GetSoftObjectPath());
+	}
+
+	if (!Missing.IsEmpty())
+	{
+		FStreamableManager StreamableManager;
+		TSharedPtr<FStreamableHandle> Handle = StreamableManager.RequestSyncLoad(ToLoad);
+
+		TArray<FString> Texts;
+		Texts.SetNum(Missing.Num());
+
+		for (int32 Index = 0; Index < Missing.Num(); ++Index)
+		{
+			if (const UMarkdownAsset* Document = Cast<UMarkdownAsset>(ToLoad[Index].ResolveObject()))
+			{
+				Texts[Index] = Document->Text.ToString();
+			}
+		}
+
+		ParallelFor(Missing.Num(), [&](int32 Index)
+		{
+			Signatures[Missing[Index]] = ComputeSignature(Texts[Index]);
+		});
+
+		for (const int32 Index : Missing)
+		{
+			if (!Keys[Index].IsEmpty())
+			{
+				Cache.Add(Keys[Index], Signatures[Index]);
+			}
+		}
+
+		SaveCache();
+	}
+
+	// documents sharing any band are candidates
+	TSet<uint64> Candidates;
+	int32 NumSkippedBuckets = 0;
+	int32 LargestSkippedBucket = 0;
+
+	for (int32 Band = 0; Band < NumBands; ++Band)
+	{
+		TMap<uint64, TArray<int32>> Buckets;
+
+		for (int32 Index = 0; Index < Signatures.Num(); ++Index)
+		{
+			const FSignature& Signature = Signatures[Index];
+			if (Signature.IsEmpty())
+			{
+				continue;
+			}
+
+			uint64 BandHash = Band;
+			for (int32 Row = 0; Row < RowsPerBand; ++Row)
+			{
+				BandHash = Mix(BandHash ^ Signature[Band * RowsPerBand + Row]);
+			}
+
+			Buckets.FindOrAdd(BandHash).Add(Index);
+		}
+
+		for (const TPair<uint64, TArray<int32>>& Bucket : Buckets)
+		{
+			// comparing only part of the bucket would miss duplicates depending on registry order, skip it and say so
+			const int32 Num = Bucket.Value.Num();
+			if (Num > MaxBucketSize)
+			{
+				++NumSkippedBuckets;
+				LargestSkippedBucket = FMath::Max(LargestSkippedBucket, Num);
+				continue;
+			}
+
+			for (int32 First = 0; First < Num; ++First)
+			{
+				for (int32 Second = First + 1; Second < Num; ++Second)
+				{
+					Candidates.Add(MakePairKey(Bucket.Value[First], Bucket.Value[Second]));
+				}
+			}
+		}
+	}
+
+	if (NumSkippedBuckets > 0)
+	{
+		UE_LOG(MarkdownStaticsLog, Warning, TEXT("Skipped %d LSH buckets shared by more than %d documents (up to %d), documents that only match through common boilerplate are not reported."),
+			NumSkippedBuckets, MaxBucketSize, LargestSkippedBucket);
+	}
+
+	TArray<FMarkdownDuplicatePair> Pairs;
+
+	for (const uint64 Candidate : Candidates)
+	{
+		const int32 A = int32(Candidate >> 32);
+		const int32 B = int32(Candidate & 0xFFFFFFFF);
+
+		const float Similarity = EstimateSimilarity(Signatures[A], Signatures[B]);
+		if (Similarity >= MinSimilarity)
+		{
+			Pairs.Add({ Documents[A].GetSoftObjectPath(), Documents[B].GetSoftObjectPath(), Similarity });
+		}
+	}
+
+	Pairs.Sort([](const FMarkdownDuplicatePair& A, const FMarkdownDuplicatePair& B) { return A.Similarity > B.Similarity; });
+
+	UE_LOG(MarkdownStaticsLog, Log, TEXT("Compared %d markdown documents (%d hashed, %d candidate pairs) in %.2f seconds, found %d near duplicate pairs."),
+		Documents.Num(), Missing.Num(), Candidates.Num(), FPlatformTime::Seconds() - StartTime, Pairs.Num());
+
+	return Pairs;
+}
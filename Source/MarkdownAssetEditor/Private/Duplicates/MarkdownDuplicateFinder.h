@@ -0,0 +1,62 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/SoftObjectPath.h"
+
+struct FAssetData;
+
+struct FMarkdownDuplicatePair
+{
+	FSoftObjectPath A;
+	FSoftObjectPath B;
+
+	/** Estimated fraction of shared text, 0 to 1. */
+	float Similarity = 0.0f;
+};
+
+/**
+ * Finds documents that are mostly the same text, e.g. pages that were copied and then drifted apart.
+ *
+ * Each document gets a MinHash signature of its word shingles, which estimates how much text two documents share
+ * without comparing them. Signatures are split into bands and only documents with an identical band are compared
+ * (locality sensitive hashing), so the work grows with the number of documents rather than the number of pairs.
+ * Signatures are cached on disk against the package saved hash, unchanged documents are neither loaded nor hashed
+ * again.
+ */
+class FMarkdownDuplicateFinder
+{
+public:
+
+	static constexpr int32 NumHashes = 128;
+
+	/** 32 bands of 4 rows make pairs above ~50% similar very likely to share a band. */
+	static constexpr int32 NumBands = 32;
+	static constexpr int32 RowsPerBand = NumHashes / NumBands;
+
+	/** Number of consecutive words in a shingle. */
+	static constexpr int32 ShingleLen = 4;
+
+	using FSignature = TArray<uint32>;
+
+	FMarkdownDuplicateFinder();
+
+	/** Returns the pairs of documents at least MinSimilarity alike, most similar first. */
+	TArray<FMarkdownDuplicatePair> Find(const TArray<FAssetData>& Documents, float MinSimilarity);
+
+	/** Returns the signature of the text, empty when it is too short to have a shingle. */
+	static FSignature ComputeSignature(FStringView Text);
+
+	static float EstimateSimilarity(const FSignature& A, const FSignature& B);
+
+private:
+
+	static FString GetCachePath();
+
+	void LoadCache();
+	void SaveCache();
+
+	/** Signatures by package saved hash. */
+	TMap<FString, FSignature> Cache;
+};
@@ -0,0 +1,233 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Embeds/MarkdownDataEmbeds.h"
+
+#include "DataTableUtils.h"
+#include "Engine/Blueprint.h"
+#include "Engine/DataTable.h"
+#include "UObject/UnrealType.h"
+
+#define LOCTEXT_NAMESPACE "MarkdownDataEmbeds"
+
+namespace MarkdownDataEmbeds
+{
+	static FString MakeTableRow(const TArray<FString>& Cells)
+	{
+		FString Row = TEXT("|");
+		for (const FString& Cell : Cells)
+		{
+			Row += TEXT(" ") + FMarkdownEmbedExpander::EscapeTableCell(Cell) + TEXT(" |");
+		}
+		return Row + TEXT("\n");
+	}
+
+	static FString MakeTableHeader(const TArray<FString>& Titles)
+	{
+		FString Separator = TEXT("|");
+		for (int32 Index = 0; Index < Titles.Num(); ++Index)
+		{
+			Separator += TEXT(" --- |");
+		}
+		return MakeTableRow(Titles) + Separator + TEXT("\n");
+	}
+
+	static FText MissingAssetError(const FMarkdownEmbedBlock& Block)
+	{
+		return FText::Format(LOCTEXT("MissingAsset", "Could not load '{0}'."), FText::FromString(Block.GetArg(TEXT("asset"))));
+	}
+
+	/** Follows a dotted path through nested structs and exports the final value as text. */
+	static bool ExportPropertyPath(const UObject* Object, const FString& Path, FString& OutValue)
+	{
+		TArray<FString> Names;
+		Path.ParseIntoArray(Names, TEXT("."));
+
+		const UStruct* Struct = Object->GetClass();
+		const void* Container = Object;
+
+		for (int32 Index = 0; Index < Names.Num(); ++Index)
+		{
+			const FProperty* Property = FindFProperty<FProperty>(Struct, *Names[Index]);
+			if (!Property)
+			{
+				return false;
+			}
+
+			const void* Value = Property->ContainerPtrToValuePtr<void>(Container);
+
+			if (Index == Names.Num() - 1)
+			{
+				Property->ExportTextItem_Direct(OutValue, Value, nullptr, nullptr, PPF_None);
+				return true;
+			}
+
+			const FStructProperty* StructProperty = CastField<FStructProperty>(Property);
+			if (!StructProperty)
+			{
+				return false;
+			}
+
+			Struct = StructProperty->Struct;
+			Container = Value;
+		}
+
+		return false;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+FString FMarkdownDataTableEmbed::GetFingerprint(const FMarkdownEmbedBlock& Block, FMarkdownEmbedExpander& Expander)
+{
+	return Expander.GetPackageFingerprint(Block.GetAssetArg(TEXT("asset")).GetLongPackageFName());
+}
+
+FString FMarkdownDataTableEmbed::Render(const FMarkdownEmbedBlock& Block, FMarkdownEmbedExpander& Expander)
+{
+	const UDataTable* DataTable = Cast<UDataTable>(Block.GetAssetArg(TEXT("asset")).TryLoad());
+	const UScriptStruct* RowStruct = DataTable ? DataTable->GetRowStruct() : nullptr;
+
+	if (!RowStruct)
+	{
+		return FMarkdownEmbedExpander::MakeError(MarkdownDataEmbeds::MissingAssetError(Block));
+	}
+
+	TArray<const FProperty*> Columns;
+	TArray<FString> Titles;
+	Titles.Add(TEXT("Name"));
+
+	const TArray<FString> RequestedColumns = Block.GetListArg(TEXT("columns"));
+
+	if (RequestedColumns.IsEmpty())
+	{
+		for (TFieldIterator<FProperty> It(RowStruct); It; ++It)
+		{
+			Columns.Add(*It);
+			Titles.Add(DataTableUtils::GetPropertyExportName(*It));
+		}
+	}
+	else
+	{
+		for (const FString& Requested : RequestedColumns)
+		{
+			const FProperty* Column = nullptr;
+			for (TFieldIterator<FProperty> It(RowStruct); It && !Column; ++It)
+			{
+				if (DataTableUtils::GetPropertyExportName(*It).Equals(Requested, ESearchCase::IgnoreCase))
+				{
+					Column = *It;
+				}
+			}
+
+			if (!Column)
+			{
+				return FMarkdownEmbedExpander::MakeError(FText::Format(LOCTEXT("MissingColumn", "'{0}' has no column '{1}'."), FText::FromString(DataTable->GetName()), FText::FromString(Requested)));
+			}
+
+			Columns.Add(Column);
+			Titles.Add(DataTableUtils::GetPropertyExportName(Column));
+		}
+	}
+
+	TArray<TPair<FName, const uint8*>> Rows;
+	const TArray<FString> RequestedRows = Block.GetListArg(TEXT("rows"));
+
+	if (RequestedRows.IsEmpty())
+	{
+		for (const TPair<FName, uint8*>& Row : DataTable->GetRowMap())
+		{
+			Rows.Emplace(Row.Key, Row.Value);
+		}
+	}
+	else
+	{
+		for (const FString& Requested : RequestedRows)
+		{
+			const FName RowName(*Requested);
+			const uint8* RowData = DataTable->FindRowUnchecked(RowName);
+
+			if (!RowData)
+			{
+				return FMarkdownEmbedExpander::MakeError(FText::Format(LOCTEXT("MissingRow", "'{0}' has no row '{1}'."), FText::FromString(DataTable->GetName()), FText::FromString(Requested)));
+			}
+
+			Rows.Emplace(RowName, RowData);
+		}
+	}
+
+	FString Output = MarkdownDataEmbeds::MakeTableHeader(Titles);
+
+	TArray<FString> Cells;
+	for (const TPair<FName, const uint8*>& Row : Rows)
+	{
+		Cells.Reset();
+		Cells.Add(Row.Key.ToString());
+
+		for (const FProperty* Column : Columns)
+		{
+			Cells.Add(DataTableUtils::GetPropertyValueAsString(Column, Row.Value, EDataTableExportFlags::None));
+		}
+
+		Output += MarkdownDataEmbeds::MakeTableRow(Cells);
+	}
+
+	return Output;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+FString FMarkdownPropertyEmbed::GetFingerprint(const FMarkdownEmbedBlock& Block, FMarkdownEmbedExpander& Expander)
+{
+	return Expander.GetPackageFingerprint(Block.GetAssetArg(TEXT("asset")).GetLongPackageFName());
+}
+
+FString FMarkdownPropertyEmbed::Render(const FMarkdownEmbedBlock& Block, FMarkdownEmbedExpander& Expander)
+{
+	const UObject* Object = Block.GetAssetArg(TEXT("asset")).TryLoad();
+
+	// Blueprints and classes show their defaults, which is what designers tune
+	if (const UBlueprint* Blueprint = Cast<UBlueprint>(Object))
+	{
+		Object = Blueprint->GeneratedClass ? Blueprint->GeneratedClass->GetDefaultObject() : nullptr;
+	}
+	else if (const UClass* Class = Cast<UClass>(Object))
+	{
+		Object = Class->GetDefaultObject();
+	}
+
+	if (!Object)
+	{
+		return FMarkdownEmbedExpander::MakeError(MarkdownDataEmbeds::MissingAssetError(Block));
+	}
+
+	TArray<FString> Paths = Block.GetListArg(TEXT("properties"));
+
+	if (Paths.IsEmpty())
+	{
+		for (TFieldIterator<FProperty> It(Object->GetClass(), EFieldIteratorFlags::ExcludeSuper); It; ++It)
+		{
+			if (It->HasAnyPropertyFlags(CPF_Edit))
+			{
+				Paths.Add(It->GetName());
+			}
+		}
+	}
+
+	FString Output = MarkdownDataEmbeds::MakeTableHeader({ LOCTEXT("PropertyColumn", "Property").ToString(), LOCTEXT("ValueColumn", "Value").ToString() });
+
+	FString Value;
+	for (const FString& Path : Paths)
+	{
+		Value.Reset();
+		if (!MarkdownDataEmbeds::ExportPropertyPath(Object, Path, Value))
+		{
+			return FMarkdownEmbedExpander::MakeError(FText::Format(LOCTEXT("MissingProperty", "'{0}' has no property '{1}'."), FText::FromString(Object->GetClass()->GetName()), FText::FromString(Path)));
+		}
+
+		Output += MarkdownDataEmbeds::MakeTableRow({ Path, Value });
+	}
+
+	return Output;
+}
+
+#undef LOCTEXT_NAMESPACE
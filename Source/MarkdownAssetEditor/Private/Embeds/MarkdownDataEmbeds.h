@@ -0,0 +1,38 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "Embeds/MarkdownEmbedExpander.h"
+
+/**
+ * Embeds the rows of a DataTable as a markdown table.
+ *
+ *     ```datatable
+ *     asset: /Script/Engine.DataTable'/Game/Data/DT_Weapons.DT_Weapons'
+ *     columns: Damage, FireRate   (optional, defaults to every column)
+ *     rows: Rifle, Pistol         (optional, defaults to every row)
+ *     ```
+ */
+class FMarkdownDataTableEmbed : public IMarkdownEmbedDirective
+{
+public:
+
+	virtual FString GetFingerprint(const FMarkdownEmbedBlock& Block, FMarkdownEmbedExpander& Expander) override;
+	virtual FString Render(const FMarkdownEmbedBlock& Block, FMarkdownEmbedExpander& Expander) override;
+};
+
+/**
+ * Embeds property values of an asset, or of the class defaults of a Blueprint, as a markdown table.
+ *
+ *     ```property
+ *     asset: /Script/Engine.Blueprint'/Game/Characters/BP_Hero.BP_Hero'
+ *     properties: MaxHealth, Movement.WalkSpeed
+ *     ```
+ */
+class FMarkdownPropertyEmbed : public IMarkdownEmbedDirective
+{
+public:
+
+	virtual FString GetFingerprint(const FMarkdownEmbedBlock& Block, FMarkdownEmbedExpander& Expander) override;
+	virtual FString Render(const FMarkdownEmbedBlock& Block, FMarkdownEmbedExpander& Expander) override;
+};
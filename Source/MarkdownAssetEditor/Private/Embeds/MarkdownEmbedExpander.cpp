@@ -0,0 +1,335 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Embeds/MarkdownEmbedExpander.h"
+
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "IO/IoHash.h"
+#include "MarkdownAsset.h"
+#include "MarkdownScanner.h"
+#include "Misc/ScopeExit.h"
+#include "UObject/UObjectGlobals.h"
+
+#define LOCTEXT_NAMESPACE "FMarkdownEmbedExpander"
+
+namespace MarkdownEmbedExpander
+{
+	/** Bounds the cache, blocks that were edited away are never looked up again. */
+	static constexpr int32 MaxCacheEntries = 2048;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+FString FMarkdownEmbedBlock::GetArg(const FString& Key) const
+{
+	const FString* Value = Args.Find(Key.ToLower());
+	return Value ? *Value : FString();
+}
+
+TArray<FString> FMarkdownEmbedBlock::GetListArg(const FString& Key) const
+{
+	TArray<FString> Values;
+	GetArg(Key).ParseIntoArray(Values, TEXT(","));
+
+	for (FString& Value : Values)
+	{
+		Value.TrimStartAndEndInline();
+	}
+
+	Values.RemoveAll([](const FString& Value) { return Value.IsEmpty(); });
+	return Values;
+}
+
+FString FMarkdownEmbedBlock::GetLinkArg(const FString& Key) const
+{
+	const FString Value = GetArg(Key);
+
+	// a copied reference keeps the link scanner working, so renames and the link index cover embeds too
+	TArray<FMarkdownAssetLinkRef> Links;
+	MarkdownScanner::FindAssetLinks(Value, Links);
+
+	if (!Links.IsEmpty())
+	{
+		return Value.Mid(Links[0].PathStart, Links[0].PathLen);
+	}
+
+	return Value;
+}
+
+FSoftObjectPath FMarkdownEmbedBlock::GetAssetArg(const FString& Key) const
+{
+	return FSoftObjectPath(GetLinkArg(Key));
+}
+
+FMarkdownEmbedBlock FMarkdownEmbedBlock::Parse(FStringView Directive, FStringView Body)
+{
+	FMarkdownEmbedBlock Block;
+	Block.Directive = FString(Directive).ToLower();
+	Block.Body = FString(Body);
+
+	TArray<FString> Lines;
+	Block.Body.ParseIntoArrayLines(Lines);
+
+	for (const FString& Line : Lines)
+	{
+		FString Key, Value;
+		if (Line.Split(TEXT(":"), &Key, &Value))
+		{
+			Block.Args.Add(Key.TrimStartAndEnd().ToLower(), Value.TrimStartAndEnd());
+		}
+	}
+
+	return Block;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void FMarkdownEmbedExpander::Initialize()
+{
+	FCoreUObjectDelegates::OnObjectModified.AddRaw(this, &FMarkdownEmbedExpander::HandleObjectModified);
+	FCoreUObjectDelegates::OnObjectPropertyChanged.AddRaw(this, &FMarkdownEmbedExpander::HandleObjectPropertyChanged);
+}
+
+void FMarkdownEmbedExpander::Shutdown()
+{
+	FCoreUObjectDelegates::OnObjectModified.RemoveAll(this);
+	FCoreUObjectDelegates::OnObjectPropertyChanged.RemoveAll(this);
+
+	Directives.Empty();
+	Cache.Empty();
+	PackageEditCounts.Empty();
+	Dependents.Empty();
+	DocumentRevisions.Empty();
+}
+
+void FMarkdownEmbedExpander::RegisterDirective(const FString& Name, TSharedRef<IMarkdownEmbedDirective> Directive)
+{
+	Directives.Add(Name.ToLower(), Directive);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void FMarkdownEmbedExpander::ForEachBlock(const FString& Text, TFunctionRef<void(const FMarkdownEmbedBlock& Block, int32 Start, int32 End)> Visit) const
+{
+	TArray<FMarkdownFenceRef> Fences;
+	MarkdownScanner::FindFencedBlocks(Text, Fences);
+
+	for (const FMarkdownFenceRef& Fence : Fences)
+	{
+		const FStringView Info = FStringView(Text).Mid(Fence.InfoStart, Fence.InfoLen);
+		if (Directives.Contains(FString(Info).ToLower()))
+		{
+			Visit(FMarkdownEmbedBlock::Parse(Info, FStringView(Text).Mid(Fence.BodyStart, Fence.BodyLen)), Fence.Start, Fence.Start + Fence.Len);
+		}
+	}
+}
+
+FString FMarkdownEmbedExpander::Expand(const FString& Text, const FSoftObjectPath& Document)
+{
+	if (Document.IsValid())
+	{
+		ExpansionStack.Push(Document);
+	}
+
+	ON_SCOPE_EXIT
+	{
+		if (Document.IsValid())
+		{
+			ExpansionStack.Pop();
+		}
+	};
+
+	FString Result;
+	int32 Copied = 0;
+
+	ForEachBlock(Text, [this, &Text, &Result, &Copied](const FMarkdownEmbedBlock& Block, int32 Start, int32 End)
+	{
+		if (Result.IsEmpty())
+		{
+			Result.Reserve(Text.Len());
+		}
+
+		Result.Append(FStringView(Text).Mid(Copied, Start - Copied));
+		Result.Append(ExpandBlock(Block));
+		Copied = End;
+	});
+
+	if (Copied == 0)
+	{
+		return Text;
+	}
+
+	Result.Append(FStringView(Text).RightChop(Copied));
+	return Result;
+}
+
+FString FMarkdownEmbedExpander::ExpandBlock(const FMarkdownEmbedBlock& Block)
+{
+	const TSharedRef<IMarkdownEmbedDirective>* Directive = Directives.Find(Block.Directive);
+	if (!Directive)
+	{
+		return MakeError(FText::Format(LOCTEXT("UnknownDirective", "Unknown embed '{0}'."), FText::FromString(Block.Directive)));
+	}
+
+	const FString Key = Block.Directive + TEXT("\n") + Block.Body;
+	const FString Fingerprint = (*Directive)->GetFingerprint(Block, *this);
+
+	if (const FCacheEntry* Entry = Cache.Find(Key))
+	{
+		if (!Fingerprint.IsEmpty() && Entry->Fingerprint == Fingerprint)
+		{
+			return Entry->Output;
+		}
+	}
+
+	FString Output = (*Directive)->Render(Block, *this);
+
+	// outputs without a fingerprint, e.g. cycle errors, depend on the include stack and are never reused
+	if (Fingerprint.IsEmpty())
+	{
+		Cache.Remove(Key);
+		return Output;
+	}
+
+	if (Cache.Num() >= MarkdownEmbedExpander::MaxCacheEntries)
+	{
+		Cache.Reset();
+	}
+
+	Cache.Add(Key, FCacheEntry{ Fingerprint, Output });
+	return Output;
+}
+
+bool FMarkdownEmbedExpander::GetEmbedsFingerprint(const FString& Text, const FSoftObjectPath& Document, FString& OutFingerprint)
+{
+	if (Document.IsValid())
+	{
+		ExpansionStack.Push(Document);
+	}
+
+	ON_SCOPE_EXIT
+	{
+		if (Document.IsValid())
+		{
+			ExpansionStack.Pop();
+		}
+	};
+
+	bool bCacheable = true;
+
+	ForEachBlock(Text, [this, &OutFingerprint, &bCacheable](const FMarkdownEmbedBlock& Block, int32 Start, int32 End)
+	{
+		if (!bCacheable)
+		{
+			return;
+		}
+
+		const FString Fingerprint = Directives[Block.Directive]->GetFingerprint(Block, *this);
+
+		bCacheable = !Fingerprint.IsEmpty();
+		OutFingerprint.Append(Fingerprint);
+		OutFingerprint.AppendChar(TEXT(';'));
+	});
+
+	return bCacheable;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+FString FMarkdownEmbedExpander::GetPackageFingerprint(FName PackageName)
+{
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+
+	const TOptional<FAssetPackageData> PackageData = AssetRegistry.GetAssetPackageDataCopy(PackageName);
+	const uint32 EditCount = PackageEditCounts.FindOrAdd(PackageName);
+
+	if (!PackageData.IsSet() && !FindPackage(nullptr, *PackageName.ToString()))
+	{
+		return FString();
+	}
+
+	const FString SavedHash = PackageData.IsSet() ? LexToString(PackageData->GetPackageSavedHash()) : FString(TEXT("unsaved"));
+	return FString::Printf(TEXT("%s#%u"), *SavedHash, EditCount);
+}
+
+bool FMarkdownEmbedExpander::IsExpanding(const FSoftObjectPath& Document) const
+{
+	return ExpansionStack.Contains(Document);
+}
+
+void FMarkdownEmbedExpander::AddDocumentDependency(const FSoftObjectPath& Dependency)
+{
+	if (!ExpansionStack.IsEmpty())
+	{
+		Dependents.FindOrAdd(Dependency).Add(ExpansionStack.Last());
+	}
+}
+
+uint32 FMarkdownEmbedExpander::GetDocumentRevision(const FSoftObjectPath& Document) const
+{
+	const uint32* Revision = DocumentRevisions.Find(Document);
+	return Revision ? *Revision : 0;
+}
+
+void FMarkdownEmbedExpander::InvalidateDocument(const FSoftObjectPath& Document)
+{
+	// only the documents that (transitively) include the edited one change, everything else stays cached
+	TArray<FSoftObjectPath> ToVisit = { Document };
+	TSet<FSoftObjectPath> Visited;
+
+	while (!ToVisit.IsEmpty())
+	{
+		const FSoftObjectPath Current = ToVisit.Pop();
+
+		bool bAlreadyVisited = false;
+		Visited.Add(Current, &bAlreadyVisited);
+		if (bAlreadyVisited)
+		{
+			continue;
+		}
+
+		++DocumentRevisions.FindOrAdd(Current);
+
+		if (const TSet<FSoftObjectPath>* Includers = Dependents.Find(Current))
+		{
+			ToVisit.Append(Includers->Array());
+		}
+	}
+}
+
+FString FMarkdownEmbedExpander::MakeError(const FText& Message)
+{
+	return FString::Printf(TEXT("> **%s** %s\n"), *LOCTEXT("EmbedErrorPrefix", "Embed error:").ToString(), *Message.ToString());
+}
+
+FString FMarkdownEmbedExpander::EscapeTableCell(const FString& Value)
+{
+	FString Escaped = Value.Replace(TEXT("|"), TEXT("\\|"));
+	Escaped.ReplaceCharInline(TEXT('\n'), TEXT(' '));
+	Escaped.ReplaceCharInline(TEXT('\r'), TEXT(' '));
+	return Escaped;
+}
+
+void FMarkdownEmbedExpander::HandleObjectModified(UObject* Object)
+{
+	if (const UMarkdownAsset* Document = Cast<UMarkdownAsset>(Object))
+	{
+		InvalidateDocument(FSoftObjectPath(Document));
+	}
+
+	// edits that are not saved yet do not change the package hash, count them so embeds still show live values
+	if (Object && !PackageEditCounts.IsEmpty())
+	{
+		if (uint32* EditCount = PackageEditCounts.Find(Object->GetOutermost()->GetFName()))
+		{
+			++*EditCount;
+		}
+	}
+}
+
+void FMarkdownEmbedExpander::HandleObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent)
+{
+	HandleObjectModified(Object);
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,144 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/SoftObjectPath.h"
+
+class FMarkdownEmbedExpander;
+
+/**
+ * A fenced block whose info string names an embed directive, e.g.
+ *
+ *     ```datatable
+ *     asset: /Script/Engine.DataTable'/Game/Data/DT_Weapons.DT_Weapons'
+ *     columns: Damage, FireRate
+ *     ```
+ *
+ * The body is a list of "key: value" lines.
+ */
+struct FMarkdownEmbedBlock
+{
+	FString Directive;
+	FString Body;
+	TMap<FString, FString> Args;
+
+	/** Returns the trimmed value of an argument, or an empty string. Keys are case insensitive. */
+	FString GetArg(const FString& Key) const;
+
+	/** Returns a comma separated argument as a list of trimmed, non-empty values. */
+	TArray<FString> GetListArg(const FString& Key) const;
+
+	/** Returns the object path of an argument written either as a path or as a copied "/Script/...'<path>'" reference. */
+	FString GetLinkArg(const FString& Key) const;
+
+	/** Returns an argument holding an asset, written either as a path or as a copied "/Script/...'<path>'" reference. */
+	FSoftObjectPath GetAssetArg(const FString& Key) const;
+
+	static FMarkdownEmbedBlock Parse(FStringView Directive, FStringView Body);
+};
+
+/** Generates the markdown for one kind of embed block. */
+class IMarkdownEmbedDirective
+{
+public:
+
+	virtual ~IMarkdownEmbedDirective() = default;
+
+	/**
+	 * Returns a cheap key for the current state of everything the block reads, e.g. the package hash of the source
+	 * asset. When it matches the cached fingerprint the cached output is reused and Render is not called. An empty
+	 * fingerprint means the output must not be cached, e.g. because it depends on where the block is expanded.
+	 */
+	virtual FString GetFingerprint(const FMarkdownEmbedBlock& Block, FMarkdownEmbedExpander& Expander) = 0;
+
+	/** Generates the markdown replacing the block. */
+	virtual FString Render(const FMarkdownEmbedBlock& Block, FMarkdownEmbedExpander& Expander) = 0;
+};
+
+/**
+ * Expands embed blocks into plain markdown before the text is rendered by the viewer.
+ *
+ * Outputs are cached per block and reused for as long as the directive reports the same fingerprint, so rendering a
+ * document repeatedly does not re-read the assets or files it embeds.
+ */
+class FMarkdownEmbedExpander
+{
+public:
+
+	void Initialize();
+	void Shutdown();
+
+	void RegisterDirective(const FString& Name, TSharedRef<IMarkdownEmbedDirective> Directive);
+
+	/**
+	 * Returns the text with every embed block replaced by its generated markdown. Document identifies where the text
+	 * comes from, if known, so documents including themselves are detected straight away.
+	 */
+	FString Expand(const FString& Text, const FSoftObjectPath& Document = FSoftObjectPath());
+
+	/** Expands a single block, using the cache. */
+	FString ExpandBlock(const FMarkdownEmbedBlock& Block);
+
+	/**
+	 * Combines the fingerprints of every embed block in the text, as if it was expanded as Document. Returns false if
+	 * any of them can not be cached. Lets blocks that expand other text (includes) change whenever the embeds inside
+	 * that text do.
+	 */
+	bool GetEmbedsFingerprint(const FString& Text, const FSoftObjectPath& Document, FString& OutFingerprint);
+
+	/**
+	 * Returns a key that changes whenever the package is saved or its objects are edited in memory, or an empty
+	 * string if the package does not exist.
+	 */
+	FString GetPackageFingerprint(FName PackageName);
+
+	/** Returns true if the document is being expanded, i.e. including it again would be a cycle. */
+	bool IsExpanding(const FSoftObjectPath& Document) const;
+
+	/** The documents currently being expanded, outermost first. */
+	const TArray<FSoftObjectPath>& GetExpansionStack() const { return ExpansionStack; }
+
+	/** Records that the document being expanded depends on another one, so editing that one invalidates it. */
+	void AddDocumentDependency(const FSoftObjectPath& Dependency);
+
+	/** Returns a counter that changes whenever the document, or any document it depends on, is edited. */
+	uint32 GetDocumentRevision(const FSoftObjectPath& Document) const;
+
+	/** Bumps the revision of the document and of every document depending on it. */
+	void InvalidateDocument(const FSoftObjectPath& Document);
+
+	/** Formats an error as markdown, shown in place of the block. */
+	static FString MakeError(const FText& Message);
+
+	/** Escapes a value for use inside a markdown table cell. */
+	static FString EscapeTableCell(const FString& Value);
+
+private:
+
+	/** Calls Visit with each embed block of the text and where it starts and ends, in order. */
+	void ForEachBlock(const FString& Text, TFunctionRef<void(const FMarkdownEmbedBlock& Block, int32 Start, int32 End)> Visit) const;
+
+	void HandleObjectModified(UObject* Object);
+	void HandleObjectPropertyChanged(UObject* Object, struct FPropertyChangedEvent& PropertyChangedEvent);
+
+	struct FCacheEntry
+	{
+		FString Fingerprint;
+		FString Output;
+	};
+
+	TMap<FString, TSharedRef<IMarkdownEmbedDirective>> Directives;
+
+	/** Keyed by directive and block body. */
+	TMap<FString, FCacheEntry> Cache;
+
+	/** In-memory edit counters of the packages embeds read from, only packages that were fingerprinted are tracked. */
+	TMap<FName, uint32> PackageEditCounts;
+
+	TArray<FSoftObjectPath> ExpansionStack;
+
+	/** Document to the documents that include it. */
+	TMap<FSoftObjectPath, TSet<FSoftObjectPath>> Dependents;
+	TMap<FSoftObjectPath, uint32> DocumentRevisions;
+};
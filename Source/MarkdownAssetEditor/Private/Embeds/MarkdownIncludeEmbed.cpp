@@ -0,0 +1,152 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Embeds/MarkdownIncludeEmbed.h"
+
+#include "MarkdownAsset.h"
+#include "MarkdownScanner.h"
+#include "MarkdownSyntaxTree.h"
+
+#define LOCTEXT_NAMESPACE "MarkdownIncludeEmbed"
+
+namespace MarkdownIncludeEmbed
+{
+	static int32 FindLineStart(FStringView Text, int32 Index)
+	{
+		while (Index > 0 && Text[Index - 1] != TEXT('\n'))
+		{
+			--Index;
+		}
+		return Index;
+	}
+
+	static int32 FindLineEnd(FStringView Text, int32 Index)
+	{
+		while (Index < Text.Len() && Text[Index] != TEXT('\n'))
+		{
+			++Index;
+		}
+		return Index;
+	}
+
+	/** Returns the content under a heading, up to the next heading of the same or a higher level. */
+	static bool ExtractSection(FStringView Text, const FString& Section, FStringView& OutSection)
+	{
+		const FMarkdownSyntaxTree Tree = FMarkdownSyntaxTree::Parse(FString(Text));
+		FMarkdownHeadingAnchors Anchors;
+
+		TArray<const FMarkdownNode*> Headings;
+		TArray<FString> HeadingAnchors;
+
+		for (const FMarkdownNode& Node : Tree.GetNodes())
+		{
+			if (Node.Type == EMarkdownNodeType::Heading)
+			{
+				Headings.Add(&Node);
+				HeadingAnchors.Add(Anchors.Add(Tree.GetInlineText(Node)));
+			}
+		}
+
+		for (int32 Index = 0; Index < Headings.Num(); ++Index)
+		{
+			const FMarkdownNode& Heading = *Headings[Index];
+
+			if (!Tree.GetArg(Heading).Equals(Section, ESearchCase::IgnoreCase) && !HeadingAnchors[Index].Equals(Section, ESearchCase::IgnoreCase))
+			{
+				continue;
+			}
+
+			// underlined headings span two lines, the section starts after the last
+			const int32 Start = FMath::Min(FindLineEnd(Text, FMath::Max(Heading.Start + Heading.Len - 1, Heading.Start)) + 1, Text.Len());
+			int32 End = Text.Len();
+
+			for (int32 Next = Index + 1; Next < Headings.Num(); ++Next)
+			{
+				if (Headings[Next]->Level <= Heading.Level)
+				{
+					End = FindLineStart(Text, Headings[Next]->Start);
+					break;
+				}
+			}
+
+			OutSection = Text.Mid(Start, End - Start);
+			return true;
+		}
+
+		return false;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+FString FMarkdownIncludeEmbed::GetFingerprint(const FMarkdownEmbedBlock& Block, FMarkdownEmbedExpander& Expander)
+{
+	const FSoftObjectPath Document = Block.GetAssetArg(TEXT("asset"));
+
+	// never serve a cached expansion for a cycle, Render reports it instead
+	if (Expander.IsExpanding(Document))
+	{
+		return FString();
+	}
+
+	Expander.AddDocumentDependency(Document);
+
+	const FString PackageFingerprint = Expander.GetPackageFingerprint(Document.GetLongPackageFName());
+	if (PackageFingerprint.IsEmpty())
+	{
+		return FString();
+	}
+
+	FString Fingerprint = FString::Printf(TEXT("%s@%u|"), *PackageFingerprint, Expander.GetDocumentRevision(Document));
+
+	// the included text may embed data tables, properties or source of its own, whose changes do not touch its
+	// package, and a cycle further down has to be reported from wherever the include is expanded
+	const UMarkdownAsset* Loaded = Cast<UMarkdownAsset>(Document.ResolveObject());
+	if (!Loaded || !Expander.GetEmbedsFingerprint(Loaded->Text.ToString(), Document, Fingerprint))
+	{
+		return FString();
+	}
+
+	return Fingerprint;
+}
+
+FString FMarkdownIncludeEmbed::Render(const FMarkdownEmbedBlock& Block, FMarkdownEmbedExpander& Expander)
+{
+	const FSoftObjectPath DocumentPath = Block.GetAssetArg(TEXT("asset"));
+
+	if (Expander.IsExpanding(DocumentPath))
+	{
+		TArray<FString> Chain;
+		for (const FSoftObjectPath& Including : Expander.GetExpansionStack())
+		{
+			Chain.Add(Including.GetAssetName());
+		}
+		Chain.Add(DocumentPath.GetAssetName());
+
+		return FMarkdownEmbedExpander::MakeError(FText::Format(LOCTEXT("IncludeCycle", "Include cycle: {0}."), FText::FromString(FString::Join(Chain, TEXT(" -> ")))));
+	}
+
+	const UMarkdownAsset* Document = Cast<UMarkdownAsset>(DocumentPath.TryLoad());
+	if (!Document)
+	{
+		return FMarkdownEmbedExpander::MakeError(FText::Format(LOCTEXT("MissingDocument", "Could not load the markdown document '{0}'."), FText::FromString(Block.GetArg(TEXT("asset")))));
+	}
+
+	const FString Text = Document->Text.ToString();
+	FStringView Included = Text;
+
+	const FString Section = Block.GetArg(TEXT("section"));
+	if (!Section.IsEmpty() && !MarkdownIncludeEmbed::ExtractSection(Text, Section, Included))
+	{
+		return FMarkdownEmbedExpander::MakeError(FText::Format(LOCTEXT("MissingSection", "'{0}' has no section '{1}'."), FText::FromString(Document->GetName()), FText::FromString(Section)));
+	}
+
+	FString Output = Expander.Expand(FString(Included), DocumentPath);
+	if (!Output.EndsWith(TEXT("\n")))
+	{
+		Output.AppendChar(TEXT('\n'));
+	}
+
+	return Output;
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,24 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "Embeds/MarkdownEmbedExpander.h"
+
+/**
+ * Transcludes another markdown document, or one section of it, expanding its own embeds.
+ *
+ *     ```include
+ *     asset: /Script/MarkdownAsset.MarkdownAsset'/Game/Docs/Snippets/Glossary.Glossary'
+ *     section: Combat Terms   (optional, a heading title or anchor)
+ *     ```
+ *
+ * The output is cached until the included document, anything it includes in turn or anything they embed changes.
+ * Includes that lead into a cycle are never cached.
+ */
+class FMarkdownIncludeEmbed : public IMarkdownEmbedDirective
+{
+public:
+
+	virtual FString GetFingerprint(const FMarkdownEmbedBlock& Block, FMarkdownEmbedExpander& Expander) override;
+	virtual FString Render(const FMarkdownEmbedBlock& Block, FMarkdownEmbedExpander& Expander) override;
+};
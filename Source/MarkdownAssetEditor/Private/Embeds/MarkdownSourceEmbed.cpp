@@ -0,0 +1,407 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Embeds/MarkdownSourceEmbed.h"
+
+#include "DirectoryWatcherModule.h"
+#include "HAL/FileManager.h"
+#include "IDirectoryWatcher.h"
+#include "Internationalization/Regex.h"
+#include "Links/MarkdownLinkResolver.h"
+#include "MarkdownAssetEditorModule.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "SourceCodeNavigation.h"
+
+#define LOCTEXT_NAMESPACE "MarkdownSourceEmbed"
+
+namespace MarkdownSourceEmbed
+{
+	static bool IsIdentifier(const FString& Name)
+	{
+		if (Name.IsEmpty() || FChar::IsDigit(Name[0]))
+		{
+			return false;
+		}
+
+		for (const TCHAR Char : Name)
+		{
+			if (!FChar::IsAlnum(Char) && Char != TEXT('_'))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	/** Skips a comment, string or character literal starting at Index, returns false if there is none. */
+	static bool SkipNonCode(const FString& Source, int32& Index)
+	{
+		const TCHAR Char = Source[Index];
+		const TCHAR Next = Index + 1 < Source.Len() ? Source[Index + 1] : TEXT('\0');
+
+		if (Char == TEXT('/') && Next == TEXT('/'))
+		{
+			while (Index < Source.Len() && Source[Index] != TEXT('\n'))
+			{
+				++Index;
+			}
+			return true;
+		}
+
+		if (Char == TEXT('/') && Next == TEXT('*'))
+		{
+			const int32 End = Source.Find(TEXT("*/"), ESearchCase::CaseSensitive, ESearchDir::FromStart, Index + 2);
+			Index = End == INDEX_NONE ? Source.Len() : End + 2;
+			return true;
+		}
+
+		if (Char == TEXT('"') || Char == TEXT('\''))
+		{
+			for (++Index; Index < Source.Len() && Source[Index] != Char && Source[Index] != TEXT('\n'); ++Index)
+			{
+				if (Source[Index] == TEXT('\\'))
+				{
+					++Index;
+				}
+			}
+			++Index;
+			return true;
+		}
+
+		return false;
+	}
+
+	/**
+	 * Finds the definition of a function ("Qualifier::Function(...) { ... }") and returns the range of lines it covers.
+	 * Declarations are skipped, the first match followed by a body wins.
+	 */
+	static bool FindFunctionBody(const FString& Source, const FString& Qualifier, const FString& Function, int32& OutStart, int32& OutEnd)
+	{
+		const FString Pattern = Qualifier.IsEmpty()
+			? FString::Printf(TEXT("\\b(\\w+::)?%s\\s*\\("), *Function)
+			: FString::Printf(TEXT("\\b%s::%s\\s*\\("), *Qualifier, *Function);
+
+		const FRegexPattern RegexPattern(Pattern);
+		FRegexMatcher Matcher(RegexPattern, Source);
+
+		while (Matcher.FindNext())
+		{
+			int32 Index = Matcher.GetMatchEnding();
+
+			// close the parameter list
+			for (int32 Depth = 1; Index < Source.Len() && Depth > 0; ++Index)
+			{
+				if (SkipNonCode(Source, Index))
+				{
+					--Index;
+					continue;
+				}
+
+				Depth += Source[Index] == TEXT('(') ? 1 : Source[Index] == TEXT(')') ? -1 : 0;
+			}
+
+			// a body opens before the statement ends, anything else was a declaration or a call
+			while (Index < Source.Len() && Source[Index] != TEXT('{') && Source[Index] != TEXT(';'))
+			{
+				if (!SkipNonCode(Source, Index))
+				{
+					++Index;
+				}
+			}
+
+			if (Index >= Source.Len() || Source[Index] == TEXT(';'))
+			{
+				continue;
+			}
+
+			int32 Depth = 0;
+			while (Index < Source.Len())
+			{
+				if (SkipNonCode(Source, Index))
+				{
+					continue;
+				}
+
+				Depth += Source[Index] == TEXT('{') ? 1 : Source[Index] == TEXT('}') ? -1 : 0;
+				++Index;
+
+				if (Depth == 0)
+				{
+					break;
+				}
+			}
+
+			OutStart = Matcher.GetMatchBeginning();
+			while (OutStart > 0 && Source[OutStart - 1] != TEXT('\n'))
+			{
+				--OutStart;
+			}
+
+			OutEnd = Index;
+			while (OutEnd < Source.Len() && Source[OutEnd] != TEXT('\n'))
+			{
+				++OutEnd;
+			}
+
+			return true;
+		}
+
+		return false;
+	}
+
+	/** Returns the range of a "first-last" (or single) one based line range. */
+	static bool FindLineRange(const FString& Source, const FString& Lines, int32& OutStart, int32& OutEnd)
+	{
+		FString FirstText, LastText;
+		if (!Lines.Split(TEXT("-"), &FirstText, &LastText))
+		{
+			FirstText = LastText = Lines;
+		}
+
+		const int32 First = FCString::Atoi(*FirstText.TrimStartAndEnd());
+		const int32 Last = FCString::Atoi(*LastText.TrimStartAndEnd());
+
+		if (First < 1 || Last < First)
+		{
+			return false;
+		}
+
+		int32 Line = 1;
+		OutStart = INDEX_NONE;
+		OutEnd = Source.Len();
+
+		for (int32 Index = 0; Index <= Source.Len(); ++Index)
+		{
+			if (Line == First && OutStart == INDEX_NONE)
+			{
+				OutStart = Index;
+			}
+
+			if (Index == Source.Len() || Source[Index] == TEXT('\n'))
+			{
+				if (Line == Last)
+				{
+					OutEnd = Index;
+					break;
+				}
+				++Line;
+			}
+		}
+
+		return OutStart != INDEX_NONE;
+	}
+
+	static FString GetFenceLanguage(const FString& FilePath)
+	{
+		const FString Extension = FPaths::GetExtension(FilePath).ToLower();
+		return (Extension == TEXT("h") || Extension == TEXT("hpp") || Extension == TEXT("inl") || Extension == TEXT("c")) ? TEXT("cpp") : Extension;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+FMarkdownSourceEmbed::~FMarkdownSourceEmbed()
+{
+	if (FDirectoryWatcherModule* DirectoryWatcherModule = FModuleManager::GetModulePtr<FDirectoryWatcherModule>("DirectoryWatcher"))
+	{
+		if (IDirectoryWatcher* DirectoryWatcher = DirectoryWatcherModule->Get())
+		{
+			for (const TPair<FString, FDelegateHandle>& Watched : WatchedDirectories)
+			{
+				DirectoryWatcher->UnregisterDirectoryChangedCallback_Handle(Watched.Key, Watched.Value);
+			}
+		}
+	}
+}
+
+FString FMarkdownSourceEmbed::GetFingerprint(const FMarkdownEmbedBlock& Block, FMarkdownEmbedExpander& Expander)
+{
+	FSourceLocation Location;
+	FText Error;
+
+	if (!ResolveLocation(Block, Location, Error))
+	{
+		return FString();
+	}
+
+	// the timestamp is the one cached when the file was read, the directory watcher drops it when the file changes
+	const FSourceFile* File = GetSourceFile(Location.FilePath);
+	return File ? Location.FilePath + TEXT("@") + File->TimeStamp.ToString() : FString();
+}
+
+FString FMarkdownSourceEmbed::Render(const FMarkdownEmbedBlock& Block, FMarkdownEmbedExpander& Expander)
+{
+	FSourceLocation Location;
+	FText Error;
+
+	if (!ResolveLocation(Block, Location, Error))
+	{
+		return FMarkdownEmbedExpander::MakeError(Error);
+	}
+
+	const FSourceFile* File = GetSourceFile(Location.FilePath);
+	if (!File)
+	{
+		return FMarkdownEmbedExpander::MakeError(FText::Format(LOCTEXT("UnreadableFile", "Could not read '{0}'."), FText::FromString(Location.FilePath)));
+	}
+
+	int32 Start = 0;
+	int32 End = File->Content.Len();
+
+	const FString Lines = Block.GetArg(TEXT("lines"));
+
+	if (!Location.Function.IsEmpty())
+	{
+		if (!MarkdownSourceEmbed::FindFunctionBody(File->Content, Location.Qualifier, Location.Function, Start, End))
+		{
+			return FMarkdownEmbedExpander::MakeError(FText::Format(LOCTEXT("MissingFunction", "Could not find the definition of '{0}' in '{1}'."), FText::FromString(Location.Function), FText::FromString(FPaths::GetCleanFilename(Location.FilePath))));
+		}
+	}
+	else if (!Lines.IsEmpty() && !MarkdownSourceEmbed::FindLineRange(File->Content, Lines, Start, End))
+	{
+		return FMarkdownEmbedExpander::MakeError(FText::Format(LOCTEXT("InvalidLines", "Invalid line range '{0}'."), FText::FromString(Lines)));
+	}
+
+	const FString Excerpt = File->Content.Mid(Start, End - Start).TrimEnd();
+
+	return FString::Printf(TEXT("```%s\n%s\n```\n*%s*\n"), *MarkdownSourceEmbed::GetFenceLanguage(Location.FilePath), *Excerpt, *FPaths::GetCleanFilename(Location.FilePath));
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool FMarkdownSourceEmbed::ResolveLocation(const FMarkdownEmbedBlock& Block, FSourceLocation& OutLocation, FText& OutError)
+{
+	OutLocation.Function = Block.GetArg(TEXT("function"));
+
+	const FString FilePath = Block.GetArg(TEXT("file"));
+	if (!FilePath.IsEmpty())
+	{
+		// relative to the project, and never outside of it
+		const FString ProjectDir = FPaths::ConvertRelativePathToFull(FPaths::ProjectDir());
+		OutLocation.FilePath = FPaths::ConvertRelativePathToFull(ProjectDir, FilePath);
+
+		if (!FPaths::IsUnderDirectory(OutLocation.FilePath, ProjectDir))
+		{
+			OutError = FText::Format(LOCTEXT("FileOutsideProject", "'{0}' is not inside the project folder."), FText::FromString(FilePath));
+			return false;
+		}
+	}
+	else if (!ResolveClassLocation(Block, OutLocation, OutError))
+	{
+		return false;
+	}
+
+	// the name ends up in a regex, anything but an identifier is rejected
+	if (!OutLocation.Function.IsEmpty() && !MarkdownSourceEmbed::IsIdentifier(OutLocation.Function))
+	{
+		OutError = FText::Format(LOCTEXT("InvalidFunction", "'{0}' is not a function name."), FText::FromString(OutLocation.Function));
+		return false;
+	}
+
+	return true;
+}
+
+bool FMarkdownSourceEmbed::ResolveClassLocation(const FMarkdownEmbedBlock& Block, FSourceLocation& OutLocation, FText& OutError)
+{
+	// "/Script/Module.Class" or "/Script/Module.Class.Function", the same form as code links
+	const FString LinkPath = Block.GetLinkArg(TEXT("class"));
+	if (LinkPath.IsEmpty())
+	{
+		OutError = LOCTEXT("MissingSource", "A source embed needs either a 'class' or a 'file'.");
+		return false;
+	}
+
+	FString ClassPath = LinkPath;
+	int32 PackageEnd = INDEX_NONE;
+	if (LinkPath.FindChar(TEXT('.'), PackageEnd))
+	{
+		const int32 FunctionDot = LinkPath.Find(TEXT("."), ESearchCase::CaseSensitive, ESearchDir::FromStart, PackageEnd + 1);
+		if (FunctionDot != INDEX_NONE)
+		{
+			ClassPath = LinkPath.Left(FunctionDot);
+			OutLocation.Function = LinkPath.RightChop(FunctionDot + 1);
+		}
+	}
+
+	const FMarkdownLinkResolver::FResolvedLink Resolved = FMarkdownAssetEditorModule::Get().GetLinkResolver().Resolve(FSoftObjectPath(ClassPath));
+	const UClass* Class = Resolved.IsValid() ? FindObject<UClass>(Resolved.Path.GetAssetPath()) : nullptr;
+
+	if (!Class)
+	{
+		OutError = FText::Format(LOCTEXT("MissingClass", "Could not find the class '{0}'."), FText::FromString(ClassPath));
+		return false;
+	}
+
+	OutLocation.Qualifier = FString(Class->GetPrefixCPP()) + Class->GetName();
+
+	const bool bHeader = Block.GetArg(TEXT("header")).ToBool();
+	const FString CacheKey = bHeader ? ClassPath + TEXT("#header") : ClassPath;
+
+	// finding the source file walks the module folders, only do it once per class
+	if (const FString* CachedPath = ClassFiles.Find(CacheKey))
+	{
+		OutLocation.FilePath = *CachedPath;
+		return true;
+	}
+
+	const bool bFound = bHeader
+		? FSourceCodeNavigation::FindClassHeaderPath(Class, OutLocation.FilePath)
+		: FSourceCodeNavigation::FindClassSourcePath(Class, OutLocation.FilePath);
+
+	if (!bFound)
+	{
+		OutError = FText::Format(LOCTEXT("MissingClassSource", "Could not find the source of '{0}', is the engine or project source available?"), FText::FromString(Class->GetName()));
+		return false;
+	}
+
+	OutLocation.FilePath = FPaths::ConvertRelativePathToFull(OutLocation.FilePath);
+	ClassFiles.Add(CacheKey, OutLocation.FilePath);
+	return true;
+}
+
+const FMarkdownSourceEmbed::FSourceFile* FMarkdownSourceEmbed::GetSourceFile(const FString& FilePath)
+{
+	if (const FSourceFile* File = Files.Find(FilePath))
+	{
+		return File;
+	}
+
+	FSourceFile File;
+	File.TimeStamp = IFileManager::Get().GetTimeStamp(*FilePath);
+
+	if (File.TimeStamp == FDateTime::MinValue() || !FFileHelper::LoadFileToString(File.Content, *FilePath))
+	{
+		return nullptr;
+	}
+
+	WatchDirectory(FPaths::GetPath(FilePath));
+	return &Files.Add(FilePath, MoveTemp(File));
+}
+
+void FMarkdownSourceEmbed::WatchDirectory(const FString& Directory)
+{
+	if (WatchedDirectories.Contains(Directory))
+	{
+		return;
+	}
+
+	FDirectoryWatcherModule& DirectoryWatcherModule = FModuleManager::LoadModuleChecked<FDirectoryWatcherModule>("DirectoryWatcher");
+	IDirectoryWatcher* DirectoryWatcher = DirectoryWatcherModule.Get();
+
+	FDelegateHandle Handle;
+	if (DirectoryWatcher && DirectoryWatcher->RegisterDirectoryChangedCallback_Handle(Directory, IDirectoryWatcher::FDirectoryChanged::CreateRaw(this, &FMarkdownSourceEmbed::HandleDirectoryChanged), Handle))
+	{
+		WatchedDirectories.Add(Directory, Handle);
+	}
+}
+
+void FMarkdownSourceEmbed::HandleDirectoryChanged(const TArray<FFileChangeData>& Changes)
+{
+	for (const FFileChangeData& Change : Changes)
+	{
+		Files.Remove(FPaths::ConvertRelativePathToFull(Change.Filename));
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
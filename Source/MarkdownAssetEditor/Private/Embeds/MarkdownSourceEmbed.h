@@ -0,0 +1,63 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "Embeds/MarkdownEmbedExpander.h"
+#include "Misc/DateTime.h"
+
+struct FFileChangeData;
+
+/**
+ * Embeds an excerpt of a C++ source file as a code block.
+ *
+ *     ```source
+ *     class: /Script/CoreUObject.Class'/Script/GameplayTasks.GameplayTask.GetOwnerActor'
+ *     ```
+ *
+ *     ```source
+ *     file: Source/MyGame/Private/MyActor.cpp
+ *     lines: 10-40
+ *     ```
+ *
+ * A class link resolves to the class source file (or its header with "header: true"), and a trailing function name,
+ * or a "function" argument, embeds just that function's body. Files are read once and cached by path and timestamp;
+ * the directories of cached files are watched, so an edited source is re-read on the next render and never before.
+ */
+class FMarkdownSourceEmbed : public IMarkdownEmbedDirective
+{
+public:
+
+	virtual ~FMarkdownSourceEmbed() override;
+
+	virtual FString GetFingerprint(const FMarkdownEmbedBlock& Block, FMarkdownEmbedExpander& Expander) override;
+	virtual FString Render(const FMarkdownEmbedBlock& Block, FMarkdownEmbedExpander& Expander) override;
+
+private:
+
+	struct FSourceFile
+	{
+		FDateTime TimeStamp;
+		FString Content;
+	};
+
+	struct FSourceLocation
+	{
+		FString FilePath;
+		FString Qualifier;
+		FString Function;
+	};
+
+	/** Maps the block arguments to a file, resolving class links through the reflection data. */
+	bool ResolveLocation(const FMarkdownEmbedBlock& Block, FSourceLocation& OutLocation, FText& OutError);
+	bool ResolveClassLocation(const FMarkdownEmbedBlock& Block, FSourceLocation& OutLocation, FText& OutError);
+
+	/** Returns the cached file, reading it (and watching its directory) on first use. */
+	const FSourceFile* GetSourceFile(const FString& FilePath);
+
+	void WatchDirectory(const FString& Directory);
+	void HandleDirectoryChanged(const TArray<FFileChangeData>& Changes);
+
+	TMap<FString, FSourceFile> Files;
+	TMap<FString, FString> ClassFiles;
+	TMap<FString, FDelegateHandle> WatchedDirectories;
+};
@@ -4,7 +4,7 @@
 
 #include "Containers/UnrealString.h"
 #include "MarkdownAsset.h"
-#include "Misc/FileHelper.h"
+#include "MarkdownTextCodec.h"
 
 
 UMarkdownAssetFactory::UMarkdownAssetFactory( const FObjectInitializer& ObjectInitializer )
@@ -21,10 +21,10 @@ UObject* UMarkdownAssetFactory::FactoryCreateFile( UClass* InClass, UObject* InP
 	UMarkdownAsset* MarkdownAsset = nullptr;
 	FString TextString;
 
-	if( FFileHelper::LoadFileToString( TextString, *Filename ) )
+	if( MarkdownTextCodec::LoadFile( Filename, TextString ) )
 	{
 		MarkdownAsset = NewObject<UMarkdownAsset>( InParent, InClass, InName, Flags );
-		MarkdownAsset->Text = FText::FromString( TextString );
+		MarkdownAsset->Text = FText::FromString( MoveTemp( TextString ) );
 	}
 
 	bOutOperationCanceled = false;
@@ -0,0 +1,403 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "FindReplace/MarkdownFindReplace.h"
+
+#include "Algo/AllOf.h"
+#include "Async/ParallelFor.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "HelperFunctions/MarkdownAssetEditorStatics.h"
+#include "Internationalization/Regex.h"
+#include "LogChannels/MarkdownLogChannels.h"
+#include "MarkdownAsset.h"
+#include "MarkdownTrigramFilter.h"
+#include "ScopedTransaction.h"
+
+#define LOCTEXT_NAMESPACE "MarkdownFindReplace"
+
+namespace MarkdownFindReplace
+{
+	static constexpr int32 MaxContextLen = 160;
+
+	static void GetRegexLiterals(const FString& Pattern, TArray<FString>& OutLiterals)
+	{
+		// with alternation no single literal is guaranteed to be part of a match, quoted sections (\Q...\E) follow
+		// rules of their own and inline flags such as (?i) or (?x) change what the literals match
+		if (Pattern.Contains(TEXT("|")) || Pattern.Contains(TEXT("\\Q")) || Pattern.Contains(TEXT("(?")))
+		{
+			return;
+		}
+
+		FString Current;
+		auto Flush = [&Current, &OutLiterals]()
+		{
+			if (Current.Len() >= 3)
+			{
+				OutLiterals.Add(Current);
+			}
+			Current.Reset();
+		};
+
+		auto SkipTo = [&Pattern](int32 Index, TCHAR Open, TCHAR Close)
+		{
+			int32 Depth = 0;
+			for (; Index < Pattern.Len(); ++Index)
+			{
+				if (Pattern[Index] == TEXT('\\'))
+				{
+					++Index;
+				}
+				else if (Pattern[Index] == Open)
+				{
+					++Depth;
+				}
+				else if (Pattern[Index] == Close && --Depth <= 0)
+				{
+					break;
+				}
+			}
+			return Index;
+		};
+
+		for (int32 Index = 0; Index < Pattern.Len(); ++Index)
+		{
+			const TCHAR Char = Pattern[Index];
+
+			switch (Char)
+			{
+				case TEXT('\\'):
+					// escaped punctuation is a literal, anything else is a class, an anchor or a character code ("\x41",
+					// "\x{e9}", "\p{L}") whose arguments must not be taken for literal text
+					if (Index + 1 < Pattern.Len() && FChar::IsPunct(Pattern[Index + 1]))
+					{
+						Current.AppendChar(Pattern[++Index]);
+					}
+					else
+					{
+						Flush();
+						while (Index + 1 < Pattern.Len() && FChar::IsAlnum(Pattern[Index + 1]))
+						{
+							++Index;
+						}
+						if (Index + 1 < Pattern.Len() && (Pattern[Index + 1] == TEXT('{') || Pattern[Index + 1] == TEXT('<')))
+						{
+							Index = SkipTo(Index + 1, Pattern[Index + 1], Pattern[Index + 1] == TEXT('{') ? TEXT('}') : TEXT('>'));
+						}
+					}
+					break;
+
+				case TEXT('?'):
+				case TEXT('*'):
+					// the previous character is optional
+					Current.LeftChopInline(1);
+					Flush();
+					break;
+
+				case TEXT('{'):
+					Current.LeftChopInline(1);
+					Flush();
+					Index = SkipTo(Index, TEXT('{'), TEXT('}'));
+					break;
+
+				case TEXT('['):
+					Flush();
+					Index = SkipTo(Index, TEXT('['), TEXT(']'));
+					break;
+
+				case TEXT('('):
+					// groups may be optional, ignore their contents
+					Flush();
+					Index = SkipTo(Index, TEXT('('), TEXT(')'));
+					break;
+
+				case TEXT('+'):
+				case TEXT('.'):
+				case TEXT('^'):
+				case TEXT('$'):
+					Flush();
+					break;
+
+				default:
+					Current.AppendChar(Char);
+					break;
+			}
+		}
+
+		Flush();
+	}
+
+	static FString ExpandReplacement(const FString& Replacement, const FRegexMatcher& Matcher)
+	{
+		FString Result;
+		Result.Reserve(Replacement.Len());
+
+		for (int32 Index = 0; Index < Replacement.Len(); ++Index)
+		{
+			const TCHAR Char = Replacement[Index];
+
+			if (Char == TEXT('$') && Index + 1 < Replacement.Len() && FChar::IsDigit(Replacement[Index + 1]))
+			{
+				Result.Append(Matcher.GetCaptureGroup(Replacement[++Index] - TEXT('0')));
+			}
+			else if (Char == TEXT('\\') && Index + 1 < Replacement.Len() && Replacement[Index + 1] == TEXT('$'))
+			{
+				Result.AppendChar(Replacement[++Index]);
+			}
+			else
+			{
+				Result.AppendChar(Char);
+			}
+		}
+
+		return Result;
+	}
+
+	template<typename CallbackType>
+	static void ForEachMatch(const FMarkdownSearchQuery& Query, const FString& Text, CallbackType&& Callback)
+	{
+		if (Query.IsEmpty())
+		{
+			return;
+		}
+
+		if (Query.bRegex)
+		{
+			const FRegexPattern Pattern(Query.Pattern, Query.bMatchCase ? ERegexPatternFlags::None : ERegexPatternFlags::CaseInsensitive);
+			FRegexMatcher Matcher(Pattern, Text);
+
+			while (Matcher.FindNext())
+			{
+				const int32 Start = Matcher.GetMatchBeginning();
+				const int32 End = Matcher.GetMatchEnding();
+
+				if (End > Start)
+				{
+					Callback(Start, End - Start, &Matcher);
+				}
+			}
+		}
+		else
+		{
+			const ESearchCase::Type SearchCase = Query.bMatchCase ? ESearchCase::CaseSensitive : ESearchCase::IgnoreCase;
+
+			int32 Start = Text.Find(Query.Pattern, SearchCase, ESearchDir::FromStart, 0);
+			while (Start != INDEX_NONE)
+			{
+				Callback(Start, Query.Pattern.Len(), nullptr);
+				Start = Text.Find(Query.Pattern, SearchCase, ESearchDir::FromStart, Start + Query.Pattern.Len());
+			}
+		}
+	}
+
+	//-----------------------------------------------------------------------------------------------------------------
+
+	void GetRequiredLiterals(const FMarkdownSearchQuery& Query, TArray<FString>& OutLiterals)
+	{
+		if (Query.bRegex)
+		{
+			GetRegexLiterals(Query.Pattern, OutLiterals);
+		}
+		else if (Query.Pattern.Len() >= 3)
+		{
+			OutLiterals.Add(Query.Pattern);
+		}
+	}
+
+	void FindMatches(const FMarkdownSearchQuery& Query, const FString& Text, TArray<FMarkdownSearchHit>& OutHits)
+	{
+		int32 Line = 1;
+		int32 LineStart = 0;
+		int32 Scanned = 0;
+
+		ForEachMatch(Query, Text, [&](int32 Start, int32 Len, const FRegexMatcher*)
+		{
+			// matches arrive in order, so line numbers are counted incrementally
+			for (; Scanned < Start; ++Scanned)
+			{
+				if (Text[Scanned] == TEXT('\n'))
+				{
+					++Line;
+					LineStart = Scanned + 1;
+				}
+			}
+
+			int32 LineEnd = Text.Find(TEXT("\n"), ESearchCase::CaseSensitive, ESearchDir::FromStart, Start);
+			if (LineEnd == INDEX_NONE)
+			{
+				LineEnd = Text.Len();
+			}
+
+			// long lines are cut to a window around the match, so matches late in the line still show what surrounds them
+			int32 ContextStart = LineStart;
+			int32 ContextEnd = LineEnd;
+
+			if (ContextEnd - ContextStart > MaxContextLen)
+			{
+				const int32 Margin = FMath::Max((MaxContextLen - Len) / 2, 0);
+				ContextStart = FMath::Clamp(Start - Margin, LineStart, FMath::Max(LineEnd - MaxContextLen, LineStart));
+				ContextEnd = FMath::Min(ContextStart + FMath::Max(MaxContextLen, Len), LineEnd);
+			}
+
+			FMarkdownSearchHit& Hit = OutHits.AddDefaulted_GetRef();
+			Hit.Start = Start;
+			Hit.Len = Len;
+			Hit.Line = Line;
+			Hit.Context = Text.Mid(ContextStart, ContextEnd - ContextStart).TrimStartAndEnd();
+		});
+	}
+
+	FString ReplaceMatches(const FMarkdownSearchQuery& Query, const FString& Text, const FString& Replacement, int32& OutNumReplaced)
+	{
+		OutNumReplaced = 0;
+
+		FString Result;
+		int32 Copied = 0;
+
+		ForEachMatch(Query, Text, [&](int32 Start, int32 Len, const FRegexMatcher* Matcher)
+		{
+			Result.Append(FStringView(Text).Mid(Copied, Start - Copied));
+			Result.Append(Matcher ? ExpandReplacement(Replacement, *Matcher) : Replacement);
+			Copied = Start + Len;
+			++OutNumReplaced;
+		});
+
+		if (OutNumReplaced == 0)
+		{
+			return Text;
+		}
+
+		Result.Append(FStringView(Text).RightChop(Copied));
+		return Result;
+	}
+
+	//-----------------------------------------------------------------------------------------------------------------
+
+	void Search(const FMarkdownSearchQuery& Query, TArray<FMarkdownSearchResult>& OutResults, FMarkdownSearchStats* OutStats)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+
+		FMarkdownSearchStats Stats;
+
+		if (Query.IsEmpty())
+		{
+			if (OutStats)
+			{
+				*OutStats = Stats;
+			}
+			return;
+		}
+
+		IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+
+		TArray<FAssetData> Documents;
+		AssetRegistry.GetAssetsByClass(UMarkdownAsset::StaticClass()->GetClassPathName(), Documents, true);
+		Stats.NumDocuments = Documents.Num();
+
+		TArray<FString> Literals;
+		GetRequiredLiterals(Query, Literals);
+
+		// decoding and testing the filters is independent per document
+		TArray<bool> IsCandidate;
+		IsCandidate.SetNumZeroed(Documents.Num());
+
+		ParallelFor(Documents.Num(), [&](int32 Index)
+		{
+			FString FilterString;
+			FMarkdownTrigramFilter Filter;
+
+			if (Literals.IsEmpty()
+				|| !Documents[Index].GetTagValue(UMarkdownAsset::TrigramsTagName, FilterString)
+				|| !FMarkdownTrigramFilter::FromString(FilterString, Filter))
+			{
+				IsCandidate[Index] = true;
+				return;
+			}
+
+			IsCandidate[Index] = Algo::AllOf(Literals, [&Filter](const FString& Literal) { return Filter.MayContain(Literal); });
+		});
+
+		// loading has to happen on the game thread, loaded documents are always searched as their tags may be stale
+		TArray<FSoftObjectPath> CandidatePaths;
+		TArray<FString> CandidateTexts;
+
+		for (int32 Index = 0; Index < Documents.Num(); ++Index)
+		{
+			UObject* Loaded = Documents[Index].FastGetAsset(false);
+
+			if (!Loaded && IsCandidate[Index])
+			{
+				Loaded = Documents[Index].GetAsset();
+				++Stats.NumLoaded;
+			}
+
+			if (const UMarkdownAsset* Document = Cast<UMarkdownAsset>(Loaded))
+			{
+				CandidatePaths.Add(Documents[Index].GetSoftObjectPath());
+				CandidateTexts.Add(Document->Text.ToString());
+			}
+		}
+
+		TArray<TArray<FMarkdownSearchHit>> Hits;
+		Hits.SetNum(CandidateTexts.Num());
+
+		ParallelFor(CandidateTexts.Num(), [&](int32 Index)
+		{
+			FindMatches(Query, CandidateTexts[Index], Hits[Index]);
+		});
+
+		for (int32 Index = 0; Index < Hits.Num(); ++Index)
+		{
+			if (!Hits[Index].IsEmpty())
+			{
+				FMarkdownSearchResult& Result = OutResults.AddDefaulted_GetRef();
+				Result.Document = CandidatePaths[Index];
+				Result.Hits = MoveTemp(Hits[Index]);
+				++Stats.NumMatched;
+			}
+		}
+
+		Stats.Seconds = FPlatformTime::Seconds() - StartTime;
+
+		UE_LOG(MarkdownStaticsLog, Log, TEXT("Markdown search '%s': %d documents, %d loaded, %d matched (%.2f ms)."),
+			*Query.Pattern, Stats.NumDocuments, Stats.NumLoaded, Stats.NumMatched, Stats.Seconds * 1000.0);
+
+		if (OutStats)
+		{
+			*OutStats = Stats;
+		}
+	}
+
+	int32 ReplaceAll(const FMarkdownSearchQuery& Query, const FString& Replacement, const TArray<FSoftObjectPath>& Documents)
+	{
+		if (Query.IsEmpty() || Documents.IsEmpty())
+		{
+			return 0;
+		}
+
+		FScopedTransaction Transaction(LOCTEXT("ReplaceAllTransaction", "Replace in Markdown Documents"));
+
+		int32 NumReplaced = 0;
+
+		for (const FSoftObjectPath& DocumentPath : Documents)
+		{
+			UMarkdownAsset* Document = Cast<UMarkdownAsset>(DocumentPath.TryLoad());
+			if (!Document)
+			{
+				continue;
+			}
+
+			// matches are recomputed from the current text in case it changed since the preview
+			int32 NumInDocument = 0;
+			const FString NewText = ReplaceMatches(Query, Document->Text.ToString(), Replacement, NumInDocument);
+
+			if (NumInDocument > 0)
+			{
+				MarkdownAssetStatics::ApplyDocumentText(Document, NewText);
+				NumReplaced += NumInDocument;
+			}
+		}
+
+		return NumReplaced;
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,62 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/SoftObjectPath.h"
+
+struct FMarkdownSearchQuery
+{
+	FString Pattern;
+	bool bRegex = false;
+	bool bMatchCase = false;
+
+	bool IsEmpty() const { return Pattern.IsEmpty(); }
+};
+
+struct FMarkdownSearchHit
+{
+	int32 Start = 0;
+	int32 Len = 0;
+
+	/** One based line number of the match. */
+	int32 Line = 0;
+
+	/** The line containing the match, for previews. Long lines are cut to a window around the match. */
+	FString Context;
+};
+
+struct FMarkdownSearchResult
+{
+	FSoftObjectPath Document;
+	TArray<FMarkdownSearchHit> Hits;
+};
+
+struct FMarkdownSearchStats
+{
+	int32 NumDocuments = 0;
+	int32 NumLoaded = 0;
+	int32 NumMatched = 0;
+	double Seconds = 0.0;
+};
+
+namespace MarkdownFindReplace
+{
+	/** Returns literal strings that every match must contain, used to skip documents with the registry trigram filter. */
+	void GetRequiredLiterals(const FMarkdownSearchQuery& Query, TArray<FString>& OutLiterals);
+
+	/** Finds all matches in a text. Thread safe. */
+	void FindMatches(const FMarkdownSearchQuery& Query, const FString& Text, TArray<FMarkdownSearchHit>& OutHits);
+
+	/** Returns the text with every match replaced, regex replacements may reference capture groups with $0-$9. */
+	FString ReplaceMatches(const FMarkdownSearchQuery& Query, const FString& Text, const FString& Replacement, int32& OutNumReplaced);
+
+	/**
+	 * Searches every markdown document in the project. Documents the trigram filter rules out are never loaded,
+	 * the remaining texts are matched in parallel.
+	 */
+	void Search(const FMarkdownSearchQuery& Query, TArray<FMarkdownSearchResult>& OutResults, FMarkdownSearchStats* OutStats = nullptr);
+
+	/** Replaces every match in the given documents inside a single undoable transaction. Returns the number of replacements. */
+	int32 ReplaceAll(const FMarkdownSearchQuery& Query, const FString& Replacement, const TArray<FSoftObjectPath>& Documents);
+}
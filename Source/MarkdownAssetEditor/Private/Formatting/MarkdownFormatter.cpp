@@ -0,0 +1,1072 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Formatting/MarkdownFormatter.h"
+
+#include "Algo/BinarySearch.h"
+#include "Async/ParallelFor.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Engine/StreamableManager.h"
+#include "HelperFunctions/MarkdownAssetEditorStatics.h"
+#include "MarkdownAsset.h"
+#include "MarkdownSyntaxTree.h"
+#include "ScopedTransaction.h"
+
+#define LOCTEXT_NAMESPACE "MarkdownFormatter"
+
+namespace MarkdownFormatter
+{
+	/** Bump whenever the output changes, documents stamped by an older formatter are then formatted again. */
+	static constexpr uint32 Version = 1;
+
+	struct FLine
+	{
+		int32 Start = 0;
+
+		/** Excludes the line break. */
+		int32 End = 0;
+
+		/** The first character that is not whitespace, End for blank lines. */
+		int32 ContentStart = 0;
+
+		/** Columns of leading whitespace, tabs stop every four columns. */
+		int32 Indent = 0;
+
+		bool bTabs = false;
+
+		bool IsBlank() const { return ContentStart == End; }
+	};
+
+	/** How a line is written out. Lines without edits lose their indentation and trailing whitespace. */
+	struct FLineEdit
+	{
+		/** Replaces the indentation with this many spaces and the marker, INDEX_NONE drops it. */
+		int32 Indent = INDEX_NONE;
+		FString Marker;
+
+		/** Where the text after the new indentation is taken from. */
+		int32 KeepStart = 0;
+
+		/** Replaces the rest of the line from here, INDEX_NONE keeps it. */
+		int32 ReplaceStart = INDEX_NONE;
+		FString Replacement;
+
+		bool bRemove = false;
+
+		/** Code, written exactly as it is apart from the indentation of the list item it is in. */
+		bool bCode = false;
+
+		/** Part of a list that could not be formatted, written exactly as it is. */
+		bool bKeepIndent = false;
+	};
+
+	/** The list item the blocks being formatted are nested in. */
+	struct FItemContext
+	{
+		int32 NewContentColumn = 0;
+	};
+
+	static bool IsInline(EMarkdownNodeType Type)
+	{
+		return Type >= EMarkdownNodeType::Text;
+	}
+
+	/** Text made only of the characters of rules, underlines, bullets and table delimiters. */
+	static bool IsMarkup(FStringView Text)
+	{
+		for (const TCHAR Char : Text)
+		{
+			if (!FChar::IsWhitespace(Char) && !FCString::Strchr(TEXT("-*_=+|:"), Char))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	/** Words that start a block at the beginning of a line, wrapping must not move them there. */
+	static bool StartsBlock(FStringView Word)
+	{
+		// words can hold runs of whitespace, only the first part ends up at the start of the line
+		int32 Whitespace = 0;
+		while (Whitespace < Word.Len() && !FChar::IsWhitespace(Word[Whitespace]))
+		{
+			++Whitespace;
+		}
+
+		Word = Word.Left(Whitespace);
+
+		const TCHAR First = Word[0];
+
+		if (First == TEXT('>') || First == TEXT('<') || Word.StartsWith(TEXT("```")) || Word.StartsWith(TEXT("~~~")))
+		{
+			return true;
+		}
+
+		bool bHashes = true;
+
+		for (const TCHAR Char : Word)
+		{
+			bHashes &= Char == TEXT('#');
+		}
+
+		if (bHashes || IsMarkup(Word))
+		{
+			return true;
+		}
+
+		// ordered list markers, "1." or "1)"
+		int32 Digits = 0;
+		while (Digits < Word.Len() && FChar::IsDigit(Word[Digits]))
+		{
+			++Digits;
+		}
+
+		return Digits > 0 && Digits <= 9 && Digits + 1 == Word.Len() && (Word[Digits] == TEXT('.') || Word[Digits] == TEXT(')'));
+	}
+
+	static void AppendSpaces(FString& Out, int32 Count)
+	{
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			Out.AppendChar(TEXT(' '));
+		}
+	}
+
+	static int32 ParseNumber(FStringView Digits)
+	{
+		int32 Number = 0;
+
+		for (const TCHAR Char : Digits)
+		{
+			if (!FChar::IsDigit(Char))
+			{
+				break;
+			}
+
+			Number = Number * 10 + (Char - TEXT('0'));
+		}
+
+		return Number;
+	}
+
+	/**
+	 * Plans an edit for every line from the syntax tree, then writes the lines out with their edits. Working on lines
+	 * leaves everything the tree does not describe (raw HTML, reference links, escapes) exactly as it was.
+	 */
+	class FFormatter
+	{
+	public:
+
+		FFormatter(const FMarkdownSyntaxTree& InTree, const FMarkdownFormatOptions& InOptions)
+			: Tree(InTree)
+			, Text(InTree.GetText())
+			, Options(InOptions)
+		{
+			SplitLines();
+			Edits.SetNum(Lines.Num());
+		}
+
+		FString Format()
+		{
+			MarkCode();
+			FormatBlocks(Tree.GetRoot(), nullptr);
+			return Write();
+		}
+
+	private:
+
+		void SplitLines()
+		{
+			Lines.Reserve(Text.Len() / 32 + 1);
+
+			int32 Start = 0;
+			while (Start < Text.Len())
+			{
+				FLine& Line = Lines.AddDefaulted_GetRef();
+				Line.Start = Start;
+
+				int32 End = Start;
+				while (End < Text.Len() && Text[End] != TEXT('\n'))
+				{
+					++End;
+				}
+
+				Start = End + 1;
+				Line.End = End > Line.Start && Text[End - 1] == TEXT('\r') ? End - 1 : End;
+
+				if (Lines.Num() == 1 && Line.End < End)
+				{
+					Newline = TEXT("\r\n");
+				}
+
+				int32 Pos = Line.Start;
+				for (; Pos < Line.End && (Text[Pos] == TEXT(' ') || Text[Pos] == TEXT('\t')); ++Pos)
+				{
+					Line.bTabs |= Text[Pos] == TEXT('\t');
+					Line.Indent = Text[Pos] == TEXT('\t') ? Line.Indent + 4 - Line.Indent % 4 : Line.Indent + 1;
+				}
+
+				Line.ContentStart = Pos;
+				Line.bTabs &= Pos < Line.End;
+			}
+		}
+
+		FStringView GetLineText(int32 LineIndex) const
+		{
+			return FStringView(Text).Mid(Lines[LineIndex].ContentStart, Lines[LineIndex].End - Lines[LineIndex].ContentStart);
+		}
+
+		int32 GetLineIndex(int32 Offset) const
+		{
+			return FMath::Max(0, int32(Algo::UpperBoundBy(Lines, Offset, &FLine::Start)) - 1);
+		}
+
+		int32 GetLastLineIndex(const FMarkdownNode& Node) const
+		{
+			return GetLineIndex(FMath::Max(Node.Start, Node.Start + Node.Len - 1));
+		}
+
+		/** Column the text at the offset ends up in, once the line is written. */
+		int32 GetOutputColumn(int32 LineIndex, int32 Offset) const
+		{
+			const FLineEdit& Edit = Edits[LineIndex];
+
+			if (Edit.Indent != INDEX_NONE)
+			{
+				return Edit.Indent + Edit.Marker.Len() + FMath::Max(0, Offset - Edit.KeepStart);
+			}
+
+			return Offset - (Edit.bKeepIndent ? Lines[LineIndex].Start : Lines[LineIndex].ContentStart);
+		}
+
+		void MarkCode()
+		{
+			for (const FMarkdownNode& Node : Tree.GetNodes())
+			{
+				if (Node.Type == EMarkdownNodeType::CodeBlock)
+				{
+					for (int32 Index = Node.Line - 1; Index <= GetLastLineIndex(Node); ++Index)
+					{
+						Edits[Index].bCode = true;
+					}
+				}
+			}
+		}
+
+		void FormatBlocks(const FMarkdownNode& Parent, const FItemContext* Item)
+		{
+			const FMarkdownNode* Previous = nullptr;
+			TCHAR PreviousMarker = 0;
+
+			Tree.ForEachChild(Parent, [this, Item, &Previous, &PreviousMarker](const FMarkdownNode& Node)
+			{
+				switch (Node.Type)
+				{
+					case EMarkdownNodeType::Heading:
+						FormatHeading(Node);
+						break;
+
+					case EMarkdownNodeType::Table:
+						FormatTable(Node);
+						break;
+
+					case EMarkdownNodeType::CodeBlock:
+						if (!Item)
+						{
+							FormatFence(Node);
+						}
+						break;
+
+					case EMarkdownNodeType::List:
+						// lists with different markers are different lists, keep them apart
+						PreviousMarker = FormatList(Node, Item, Previous && Previous->Type == EMarkdownNodeType::List ? PreviousMarker : 0, Previous && Previous->Type == EMarkdownNodeType::Table);
+						break;
+
+					case EMarkdownNodeType::Paragraph:
+						// joining the first lines of a paragraph right under a table could make a row of it
+						if (Options.WrapColumn > 0 && !(Previous && Previous->Type == EMarkdownNodeType::Table))
+						{
+							Wrap(Node.Start, Node.Start + Node.Len, Item ? Item->NewContentColumn : 0);
+						}
+						break;
+
+					default:
+						break;
+				}
+
+				Previous = &Node;
+			});
+		}
+
+		void FormatHeading(const FMarkdownNode& Node)
+		{
+			const int32 First = Node.Line - 1;
+			const int32 Last = GetLastLineIndex(Node);
+			const bool bUnderlined = EnumHasAnyFlags(Node.Flags, EMarkdownNodeFlags::Underlined);
+
+			// a title over several lines would not fit on one
+			if (bUnderlined && Last != First + 1)
+			{
+				return;
+			}
+
+			const FStringView Title = Tree.GetArg(Node);
+
+			FString Heading = FString::ChrN(Node.Level, TEXT('#'));
+
+			if (!Title.IsEmpty())
+			{
+				Heading.AppendChar(TEXT(' '));
+				Heading.Append(Title);
+
+				// a closing sequence stops trailing hashes of the title being taken for one
+				if (Title.EndsWith(TEXT('#')))
+				{
+					Heading.AppendChar(TEXT(' '));
+					Heading.Append(FString::ChrN(Node.Level, TEXT('#')));
+				}
+			}
+
+			Edits[First].ReplaceStart = Node.Start;
+			Edits[First].Replacement = MoveTemp(Heading);
+
+			if (bUnderlined)
+			{
+				Edits[Last].bRemove = true;
+			}
+		}
+
+		/** Moves an indented fence to the margin, the code keeps its indentation relative to the fence. */
+		void FormatFence(const FMarkdownNode& Block)
+		{
+			const int32 First = Block.Line - 1;
+			const int32 Last = GetLastLineIndex(Block);
+			const int32 FenceIndent = Lines[First].Indent;
+
+			if (EnumHasAnyFlags(Block.Flags, EMarkdownNodeFlags::Indented) || FenceIndent == 0)
+			{
+				return;
+			}
+
+			for (int32 Index = First; Index <= Last; ++Index)
+			{
+				if (Lines[Index].bTabs)
+				{
+					return;
+				}
+			}
+
+			for (int32 Index = First; Index <= Last; ++Index)
+			{
+				if (!Lines[Index].IsBlank())
+				{
+					Edits[Index].Indent = FMath::Max(0, Lines[Index].Indent - FenceIndent);
+					Edits[Index].KeepStart = Lines[Index].ContentStart;
+				}
+			}
+		}
+
+		void FormatTable(const FMarkdownNode& Table)
+		{
+			const int32 NumColumns = Table.Level;
+
+			TArray<const FMarkdownNode*> Rows;
+			TArray<TArray<FStringView>> Cells;
+
+			Tree.ForEachChild(Table, [this, &Rows, &Cells](const FMarkdownNode& Row)
+			{
+				Rows.Add(&Row);
+				TArray<FStringView>& RowCells = Cells.AddDefaulted_GetRef();
+
+				Tree.ForEachChild(Row, [this, &RowCells](const FMarkdownNode& Cell)
+				{
+					RowCells.Add(Tree.GetSpan(Cell));
+				});
+			});
+
+			if (NumColumns == 0 || Rows.IsEmpty())
+			{
+				return;
+			}
+
+			TArray<int32, TInlineAllocator<16>> Widths;
+			TArray<EMarkdownNodeFlags, TInlineAllocator<16>> Alignments;
+			Widths.Init(3, NumColumns);
+			Alignments.Init(EMarkdownNodeFlags::None, NumColumns);
+
+			for (int32 RowIndex = 0; RowIndex < Rows.Num(); ++RowIndex)
+			{
+				int32 Column = 0;
+
+				Tree.ForEachChild(*Rows[RowIndex], [&Widths, &Alignments, &Column, NumColumns](const FMarkdownNode& Cell)
+				{
+					if (Column < NumColumns)
+					{
+						Widths[Column] = FMath::Max(Widths[Column], Cell.Len);
+						Alignments[Column] = Cell.Flags & (EMarkdownNodeFlags::AlignLeft | EMarkdownNodeFlags::AlignRight);
+					}
+					++Column;
+				});
+			}
+
+			auto WriteRow = [&Widths, &Alignments, NumColumns](TConstArrayView<FStringView> RowCells)
+			{
+				FString Row = TEXT("|");
+
+				for (int32 Column = 0; Column < FMath::Max(NumColumns, RowCells.Num()); ++Column)
+				{
+					const FStringView Cell = Column < RowCells.Num() ? RowCells[Column] : FStringView();
+					const int32 Padding = Column < NumColumns ? Widths[Column] - Cell.Len() : 0;
+
+					const EMarkdownNodeFlags Alignment = Column < NumColumns ? Alignments[Column] : EMarkdownNodeFlags::None;
+					const int32 Left = Alignment == (EMarkdownNodeFlags::AlignLeft | EMarkdownNodeFlags::AlignRight) ? Padding / 2
+						: Alignment == EMarkdownNodeFlags::AlignRight ? Padding : 0;
+
+					Row.AppendChar(TEXT(' '));
+					AppendSpaces(Row, Left);
+					Row.Append(Cell);
+					AppendSpaces(Row, Padding - Left);
+					Row.Append(TEXT(" |"));
+				}
+
+				return Row;
+			};
+
+			FString Delimiter = TEXT("|");
+
+			for (int32 Column = 0; Column < NumColumns; ++Column)
+			{
+				const bool bLeft = EnumHasAnyFlags(Alignments[Column], EMarkdownNodeFlags::AlignLeft);
+				const bool bRight = EnumHasAnyFlags(Alignments[Column], EMarkdownNodeFlags::AlignRight);
+
+				Delimiter.Append(bLeft ? TEXT(" :") : TEXT(" -"));
+				Delimiter.Append(FString::ChrN(Widths[Column] - 2, TEXT('-')));
+				Delimiter.Append(bRight ? TEXT(": |") : TEXT("- |"));
+			}
+
+			for (int32 RowIndex = 0; RowIndex < Rows.Num(); ++RowIndex)
+			{
+				FLineEdit& Edit = Edits[Rows[RowIndex]->Line - 1];
+				Edit.ReplaceStart = Rows[RowIndex]->Start;
+				Edit.Replacement = WriteRow(Cells[RowIndex]);
+			}
+
+			// the delimiter row is not a node, it is always the line under the header
+			const int32 DelimiterLine = Rows[0]->Line;
+			Edits[DelimiterLine].ReplaceStart = Lines[DelimiterLine].ContentStart;
+			Edits[DelimiterLine].Replacement = MoveTemp(Delimiter);
+		}
+
+		/** Returns the marker the list ends up with, the next list must use another one to stay separate. */
+		TCHAR FormatList(const FMarkdownNode& List, const FItemContext* Parent, TCHAR AvoidMarker, bool bAfterTable)
+		{
+			const bool bOrdered = EnumHasAnyFlags(List.Flags, EMarkdownNodeFlags::Ordered);
+
+			TArray<const FMarkdownNode*, TInlineAllocator<32>> Items;
+			Tree.ForEachChild(List, [&Items](const FMarkdownNode& Item) { Items.Add(&Item); });
+
+			const TCHAR OldMarker = Text[Items[0]->Start + GetMarkerLen(*Items[0]) - 1];
+
+			// tabs and items starting with indented code cannot be re-indented without changing what they contain
+			const int32 LastLine = GetLastLineIndex(List);
+			bool bTabs = false;
+
+			for (int32 Index = List.Line - 1; Index <= LastLine; ++Index)
+			{
+				bTabs |= Lines[Index].bTabs;
+			}
+
+			bool bKeep = bTabs;
+
+			for (const FMarkdownNode* Item : Items)
+			{
+				bKeep |= !IsBlankItem(*Item) && GetSpacesAfterMarker(*Item) > 4;
+				const int32 TextStart = Item->Start + GetMarkerLen(*Item) + GetSpacesAfterMarker(*Item);
+				bKeep |= TextStart < Lines[Item->Line - 1].End && Text[TextStart] == TEXT('\t');
+			}
+
+			const int32 MarkerColumn = Parent ? Parent->NewContentColumn : 0;
+
+			if (bKeep)
+			{
+				// the list still moves to where its markers would be, unless it is indented with tabs
+				const int32 OldMarkerColumn = Lines[List.Line - 1].Indent;
+
+				for (int32 Index = List.Line - 1; Index <= LastLine; ++Index)
+				{
+					FLineEdit& Edit = Edits[Index];
+					Edit.bKeepIndent = true;
+					Edit.Indent = INDEX_NONE;
+
+					if (!Lines[Index].IsBlank() && !bTabs)
+					{
+						Edit.Indent = MarkerColumn + FMath::Max(0, Lines[Index].Indent - OldMarkerColumn);
+						Edit.KeepStart = Lines[Index].ContentStart;
+					}
+				}
+				return OldMarker;
+			}
+
+			// lists with different markers are different lists, the list before this one keeps its marker, bullets are
+			// chosen once the text of the items is known
+			TCHAR Marker = bOrdered ? (AvoidMarker == TEXT('.') ? TEXT(')') : TEXT('.')) : TEXT('-');
+
+			// "1. 1. 1." stays that way, anything else is numbered up from the first item
+			const int32 FirstNumber = ParseNumber(Tree.GetArg(List));
+			const bool bSameNumbers = Items.Num() > 1 && ParseNumber(Tree.GetSpan(*Items[1])) == FirstNumber;
+
+			for (int32 ItemIndex = 0; ItemIndex < Items.Num(); ++ItemIndex)
+			{
+				const FMarkdownNode& Item = *Items[ItemIndex];
+				const FLine& MarkerLine = Lines[Item.Line - 1];
+
+				const int32 MarkerLen = GetMarkerLen(Item);
+				const int32 Spaces = GetSpacesAfterMarker(Item);
+				const bool bBlank = IsBlankItem(Item);
+				const int32 OldContentColumn = MarkerLine.Indent + MarkerLen + (Spaces > 4 || Item.Start + MarkerLen + Spaces == MarkerLine.End ? 1 : Spaces);
+
+				const FString NewMarker = bOrdered ? FString::Printf(TEXT("%d%c"), bSameNumbers ? FirstNumber : FirstNumber + ItemIndex, Marker) : FString::Chr(Marker);
+				const FItemContext Context{ MarkerColumn + NewMarker.Len() + 1 };
+
+				FLineEdit& Edit = Edits[Item.Line - 1];
+				Edit.Indent = MarkerColumn;
+				Edit.Marker = bBlank ? NewMarker : NewMarker + TEXT(" ");
+				Edit.KeepStart = bBlank ? MarkerLine.End : Item.Start + MarkerLen + Spaces;
+
+				// everything in the item lines up with its text, code keeps its own indentation on top of that
+				const int32 ItemLastLine = GetLastLineIndex(Item);
+
+				for (int32 Index = Item.Line; Index <= ItemLastLine; ++Index)
+				{
+					const FLine& Line = Lines[Index];
+
+					if (Line.IsBlank() && !(Edits[Index].bCode && Line.Indent > OldContentColumn))
+					{
+						continue;
+					}
+
+					Edits[Index].Indent = Context.NewContentColumn + (Edits[Index].bCode ? FMath::Max(0, Line.Indent - OldContentColumn) : 0);
+					Edits[Index].KeepStart = Line.ContentStart;
+				}
+
+				// a line with a pipe right under a table would be a row of it
+				if (Options.WrapColumn > 0 && !(bAfterTable && ItemIndex == 0))
+				{
+					// inline spans can stop short of their closing delimiters, wrap up to the end of their last line but
+					// not into the blocks of the item
+					int32 InlineLine = INDEX_NONE;
+					int32 BlockLine = MAX_int32;
+
+					Tree.ForEachChild(Item, [this, &InlineLine, &BlockLine](const FMarkdownNode& Child)
+					{
+						InlineLine = IsInline(Child.Type) ? FMath::Max(InlineLine, GetLastLineIndex(Child)) : InlineLine;
+						BlockLine = IsInline(Child.Type) ? BlockLine : FMath::Min(BlockLine, Child.Line - 2);
+					});
+
+					InlineLine = FMath::Min(InlineLine, BlockLine);
+
+					// text under a marker with only whitespace after it is written as the paragraph it reads as next time
+					if (InlineLine != INDEX_NONE && (!bBlank || InlineLine >= Item.Line))
+					{
+						Wrap(bBlank ? Lines[Item.Line].ContentStart : Edit.KeepStart, Lines[InlineLine].End, Context.NewContentColumn);
+					}
+				}
+
+				FormatBlocks(Item, &Context);
+			}
+
+			if (!bOrdered)
+			{
+				Marker = ChooseBullet(Items, AvoidMarker);
+
+				for (const FMarkdownNode* Item : Items)
+				{
+					Edits[Item->Line - 1].Marker[0] = Marker;
+				}
+			}
+
+			return Marker;
+		}
+
+		TCHAR ChooseBullet(TConstArrayView<const FMarkdownNode*> Items, TCHAR AvoidMarker) const
+		{
+			for (const TCHAR* Candidate = TEXT("-*+"); *Candidate; ++Candidate)
+			{
+				bool bSafe = *Candidate != AvoidMarker;
+
+				for (int32 Index = 0; Index < Items.Num() && bSafe; ++Index)
+				{
+					bSafe = IsBulletSafe(GetOutputText(Items[Index]->Line - 1), *Candidate);
+				}
+
+				if (bSafe)
+				{
+					return *Candidate;
+				}
+			}
+
+			return AvoidMarker == TEXT('-') ? TEXT('*') : TEXT('-');
+		}
+
+		/** The text of the line as it is written after the indentation and marker, up to the first line break. */
+		FString GetOutputText(int32 LineIndex) const
+		{
+			const FLineEdit& Edit = Edits[LineIndex];
+			const FStringView Source = FStringView(Text).Mid(Edit.KeepStart, Lines[LineIndex].End - Edit.KeepStart);
+
+			if (Edit.ReplaceStart == INDEX_NONE)
+			{
+				return FString(Source);
+			}
+
+			int32 Break = INDEX_NONE;
+			const FStringView Replacement = Edit.Replacement;
+
+			FString Output(Source.Left(Edit.ReplaceStart - Edit.KeepStart));
+			Output.Append(Replacement.FindChar(TEXT('\n'), Break) ? Replacement.Left(Break) : Replacement);
+			return Output;
+		}
+
+		/** Items of an ordered list can have numbers of different lengths. */
+		int32 GetMarkerLen(const FMarkdownNode& Item) const
+		{
+			int32 Pos = Item.Start;
+			while (FChar::IsDigit(Text[Pos]))
+			{
+				++Pos;
+			}
+
+			return Pos - Item.Start + 1;
+		}
+
+		/** Items with nothing but whitespace after the marker, written as just the marker. */
+		bool IsBlankItem(const FMarkdownNode& Item) const
+		{
+			const int32 TextStart = Item.Start + GetMarkerLen(Item);
+			return FStringView(Text).Mid(TextStart, Lines[Item.Line - 1].End - TextStart).TrimStart().IsEmpty();
+		}
+
+		/** False if a line with the bullet and the text would read as something else than a list item. */
+		static bool IsBulletSafe(FStringView ItemText, TCHAR Marker)
+		{
+			ItemText = ItemText.TrimStartAndEnd();
+
+			bool bRule = !ItemText.IsEmpty();
+			bool bDelimiter = true;
+
+			for (const TCHAR Char : ItemText)
+			{
+				bRule &= Char == Marker || FChar::IsWhitespace(Char);
+				bDelimiter &= Char == TEXT('-') || Char == TEXT('|') || Char == TEXT(':') || FChar::IsWhitespace(Char);
+			}
+
+			// "- - -" and "* * *" are rules, a blank "-" under a line of text underlines it and "- |" is a table delimiter
+			return Marker == TEXT('-') ? !bDelimiter : !bRule;
+		}
+
+		int32 GetSpacesAfterMarker(const FMarkdownNode& Item) const
+		{
+			const int32 LineEnd = Lines[Item.Line - 1].End;
+			const int32 MarkerLen = GetMarkerLen(Item);
+
+			int32 Pos = Item.Start + MarkerLen;
+			while (Pos < LineEnd && Text[Pos] == TEXT(' '))
+			{
+				++Pos;
+			}
+
+			return Pos - Item.Start - MarkerLen;
+		}
+
+		/** Rewraps the text from Start to End, which has to be inline text, continuing lines at the indent. */
+		void Wrap(int32 Start, int32 End, int32 ContinuationIndent)
+		{
+			struct FWord
+			{
+				int32 Start = 0;
+				int32 Len = 0;
+
+				/** A hard line break follows the word. */
+				bool bBreak = false;
+			};
+
+			const int32 First = GetLineIndex(Start);
+			const int32 Last = GetLineIndex(FMath::Max(Start, End - 1));
+
+			// the last line could become the header of a table with a line of markup under it
+			if (Lines.IsValidIndex(Last + 1) && !Lines[Last + 1].IsBlank() && IsMarkup(GetLineText(Last + 1)))
+			{
+				return;
+			}
+
+			TArray<FWord> Words;
+
+			for (int32 Index = First; Index <= Last; ++Index)
+			{
+				const FLine& Line = Lines[Index];
+
+				int32 Pos = Index == First ? Start : Line.ContentStart;
+				int32 LineEnd = Line.End;
+				int32 TrailingSpaces = 0;
+
+				while (LineEnd > Pos && FChar::IsWhitespace(Text[LineEnd - 1]))
+				{
+					TrailingSpaces += Text[--LineEnd] == TEXT(' ') ? 1 : 0;
+				}
+
+				// a line like that under another one is what keeps it from being a table header, leave them be
+				if (IsMarkup(GetLineText(Index)))
+				{
+					return;
+				}
+
+				const int32 FirstWord = Words.Num();
+
+				while (Pos < LineEnd)
+				{
+					// words are split at single spaces, longer runs and tabs are kept as they may be inside code
+					const int32 WordStart = Pos;
+					while (Pos < LineEnd && !(Text[Pos] == TEXT(' ') && !FChar::IsWhitespace(Text[Pos - 1]) && !FChar::IsWhitespace(Text[Pos + 1])))
+					{
+						++Pos;
+					}
+
+					Words.Add({ WordStart, Pos - WordStart, false });
+					++Pos;
+				}
+
+				if (Index < Last && Words.Num() > FirstWord && (TrailingSpaces >= 2 || Text[LineEnd - 1] == TEXT('\\')))
+				{
+					Words.Last().bBreak = true;
+				}
+			}
+
+			FString Wrapped;
+			Wrapped.Reserve(End - Start + 16);
+
+			int32 Column = GetOutputColumn(First, Start);
+			bool bLineStart = true;
+
+			// a line starting with a fence is only text because of what follows it on the line, and a line of markup
+			// would become a rule, underline or table delimiter, neither can be broken
+			bool bKeepLine = false;
+			bool bMarkupLine = true;
+
+			auto NewLine = [this, &Wrapped, &Column, &bLineStart, &bKeepLine, &bMarkupLine, ContinuationIndent]()
+			{
+				Wrapped.Append(Newline);
+				AppendSpaces(Wrapped, ContinuationIndent);
+				Column = ContinuationIndent;
+				bLineStart = true;
+				bKeepLine = false;
+				bMarkupLine = true;
+			};
+
+			for (int32 Index = 0; Index < Words.Num(); ++Index)
+			{
+				const FWord& Word = Words[Index];
+				const FStringView WordText = FStringView(Text).Mid(Word.Start, Word.Len);
+
+				if (!bLineStart)
+				{
+					if (Column + 1 + Word.Len > Options.WrapColumn && !StartsBlock(WordText) && !bKeepLine && !bMarkupLine)
+					{
+						NewLine();
+					}
+					else
+					{
+						Wrapped.AppendChar(TEXT(' '));
+						++Column;
+					}
+				}
+
+				bKeepLine |= bLineStart && (WordText.StartsWith(TEXT("```")) || WordText.StartsWith(TEXT("~~~")));
+				bMarkupLine &= IsMarkup(WordText);
+
+				Wrapped.Append(WordText);
+				Column += Word.Len;
+				bLineStart = false;
+
+				if (Word.bBreak && Index + 1 < Words.Num())
+				{
+					Wrapped.Append(WordText.EndsWith(TEXT('\\')) ? TEXT("") : TEXT("  "));
+					NewLine();
+				}
+			}
+
+			Edits[First].ReplaceStart = Start;
+			Edits[First].Replacement = MoveTemp(Wrapped);
+
+			for (int32 Index = First + 1; Index <= Last; ++Index)
+			{
+				Edits[Index].bRemove = true;
+			}
+		}
+
+		FString Write() const
+		{
+			FString Out;
+			Out.Reserve(Text.Len() + Text.Len() / 8 + 16);
+
+			FString Line;
+			bool bPendingBlank = false;
+
+			for (int32 Index = 0; Index < Lines.Num(); ++Index)
+			{
+				const FLine& Source = Lines[Index];
+				const FLineEdit& Edit = Edits[Index];
+
+				if (Edit.bRemove)
+				{
+					continue;
+				}
+
+				Line.Reset();
+				int32 From = Edit.bCode || Edit.bKeepIndent ? Source.Start : Source.ContentStart;
+
+				if (Edit.Indent != INDEX_NONE)
+				{
+					AppendSpaces(Line, Edit.Indent);
+					Line.Append(Edit.Marker);
+					From = Edit.KeepStart;
+				}
+
+				if (Edit.ReplaceStart != INDEX_NONE && Edit.ReplaceStart >= From)
+				{
+					Line.Append(*Text + From, Edit.ReplaceStart - From);
+					Line.Append(Edit.Replacement);
+				}
+				else if (Source.End > From)
+				{
+					Line.Append(*Text + From, Source.End - From);
+				}
+
+				int32 LineLen = Line.Len();
+
+				if (!Edit.bCode && !Edit.bKeepIndent)
+				{
+					int32 NumSpaces = 0;
+					bool bOnlySpaces = true;
+
+					while (LineLen > 0 && (Line[LineLen - 1] == TEXT(' ') || Line[LineLen - 1] == TEXT('\t')))
+					{
+						bOnlySpaces &= Line[--LineLen] == TEXT(' ');
+						++NumSpaces;
+					}
+
+					// two or more spaces are a hard break
+					LineLen += LineLen > 0 && NumSpaces >= 2 && bOnlySpaces ? 2 : 0;
+
+					if (LineLen == 0)
+					{
+						// runs of blank lines become one, leading and trailing ones go
+						bPendingBlank = !Out.IsEmpty();
+						continue;
+					}
+				}
+
+				if (bPendingBlank)
+				{
+					Out.Append(Newline);
+					bPendingBlank = false;
+				}
+
+				Out.Append(*Line, LineLen);
+				Out.Append(Newline);
+			}
+
+			return Out;
+		}
+
+		const FMarkdownSyntaxTree& Tree;
+		const FString& Text;
+		const FMarkdownFormatOptions& Options;
+
+		const TCHAR* Newline = TEXT("\n");
+
+		TArray<FLine> Lines;
+		TArray<FLineEdit> Edits;
+	};
+
+	static bool IsFormatted(const UMarkdownAsset& Document, const FMarkdownFormatOptions& Options)
+	{
+		return Document.FormattedHash != 0 && Document.FormattedHash == GetFormattedHash(Document.Text.ToString(), Options);
+	}
+
+	/** Stores the formatted text and stamps the document, returns true if the text changed. */
+	static bool ApplyFormatted(UMarkdownAsset* Document, const FString& Formatted, const FMarkdownFormatOptions& Options)
+	{
+		const bool bChanged = !Document->Text.ToString().Equals(Formatted, ESearchCase::CaseSensitive);
+
+		if (bChanged)
+		{
+			MarkdownAssetStatics::ApplyDocumentText(Document, Formatted);
+		}
+
+		const uint32 Hash = GetFormattedHash(Formatted, Options);
+
+		if (Document->FormattedHash != Hash)
+		{
+			Document->Modify();
+			Document->FormattedHash = Hash;
+		}
+
+		return bChanged;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+uint32 FMarkdownFormatOptions::GetHash() const
+{
+	return HashCombine(MarkdownFormatter::Version, GetTypeHash(WrapColumn));
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+FString MarkdownFormatter::Format(const FString& Text, const FMarkdownFormatOptions& Options)
+{
+	const FMarkdownSyntaxTree Tree = FMarkdownSyntaxTree::Parse(Text);
+	return FFormatter(Tree, Options).Format();
+}
+
+uint32 MarkdownFormatter::GetFormattedHash(const FString& FormattedText, const FMarkdownFormatOptions& Options)
+{
+	return HashCombine(UMarkdownAsset::GetContentHash(FormattedText), Options.GetHash());
+}
+
+bool MarkdownFormatter::IsFormatted(const FAssetData& Document, const FMarkdownFormatOptions& Options)
+{
+	// loaded documents may have unsaved edits, their registry tags describe the saved text
+	if (const UMarkdownAsset* Loaded = Cast<UMarkdownAsset>(Document.FastGetAsset(false)))
+	{
+		return MarkdownFormatter::IsFormatted(*Loaded, Options);
+	}
+
+	uint32 ContentHash = 0;
+	uint32 FormattedHash = 0;
+
+	return Document.GetTagValue(UMarkdownAsset::ContentHashTagName, ContentHash)
+		&& Document.GetTagValue(UMarkdownAsset::FormattedHashTagName, FormattedHash)
+		&& FormattedHash == HashCombine(ContentHash, Options.GetHash());
+}
+
+bool MarkdownFormatter::FormatDocument(UMarkdownAsset* Document, const FMarkdownFormatOptions& Options)
+{
+	if (!Document || IsFormatted(*Document, Options))
+	{
+		return false;
+	}
+
+	const FString Formatted = Format(Document->Text.ToString(), Options);
+
+	FScopedTransaction Transaction(LOCTEXT("FormatDocumentTransaction", "Format Markdown Document"));
+	return ApplyFormatted(Document, Formatted, Options);
+}
+
+void MarkdownFormatter::FormatDocuments(const TArray<UMarkdownAsset*>& Documents, const FMarkdownFormatOptions& Options, TArray<UMarkdownAsset*>* OutModified, FMarkdownFormatStats* OutStats)
+{
+	const double StartTime = FPlatformTime::Seconds();
+
+	TArray<UMarkdownAsset*> ToFormat;
+	TArray<FString> Texts;
+
+	for (UMarkdownAsset* Document : Documents)
+	{
+		if (Document && !IsFormatted(*Document, Options))
+		{
+			ToFormat.Add(Document);
+			Texts.Add(Document->Text.ToString());
+		}
+	}
+
+	// documents range from a few lines to whole manuals, let idle workers take the next one rather than fixed batches
+	ParallelFor(Texts.Num(), [&Texts, &Options](int32 Index)
+	{
+		Texts[Index] = Format(Texts[Index], Options);
+	}, EParallelForFlags::Unbalanced);
+
+	int32 NumChanged = 0;
+
+	if (!ToFormat.IsEmpty())
+	{
+		FScopedTransaction Transaction(LOCTEXT("FormatDocumentsTransaction", "Format Markdown Documents"));
+
+		for (int32 Index = 0; Index < ToFormat.Num(); ++Index)
+		{
+			NumChanged += ApplyFormatted(ToFormat[Index], Texts[Index], Options) ? 1 : 0;
+		}
+	}
+
+	if (OutModified)
+	{
+		OutModified->Append(ToFormat);
+	}
+
+	if (OutStats)
+	{
+		OutStats->NumDocuments = Documents.Num();
+		OutStats->NumSkipped = Documents.Num() - ToFormat.Num();
+		OutStats->NumChanged = NumChanged;
+		OutStats->Seconds = FPlatformTime::Seconds() - StartTime;
+	}
+}
+
+void MarkdownFormatter::FormatFolders(const TArray<FString>& PackagePaths, const FMarkdownFormatOptions& Options, TArray<UMarkdownAsset*>* OutModified, FMarkdownFormatStats* OutStats)
+{
+	const double StartTime = FPlatformTime::Seconds();
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+
+	FARFilter Filter;
+	Filter.ClassPaths.Add(UMarkdownAsset::StaticClass()->GetClassPathName());
+	Filter.bRecursiveClasses = true;
+	Filter.bRecursivePaths = true;
+
+	for (const FString& PackagePath : PackagePaths)
+	{
+		Filter.PackagePaths.Add(FName(*PackagePath));
+	}
+
+	TArray<FAssetData> Assets;
+	AssetRegistry.GetAssets(Filter, Assets);
+
+	// only documents whose tags do not match are loaded, on a formatted project that is none of them
+	TArray<FSoftObjectPath> ToLoad;
+
+	for (const FAssetData& Asset : Assets)
+	{
+		if (!IsFormatted(Asset, Options))
+		{
+			ToLoad.Add(Asset.GetSoftObjectPath());
+		}
+	}
+
+	FStreamableManager StreamableManager;
+	TSharedPtr<FStreamableHandle> Handle;
+	if (!ToLoad.IsEmpty())
+	{
+		Handle = StreamableManager.RequestSyncLoad(ToLoad);
+	}
+
+	TArray<UMarkdownAsset*> Documents;
+	Documents.Reserve(ToLoad.Num());
+
+	for (const FSoftObjectPath& Path : ToLoad)
+	{
+		Documents.Add(Cast<UMarkdownAsset>(Path.ResolveObject()));
+	}
+
+	FormatDocuments(Documents, Options, OutModified, OutStats);
+
+	if (OutStats)
+	{
+		OutStats->NumSkipped += Assets.Num() - Documents.Num();
+		OutStats->NumDocuments = Assets.Num();
+		OutStats->Seconds = FPlatformTime::Seconds() - StartTime;
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,72 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FAssetData;
+class UMarkdownAsset;
+
+struct FMarkdownFormatOptions
+{
+	/** Paragraphs and list items are wrapped at this column, 0 leaves the lines as they are. */
+	int32 WrapColumn = 0;
+
+	/** Changes whenever the options or the formatter output change, so formatted documents are formatted again. */
+	uint32 GetHash() const;
+};
+
+struct FMarkdownFormatStats
+{
+	int32 NumDocuments = 0;
+
+	/** Documents already formatted, told apart by their hashes without loading them. */
+	int32 NumSkipped = 0;
+
+	/** Documents whose text the formatter changed. */
+	int32 NumChanged = 0;
+
+	double Seconds = 0.0;
+};
+
+/**
+ * Rewrites documents into one canonical layout, so diffs show what changed rather than whose editor saved it last.
+ *
+ *  - ATX headings ("## Title"), underlined headings are converted
+ *  - tables padded into aligned columns, short rows filled with empty cells
+ *  - list items marked with "-" or "1.", one space after the marker, nested lists indented by their parent's marker
+ *  - trailing whitespace removed (but for the two spaces of a hard break), runs of blank lines collapsed into one
+ *  - optionally, paragraphs and list items wrapped at a column
+ *
+ * Code is left as it is. Formatting is idempotent, formatted text formats to itself.
+ *
+ * Documents are stamped with the hash of the text the formatter produced, see UMarkdownAsset::FormattedHash. As long
+ * as their content hash tag matches it they are skipped without loading.
+ */
+namespace MarkdownFormatter
+{
+	/** Formats the text. Thread safe. */
+	FString Format(const FString& Text, const FMarkdownFormatOptions& Options);
+
+	/** The FormattedHash of a document whose text is the output of the formatter. */
+	uint32 GetFormattedHash(const FString& FormattedText, const FMarkdownFormatOptions& Options);
+
+	/** True if the registry tags of the document say its saved text is formatted with the options. */
+	bool IsFormatted(const FAssetData& Document, const FMarkdownFormatOptions& Options);
+
+	/** Formats the document in an undoable transaction unless it is formatted already, returns true if the text changed. */
+	bool FormatDocument(UMarkdownAsset* Document, const FMarkdownFormatOptions& Options);
+
+	/**
+	 * Formats the documents in parallel and applies the results in one undoable transaction, documents already formatted
+	 * are skipped. OutModified gets every document that was changed or stamped, these are left dirty for saving.
+	 */
+	void FormatDocuments(const TArray<UMarkdownAsset*>& Documents, const FMarkdownFormatOptions& Options, TArray<UMarkdownAsset*>* OutModified = nullptr, FMarkdownFormatStats* OutStats = nullptr);
+
+	/**
+	 * Formats every document in the folders in one undoable transaction. Documents already formatted are skipped
+	 * without loading, the others are formatted in parallel. OutModified gets every document that was changed or
+	 * stamped, these are left dirty for saving.
+	 */
+	void FormatFolders(const TArray<FString>& PackagePaths, const FMarkdownFormatOptions& Options, TArray<UMarkdownAsset*>* OutModified = nullptr, FMarkdownFormatStats* OutStats = nullptr);
+}
@@ -5,13 +5,26 @@
 #include "AssetToolsModule.h"
 #include "PackageTools.h"
 #include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/AssetRegistryState.h"
 #include "IContentBrowserSingleton.h"
 #include "ContentBrowserModule.h"
 #include "MarkdownAssetFactoryNew.h"
 #include "DeveloperSettings/MarkdownAssetDeveloperSettings.h"
 #include "Shared/MarkdownAssetEditorSettings.h"
+#include "Formatting/MarkdownFormatter.h"
 #include "Framework/Notifications/NotificationManager.h"
 #include "LogChannels/MarkdownLogChannels.h"
+#include "Lint/MarkdownLinter.h"
+#include "Links/MarkdownLinkIndex.h"
+#include "Links/MarkdownLinkResolver.h"
+#include "Logging/MessageLog.h"
+#include "MarkdownAssetEditorModule.h"
+#include "MarkdownAssetEditorToolkit.h"
+#include "MarkdownScanner.h"
+#include "MarkdownTranslation.h"
+#include "Misc/FileHelper.h"
+#include "Misc/UObjectToken.h"
+#include "Serialization/ArrayReader.h"
 #include "Widgets/Notifications/SNotificationList.h"
 
 #define LOCTEXT_NAMESPACE "FMarkdownAssetEditorStaticFunctions"
@@ -46,11 +59,8 @@ namespace MarkdownAssetStatics
 			return;
 		}
 		
-		UObject* Object = FindObject<UObject>(ObjectPath.GetAssetPath());
-		if (!Object)
-		{
-			Object = LoadObject<UObject>(nullptr, *ObjectPath.GetAssetPathString(), nullptr, LOAD_NoRedirects);
-		}
+		// the resolver follows redirectors and caches the result, so repeated clicks are cheap
+		UObject* Object = FMarkdownAssetEditorModule::Get().GetLinkResolver().LoadResolved(ObjectPath);
 
 		if (Object)
 		{
@@ -82,9 +92,279 @@ namespace MarkdownAssetStatics
 	static void TryToOpenAsset(const FString& URL, const FText& MessageIfNotFound = FText::FromString(""),
 		const FHyperlinkData& HyperlinkData = FHyperlinkData() )
 	{
-		TryToOpenAsset(FSoftObjectPath(URL), MessageIfNotFound);
+		TryToOpenAsset(FSoftObjectPath(URL), MessageIfNotFound, HyperlinkData);
 	};
 
+	/**
+	 * Replaces the text of a document as part of the current transaction. Keeps the link index up to date,
+	 * writes link assets through to their source file and notifies open editors. Link assets backed by a file are
+	 * left out of the transaction, undo could restore their text but not the file written here.
+	 */
+	static void ApplyDocumentText(UMarkdownAsset* Document, const FString& NewText)
+	{
+		if (!Document)
+		{
+			return;
+		}
+
+		UMarkdownLinkAsset* LinkAsset = Cast<UMarkdownLinkAsset>(Document);
+		const bool bWritesFile = LinkAsset && !LinkAsset->URL.IsEmpty() && !LinkAsset->URL.Contains(TEXT("://"));
+
+		if (bWritesFile)
+		{
+			Document->MarkPackageDirty();
+		}
+		else
+		{
+			Document->Modify();
+		}
+
+		Document->Text = FText::FromString(NewText);
+		Document->PostEditChange();
+
+		FMarkdownAssetEditorModule::Get().GetLinkIndex().UpdateDocument(Document);
+
+		if (bWritesFile)
+		{
+			if (!FMarkdownAssetEditorModule::CanWriteToFile(LinkAsset->URL) || !FMarkdownAssetEditorModule::WriteTextToFile(LinkAsset->URL, Document->Text))
+			{
+				UE_LOG(MarkdownStaticsLog, Warning, TEXT("Failed to write markdown file: %s"), *LinkAsset->URL);
+			}
+		}
+	}
+
+	/** Reports links to missing objects, and links that only work through a redirector, to the markdown message log. */
+	static int32 ValidateDocumentLinks(const TArray<UMarkdownAsset*>& Documents)
+	{
+		FMessageLog MessageLog(MarkdownMessageLog::LogName);
+		FMarkdownLinkResolver& Resolver = FMarkdownAssetEditorModule::Get().GetLinkResolver();
+
+		int32 NumProblems = 0;
+
+		for (UMarkdownAsset* Document : Documents)
+		{
+			if (!Document)
+			{
+				continue;
+			}
+
+			TArray<FString> Links;
+			MarkdownScanner::ExtractAssetLinks(Document->Text.ToString(), Links);
+
+			for (const FString& Link : Links)
+			{
+				const FMarkdownLinkResolver::FResolvedLink Resolved = Resolver.Resolve(FSoftObjectPath(Link));
+
+				if (!Resolved.IsValid())
+				{
+					MessageLog.Error()
+						->AddToken(FUObjectToken::Create(Document))
+						->AddToken(FTextToken::Create(FText::Format(LOCTEXT("MarkdownAsset_BrokenLink", "links to a missing object '{0}'"), FText::FromString(Link))));
+					++NumProblems;
+				}
+				else if (Resolved.bRedirected)
+				{
+					MessageLog.Warning()
+						->AddToken(FUObjectToken::Create(Document))
+						->AddToken(FTextToken::Create(FText::Format(LOCTEXT("MarkdownAsset_RedirectedLink", "links to '{0}' through a redirector, it now lives at '{1}'"), FText::FromString(Link), FText::FromString(Resolved.Path.ToString()))));
+					++NumProblems;
+				}
+			}
+		}
+
+		if (NumProblems == 0)
+		{
+			MessageLog.Info(FText::Format(LOCTEXT("MarkdownAsset_LinksValid", "All links are valid in {0} markdown document(s)."), Documents.Num()));
+		}
+
+		MessageLog.Open(EMessageSeverity::Info);
+
+		return NumProblems;
+	}
+
+	/** Opens the document in its editor with the line selected. */
+	static void OpenDocumentAtLine(UMarkdownAsset* Document, int32 Line)
+	{
+		UAssetEditorSubsystem* AssetEditors = GEditor->GetEditorSubsystem<UAssetEditorSubsystem>();
+
+		if (!Document || !AssetEditors->OpenEditorForAsset(Document))
+		{
+			return;
+		}
+
+		IAssetEditorInstance* Editor = AssetEditors->FindEditorForAsset(Document, true);
+
+		if (Editor && Editor->GetEditorName() == FMarkdownAssetEditorToolkit::ToolkitName)
+		{
+			static_cast<FMarkdownAssetEditorToolkit*>(Editor)->RevealLine(Line);
+		}
+	}
+
+	/** Adds the line and description of a lint issue to a message, clicking the line opens the document at it. */
+	static TSharedRef<FTokenizedMessage> AddLintMessage(const TSharedRef<FTokenizedMessage>& Message, UMarkdownAsset* Document, const FMarkdownLintIssue& Issue)
+	{
+		const TWeakObjectPtr<UMarkdownAsset> WeakDocument = Document;
+		const int32 Line = Issue.Line;
+
+		return Message
+			->AddToken(FActionToken::Create(
+				FText::Format(LOCTEXT("MarkdownAsset_LintLine", "line {0}"), Line),
+				LOCTEXT("MarkdownAsset_LintLineTooltip", "Open the document at this line"),
+				FOnActionTokenExecuted::CreateLambda([WeakDocument, Line]()
+				{
+					OpenDocumentAtLine(WeakDocument.Get(), Line);
+				})))
+			->AddToken(FTextToken::Create(FText::Format(LOCTEXT("MarkdownAsset_LintIssue", "{0} ({1})"), FText::FromString(Issue.Message), FText::FromString(LexToString(Issue.Rule)))));
+	}
+
+	/** Lints the documents in parallel and writes the issues to the message log, returns the number of errors. */
+	static int32 LintDocuments(const TArray<UMarkdownAsset*>& Documents)
+	{
+		FMessageLog MessageLog(MarkdownMessageLog::LogName);
+
+		TArray<FString> Texts;
+		Texts.Reserve(Documents.Num());
+
+		for (const UMarkdownAsset* Document : Documents)
+		{
+			Texts.Add(Document ? Document->Text.ToString() : FString());
+		}
+
+		TArray<TArray<FMarkdownLintIssue>> Issues;
+		MarkdownLinter::LintAll(Texts, UMarkdownAssetDeveloperSettings::Get()->GetLintOptions(), Issues);
+
+		int32 NumIssues = 0;
+		int32 NumErrors = 0;
+
+		for (int32 Index = 0; Index < Documents.Num(); ++Index)
+		{
+			for (const FMarkdownLintIssue& Issue : Issues[Index])
+			{
+				const bool bError = Issue.Severity == EMarkdownLintSeverity::Error;
+				const TSharedRef<FTokenizedMessage> Message = bError ? MessageLog.Error() : MessageLog.Warning();
+				AddLintMessage(Message->AddToken(FUObjectToken::Create(Documents[Index])), Documents[Index], Issue);
+
+				++NumIssues;
+				NumErrors += bError ? 1 : 0;
+			}
+		}
+
+		if (NumIssues == 0)
+		{
+			MessageLog.Info(FText::Format(LOCTEXT("MarkdownAsset_LintClean", "No lint issues in {0} markdown document(s)."), Documents.Num()));
+		}
+
+		MessageLog.Open(EMessageSeverity::Info);
+
+		return NumErrors;
+	}
+
+	/** Writes the number of blocks each translation of the documents is missing to the message log. */
+	static int32 ReportUntranslatedBlocks(const TArray<UMarkdownAsset*>& Documents)
+	{
+		FMessageLog MessageLog(MarkdownMessageLog::LogName);
+
+		int32 NumOutdated = 0;
+
+		for (UMarkdownAsset* Document : Documents)
+		{
+			if (!Document)
+			{
+				continue;
+			}
+
+			const FString Text = Document->Text.ToString();
+
+			TArray<FMarkdownTranslationBlock> Blocks;
+			UMarkdownTranslation::SplitBlocks(Text, Blocks);
+
+			for (const TPair<FString, TSoftObjectPtr<UMarkdownTranslation>>& Entry : Document->Translations)
+			{
+				const UMarkdownTranslation* Translation = Entry.Value.LoadSynchronous();
+				if (!Translation)
+				{
+					MessageLog.Error()
+						->AddToken(FUObjectToken::Create(Document))
+						->AddToken(FTextToken::Create(FText::Format(LOCTEXT("MarkdownAsset_MissingTranslation", "has a missing '{0}' translation"), FText::FromString(Entry.Key))));
+					++NumOutdated;
+					continue;
+				}
+
+				TArray<FMarkdownTranslationBlock> Untranslated;
+				Translation->GetUntranslatedBlocks(Text, Untranslated);
+
+				if (!Untranslated.IsEmpty())
+				{
+					MessageLog.Warning()
+						->AddToken(FUObjectToken::Create(Document))
+						->AddToken(FTextToken::Create(FText::Format(LOCTEXT("MarkdownAsset_UntranslatedBlocks", "{0} of {1} block(s) need translating into '{2}'"), Untranslated.Num(), Blocks.Num(), FText::FromString(Entry.Key))))
+						->AddToken(FUObjectToken::Create(Translation));
+					++NumOutdated;
+				}
+			}
+		}
+
+		if (NumOutdated == 0)
+		{
+			MessageLog.Info(FText::Format(LOCTEXT("MarkdownAsset_TranslationsComplete", "All translations are up to date in {0} markdown document(s)."), Documents.Num()));
+		}
+
+		MessageLog.Open(EMessageSeverity::Info);
+
+		return NumOutdated;
+	}
+
+	/** Writes what a format run did to the message log and pops up a summary. */
+	static void ReportFormatStats(const TArray<UMarkdownAsset*>& Modified, const FMarkdownFormatStats& Stats)
+	{
+		FMessageLog MessageLog(MarkdownMessageLog::LogName);
+
+		for (UMarkdownAsset* Document : Modified)
+		{
+			MessageLog.Info()
+				->AddToken(FUObjectToken::Create(Document))
+				->AddToken(FTextToken::Create(LOCTEXT("MarkdownAsset_DocumentFormatted", "was formatted")));
+		}
+
+		FNumberFormattingOptions SecondsFormat;
+		SecondsFormat.MaximumFractionalDigits = 2;
+
+		const FText Summary = FText::Format(
+			LOCTEXT("MarkdownAsset_FormatSummary", "Formatted {0} of {1} markdown document(s), {2} already formatted, in {3} second(s)."),
+			Stats.NumChanged, Stats.NumDocuments, Stats.NumSkipped, FText::AsNumber(Stats.Seconds, &SecondsFormat));
+
+		MessageLog.Info(Summary);
+
+		FNotificationInfo* Info = new FNotificationInfo(Summary);
+		Info->bUseLargeFont = true;
+		Info->ExpireDuration = 5.0f;
+		FSlateNotificationManager::Get().AddNotification(*Info);
+	}
+
+	/** Formats the documents with the project's format settings and reports what changed. */
+	static int32 FormatDocuments(const TArray<UMarkdownAsset*>& Documents)
+	{
+		TArray<UMarkdownAsset*> Modified;
+		FMarkdownFormatStats Stats;
+		MarkdownFormatter::FormatDocuments(Documents, UMarkdownAssetDeveloperSettings::Get()->GetFormatOptions(), &Modified, &Stats);
+
+		ReportFormatStats(Modified, Stats);
+
+		return Stats.NumChanged;
+	}
+
+	/** Formats every document under the package paths and reports what changed. */
+	static int32 FormatFolders(const TArray<FString>& PackagePaths)
+	{
+		TArray<UMarkdownAsset*> Modified;
+		FMarkdownFormatStats Stats;
+		MarkdownFormatter::FormatFolders(PackagePaths, UMarkdownAssetDeveloperSettings::Get()->GetFormatOptions(), &Modified, &Stats);
+
+		ReportFormatStats(Modified, Stats);
+
+		return Stats.NumChanged;
+	}
+
 	static FString GetAssetShortName(const UObject* Asset)
 	{
 		const FString BaseName = Asset->GetOutermost()->GetName();
@@ -220,6 +500,30 @@ namespace MarkdownAssetStatics
 
 		MarkdownAssetStatics::TryToOpenAsset(MarkdownAssetToOpen);
 	}
+
+	/** Reads the asset registry a cook writes next to its content, e.g. Metadata/DevelopmentAssetRegistry.bin. */
+	static bool LoadCookedAssetRegistry(const FString& Path, FAssetRegistryState& OutState)
+	{
+		FArrayReader Reader;
+		return FFileHelper::LoadFileToArray(Reader, *Path) && OutState.Load(Reader);
+	}
+
+	/**
+	 * Whether the cooker ships a document with the Cook policy, which it only does when something cooked references it.
+	 * With the asset registry of a cook this is exact, before the first cook the best guess is that it is referenced by
+	 * something the game uses.
+	 */
+	static bool IsDocumentCooked(const FAssetData& AssetData, const IAssetRegistry& AssetRegistry, const FAssetRegistryState* CookedRegistry)
+	{
+		if (CookedRegistry)
+		{
+			return CookedRegistry->GetAssetsByPackageName(AssetData.PackageName).Num() > 0;
+		}
+
+		TArray<FName> Referencers;
+		AssetRegistry.GetReferencers(AssetData.PackageName, Referencers, UE::AssetRegistry::EDependencyCategory::Package, UE::AssetRegistry::EDependencyQuery::Game);
+		return !Referencers.IsEmpty();
+	}
 }
 
 #undef LOCTEXT_NAMESPACE
\ No newline at end of file
@@ -0,0 +1,330 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Images/MarkdownImageStore.h"
+
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetToolsModule.h"
+#include "DeveloperSettings/MarkdownAssetDeveloperSettings.h"
+#include "Engine/Texture2D.h"
+#include "Framework/Notifications/NotificationManager.h"
+#include "HAL/FileManager.h"
+#include "IImageWrapper.h"
+#include "IImageWrapperModule.h"
+#include "ImageCore.h"
+#include "Internationalization/Regex.h"
+#include "Links/MarkdownLinkResolver.h"
+#include "LogChannels/MarkdownLogChannels.h"
+#include "MarkdownAsset.h"
+#include "MarkdownAssetEditorModule.h"
+#include "Misc/Base64.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "Scheduling/MarkdownTaskScheduler.h"
+#include "Styling/AppStyle.h"
+#include "Widgets/Notifications/SNotificationList.h"
+
+#define LOCTEXT_NAMESPACE "MarkdownImageStore"
+
+namespace MarkdownImageStore
+{
+	/** Everything the worker needs, copied on the game thread. */
+	struct FPasteRequest
+	{
+		FString DataUrl;
+		FString BaseName;
+
+		EImageFormat Format = EImageFormat::PNG;
+		int32 Quality = 0;
+		int32 MaxWidth = 0;
+
+		/** Folder name used in the inserted link. */
+		FString Folder;
+
+		/** Set for linked markdown files, the image file is written here. */
+		FString SidecarDirectory;
+
+		/** Set for markdown assets, the texture is created in this package path. */
+		FString TexturePackagePath;
+
+		IImageWrapperModule* ImageWrapper = nullptr;
+	};
+
+	struct FPasteResult
+	{
+		FImage Image;
+		TArray64<uint8> Encoded;
+		FString Markdown;
+		FText Error;
+	};
+
+	static IImageWrapperModule& GetImageWrapper()
+	{
+		return FModuleManager::LoadModuleChecked<IImageWrapperModule>("ImageWrapper");
+	}
+
+	static void NotifyError(const FText& Error)
+	{
+		UE_LOG(MarkdownStaticsLog, Warning, TEXT("%s"), *Error.ToString());
+
+		FNotificationInfo Info(Error);
+		Info.ExpireDuration = 5.0f;
+		Info.Image = FAppStyle::Get().GetBrush(TEXT("MessageLog.Warning"));
+		FSlateNotificationManager::Get().AddNotification(Info);
+	}
+
+	static FString MakeImageMarkdown(const FString& Link)
+	{
+		return FString::Printf(TEXT("![image](%s)"), *Link);
+	}
+
+	/** Decodes the pasted image, scales it down if needed and encodes it in the configured format. */
+	static bool DecodeAndEncode(const FPasteRequest& Request, FPasteResult& Result)
+	{
+		int32 Comma = INDEX_NONE;
+		TArray<uint8> Bytes;
+
+		if (!Request.DataUrl.FindChar(TEXT(','), Comma) || !FBase64::Decode(Request.DataUrl.RightChop(Comma + 1), Bytes))
+		{
+			Result.Error = LOCTEXT("InvalidData", "The pasted image data could not be read.");
+			return false;
+		}
+
+		if (!Request.ImageWrapper->DecompressImage(Bytes.GetData(), Bytes.Num(), Result.Image))
+		{
+			Result.Error = LOCTEXT("UnsupportedImage", "The pasted image format is not supported.");
+			return false;
+		}
+
+		Result.Image.ChangeFormat(ERawImageFormat::BGRA8, EGammaSpace::sRGB);
+
+		if (Request.MaxWidth > 0 && Result.Image.SizeX > Request.MaxWidth)
+		{
+			const int32 Height = FMath::Max<int32>(1, int64(Result.Image.SizeY) * Request.MaxWidth / Result.Image.SizeX);
+
+			FImage Resized;
+			Result.Image.ResizeTo(Resized, Request.MaxWidth, Height, ERawImageFormat::BGRA8, EGammaSpace::sRGB);
+			Result.Image = MoveTemp(Resized);
+		}
+
+		// textures keep the raw pixels, the encoded copy becomes their viewer preview
+		const EImageFormat Format = Request.SidecarDirectory.IsEmpty() ? EImageFormat::PNG : Request.Format;
+		if (!Request.ImageWrapper->CompressImage(Result.Encoded, Format, Result.Image, Request.Quality))
+		{
+			Result.Error = LOCTEXT("EncodeFailed", "The pasted image could not be encoded.");
+			return false;
+		}
+
+		return true;
+	}
+
+	/** Writes the encoded image next to the linked markdown file, never overwriting an earlier image. */
+	static bool WriteSidecar(const FPasteRequest& Request, FPasteResult& Result)
+	{
+		const TCHAR* Extension = Request.Format == EImageFormat::JPEG ? TEXT("jpg") : TEXT("png");
+		const FString Stem = Request.BaseName + FDateTime::Now().ToString(TEXT("-%Y%m%d-%H%M%S"));
+
+		FString FileName = FString::Printf(TEXT("%s.%s"), *Stem, Extension);
+		for (int32 Suffix = 1; IFileManager::Get().FileExists(*(Request.SidecarDirectory / FileName)); ++Suffix)
+		{
+			FileName = FString::Printf(TEXT("%s-%d.%s"), *Stem, Suffix, Extension);
+		}
+
+		if (!FFileHelper::SaveArrayToFile(Result.Encoded, *(Request.SidecarDirectory / FileName)))
+		{
+			Result.Error = FText::Format(LOCTEXT("WriteFailed", "Could not write the pasted image to '{0}'."), FText::FromString(Request.SidecarDirectory / FileName));
+			return false;
+		}
+
+		const FString Link = Request.Folder / FileName;
+		Result.Markdown = MakeImageMarkdown(Link.Replace(TEXT(" "), TEXT("%20")));
+		return true;
+	}
+
+	static UTexture2D* CreateTexture(const FPasteRequest& Request, const FImage& Image)
+	{
+		FString PackageName;
+		FString AssetName;
+
+		IAssetTools& AssetTools = FModuleManager::LoadModuleChecked<FAssetToolsModule>("AssetTools").Get();
+		AssetTools.CreateUniqueAssetName(Request.TexturePackagePath / (TEXT("T_") + Request.BaseName), FString(), PackageName, AssetName);
+
+		UPackage* Package = CreatePackage(*PackageName);
+		UTexture2D* Texture = NewObject<UTexture2D>(Package, *AssetName, RF_Public | RF_Standalone | RF_Transactional);
+
+		Texture->Source.Init(Image.SizeX, Image.SizeY, 1, 1, TSF_BGRA8, Image.RawData.GetData());
+		Texture->CompressionSettings = TC_EditorIcon;
+		Texture->MipGenSettings = TMGS_NoMipmaps;
+		Texture->LODGroup = TEXTUREGROUP_UI;
+		Texture->SRGB = true;
+
+		// the platform data is built by the texture compiler in the background
+		Texture->PostEditChange();
+
+		FAssetRegistryModule::AssetCreated(Texture);
+		Package->MarkPackageDirty();
+
+		return Texture;
+	}
+
+	static FString ToFileURL(const FString& FilePath)
+	{
+		FString Absolute = FPaths::ConvertRelativePathToFull(FilePath);
+		Absolute.ReplaceInline(TEXT("\\"), TEXT("/"));
+		Absolute.ReplaceInline(TEXT(" "), TEXT("%20"));
+		return FString::Printf(TEXT("file:///%s"), *Absolute);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void FMarkdownImageStore::Initialize()
+{
+	// loaded up front, modules cannot be loaded from the encoding threads
+	MarkdownImageStore::GetImageWrapper();
+}
+
+void FMarkdownImageStore::Shutdown()
+{
+	Previews.Empty();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void FMarkdownImageStore::PasteImage(const UMarkdownAsset* Document, FString DataUrl, TFunction<void(const FString& Markdown)> OnComplete)
+{
+	using namespace MarkdownImageStore;
+
+	if (!Document)
+	{
+		OnComplete(FString());
+		return;
+	}
+
+	const UMarkdownAssetDeveloperSettings* Settings = UMarkdownAssetDeveloperSettings::Get();
+
+	FPasteRequest Request;
+	Request.DataUrl = MoveTemp(DataUrl);
+	Request.BaseName = Document->GetName();
+	Request.Format = Settings->GetPastedImageFormat() == EMarkdownPastedImageFormat::JPEG ? EImageFormat::JPEG : EImageFormat::PNG;
+	Request.Quality = Request.Format == EImageFormat::JPEG ? Settings->GetPastedImageQuality() : 0;
+	Request.MaxWidth = Settings->GetMaxPastedImageWidth();
+	Request.Folder = Settings->GetPastedImageFolder();
+	Request.ImageWrapper = &GetImageWrapper();
+
+	const UMarkdownLinkAsset* LinkAsset = Cast<UMarkdownLinkAsset>(Document);
+	if (LinkAsset && !LinkAsset->URL.IsEmpty() && !LinkAsset->URL.Contains(TEXT("://")))
+	{
+		Request.SidecarDirectory = FPaths::GetPath(LinkAsset->URL) / Request.Folder;
+	}
+	else
+	{
+		Request.TexturePackagePath = FPackageName::GetLongPackagePath(Document->GetPackage()->GetName()) / Request.Folder;
+	}
+
+	// the user is waiting on the paste, so it goes ahead of any indexing or checks
+	FMarkdownAssetEditorModule::Get().GetTaskScheduler().Launch(TEXT("MarkdownPasteImage"), EMarkdownTaskPriority::Interactive,
+		[Request = MoveTemp(Request), OnComplete = MoveTemp(OnComplete)](const FMarkdownTask& Task) mutable -> TUniqueFunction<void()>
+	{
+		TSharedRef<FPasteResult> Result = MakeShared<FPasteResult>();
+
+		if (DecodeAndEncode(Request, *Result) && !Request.SidecarDirectory.IsEmpty())
+		{
+			WriteSidecar(Request, *Result);
+		}
+
+		return [Request = MoveTemp(Request), Result, OnComplete = MoveTemp(OnComplete)]()
+		{
+			if (Result->Error.IsEmpty() && !Request.TexturePackagePath.IsEmpty())
+			{
+				UTexture2D* Texture = CreateTexture(Request, Result->Image);
+
+				// the encoded copy doubles as the preview, so the viewer shows the new texture without exporting it
+				FFileHelper::SaveArrayToFile(Result->Encoded, *GetPreviewFilePath(Texture));
+
+				Result->Markdown = MakeImageMarkdown(FString::Printf(TEXT("%s'%s'"), *UTexture2D::StaticClass()->GetClassPathName().ToString(), *FSoftObjectPath(Texture).ToString()));
+			}
+
+			if (!Result->Error.IsEmpty())
+			{
+				NotifyError(Result->Error);
+			}
+
+			OnComplete(Result->Markdown);
+		};
+	});
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+FString FMarkdownImageStore::ResolveImageLinks(const FString& Text)
+{
+	// ![alt](/Script/Engine.Texture2D'/Game/Docs/Images/T_Doc.T_Doc')
+	static const FRegexPattern ImageLinkPattern(TEXT("!\\[[^\\]]*\\]\\((/Script/[^'\\s)]+'([^']+)')\\)"));
+
+	FRegexMatcher Matcher(ImageLinkPattern, Text);
+
+	FString Output;
+	int32 Copied = 0;
+
+	while (Matcher.FindNext())
+	{
+		UTexture* Texture = Cast<UTexture>(FMarkdownAssetEditorModule::Get().GetLinkResolver().LoadResolved(FSoftObjectPath(Matcher.GetCaptureGroup(2))));
+		if (!Texture)
+		{
+			continue;
+		}
+
+		const FString PreviewURL = GetPreviewURL(Texture);
+		if (PreviewURL.IsEmpty())
+		{
+			continue;
+		}
+
+		const int32 LinkStart = Matcher.GetCaptureGroupBeginning(1);
+		Output.Append(FStringView(Text).Mid(Copied, LinkStart - Copied));
+		Output.Append(PreviewURL);
+		Copied = Matcher.GetCaptureGroupEnding(1);
+	}
+
+	if (Copied == 0)
+	{
+		return Text;
+	}
+
+	Output.Append(FStringView(Text).RightChop(Copied));
+	return Output;
+}
+
+FString FMarkdownImageStore::GetPreviewURL(UTexture* Texture)
+{
+	const FString FilePath = GetPreviewFilePath(Texture);
+
+	if (!Previews.Contains(FilePath) && !IFileManager::Get().FileExists(*FilePath))
+	{
+		FImage Image;
+		TArray64<uint8> Encoded;
+
+		if (!Texture->Source.IsValid() || !Texture->Source.GetMipImage(Image, 0, 0, 0))
+		{
+			return FString();
+		}
+
+		if (!MarkdownImageStore::GetImageWrapper().CompressImage(Encoded, EImageFormat::PNG, Image) || !FFileHelper::SaveArrayToFile(Encoded, *FilePath))
+		{
+			UE_LOG(MarkdownStaticsLog, Warning, TEXT("Could not export a preview of '%s' for the markdown viewer."), *Texture->GetPathName());
+			return FString();
+		}
+	}
+
+	Previews.Add(FilePath);
+	return MarkdownImageStore::ToFileURL(FilePath);
+}
+
+FString FMarkdownImageStore::GetPreviewFilePath(const UTexture* Texture)
+{
+	// the source id changes whenever the pixels do, so an existing preview is always current
+	return FPaths::ProjectSavedDir() / TEXT("MarkdownAsset") / TEXT("Images") / Texture->Source.GetId().ToString() + TEXT(".png");
+}
+
+#undef LOCTEXT_NAMESPACE
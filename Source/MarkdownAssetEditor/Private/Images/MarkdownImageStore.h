@@ -0,0 +1,43 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UMarkdownAsset;
+class UTexture;
+
+/**
+ * Stores images pasted into the editor and makes texture assets displayable in the viewer.
+ *
+ * Pasted images are decoded, scaled and encoded on a worker thread, so pasting a large capture never stalls the
+ * editor. Linked markdown files get an image file in a folder next to them, markdown assets get a texture asset
+ * next to the document. The viewer cannot load textures, so image links to texture assets are rewritten to a PNG
+ * preview kept under Saved/, keyed by the texture source id and only exported again when the pixels change.
+ */
+class FMarkdownImageStore
+{
+public:
+
+	void Initialize();
+	void Shutdown();
+
+	/**
+	 * Stores an image given as a data URL ("data:image/png;base64,...") for the document, then calls OnComplete on
+	 * the game thread with the markdown that shows it, or an empty string if the image could not be stored.
+	 */
+	void PasteImage(const UMarkdownAsset* Document, FString DataUrl, TFunction<void(const FString& Markdown)> OnComplete);
+
+	/** Rewrites image links to texture assets so the viewer can display them. */
+	FString ResolveImageLinks(const FString& Text);
+
+private:
+
+	/** Returns the file URL of the texture preview, exporting it if the texture changed since the last export. */
+	FString GetPreviewURL(UTexture* Texture);
+
+	static FString GetPreviewFilePath(const UTexture* Texture);
+
+	/** Previews known to be on disk. */
+	TSet<FString> Previews;
+};
@@ -0,0 +1,533 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Links/MarkdownLinkIndex.h"
+
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "DeveloperSettings/MarkdownAssetDeveloperSettings.h"
+#include "HelperFunctions/MarkdownAssetEditorStatics.h"
+#include "LogChannels/MarkdownLogChannels.h"
+#include "MarkdownAsset.h"
+#include "MarkdownAssetEditorModule.h"
+#include "MarkdownScanner.h"
+#include "Scheduling/MarkdownTaskScheduler.h"
+#include "ScopedTransaction.h"
+
+#define LOCTEXT_NAMESPACE "FMarkdownLinkIndex"
+
+namespace MarkdownLinkIndex
+{
+	static IAssetRegistry* GetAssetRegistry()
+	{
+		FAssetRegistryModule* AssetRegistryModule = FModuleManager::GetModulePtr<FAssetRegistryModule>("AssetRegistry");
+		return AssetRegistryModule ? &AssetRegistryModule->Get() : nullptr;
+	}
+
+	static bool IsMarkdownAsset(const FAssetData& AssetData)
+	{
+		return AssetData.IsInstanceOf(UMarkdownAsset::StaticClass());
+	}
+
+	/** Returns the length of the "/Package/Path.Asset" part of a link, dropping sub-object or member suffixes. */
+	static int32 GetAssetPathLen(FStringView Path)
+	{
+		int32 SlashIndex = INDEX_NONE;
+		Path.FindLastChar(TEXT('/'), SlashIndex);
+
+		int32 DotIndex = INDEX_NONE;
+		for (int32 i = SlashIndex + 1; i < Path.Len(); ++i)
+		{
+			if (Path[i] == TEXT(':') || (Path[i] == TEXT('.') && DotIndex != INDEX_NONE))
+			{
+				return i;
+			}
+
+			if (Path[i] == TEXT('.'))
+			{
+				DotIndex = i;
+			}
+		}
+
+		return Path.Len();
+	}
+
+	static FSoftObjectPath ToAssetKey(FStringView Path)
+	{
+		return FSoftObjectPath(FString(Path.Left(GetAssetPathLen(Path))));
+	}
+
+	static void AddLink(FStringView Path, TArray<FSoftObjectPath>& OutLinks)
+	{
+		if (!Path.IsEmpty())
+		{
+			OutLinks.AddUnique(ToAssetKey(Path));
+		}
+	}
+
+	static void ParseLinksTag(const FString& TagValue, TArray<FSoftObjectPath>& OutLinks)
+	{
+		TArray<FString> Paths;
+		TagValue.ParseIntoArray(Paths, TEXT(","));
+
+		for (const FString& Path : Paths)
+		{
+			AddLink(Path, OutLinks);
+		}
+	}
+
+	static void LinksFromText(const FString& Text, TArray<FSoftObjectPath>& OutLinks)
+	{
+		TArray<FString> Paths;
+		MarkdownScanner::ExtractAssetLinks(Text, Paths);
+
+		for (const FString& Path : Paths)
+		{
+			AddLink(Path, OutLinks);
+		}
+	}
+}
+
+/** What the build task read from the registry, the links of Documents[i] are Links[i]. */
+struct FMarkdownLinkIndex::FBuildResult
+{
+	TArray<FAssetData> Documents;
+	TArray<TArray<FSoftObjectPath>> Links;
+	int32 NumUntagged = 0;
+	double Seconds = 0.0;
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void FMarkdownLinkIndex::Initialize()
+{
+	IAssetRegistry* AssetRegistry = MarkdownLinkIndex::GetAssetRegistry();
+	if (!AssetRegistry)
+	{
+		return;
+	}
+
+	AssetRegistry->OnAssetAdded().AddRaw(this, &FMarkdownLinkIndex::HandleAssetAdded);
+	AssetRegistry->OnAssetRemoved().AddRaw(this, &FMarkdownLinkIndex::HandleAssetRemoved);
+	AssetRegistry->OnAssetUpdated().AddRaw(this, &FMarkdownLinkIndex::HandleAssetUpdated);
+	AssetRegistry->OnAssetRenamed().AddRaw(this, &FMarkdownLinkIndex::HandleAssetRenamed);
+
+	if (AssetRegistry->IsLoadingAssets())
+	{
+		AssetRegistry->OnFilesLoaded().AddRaw(this, &FMarkdownLinkIndex::HandleFilesLoaded);
+	}
+	else
+	{
+		BuildFromRegistry();
+	}
+}
+
+void FMarkdownLinkIndex::Shutdown()
+{
+	if (IAssetRegistry* AssetRegistry = MarkdownLinkIndex::GetAssetRegistry())
+	{
+		AssetRegistry->OnAssetAdded().RemoveAll(this);
+		AssetRegistry->OnAssetRemoved().RemoveAll(this);
+		AssetRegistry->OnAssetUpdated().RemoveAll(this);
+		AssetRegistry->OnAssetRenamed().RemoveAll(this);
+		AssetRegistry->OnFilesLoaded().RemoveAll(this);
+	}
+
+	FTSTicker::GetCoreTicker().RemoveTicker(PendingRenamesTickerHandle);
+	PendingRenamesTickerHandle.Reset();
+
+	PendingRenames.Empty();
+	DocumentsByTarget.Empty();
+	TargetsByDocument.Empty();
+	ChangedWhileBuilding.Empty();
+	bBuilding = false;
+	bBuilt = false;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void FMarkdownLinkIndex::GetReferencingDocuments(const FSoftObjectPath& Target, TArray<FSoftObjectPath>& OutDocuments) const
+{
+	if (const TSet<FSoftObjectPath>* Documents = DocumentsByTarget.Find(MarkdownLinkIndex::ToAssetKey(Target.ToString())))
+	{
+		OutDocuments.Append(Documents->Array());
+	}
+}
+
+void FMarkdownLinkIndex::GetDocumentLinks(const FSoftObjectPath& Document, TArray<FSoftObjectPath>& OutLinks) const
+{
+	if (const TArray<FSoftObjectPath>* Links = TargetsByDocument.Find(Document))
+	{
+		OutLinks.Append(*Links);
+	}
+}
+
+void FMarkdownLinkIndex::UpdateDocument(const UMarkdownAsset* Document)
+{
+	if (!Document)
+	{
+		return;
+	}
+
+	TArray<FSoftObjectPath> Links;
+	MarkdownLinkIndex::LinksFromText(Document->Text.ToString(), Links);
+	SetDocumentLinks(FSoftObjectPath(Document), Links);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void FMarkdownLinkIndex::BuildFromRegistry()
+{
+	IAssetRegistry* AssetRegistry = MarkdownLinkIndex::GetAssetRegistry();
+	if (!AssetRegistry)
+	{
+		return;
+	}
+
+	bBuilding = true;
+
+	// only what is on disk can be read off the game thread, loaded documents are read from memory when the result is applied
+	FARFilter Filter;
+	Filter.ClassPaths.Add(UMarkdownAsset::StaticClass()->GetClassPathName());
+	Filter.bRecursiveClasses = true;
+	Filter.bIncludeOnlyOnDiskAssets = true;
+
+	TWeakPtr<FMarkdownLinkIndex, ESPMode::ThreadSafe> WeakThis = AsShared();
+
+	FMarkdownAssetEditorModule::Get().GetTaskScheduler().Launch(TEXT("MarkdownLinkIndexBuild"), EMarkdownTaskPriority::Background,
+		[WeakThis, AssetRegistry, Filter = MoveTemp(Filter)](const FMarkdownTask& Task) -> TUniqueFunction<void()>
+	{
+		const double StartTime = FPlatformTime::Seconds();
+
+		FBuildResult Result;
+		AssetRegistry->GetAssets(Filter, Result.Documents);
+		Result.Links.SetNum(Result.Documents.Num());
+
+		for (int32 Index = 0; Index < Result.Documents.Num(); ++Index)
+		{
+			if (Task.IsCancelled())
+			{
+				return nullptr;
+			}
+
+			FString TagValue;
+			if (Result.Documents[Index].GetTagValue(UMarkdownAsset::LinksTagName, TagValue))
+			{
+				MarkdownLinkIndex::ParseLinksTag(TagValue, Result.Links[Index]);
+			}
+			else
+			{
+				++Result.NumUntagged;
+			}
+		}
+
+		Result.Seconds = FPlatformTime::Seconds() - StartTime;
+
+		return [WeakThis, Result = MoveTemp(Result)]() mutable
+		{
+			if (TSharedPtr<FMarkdownLinkIndex, ESPMode::ThreadSafe> This = WeakThis.Pin())
+			{
+				This->FinishBuild(Result);
+			}
+		};
+	});
+}
+
+void FMarkdownLinkIndex::FinishBuild(FBuildResult& Result)
+{
+	const double StartTime = FPlatformTime::Seconds();
+
+	for (int32 Index = 0; Index < Result.Documents.Num(); ++Index)
+	{
+		const FAssetData& AssetData = Result.Documents[Index];
+		const FSoftObjectPath Document = AssetData.GetSoftObjectPath();
+
+		if (ChangedWhileBuilding.Contains(Document))
+		{
+			continue;
+		}
+
+		if (AssetData.FastGetAsset(false))
+		{
+			UpdateDocumentFromAssetData(AssetData);
+		}
+		else
+		{
+			SetDocumentLinks(Document, Result.Links[Index]);
+		}
+	}
+
+	// the registry may have moved on since the task read it, these documents are read as they are now
+	IAssetRegistry* AssetRegistry = MarkdownLinkIndex::GetAssetRegistry();
+
+	for (const FSoftObjectPath& Document : ChangedWhileBuilding)
+	{
+		const FAssetData AssetData = AssetRegistry ? AssetRegistry->GetAssetByObjectPath(Document) : FAssetData();
+
+		if (AssetData.IsValid() && MarkdownLinkIndex::IsMarkdownAsset(AssetData))
+		{
+			UpdateDocumentFromAssetData(AssetData);
+		}
+		else
+		{
+			RemoveDocument(Document);
+		}
+	}
+
+	ChangedWhileBuilding.Empty();
+	bBuilding = false;
+	bBuilt = true;
+
+	UE_LOG(MarkdownStaticsLog, Log, TEXT("Markdown link index built: %d documents, %d linked assets (%.2f ms reading the registry, %.2f ms on the game thread)."),
+		Result.Documents.Num(), DocumentsByTarget.Num(), Result.Seconds * 1000.0, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+
+	if (Result.NumUntagged > 0)
+	{
+		UE_LOG(MarkdownStaticsLog, Log, TEXT("%d markdown documents were saved without link information, resave them to include their links in the index."), Result.NumUntagged);
+	}
+
+	if (!PendingRenames.IsEmpty())
+	{
+		ProcessPendingRenames(0.0f);
+	}
+}
+
+bool FMarkdownLinkIndex::DeferUntilBuilt(const FSoftObjectPath& Document)
+{
+	if (bBuilding)
+	{
+		ChangedWhileBuilding.Add(Document);
+	}
+
+	return !bBuilt;
+}
+
+void FMarkdownLinkIndex::SetDocumentLinks(const FSoftObjectPath& Document, const TArray<FSoftObjectPath>& Links)
+{
+	RemoveDocument(Document);
+
+	if (Links.IsEmpty())
+	{
+		return;
+	}
+
+	for (const FSoftObjectPath& Link : Links)
+	{
+		DocumentsByTarget.FindOrAdd(Link).Add(Document);
+	}
+
+	TargetsByDocument.Add(Document, Links);
+}
+
+void FMarkdownLinkIndex::RemoveDocument(const FSoftObjectPath& Document)
+{
+	TArray<FSoftObjectPath> OldLinks;
+	if (!TargetsByDocument.RemoveAndCopyValue(Document, OldLinks))
+	{
+		return;
+	}
+
+	for (const FSoftObjectPath& Link : OldLinks)
+	{
+		if (TSet<FSoftObjectPath>* Documents = DocumentsByTarget.Find(Link))
+		{
+			Documents->Remove(Document);
+			if (Documents->IsEmpty())
+			{
+				DocumentsByTarget.Remove(Link);
+			}
+		}
+	}
+}
+
+void FMarkdownLinkIndex::UpdateDocumentFromAssetData(const FAssetData& AssetData)
+{
+	const FSoftObjectPath Document = AssetData.GetSoftObjectPath();
+	TArray<FSoftObjectPath> Links;
+
+	// prefer the in-memory text when the document is loaded, it may have been edited since the last save
+	if (const UMarkdownAsset* LoadedDocument = Cast<UMarkdownAsset>(AssetData.FastGetAsset(false)))
+	{
+		MarkdownLinkIndex::LinksFromText(LoadedDocument->Text.ToString(), Links);
+	}
+	else
+	{
+		FString TagValue;
+		if (AssetData.GetTagValue(UMarkdownAsset::LinksTagName, TagValue))
+		{
+			MarkdownLinkIndex::ParseLinksTag(TagValue, Links);
+		}
+	}
+
+	SetDocumentLinks(Document, Links);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void FMarkdownLinkIndex::HandleFilesLoaded()
+{
+	if (IAssetRegistry* AssetRegistry = MarkdownLinkIndex::GetAssetRegistry())
+	{
+		AssetRegistry->OnFilesLoaded().RemoveAll(this);
+	}
+
+	BuildFromRegistry();
+}
+
+void FMarkdownLinkIndex::HandleAssetAdded(const FAssetData& AssetData)
+{
+	if (MarkdownLinkIndex::IsMarkdownAsset(AssetData) && !DeferUntilBuilt(AssetData.GetSoftObjectPath()))
+	{
+		UpdateDocumentFromAssetData(AssetData);
+	}
+}
+
+void FMarkdownLinkIndex::HandleAssetRemoved(const FAssetData& AssetData)
+{
+	if (MarkdownLinkIndex::IsMarkdownAsset(AssetData) && !DeferUntilBuilt(AssetData.GetSoftObjectPath()))
+	{
+		RemoveDocument(AssetData.GetSoftObjectPath());
+	}
+}
+
+void FMarkdownLinkIndex::HandleAssetUpdated(const FAssetData& AssetData)
+{
+	if (MarkdownLinkIndex::IsMarkdownAsset(AssetData) && !DeferUntilBuilt(AssetData.GetSoftObjectPath()))
+	{
+		UpdateDocumentFromAssetData(AssetData);
+	}
+}
+
+void FMarkdownLinkIndex::HandleAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath)
+{
+	const FSoftObjectPath OldPath(OldObjectPath);
+	const FSoftObjectPath NewPath = AssetData.GetSoftObjectPath();
+
+	// a renamed document keeps its links, only its key changes
+	if (MarkdownLinkIndex::IsMarkdownAsset(AssetData))
+	{
+		DeferUntilBuilt(OldPath);
+
+		TArray<FSoftObjectPath> Links;
+		if (!DeferUntilBuilt(NewPath) && TargetsByDocument.RemoveAndCopyValue(OldPath, Links))
+		{
+			for (const FSoftObjectPath& Link : Links)
+			{
+				if (TSet<FSoftObjectPath>* Documents = DocumentsByTarget.Find(Link))
+				{
+					Documents->Remove(OldPath);
+					Documents->Add(NewPath);
+				}
+			}
+
+			TargetsByDocument.Add(NewPath, MoveTemp(Links));
+		}
+	}
+
+	// renames arrive one asset at a time, collect them so a folder move is processed as one batch. An asset renamed
+	// again within the batch (A to B, then B to C) is followed to where it ends up, so links to A end up at C
+	for (TPair<FSoftObjectPath, FSoftObjectPath>& Rename : PendingRenames)
+	{
+		if (Rename.Value == OldPath)
+		{
+			Rename.Value = NewPath;
+		}
+	}
+
+	// links to a path the batch already moved away from meant the asset that was there first
+	if (!PendingRenames.Contains(OldPath))
+	{
+		PendingRenames.Add(OldPath, NewPath);
+	}
+
+	// until the index is built nothing is known to link to the asset, FinishBuild processes the batch
+	if (!PendingRenamesTickerHandle.IsValid() && bBuilt)
+	{
+		PendingRenamesTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FMarkdownLinkIndex::ProcessPendingRenames));
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool FMarkdownLinkIndex::RedirectPath(FStringView Path, FString& OutNewPath) const
+{
+	// links may point inside an asset (e.g. a class function), keep whatever follows the asset name
+	const int32 AssetPathLen = MarkdownLinkIndex::GetAssetPathLen(Path);
+
+	const FSoftObjectPath OldPath(FString(Path.Left(AssetPathLen)));
+
+	// an asset renamed and then renamed back within a batch has not moved
+	const FSoftObjectPath* NewPath = PendingRenames.Find(OldPath);
+	if (NewPath && *NewPath != OldPath)
+	{
+		OutNewPath = NewPath->ToString();
+		OutNewPath.Append(Path.RightChop(AssetPathLen));
+		return true;
+	}
+
+	return false;
+}
+
+bool FMarkdownLinkIndex::ProcessPendingRenames(float DeltaTime)
+{
+	PendingRenamesTickerHandle.Reset();
+
+	if (PendingRenames.IsEmpty())
+	{
+		return false;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	TSet<FSoftObjectPath> AffectedDocuments;
+	for (const TPair<FSoftObjectPath, FSoftObjectPath>& Rename : PendingRenames)
+	{
+		if (const TSet<FSoftObjectPath>* Documents = DocumentsByTarget.Find(Rename.Key))
+		{
+			AffectedDocuments.Append(*Documents);
+		}
+	}
+
+	int32 NumRewritten = 0;
+
+	if (!AffectedDocuments.IsEmpty())
+	{
+		FScopedTransaction Transaction(LOCTEXT("RewriteLinksTransaction", "Update Markdown Links"));
+
+		for (const FSoftObjectPath& DocumentPath : AffectedDocuments)
+		{
+			UMarkdownAsset* Document = Cast<UMarkdownAsset>(DocumentPath.TryLoad());
+			if (!Document)
+			{
+				continue;
+			}
+
+			FString Text = Document->Text.ToString();
+			const bool bChanged = MarkdownScanner::RewriteAssetLinks(Text, [this](FStringView Path, FString& OutNewPath)
+			{
+				return RedirectPath(Path, OutNewPath);
+			});
+
+			if (!bChanged)
+			{
+				continue;
+			}
+
+			MarkdownAssetStatics::ApplyDocumentText(Document, Text);
+			++NumRewritten;
+		}
+	}
+
+	UMarkdownAssetDeveloperSettings* ProjectSettings = GetMutableDefault<UMarkdownAssetDeveloperSettings>();
+	if (ProjectSettings->RedirectAssetPaths(PendingRenames))
+	{
+		ProjectSettings->SaveConfig(CPF_Config, *ProjectSettings->GetDefaultConfigFilename());
+	}
+
+	UE_LOG(MarkdownStaticsLog, Log, TEXT("Processed %d renamed assets, updated links in %d of %d referencing documents (%.2f ms)."),
+		PendingRenames.Num(), NumRewritten, AffectedDocuments.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+
+	PendingRenames.Empty();
+	return false;
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,77 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "UObject/SoftObjectPath.h"
+
+struct FAssetData;
+class UMarkdownAsset;
+
+/**
+ * Reverse index of the links between markdown documents and the assets they reference.
+ *
+ * The index is built from the asset registry tags written when a document is saved, so it never needs to load
+ * a document to answer "who links to this asset?". When assets are renamed or moved the affected documents are
+ * rewritten in a single batch on the next tick, which keeps folder moves of thousands of assets cheap.
+ *
+ * The tags are read by a background task of FMarkdownTaskScheduler, documents that change while it runs are refreshed
+ * once it has finished and renames wait for it.
+ */
+class FMarkdownLinkIndex : public TSharedFromThis<FMarkdownLinkIndex, ESPMode::ThreadSafe>
+{
+public:
+
+	void Initialize();
+	void Shutdown();
+
+	/** Returns the documents that link to the given object path. */
+	void GetReferencingDocuments(const FSoftObjectPath& Target, TArray<FSoftObjectPath>& OutDocuments) const;
+
+	/** Returns the object paths the given document links to. */
+	void GetDocumentLinks(const FSoftObjectPath& Document, TArray<FSoftObjectPath>& OutLinks) const;
+
+	/** Refreshes the links of a document from its in-memory text, e.g. while it is being edited. */
+	void UpdateDocument(const UMarkdownAsset* Document);
+
+private:
+
+	struct FBuildResult;
+
+	void BuildFromRegistry();
+	void FinishBuild(FBuildResult& Result);
+
+	/** Remembers a document changed while the index is built. Returns true if the index is not built yet. */
+	bool DeferUntilBuilt(const FSoftObjectPath& Document);
+
+	void SetDocumentLinks(const FSoftObjectPath& Document, const TArray<FSoftObjectPath>& Links);
+	void RemoveDocument(const FSoftObjectPath& Document);
+	void UpdateDocumentFromAssetData(const FAssetData& AssetData);
+
+	void HandleFilesLoaded();
+	void HandleAssetAdded(const FAssetData& AssetData);
+	void HandleAssetRemoved(const FAssetData& AssetData);
+	void HandleAssetUpdated(const FAssetData& AssetData);
+	void HandleAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath);
+
+	/** Rewrites every document affected by the renames queued since the last tick. */
+	bool ProcessPendingRenames(float DeltaTime);
+
+	/** Maps a linked path through the pending renames, keeping any sub-object or member suffix. */
+	bool RedirectPath(FStringView Path, FString& OutNewPath) const;
+
+private:
+
+	TMap<FSoftObjectPath, TSet<FSoftObjectPath>> DocumentsByTarget;
+	TMap<FSoftObjectPath, TArray<FSoftObjectPath>> TargetsByDocument;
+
+	TMap<FSoftObjectPath, FSoftObjectPath> PendingRenames;
+	FTSTicker::FDelegateHandle PendingRenamesTickerHandle;
+
+	/** Documents the registry reported changes for while the build task ran, they are read again when it finishes. */
+	TSet<FSoftObjectPath> ChangedWhileBuilding;
+
+	bool bBuilding = false;
+	bool bBuilt = false;
+};
@@ -0,0 +1,183 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Links/MarkdownLinkResolver.h"
+
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "UObject/CoreRedirects.h"
+
+namespace MarkdownLinkResolver
+{
+	static IAssetRegistry* GetAssetRegistry()
+	{
+		FAssetRegistryModule* AssetRegistryModule = FModuleManager::GetModulePtr<FAssetRegistryModule>("AssetRegistry");
+		return AssetRegistryModule ? &AssetRegistryModule->Get() : nullptr;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void FMarkdownLinkResolver::Initialize()
+{
+	if (IAssetRegistry* AssetRegistry = MarkdownLinkResolver::GetAssetRegistry())
+	{
+		AssetRegistry->OnAssetAdded().AddRaw(this, &FMarkdownLinkResolver::HandleAssetAdded);
+		AssetRegistry->OnAssetRemoved().AddRaw(this, &FMarkdownLinkResolver::HandleAssetRemoved);
+		AssetRegistry->OnAssetRenamed().AddRaw(this, &FMarkdownLinkResolver::HandleAssetRenamed);
+	}
+}
+
+void FMarkdownLinkResolver::Shutdown()
+{
+	if (IAssetRegistry* AssetRegistry = MarkdownLinkResolver::GetAssetRegistry())
+	{
+		AssetRegistry->OnAssetAdded().RemoveAll(this);
+		AssetRegistry->OnAssetRemoved().RemoveAll(this);
+		AssetRegistry->OnAssetRenamed().RemoveAll(this);
+	}
+
+	Cache.Empty();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+FMarkdownLinkResolver::FResolvedLink FMarkdownLinkResolver::Resolve(const FSoftObjectPath& LinkPath)
+{
+	if (const FResolvedLink* Cached = Cache.Find(LinkPath))
+	{
+		return *Cached;
+	}
+
+	// member links ("Class.Function") resolve through the object that owns them
+	return Cache.Add(LinkPath, ResolveUncached(FSoftObjectPath(LinkPath.GetAssetPath())));
+}
+
+UObject* FMarkdownLinkResolver::LoadResolved(const FSoftObjectPath& LinkPath)
+{
+	if (!LinkPath.IsValid())
+	{
+		return nullptr;
+	}
+
+	const FResolvedLink Resolved = Resolve(LinkPath);
+	if (!Resolved.IsValid())
+	{
+		return nullptr;
+	}
+
+	UObject* Object = FindObject<UObject>(Resolved.Path.GetAssetPath());
+	if (!Object)
+	{
+		Object = LoadObject<UObject>(nullptr, *Resolved.Path.GetAssetPathString());
+	}
+
+	return Object;
+}
+
+FString FMarkdownLinkResolver::Describe(const FSoftObjectPath& LinkPath)
+{
+	if (!LinkPath.IsValid())
+	{
+		return TEXT("Invalid link");
+	}
+
+	const FResolvedLink Resolved = Resolve(LinkPath);
+	if (!Resolved.IsValid())
+	{
+		return FString::Printf(TEXT("Missing: %s"), *LinkPath.ToString());
+	}
+
+	const FString ClassName = Resolved.ClassPath.IsValid() ? Resolved.ClassPath.GetAssetName().ToString() : TEXT("Object");
+
+	return Resolved.bRedirected
+		? FString::Printf(TEXT("%s %s (redirected from %s)"), *ClassName, *Resolved.Path.ToString(), *LinkPath.ToString())
+		: FString::Printf(TEXT("%s %s"), *ClassName, *Resolved.Path.ToString());
+}
+
+void FMarkdownLinkResolver::Invalidate()
+{
+	Cache.Reset();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+FMarkdownLinkResolver::FResolvedLink FMarkdownLinkResolver::ResolveUncached(const FSoftObjectPath& AssetPath) const
+{
+	FResolvedLink Result;
+
+	if (!AssetPath.IsValid())
+	{
+		return Result;
+	}
+
+	// native classes are never in the registry, core redirects take care of renamed types
+	if (AssetPath.GetLongPackageName().StartsWith(TEXT("/Script/")))
+	{
+		const FCoreRedirectObjectName RedirectedName = FCoreRedirects::GetRedirectedName(ECoreRedirectFlags::Type_Class, FCoreRedirectObjectName(AssetPath.ToString()));
+		const FSoftObjectPath NativePath(RedirectedName.ToString());
+
+		if (const UObject* Object = FindObject<UObject>(NativePath.GetAssetPath()))
+		{
+			Result.Path = NativePath;
+			Result.ClassPath = Object->GetClass()->GetClassPathName();
+			Result.bRedirected = NativePath != AssetPath;
+		}
+
+		return Result;
+	}
+
+	IAssetRegistry* AssetRegistry = MarkdownLinkResolver::GetAssetRegistry();
+	if (!AssetRegistry)
+	{
+		return Result;
+	}
+
+	const FAssetData AssetData = AssetRegistry->GetAssetByObjectPath(AssetPath);
+	if (AssetData.IsValid() && !AssetData.IsRedirector())
+	{
+		Result.Path = AssetPath;
+		Result.ClassPath = AssetData.AssetClassPath;
+		return Result;
+	}
+
+	// follows the whole redirector chain using only registry data
+	const FSoftObjectPath Destination = AssetRegistry->GetRedirectedObjectPath(AssetPath);
+	if (Destination.IsValid() && Destination != AssetPath)
+	{
+		const FAssetData DestinationData = AssetRegistry->GetAssetByObjectPath(Destination);
+		if (DestinationData.IsValid() && !DestinationData.IsRedirector())
+		{
+			Result.Path = Destination;
+			Result.ClassPath = DestinationData.AssetClassPath;
+			Result.bRedirected = true;
+		}
+	}
+
+	return Result;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void FMarkdownLinkResolver::HandleAssetAdded(const FAssetData& AssetData)
+{
+	// only a previously missing link can change when an asset appears, that includes member links ("Path.Asset:Member")
+	// and generated classes ("Path.Asset_C"), which are keyed by their own path but live in the same package
+	for (auto It = Cache.CreateIterator(); It; ++It)
+	{
+		if (It.Key().GetLongPackageFName() == AssetData.PackageName)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void FMarkdownLinkResolver::HandleAssetRemoved(const FAssetData& AssetData)
+{
+	// the removed asset may be the end of any redirector chain, start over
+	Invalidate();
+}
+
+void FMarkdownLinkResolver::HandleAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath)
+{
+	Invalidate();
+}
@@ -0,0 +1,62 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/SoftObjectPath.h"
+#include "UObject/TopLevelAssetPath.h"
+
+struct FAssetData;
+
+/**
+ * Resolves the object paths used by markdown links to the objects they currently point at.
+ *
+ * Redirectors are followed through the asset registry, so documents keep working after an asset is moved even
+ * before the links are rewritten. Results are cached for the session and invalidated by asset registry events,
+ * so clicking, validating or previewing a link only pays for the lookup the first time.
+ */
+class FMarkdownLinkResolver
+{
+public:
+
+	struct FResolvedLink
+	{
+		/** The object the link resolves to, invalid if the target does not exist. */
+		FSoftObjectPath Path;
+
+		/** The class of the resolved object, if known. */
+		FTopLevelAssetPath ClassPath;
+
+		/** True if the link went through one or more redirectors. */
+		bool bRedirected = false;
+
+		bool IsValid() const { return Path.IsValid(); }
+	};
+
+	void Initialize();
+	void Shutdown();
+
+	/** Resolves a link, following redirectors. Returned by value, a later lookup may grow the cache. */
+	FResolvedLink Resolve(const FSoftObjectPath& LinkPath);
+
+	/** Resolves a link and loads the object it points at. */
+	UObject* LoadResolved(const FSoftObjectPath& LinkPath);
+
+	/** Returns a one line description of the link target, used for hover previews. */
+	FString Describe(const FSoftObjectPath& LinkPath);
+
+	/** Drops every cached result. */
+	void Invalidate();
+
+private:
+
+	FResolvedLink ResolveUncached(const FSoftObjectPath& AssetPath) const;
+
+	void HandleAssetAdded(const FAssetData& AssetData);
+	void HandleAssetRemoved(const FAssetData& AssetData);
+	void HandleAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath);
+
+private:
+
+	TMap<FSoftObjectPath, FResolvedLink> Cache;
+};
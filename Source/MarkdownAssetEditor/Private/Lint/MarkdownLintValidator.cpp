@@ -0,0 +1,102 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Lint/MarkdownLintValidator.h"
+
+#include "DeveloperSettings/MarkdownAssetDeveloperSettings.h"
+#include "HelperFunctions/MarkdownAssetEditorStatics.h"
+#include "Lint/MarkdownLinter.h"
+#include "MarkdownAsset.h"
+
+#define LOCTEXT_NAMESPACE "MarkdownLintValidator"
+
+namespace MarkdownLintValidator
+{
+	static bool CanLint(const UObject* InAsset)
+	{
+		return InAsset && InAsset->IsA<UMarkdownAsset>() && UMarkdownAssetDeveloperSettings::Get()->ShouldLintOnValidate();
+	}
+
+	static FText GetSummary(int32 NumErrors)
+	{
+		return FText::Format(LOCTEXT("LintErrors", "{0} markdown lint error(s)"), NumErrors);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#if UE_VERSION_OLDER_THAN(5, 3, 0)
+
+bool UMarkdownLintValidator::CanValidateAsset_Implementation(UObject* InAsset) const
+{
+	return MarkdownLintValidator::CanLint(InAsset);
+}
+
+EDataValidationResult UMarkdownLintValidator::ValidateLoadedAsset_Implementation(UObject* InAsset, TArray<FText>& ValidationErrors)
+{
+	UMarkdownAsset* Document = CastChecked<UMarkdownAsset>(InAsset);
+	const TArray<FMarkdownLintIssue> Issues = MarkdownLinter::Lint(Document->Text.ToString(), UMarkdownAssetDeveloperSettings::Get()->GetLintOptions());
+
+	// messages are plain text here, open the document from the Lint action in the content browser to get to the line
+	for (const FMarkdownLintIssue& Issue : Issues)
+	{
+		const FText Message = FText::Format(LOCTEXT("LintIssue", "line {0}: {1} ({2})"), Issue.Line, FText::FromString(Issue.Message), FText::FromString(LexToString(Issue.Rule)));
+
+		if (Issue.Severity == EMarkdownLintSeverity::Error)
+		{
+			ValidationErrors.Add(Message);
+		}
+		else
+		{
+			AssetWarning(InAsset, Message);
+		}
+	}
+
+	const int32 NumErrors = MarkdownLinter::Count(Issues, EMarkdownLintSeverity::Error);
+
+	if (NumErrors > 0)
+	{
+		AssetFails(InAsset, MarkdownLintValidator::GetSummary(NumErrors), ValidationErrors);
+	}
+	else
+	{
+		AssetPasses(InAsset);
+	}
+
+	return GetValidationResult();
+}
+
+#else
+
+bool UMarkdownLintValidator::CanValidateAsset_Implementation(const FAssetData& InAssetData, UObject* InObject, FDataValidationContext& InContext) const
+{
+	return MarkdownLintValidator::CanLint(InObject);
+}
+
+EDataValidationResult UMarkdownLintValidator::ValidateLoadedAsset_Implementation(const FAssetData& InAssetData, UObject* InAsset, FDataValidationContext& Context)
+{
+	UMarkdownAsset* Document = CastChecked<UMarkdownAsset>(InAsset);
+	const TArray<FMarkdownLintIssue> Issues = MarkdownLinter::Lint(Document->Text.ToString(), UMarkdownAssetDeveloperSettings::Get()->GetLintOptions());
+
+	for (const FMarkdownLintIssue& Issue : Issues)
+	{
+		const EMessageSeverity::Type Severity = Issue.Severity == EMarkdownLintSeverity::Error ? EMessageSeverity::Error : EMessageSeverity::Warning;
+		MarkdownAssetStatics::AddLintMessage(AssetMessage(InAssetData, Severity), Document, Issue);
+	}
+
+	const int32 NumErrors = MarkdownLinter::Count(Issues, EMarkdownLintSeverity::Error);
+
+	if (NumErrors > 0)
+	{
+		AssetFails(InAsset, MarkdownLintValidator::GetSummary(NumErrors));
+	}
+	else
+	{
+		AssetPasses(InAsset);
+	}
+
+	return GetValidationResult();
+}
+
+#endif
+
+#undef LOCTEXT_NAMESPACE
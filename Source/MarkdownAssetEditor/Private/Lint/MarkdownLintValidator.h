@@ -0,0 +1,28 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EditorValidatorBase.h"
+#include "Misc/EngineVersionComparison.h"
+#include "MarkdownLintValidator.generated.h"
+
+/**
+ * Lints markdown documents whenever they are validated, on save and from Tools -> Validate Data. Unclosed code
+ * fences fail validation, the other rules are warnings. See MarkdownLinter.
+ */
+UCLASS()
+class UMarkdownLintValidator : public UEditorValidatorBase
+{
+	GENERATED_BODY()
+
+protected:
+
+#if UE_VERSION_OLDER_THAN(5, 3, 0)
+	virtual bool CanValidateAsset_Implementation(UObject* InAsset) const override;
+	virtual EDataValidationResult ValidateLoadedAsset_Implementation(UObject* InAsset, TArray<FText>& ValidationErrors) override;
+#else
+	virtual bool CanValidateAsset_Implementation(const FAssetData& InAssetData, UObject* InObject, FDataValidationContext& InContext) const override;
+	virtual EDataValidationResult ValidateLoadedAsset_Implementation(const FAssetData& InAssetData, UObject* InAsset, FDataValidationContext& Context) override;
+#endif
+};
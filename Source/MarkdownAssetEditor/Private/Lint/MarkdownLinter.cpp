@@ -0,0 +1,270 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Lint/MarkdownLinter.h"
+
+#include "Algo/StableSort.h"
+#include "Async/ParallelFor.h"
+#include "MarkdownSyntaxTree.h"
+
+namespace MarkdownLinter
+{
+	static const TCHAR* RuleNames[] =
+	{
+		TEXT("heading-increment"),
+		TEXT("table-columns"),
+		TEXT("unclosed-fence"),
+		TEXT("inline-image-size"),
+		TEXT("trailing-whitespace"),
+	};
+
+	static_assert(UE_ARRAY_COUNT(RuleNames) == int32(EMarkdownLintRule::Count), "Every lint rule needs a name");
+
+	static void AddIssue(TArray<FMarkdownLintIssue>& Issues, EMarkdownLintRule Rule, int32 Line, FString Message)
+	{
+		FMarkdownLintIssue& Issue = Issues.AddDefaulted_GetRef();
+		Issue.Rule = Rule;
+		Issue.Severity = GetSeverity(Rule);
+		Issue.Line = Line;
+		Issue.Message = MoveTemp(Message);
+	}
+
+	/** Decoded size of the data of a data URI, or -1 if the source is not one. */
+	static int64 GetDataUriSize(FStringView Source)
+	{
+		if (!Source.StartsWith(TEXT("data:"), ESearchCase::IgnoreCase))
+		{
+			return -1;
+		}
+
+		int32 Comma = INDEX_NONE;
+		if (!Source.FindChar(TEXT(','), Comma))
+		{
+			return -1;
+		}
+
+		const int64 PayloadLen = Source.Len() - Comma - 1;
+		const bool bBase64 = Source.Left(Comma).EndsWith(TEXT(";base64"), ESearchCase::IgnoreCase);
+
+		return bBase64 ? PayloadLen * 3 / 4 : PayloadLen;
+	}
+
+	/** Every syntax rule, checked in one walk of the tree. */
+	struct FLintVisitor
+	{
+		const FMarkdownSyntaxTree& Tree;
+		const FMarkdownLintOptions& Options;
+		TArray<FMarkdownLintIssue>& Issues;
+
+		int32 PreviousHeadingLevel = 0;
+		int32 NumTableColumns = 0;
+
+		/** Start and end offsets of the code blocks, in document order. */
+		TArray<TPair<int32, int32>> CodeBlocks;
+
+		bool Enter(const FMarkdownNode& Node)
+		{
+			switch (Node.Type)
+			{
+				case EMarkdownNodeType::Heading:
+				{
+					if (PreviousHeadingLevel > 0 && Node.Level > PreviousHeadingLevel + 1 && Options.IsEnabled(EMarkdownLintRule::HeadingIncrement))
+					{
+						AddIssue(Issues, EMarkdownLintRule::HeadingIncrement, Node.Line,
+							FString::Printf(TEXT("heading jumps from level %d to level %d"), PreviousHeadingLevel, int32(Node.Level)));
+					}
+
+					PreviousHeadingLevel = Node.Level;
+					return true;
+				}
+
+				case EMarkdownNodeType::Table:
+				{
+					NumTableColumns = Node.Level;
+					return true;
+				}
+
+				case EMarkdownNodeType::TableRow:
+				{
+					if (Options.IsEnabled(EMarkdownLintRule::TableColumns))
+					{
+						int32 NumCells = 0;
+						Tree.ForEachChild(Node, [&NumCells](const FMarkdownNode&) { ++NumCells; });
+
+						if (NumCells != NumTableColumns)
+						{
+							AddIssue(Issues, EMarkdownLintRule::TableColumns, Node.Line,
+								FString::Printf(TEXT("table row has %d cell(s) but the table has %d column(s)"), NumCells, NumTableColumns));
+						}
+					}
+					return true;
+				}
+
+				case EMarkdownNodeType::CodeBlock:
+				{
+					CodeBlocks.Emplace(Node.Start, Node.Start + Node.Len);
+
+					if (EnumHasAnyFlags(Node.Flags, EMarkdownNodeFlags::Unclosed) && Options.IsEnabled(EMarkdownLintRule::UnclosedFence))
+					{
+						AddIssue(Issues, EMarkdownLintRule::UnclosedFence, Node.Line,
+							TEXT("code fence is never closed, the rest of the document is shown as code"));
+					}
+
+					// only lines of code below here
+					return false;
+				}
+
+				case EMarkdownNodeType::Image:
+				{
+					if (Options.IsEnabled(EMarkdownLintRule::InlineImageSize))
+					{
+						const int64 Size = GetDataUriSize(Tree.GetArg(Node));
+
+						if (Size > Options.MaxInlineImageBytes)
+						{
+							AddIssue(Issues, EMarkdownLintRule::InlineImageSize, Node.Line,
+								FString::Printf(TEXT("inline image is %lld KB, over the %lld KB limit, import it as a texture instead"), Size / 1024, Options.MaxInlineImageBytes / 1024));
+						}
+					}
+					return false;
+				}
+
+				default:
+					return true;
+			}
+		}
+
+		void Leave(const FMarkdownNode& Node)
+		{
+		}
+	};
+
+	/**
+	 * Two trailing spaces are a hard line break, anything else left at the end of a line is noise in diffs. Lines of
+	 * code blocks are left alone, whitespace there may be part of the code.
+	 */
+	static void FindTrailingWhitespace(const FString& Text, TConstArrayView<TPair<int32, int32>> CodeBlocks, TArray<FMarkdownLintIssue>& Issues)
+	{
+		const TCHAR* Chars = *Text;
+		const int32 Len = Text.Len();
+
+		int32 Line = 1;
+		int32 CodeBlock = 0;
+
+		for (int32 LineStart = 0; LineStart < Len; ++Line)
+		{
+			int32 End = LineStart;
+			while (End < Len && Chars[End] != TEXT('\n'))
+			{
+				++End;
+			}
+
+			const int32 NextLine = End + 1;
+
+			while (CodeBlock < CodeBlocks.Num() && CodeBlocks[CodeBlock].Value <= LineStart)
+			{
+				++CodeBlock;
+			}
+
+			if (CodeBlock < CodeBlocks.Num() && CodeBlocks[CodeBlock].Key < End)
+			{
+				LineStart = NextLine;
+				continue;
+			}
+
+			End -= End > LineStart && Chars[End - 1] == TEXT('\r') ? 1 : 0;
+
+			int32 ContentEnd = End;
+			bool bTabs = false;
+
+			while (ContentEnd > LineStart && (Chars[ContentEnd - 1] == TEXT(' ') || Chars[ContentEnd - 1] == TEXT('\t')))
+			{
+				bTabs |= Chars[--ContentEnd] == TEXT('\t');
+			}
+
+			const int32 NumTrailing = End - ContentEnd;
+			const bool bHardBreak = NumTrailing == 2 && !bTabs && ContentEnd > LineStart;
+
+			if (NumTrailing > 0 && !bHardBreak)
+			{
+				AddIssue(Issues, EMarkdownLintRule::TrailingWhitespace, Line,
+					FString::Printf(TEXT("line ends with %d whitespace character(s)"), NumTrailing));
+			}
+
+			LineStart = NextLine;
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+const TCHAR* LexToString(EMarkdownLintRule Rule)
+{
+	return Rule < EMarkdownLintRule::Count ? MarkdownLinter::RuleNames[int32(Rule)] : TEXT("unknown");
+}
+
+bool LexTryParseString(EMarkdownLintRule& OutRule, const TCHAR* Name)
+{
+	for (int32 Index = 0; Index < int32(EMarkdownLintRule::Count); ++Index)
+	{
+		if (FCString::Stricmp(Name, MarkdownLinter::RuleNames[Index]) == 0)
+		{
+			OutRule = EMarkdownLintRule(Index);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+EMarkdownLintSeverity MarkdownLinter::GetSeverity(EMarkdownLintRule Rule)
+{
+	return Rule == EMarkdownLintRule::UnclosedFence ? EMarkdownLintSeverity::Error : EMarkdownLintSeverity::Warning;
+}
+
+void MarkdownLinter::Lint(const FMarkdownSyntaxTree& Tree, const FMarkdownLintOptions& Options, TArray<FMarkdownLintIssue>& OutIssues)
+{
+	const int32 FirstIssue = OutIssues.Num();
+
+	FLintVisitor Visitor{ Tree, Options, OutIssues };
+	Tree.Walk(Visitor);
+
+	if (Options.IsEnabled(EMarkdownLintRule::TrailingWhitespace))
+	{
+		FindTrailingWhitespace(Tree.GetText(), Visitor.CodeBlocks, OutIssues);
+	}
+
+	// the walk and the line scan each find issues in order, merge them
+	Algo::StableSortBy(MakeArrayView(OutIssues).Mid(FirstIssue), &FMarkdownLintIssue::Line);
+}
+
+TArray<FMarkdownLintIssue> MarkdownLinter::Lint(FString Text, const FMarkdownLintOptions& Options)
+{
+	TArray<FMarkdownLintIssue> Issues;
+	Lint(FMarkdownSyntaxTree::Parse(MoveTemp(Text)), Options, Issues);
+	return Issues;
+}
+
+void MarkdownLinter::LintAll(TConstArrayView<FString> Texts, const FMarkdownLintOptions& Options, TArray<TArray<FMarkdownLintIssue>>& OutIssues)
+{
+	OutIssues.Reset();
+	OutIssues.SetNum(Texts.Num());
+
+	ParallelFor(Texts.Num(), [&Texts, &Options, &OutIssues](int32 Index)
+	{
+		OutIssues[Index] = Lint(Texts[Index], Options);
+	}, EParallelForFlags::Unbalanced);
+}
+
+int32 MarkdownLinter::Count(TConstArrayView<FMarkdownLintIssue> Issues, EMarkdownLintSeverity Severity)
+{
+	int32 Num = 0;
+
+	for (const FMarkdownLintIssue& Issue : Issues)
+	{
+		Num += Issue.Severity == Severity ? 1 : 0;
+	}
+
+	return Num;
+}
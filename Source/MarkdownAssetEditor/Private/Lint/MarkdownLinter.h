@@ -0,0 +1,82 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FMarkdownSyntaxTree;
+
+enum class EMarkdownLintRule : uint8
+{
+	/** A heading more than one level below the heading before it, e.g. a h4 straight after a h2. */
+	HeadingIncrement,
+
+	/** A table row with more or fewer cells than the delimiter row has columns. */
+	TableColumns,
+
+	/** A code fence that is never closed, so the rest of the document is rendered as code. */
+	UnclosedFence,
+
+	/** An image embedded as a data URI bigger than FMarkdownLintOptions::MaxInlineImageBytes. */
+	InlineImageSize,
+
+	/** Spaces or tabs at the end of a line outside code, other than the two spaces of a hard line break. */
+	TrailingWhitespace,
+
+	Count
+};
+
+/** The name used in settings, reports and the message log, e.g. "heading-increment". */
+const TCHAR* LexToString(EMarkdownLintRule Rule);
+bool LexTryParseString(EMarkdownLintRule& OutRule, const TCHAR* Name);
+
+enum class EMarkdownLintSeverity : uint8
+{
+	Warning,
+	Error,
+};
+
+struct FMarkdownLintIssue
+{
+	EMarkdownLintRule Rule = EMarkdownLintRule::Count;
+	EMarkdownLintSeverity Severity = EMarkdownLintSeverity::Warning;
+
+	/** One based line number. */
+	int32 Line = 0;
+
+	FString Message;
+};
+
+struct FMarkdownLintOptions
+{
+	/** One bit per EMarkdownLintRule. */
+	uint32 EnabledRules = (1u << uint32(EMarkdownLintRule::Count)) - 1;
+
+	int64 MaxInlineImageBytes = 64 * 1024;
+
+	bool IsEnabled(EMarkdownLintRule Rule) const { return (EnabledRules & (1u << uint32(Rule))) != 0; }
+	void Disable(EMarkdownLintRule Rule) { EnabledRules &= ~(1u << uint32(Rule)); }
+};
+
+/**
+ * Checks documents for markdown that renders differently than intended or bloats them.
+ *
+ * Each document is parsed once and every syntax rule is checked in a single walk of its tree, only trailing whitespace
+ * needs the raw lines and is found by one scan of the text. Batches are spread over all cores, one document per task.
+ */
+namespace MarkdownLinter
+{
+	/** The severity issues of the rule are reported with. Unclosed fences are errors, everything else warnings. */
+	EMarkdownLintSeverity GetSeverity(EMarkdownLintRule Rule);
+
+	/** Lints a parsed document, the issues are sorted by line. */
+	void Lint(const FMarkdownSyntaxTree& Tree, const FMarkdownLintOptions& Options, TArray<FMarkdownLintIssue>& OutIssues);
+
+	TArray<FMarkdownLintIssue> Lint(FString Text, const FMarkdownLintOptions& Options);
+
+	/** Lints the documents in parallel, OutIssues gets the issues of each text at the same index. */
+	void LintAll(TConstArrayView<FString> Texts, const FMarkdownLintOptions& Options, TArray<TArray<FMarkdownLintIssue>>& OutIssues);
+
+	/** Number of issues with the severity. */
+	int32 Count(TConstArrayView<FMarkdownLintIssue> Issues, EMarkdownLintSeverity Severity);
+}
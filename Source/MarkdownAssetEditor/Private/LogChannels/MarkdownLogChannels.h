@@ -2,4 +2,15 @@
 
 #pragma once
 
-MARKDOWNASSETEDITOR_API DECLARE_LOG_CATEGORY_EXTERN(MarkdownStaticsLog, Log, All)
\ No newline at end of file
+#include "Stats/Stats.h"
+
+MARKDOWNASSETEDITOR_API DECLARE_LOG_CATEGORY_EXTERN(MarkdownStaticsLog, Log, All)
+
+namespace MarkdownMessageLog
+{
+	/** Message log listing used for link validation and other document reports. */
+	inline const FName LogName(TEXT("MarkdownAsset"));
+}
+
+/** Stat group for the editor services, shown with "stat Markdown". */
+DECLARE_STATS_GROUP(TEXT("Markdown"), STATGROUP_Markdown, STATCAT_Advanced);
@@ -14,20 +14,121 @@
 #include "DeveloperSettings/MarkdownAssetDeveloperSettings.h"
 #include "Toolkits/AssetEditorToolkitMenuContext.h"
 #include "HelperFunctions/MarkdownAssetEditorStatics.h"
+#include "Completion/MarkdownCompletionIndex.h"
+#include "Embeds/MarkdownDataEmbeds.h"
+#include "Embeds/MarkdownEmbedExpander.h"
+#include "Embeds/MarkdownIncludeEmbed.h"
+#include "Embeds/MarkdownSourceEmbed.h"
+#include "IAssetSearchModule.h"
 #include "Icons/Icons.h"
+#include "Images/MarkdownImageStore.h"
+#include "Links/MarkdownLinkIndex.h"
+#include "Links/MarkdownLinkResolver.h"
+#include "MarkdownAsset.h"
+#include "MessageLogModule.h"
+#include "Search/MarkdownAssetIndexer.h"
+#include "Scheduling/MarkdownTaskScheduler.h"
+#include "Staleness/MarkdownStalenessTracker.h"
+#include "Framework/Docking/TabManager.h"
+#include "Widgets/Docking/SDockTab.h"
+#include "Widgets/SMarkdownFindReplace.h"
+#include "WorkspaceMenuStructure.h"
+#include "WorkspaceMenuStructureModule.h"
 
 #define LOCTEXT_NAMESPACE "FMarkdownAssetEditorModule"
 
+namespace MarkdownAssetEditorTabs
+{
+	static const FName FindReplaceTabId( "MarkdownFindReplace" );
+}
+
+FMarkdownAssetEditorModule::FMarkdownAssetEditorModule() = default;
+FMarkdownAssetEditorModule::~FMarkdownAssetEditorModule() = default;
+
 void FMarkdownAssetEditorModule::StartupModule()
 {
 	RegisterMenuExtensions();
 	RegisterSettings();
+	RegisterMessageLog();
+	RegisterTabSpawners();
+	RegisterAssetIndexers();
+	RegisterCookPolicy();
+
+	TaskScheduler = MakeShared<FMarkdownTaskScheduler, ESPMode::ThreadSafe>();
+	TaskScheduler->Initialize();
+
+	LinkIndex = MakeShared<FMarkdownLinkIndex, ESPMode::ThreadSafe>();
+	LinkIndex->Initialize();
+
+	LinkResolver = MakeUnique<FMarkdownLinkResolver>();
+	LinkResolver->Initialize();
+
+	CompletionIndex = MakeShared<FMarkdownCompletionIndex, ESPMode::ThreadSafe>();
+	CompletionIndex->Initialize();
+
+	EmbedExpander = MakeUnique<FMarkdownEmbedExpander>();
+	EmbedExpander->Initialize();
+	EmbedExpander->RegisterDirective(TEXT("datatable"), MakeShared<FMarkdownDataTableEmbed>());
+	EmbedExpander->RegisterDirective(TEXT("property"), MakeShared<FMarkdownPropertyEmbed>());
+	EmbedExpander->RegisterDirective(TEXT("include"), MakeShared<FMarkdownIncludeEmbed>());
+	EmbedExpander->RegisterDirective(TEXT("source"), MakeShared<FMarkdownSourceEmbed>());
+
+	ImageStore = MakeUnique<FMarkdownImageStore>();
+	ImageStore->Initialize();
+
+	StalenessTracker = MakeShared<FMarkdownStalenessTracker, ESPMode::ThreadSafe>();
+	StalenessTracker->Initialize();
 }
 
 void FMarkdownAssetEditorModule::ShutdownModule()
 {
+	if (StalenessTracker.IsValid())
+	{
+		StalenessTracker->Shutdown();
+		StalenessTracker.Reset();
+	}
+
+	if (ImageStore.IsValid())
+	{
+		ImageStore->Shutdown();
+		ImageStore.Reset();
+	}
+
+	if (EmbedExpander.IsValid())
+	{
+		EmbedExpander->Shutdown();
+		EmbedExpander.Reset();
+	}
+
+	if (CompletionIndex.IsValid())
+	{
+		CompletionIndex->Shutdown();
+		CompletionIndex.Reset();
+	}
+
+	if (LinkResolver.IsValid())
+	{
+		LinkResolver->Shutdown();
+		LinkResolver.Reset();
+	}
+
+	if (LinkIndex.IsValid())
+	{
+		LinkIndex->Shutdown();
+		LinkIndex.Reset();
+	}
+
+	if (TaskScheduler.IsValid())
+	{
+		TaskScheduler->Shutdown();
+		TaskScheduler.Reset();
+	}
+
+	UnregisterCookPolicy();
+	UnregisterTabSpawners();
 	UnregisterMenuExtensions();
 	UnregisterSettings();
+	UnregisterMessageLog();
 }
 
 void FMarkdownAssetEditorModule::RegisterMenuExtensions()
@@ -46,6 +147,23 @@ void FMarkdownAssetEditorModule::RegisterMenuExtensions()
 		MarkdownIcons::DocumentationIcon
 	));
 
+	UToolMenu* ToolsMenu = UToolMenus::Get()->ExtendMenu("LevelEditor.MainMenu.Tools");
+
+	FToolMenuSection& ToolsDocumentationSection = ToolsMenu->FindOrAddSection("Documentation", LOCTEXT("DocumentationSection", "Documentation"));
+	ToolsDocumentationSection.AddMenuEntry(
+		TEXT("MarkdownStalenessReport"),
+		LOCTEXT("StalenessReportLabel", "Outdated Documentation Report"),
+		LOCTEXT("StalenessReportTooltip", "List the markdown documents whose linked assets changed since the document was last saved."),
+		MarkdownIcons::DocumentationIcon,
+		FUIAction(FExecuteAction::CreateLambda([this]()
+		{
+			if (StalenessTracker.IsValid())
+			{
+				StalenessTracker->ReportStaleDocuments();
+			}
+		}))
+	);
+
 	
 	
 	UToolMenu* AssetEditorToolbar = UToolMenus::Get()->ExtendMenu("AssetEditorToolbar.CommonActions");
@@ -80,6 +198,72 @@ void FMarkdownAssetEditorModule::RegisterSettings()
 	}
 }
 
+void FMarkdownAssetEditorModule::RegisterTabSpawners()
+{
+	FGlobalTabmanager::Get()->RegisterNomadTabSpawner( MarkdownAssetEditorTabs::FindReplaceTabId, FOnSpawnTab::CreateRaw( this, &FMarkdownAssetEditorModule::SpawnFindReplaceTab ) )
+		.SetDisplayName( LOCTEXT( "FindReplaceTabTitle", "Markdown Find & Replace" ) )
+		.SetTooltipText( LOCTEXT( "FindReplaceTabTooltip", "Find and replace text across all markdown documents." ) )
+		.SetGroup( WorkspaceMenu::GetMenuStructure().GetToolsCategory() )
+		.SetIcon( MarkdownIcons::DocumentationIcon );
+}
+
+void FMarkdownAssetEditorModule::UnregisterTabSpawners()
+{
+	if( FSlateApplication::IsInitialized() )
+	{
+		FGlobalTabmanager::Get()->UnregisterNomadTabSpawner( MarkdownAssetEditorTabs::FindReplaceTabId );
+	}
+}
+
+TSharedRef<SDockTab> FMarkdownAssetEditorModule::SpawnFindReplaceTab( const FSpawnTabArgs& Args )
+{
+	return SNew( SDockTab )
+		.TabRole( ETabRole::NomadTab )
+		[
+			SNew( SMarkdownFindReplace )
+		];
+}
+
+void FMarkdownAssetEditorModule::RegisterAssetIndexers()
+{
+	// the engine search index has no way to remove an indexer, it lives as long as the asset search module. Indexers
+	// apply to subclasses too, so link assets are covered by the markdown asset one
+	IAssetSearchModule& AssetSearchModule = FModuleManager::LoadModuleChecked<IAssetSearchModule>( "AssetSearch" );
+	AssetSearchModule.RegisterAssetIndexer( UMarkdownAsset::StaticClass(), MakeUnique<FMarkdownAssetIndexer>() );
+}
+
+void FMarkdownAssetEditorModule::RegisterCookPolicy()
+{
+	UMarkdownAsset::IsEditorOnlyByDefault.BindLambda( []( const UMarkdownAsset& Document )
+	{
+		return UMarkdownAssetDeveloperSettings::Get()->IsDocumentEditorOnly( EMarkdownCookPolicy::Default, Document.GetPackage()->GetFName() );
+	});
+}
+
+void FMarkdownAssetEditorModule::UnregisterCookPolicy()
+{
+	UMarkdownAsset::IsEditorOnlyByDefault.Unbind();
+}
+
+void FMarkdownAssetEditorModule::RegisterMessageLog()
+{
+	FMessageLogModule& MessageLogModule = FModuleManager::LoadModuleChecked<FMessageLogModule>( "MessageLog" );
+
+	FMessageLogInitializationOptions InitOptions;
+	InitOptions.bShowPages = true;
+	InitOptions.bAllowClear = true;
+
+	MessageLogModule.RegisterLogListing( MarkdownMessageLog::LogName, LOCTEXT( "MarkdownAssetMessageLogLabel", "Markdown Asset" ), InitOptions );
+}
+
+void FMarkdownAssetEditorModule::UnregisterMessageLog()
+{
+	if( FMessageLogModule* MessageLogModule = FModuleManager::GetModulePtr<FMessageLogModule>( "MessageLog" ) )
+	{
+		MessageLogModule->UnregisterLogListing( MarkdownMessageLog::LogName );
+	}
+}
+
 void FMarkdownAssetEditorModule::UnregisterMenuExtensions()
 {
 	UToolMenus::UnregisterOwner(this);
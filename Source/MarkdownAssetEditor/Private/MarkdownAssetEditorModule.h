@@ -5,28 +5,72 @@
 #include "Modules/ModuleInterface.h"
 #include "HAL/FileManager.h"
 #include "Misc/FileHelper.h"
+#include "MarkdownTextCodec.h"
+#include "Modules/ModuleManager.h"
+#include "Templates/UniquePtr.h"
+
+class FMarkdownCompletionIndex;
+class FMarkdownEmbedExpander;
+class FMarkdownImageStore;
+class FMarkdownLinkIndex;
+class FMarkdownLinkResolver;
+class FMarkdownStalenessTracker;
+class FMarkdownTaskScheduler;
+class FSpawnTabArgs;
+class SDockTab;
+class UAssetEditorToolkitMenuContext;
 
 class MARKDOWNASSETEDITOR_API FMarkdownAssetEditorModule : public IModuleInterface 
 {
 	
 public:
+
+	FMarkdownAssetEditorModule();
+	virtual ~FMarkdownAssetEditorModule();
 	
 	virtual void StartupModule() override;
 	virtual void ShutdownModule() override;
 
+	static FMarkdownAssetEditorModule& Get()
+	{
+		return FModuleManager::LoadModuleChecked<FMarkdownAssetEditorModule>("MarkdownAssetEditor");
+	}
+
+	/** Reverse index of the links between documents and assets. */
+	FMarkdownLinkIndex& GetLinkIndex() const { return *LinkIndex; }
+
+	/** Shared, cached resolution of link paths to the objects they point at. */
+	FMarkdownLinkResolver& GetLinkResolver() const { return *LinkResolver; }
+
+	/** Prefix index of the asset registry used to autocomplete links in the editor. */
+	FMarkdownCompletionIndex& GetCompletionIndex() const { return *CompletionIndex; }
+
+	/** Expands live data embeds into markdown before documents are rendered. */
+	FMarkdownEmbedExpander& GetEmbedExpander() const { return *EmbedExpander; }
+
+	/** Stores pasted images and prepares texture links for the viewer. */
+	FMarkdownImageStore& GetImageStore() const { return *ImageStore; }
+
+	/** Tracks documents that are out of date with the assets they link to. */
+	FMarkdownStalenessTracker& GetStalenessTracker() const { return *StalenessTracker; }
+
+	/** Runs the background work of the other services on worker threads, by priority and within a frame budget. */
+	FMarkdownTaskScheduler& GetTaskScheduler() const { return *TaskScheduler; }
+
 	static FText ReadTextFromFile(const FString& FilePath)
 	{
 		FString Text;
-		if (FFileHelper::LoadFileToString(Text, *FilePath))
+		if (MarkdownTextCodec::LoadFile(FilePath, Text))
 		{
-			return FText::FromString(Text);
+			return FText::FromString(MoveTemp(Text));
 		}
 		return FText::GetEmpty();
 	}
 
+	/** Keeps the encoding of an existing file, so only the edited text shows up in source control. */
 	static bool WriteTextToFile(const FString& FilePath, const FText& Content)
 	{
-		return FFileHelper::SaveStringToFile(Content.ToString(), *FilePath);
+		return MarkdownTextCodec::SaveFile(FilePath, Content.ToString());
 	}
 
 	static bool IsFileReadOnly(const FString& FilePath)
@@ -71,8 +115,39 @@ protected:
 	void UnregisterMenuExtensions();
 	void UnregisterSettings();
 
+	/** Registers the project wide markdown tool tabs (find & replace, reports). */
+	void RegisterTabSpawners();
+	void UnregisterTabSpawners();
+
+	TSharedRef<SDockTab> SpawnFindReplaceTab(const FSpawnTabArgs& Args);
+
+	/** Makes markdown documents searchable from the engine Asset Search tab. */
+	void RegisterAssetIndexers();
+
+	/** Lets the project settings decide which documents are stripped from cooked builds. */
+	void RegisterCookPolicy();
+	void UnregisterCookPolicy();
+
+	/** Registers the message log listing used for document reports. */
+	void RegisterMessageLog();
+	void UnregisterMessageLog();
+
 	void EditorAction_OpenProjectDocumentation();
 	void EditorAction_OpenAssetDocumentation(UAssetEditorToolkitMenuContext* ExecutionContext);
 
+private:
+
+	/** Shared so tasks finishing on the game thread can hold weak references to it. */
+	TSharedPtr<FMarkdownTaskScheduler, ESPMode::ThreadSafe> TaskScheduler;
+
+	/** Shared so their build tasks can hold weak references to them. */
+	TSharedPtr<FMarkdownLinkIndex, ESPMode::ThreadSafe> LinkIndex;
+	TSharedPtr<FMarkdownCompletionIndex, ESPMode::ThreadSafe> CompletionIndex;
+
+	TUniquePtr<FMarkdownLinkResolver> LinkResolver;
+	TUniquePtr<FMarkdownEmbedExpander> EmbedExpander;
+	TUniquePtr<FMarkdownImageStore> ImageStore;
 
+	/** Shared so the background checks and Content Browser widgets can hold weak references to it. */
+	TSharedPtr<FMarkdownStalenessTracker, ESPMode::ThreadSafe> StalenessTracker;
 };
\ No newline at end of file
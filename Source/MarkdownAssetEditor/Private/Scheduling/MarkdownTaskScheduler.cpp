@@ -0,0 +1,251 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Scheduling/MarkdownTaskScheduler.h"
+
+#include "Async/Async.h"
+#include "Editor.h"
+#include "HAL/IConsoleManager.h"
+#include "LogChannels/MarkdownLogChannels.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Queued Tasks"), STAT_MarkdownQueuedTasks, STATGROUP_Markdown);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Running Tasks"), STAT_MarkdownRunningTasks, STATGROUP_Markdown);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Tasks Per Second"), STAT_MarkdownTasksPerSecond, STATGROUP_Markdown);
+
+namespace MarkdownTaskScheduler
+{
+	static TAutoConsoleVariable<int32> CVarMaxWorkers(
+		TEXT("Markdown.Scheduler.MaxWorkers"),
+		2,
+		TEXT("Number of normal and background markdown tasks run at the same time. Interactive tasks are not limited."));
+
+	static TAutoConsoleVariable<float> CVarSpikeMs(
+		TEXT("Markdown.Scheduler.SpikeMs"),
+		50.0f,
+		TEXT("Frames slower than this, in milliseconds, hold back markdown background tasks for Markdown.Scheduler.SpikeCooldown seconds."));
+
+	static TAutoConsoleVariable<float> CVarSpikeCooldown(
+		TEXT("Markdown.Scheduler.SpikeCooldown"),
+		1.0f,
+		TEXT("Seconds markdown background tasks are held back after a slow frame."));
+
+	static TAutoConsoleVariable<bool> CVarRunDuringPIE(
+		TEXT("Markdown.Scheduler.RunDuringPIE"),
+		false,
+		TEXT("Run markdown background tasks while playing in the editor."));
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void FMarkdownTaskScheduler::Initialize()
+{
+	WindowStart = FPlatformTime::Seconds();
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FMarkdownTaskScheduler::Tick));
+}
+
+void FMarkdownTaskScheduler::Shutdown()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+
+	for (TArray<FTaskRef>& Queue : Queues)
+	{
+		for (const FTaskRef& Task : Queue)
+		{
+			Task->Cancel();
+		}
+
+		Queue.Empty();
+	}
+
+	// running tasks finish on their own, their continuations are dropped with the scheduler
+	for (const FTaskRef& Task : Running)
+	{
+		Task->Cancel();
+	}
+
+	Running.Empty();
+}
+
+TSharedRef<FMarkdownTask, ESPMode::ThreadSafe> FMarkdownTaskScheduler::Launch(FName Name, EMarkdownTaskPriority Priority, FMarkdownTaskWork Work)
+{
+	check(IsInGameThread());
+
+	FTaskRef Task = MakeShared<FMarkdownTask, ESPMode::ThreadSafe>();
+	Task->Name = Name;
+	Task->Priority = Priority;
+	Task->Work = MoveTemp(Work);
+
+	Queues[int32(Priority)].Add(Task);
+
+	if (Priority == EMarkdownTaskPriority::Interactive)
+	{
+		Dispatch();
+	}
+
+	return Task;
+}
+
+void FMarkdownTaskScheduler::Cancel(FName Name)
+{
+	for (TArray<FTaskRef>& Queue : Queues)
+	{
+		NumCancelled += Queue.RemoveAll([Name](const FTaskRef& Task) { return Task->GetName() == Name; });
+	}
+
+	for (const FTaskRef& Task : Running)
+	{
+		if (Task->GetName() == Name)
+		{
+			Task->Cancel();
+		}
+	}
+}
+
+FMarkdownTaskSchedulerStats FMarkdownTaskScheduler::GetStats() const
+{
+	FMarkdownTaskSchedulerStats Stats;
+
+	for (const TArray<FTaskRef>& Queue : Queues)
+	{
+		Stats.NumQueued += Queue.Num();
+	}
+
+	Stats.NumRunning = Running.Num();
+	Stats.NumCompleted = NumCompleted;
+	Stats.NumCancelled = NumCancelled;
+	Stats.TasksPerSecond = TasksPerSecond;
+	Stats.bPaused = IsPaused();
+
+	return Stats;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool FMarkdownTaskScheduler::Tick(float DeltaTime)
+{
+	const double Now = FPlatformTime::Seconds();
+
+	// the ticker delta is the editor frame time, a spike means the user is waiting on something heavier than us
+	if (DeltaTime * 1000.0f > MarkdownTaskScheduler::CVarSpikeMs.GetValueOnGameThread())
+	{
+		ThrottledUntil = Now + MarkdownTaskScheduler::CVarSpikeCooldown.GetValueOnGameThread();
+	}
+
+	if (Now - WindowStart >= 1.0)
+	{
+		TasksPerSecond = float(WindowCompleted / (Now - WindowStart));
+		WindowCompleted = 0;
+		WindowStart = Now;
+	}
+
+	Dispatch();
+
+	const FMarkdownTaskSchedulerStats Stats = GetStats();
+	SET_DWORD_STAT(STAT_MarkdownQueuedTasks, Stats.NumQueued);
+	SET_DWORD_STAT(STAT_MarkdownRunningTasks, Stats.NumRunning);
+	SET_FLOAT_STAT(STAT_MarkdownTasksPerSecond, Stats.TasksPerSecond);
+
+	return true;
+}
+
+bool FMarkdownTaskScheduler::IsPaused() const
+{
+	if (FPlatformTime::Seconds() < ThrottledUntil)
+	{
+		return true;
+	}
+
+	if (GEditor && GEditor->PlayWorld && !MarkdownTaskScheduler::CVarRunDuringPIE.GetValueOnGameThread())
+	{
+		return true;
+	}
+
+	return false;
+}
+
+void FMarkdownTaskScheduler::Dispatch()
+{
+	TArray<FTaskRef>& Interactive = Queues[int32(EMarkdownTaskPriority::Interactive)];
+
+	while (!Interactive.IsEmpty())
+	{
+		Start(Interactive[0]);
+		Interactive.RemoveAt(0);
+	}
+
+	// everything else yields to interactive work
+	for (const FTaskRef& Task : Running)
+	{
+		if (Task->GetPriority() == EMarkdownTaskPriority::Interactive)
+		{
+			return;
+		}
+	}
+
+	if (IsPaused())
+	{
+		return;
+	}
+
+	const int32 MaxWorkers = FMath::Max(1, MarkdownTaskScheduler::CVarMaxWorkers.GetValueOnGameThread());
+
+	for (int32 Priority = int32(EMarkdownTaskPriority::Normal); Priority < int32(EMarkdownTaskPriority::Num); ++Priority)
+	{
+		TArray<FTaskRef>& Queue = Queues[Priority];
+
+		while (!Queue.IsEmpty() && Running.Num() < MaxWorkers)
+		{
+			Start(Queue[0]);
+			Queue.RemoveAt(0);
+		}
+	}
+}
+
+void FMarkdownTaskScheduler::Start(const FTaskRef& Task)
+{
+	Running.Add(Task);
+
+	TWeakPtr<FMarkdownTaskScheduler, ESPMode::ThreadSafe> WeakThis = AsShared();
+
+	Async(EAsyncExecution::ThreadPool, [WeakThis, Task]()
+	{
+		TUniqueFunction<void()> Continuation;
+
+		if (!Task->IsCancelled())
+		{
+			Continuation = Task->Work(*Task);
+		}
+
+		// release whatever the work captured here rather than on the game thread
+		Task->Work = nullptr;
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Task, Continuation = MoveTemp(Continuation)]() mutable
+		{
+			if (TSharedPtr<FMarkdownTaskScheduler, ESPMode::ThreadSafe> This = WeakThis.Pin())
+			{
+				This->Finish(Task, MoveTemp(Continuation));
+			}
+		});
+	});
+}
+
+void FMarkdownTaskScheduler::Finish(const FTaskRef& Task, TUniqueFunction<void()>&& Continuation)
+{
+	Running.Remove(Task);
+
+	if (Task->IsCancelled())
+	{
+		++NumCancelled;
+	}
+	else
+	{
+		++NumCompleted;
+		++WindowCompleted;
+
+		if (Continuation)
+		{
+			Continuation();
+		}
+	}
+
+	Dispatch();
+}
@@ -0,0 +1,111 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+
+#include <atomic>
+
+enum class EMarkdownTaskPriority : uint8
+{
+	/** The user asked for it and is waiting, e.g. pasting an image. Starts at once, even while playing, and holds the other tasks back. */
+	Interactive,
+
+	/** Keeps editor state current, e.g. refreshing an index after an asset changed. */
+	Normal,
+
+	/** Housekeeping nobody is waiting on, e.g. staleness checks. */
+	Background,
+
+	Num
+};
+
+class FMarkdownTask;
+
+/** Runs on a worker thread and returns what to run on the game thread afterwards, which may be empty. */
+using FMarkdownTaskWork = TUniqueFunction<TUniqueFunction<void()>(const FMarkdownTask& Task)>;
+
+class FMarkdownTask
+{
+public:
+
+	FName GetName() const { return Name; }
+	EMarkdownTaskPriority GetPriority() const { return Priority; }
+
+	/** Long running work should check this and return early. The game thread continuation is skipped once cancelled. */
+	bool IsCancelled() const { return bCancelled; }
+	void Cancel() { bCancelled = true; }
+
+private:
+
+	friend class FMarkdownTaskScheduler;
+
+	FName Name;
+	EMarkdownTaskPriority Priority = EMarkdownTaskPriority::Normal;
+	FMarkdownTaskWork Work;
+	std::atomic<bool> bCancelled = false;
+};
+
+struct FMarkdownTaskSchedulerStats
+{
+	int32 NumQueued = 0;
+	int32 NumRunning = 0;
+	int32 NumCompleted = 0;
+	int32 NumCancelled = 0;
+
+	/** Tasks completed over the last second. */
+	float TasksPerSecond = 0.0f;
+
+	/** True while background work is held back, i.e. playing in the editor or after a slow frame. */
+	bool bPaused = false;
+};
+
+/**
+ * Runs the plugin background work (indexing, link and staleness checks, image encoding, ...) on worker threads
+ * without competing with the editor.
+ *
+ * Tasks are queued by priority and started from the game thread tick. Interactive tasks start at once; the others
+ * wait while an interactive task runs, while playing in the editor, and for a moment after a slow frame, and only a
+ * few of them run at a time. Queue depth and throughput are published under "stat Markdown".
+ */
+class FMarkdownTaskScheduler : public TSharedFromThis<FMarkdownTaskScheduler, ESPMode::ThreadSafe>
+{
+public:
+
+	void Initialize();
+	void Shutdown();
+
+	/** Queues work for a worker thread. The returned task can be cancelled. */
+	TSharedRef<FMarkdownTask, ESPMode::ThreadSafe> Launch(FName Name, EMarkdownTaskPriority Priority, FMarkdownTaskWork Work);
+
+	/** Cancels the queued and running tasks with the name, e.g. before queuing a newer pass of the same work. */
+	void Cancel(FName Name);
+
+	FMarkdownTaskSchedulerStats GetStats() const;
+
+private:
+
+	using FTaskRef = TSharedRef<FMarkdownTask, ESPMode::ThreadSafe>;
+
+	bool Tick(float DeltaTime);
+	void Dispatch();
+	void Start(const FTaskRef& Task);
+	void Finish(const FTaskRef& Task, TUniqueFunction<void()>&& Continuation);
+
+	bool IsPaused() const;
+
+	TArray<FTaskRef> Queues[int32(EMarkdownTaskPriority::Num)];
+	TArray<FTaskRef> Running;
+
+	double ThrottledUntil = 0.0;
+
+	int32 NumCompleted = 0;
+	int32 NumCancelled = 0;
+
+	double WindowStart = 0.0;
+	int32 WindowCompleted = 0;
+	float TasksPerSecond = 0.0f;
+
+	FTSTicker::FDelegateHandle TickerHandle;
+};
@@ -0,0 +1,532 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Scripting/MarkdownAssetLibrary.h"
+
+#include "Async/ParallelFor.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetToolsModule.h"
+#include "Duplicates/MarkdownDuplicateFinder.h"
+#include "Engine/StreamableManager.h"
+#include "FindReplace/MarkdownFindReplace.h"
+#include "HelperFunctions/MarkdownAssetEditorStatics.h"
+#include "Internationalization/Culture.h"
+#include "Internationalization/Internationalization.h"
+#include "Links/MarkdownLinkIndex.h"
+#include "LogChannels/MarkdownLogChannels.h"
+#include "MarkdownAsset.h"
+#include "MarkdownAssetFactoryNew.h"
+#include "MarkdownRender.h"
+#include "MarkdownScanner.h"
+#include "MarkdownSyntaxTree.h"
+#include "MarkdownTranslation.h"
+#include "Misc/PackageName.h"
+#include "ScopedTransaction.h"
+
+#include <atomic>
+
+#define LOCTEXT_NAMESPACE "MarkdownAssetLibrary"
+
+TArray<UMarkdownAsset*> UMarkdownAssetLibrary::LoadDocuments(const TArray<FSoftObjectPath>& Documents)
+{
+	TArray<FSoftObjectPath> ToLoad;
+	for (const FSoftObjectPath& Document : Documents)
+	{
+		if (Document.IsValid() && !Document.ResolveObject())
+		{
+			ToLoad.AddUnique(Document);
+		}
+	}
+
+	// one request lets the async loader stream the packages in together instead of one blocking load each
+	FStreamableManager StreamableManager;
+	TSharedPtr<FStreamableHandle> Handle;
+	if (!ToLoad.IsEmpty())
+	{
+		Handle = StreamableManager.RequestSyncLoad(ToLoad);
+	}
+
+	TArray<UMarkdownAsset*> Loaded;
+	Loaded.Reserve(Documents.Num());
+
+	for (const FSoftObjectPath& Document : Documents)
+	{
+		Loaded.Add(Cast<UMarkdownAsset>(Document.ResolveObject()));
+	}
+
+	return Loaded;
+}
+
+FString UMarkdownAssetLibrary::GetTranslationCulture(const FString& Culture)
+{
+	// the canonical name is what UMarkdownAsset::FindTranslation looks up at runtime
+	const FCulturePtr Found = FInternationalization::Get().GetCulture(Culture);
+	return Found.IsValid() ? Found->GetName() : Culture;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+TArray<FSoftObjectPath> UMarkdownAssetLibrary::FindMarkdownAssets(const FString& PackagePath, bool bRecursive)
+{
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+
+	FARFilter Filter;
+	Filter.ClassPaths.Add(UMarkdownAsset::StaticClass()->GetClassPathName());
+	Filter.bRecursiveClasses = true;
+	Filter.PackagePaths.Add(FName(*PackagePath));
+	Filter.bRecursivePaths = bRecursive;
+
+	TArray<FAssetData> Assets;
+	AssetRegistry.GetAssets(Filter, Assets);
+
+	TArray<FSoftObjectPath> Documents;
+	Documents.Reserve(Assets.Num());
+
+	for (const FAssetData& Asset : Assets)
+	{
+		Documents.Add(Asset.GetSoftObjectPath());
+	}
+
+	return Documents;
+}
+
+TArray<FString> UMarkdownAssetLibrary::GetMarkdownTexts(const TArray<FSoftObjectPath>& Documents)
+{
+	TArray<FString> Texts;
+	Texts.Reserve(Documents.Num());
+
+	for (const UMarkdownAsset* Document : LoadDocuments(Documents))
+	{
+		Texts.Add(Document ? Document->Text.ToString() : FString());
+	}
+
+	return Texts;
+}
+
+int32 UMarkdownAssetLibrary::SetMarkdownTexts(const TArray<FSoftObjectPath>& Documents, const TArray<FString>& Texts)
+{
+	if (Documents.Num() != Texts.Num())
+	{
+		UE_LOG(MarkdownStaticsLog, Error, TEXT("SetMarkdownTexts: got %d documents but %d texts."), Documents.Num(), Texts.Num());
+		return 0;
+	}
+
+	const TArray<UMarkdownAsset*> Loaded = LoadDocuments(Documents);
+
+	FScopedTransaction Transaction(LOCTEXT("SetMarkdownTextsTransaction", "Set Markdown Texts"));
+
+	int32 NumChanged = 0;
+	for (int32 Index = 0; Index < Loaded.Num(); ++Index)
+	{
+		if (Loaded[Index] && !Loaded[Index]->Text.ToString().Equals(Texts[Index], ESearchCase::CaseSensitive))
+		{
+			MarkdownAssetStatics::ApplyDocumentText(Loaded[Index], Texts[Index]);
+			++NumChanged;
+		}
+	}
+
+	return NumChanged;
+}
+
+TArray<FString> UMarkdownAssetLibrary::RenderMarkdownAssets(const TArray<FSoftObjectPath>& Documents, EMarkdownRenderFormat Format)
+{
+	TArray<FString> Texts = GetMarkdownTexts(Documents);
+
+	ParallelFor(Texts.Num(), [&Texts, Format](int32 Index)
+	{
+		if (Texts[Index].IsEmpty())
+		{
+			return;
+		}
+
+		const FMarkdownSyntaxTree Tree = FMarkdownSyntaxTree::Parse(MoveTemp(Texts[Index]));
+
+		switch (Format)
+		{
+			case EMarkdownRenderFormat::Html: Texts[Index] = MarkdownRender::ToHtml(Tree); break;
+			case EMarkdownRenderFormat::PlainText: Texts[Index] = MarkdownRender::ToPlainText(Tree); break;
+			case EMarkdownRenderFormat::RichText: Texts[Index] = MarkdownRender::ToRichText(Tree); break;
+			case EMarkdownRenderFormat::Json: Texts[Index] = MarkdownRender::ToJson(Tree); break;
+		}
+	});
+
+	return Texts;
+}
+
+TArray<FMarkdownHeadingInfo> UMarkdownAssetLibrary::GetMarkdownHeadings(const TArray<FSoftObjectPath>& Documents)
+{
+	const TArray<FString> Texts = GetMarkdownTexts(Documents);
+
+	TArray<TArray<FMarkdownHeadingInfo>> PerDocument;
+	PerDocument.SetNum(Texts.Num());
+
+	ParallelFor(Texts.Num(), [&](int32 Index)
+	{
+		const FMarkdownSyntaxTree Tree = FMarkdownSyntaxTree::Parse(Texts[Index]);
+		FMarkdownHeadingAnchors Anchors;
+
+		for (const FMarkdownNode& Node : Tree.GetNodes())
+		{
+			if (Node.Type != EMarkdownNodeType::Heading)
+			{
+				continue;
+			}
+
+			FMarkdownHeadingInfo& Info = PerDocument[Index].AddDefaulted_GetRef();
+			Info.Document = Documents[Index];
+			Info.Level = Node.Level;
+			Info.Title = FString(Tree.GetArg(Node));
+			Info.Anchor = Anchors.Add(Tree.GetInlineText(Node));
+			Info.Line = Node.Line;
+		}
+	});
+
+	TArray<FMarkdownHeadingInfo> Result;
+	for (TArray<FMarkdownHeadingInfo>& Headings : PerDocument)
+	{
+		Result.Append(MoveTemp(Headings));
+	}
+
+	return Result;
+}
+
+TArray<FMarkdownLinkInfo> UMarkdownAssetLibrary::GetMarkdownLinks(const TArray<FSoftObjectPath>& Documents)
+{
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+
+	FARFilter Filter;
+	Filter.SoftObjectPaths = Documents;
+
+	TArray<FAssetData> Assets;
+	AssetRegistry.GetAssets(Filter, Assets);
+
+	TArray<FMarkdownLinkInfo> Result;
+
+	for (const FAssetData& Asset : Assets)
+	{
+		TArray<FString> Targets;
+
+		// loaded documents may have unsaved edits, their text is newer than the registry tag
+		if (const UMarkdownAsset* Loaded = Cast<UMarkdownAsset>(Asset.FastGetAsset(false)))
+		{
+			MarkdownScanner::ExtractAssetLinks(Loaded->Text.ToString(), Targets);
+		}
+		else
+		{
+			FString TagValue;
+			if (Asset.GetTagValue(UMarkdownAsset::LinksTagName, TagValue))
+			{
+				TagValue.ParseIntoArray(Targets, TEXT(","));
+			}
+		}
+
+		for (FString& Target : Targets)
+		{
+			FMarkdownLinkInfo& Info = Result.AddDefaulted_GetRef();
+			Info.Document = Asset.GetSoftObjectPath();
+			Info.Target = MoveTemp(Target);
+		}
+	}
+
+	return Result;
+}
+
+TArray<FSoftObjectPath> UMarkdownAssetLibrary::GetDocumentsLinkingTo(const FSoftObjectPath& Asset)
+{
+	TArray<FSoftObjectPath> Documents;
+	FMarkdownAssetEditorModule::Get().GetLinkIndex().GetReferencingDocuments(Asset, Documents);
+	return Documents;
+}
+
+TArray<FMarkdownSearchMatch> UMarkdownAssetLibrary::SearchMarkdownAssets(const FString& Pattern, bool bRegex, bool bMatchCase)
+{
+	FMarkdownSearchQuery Query;
+	Query.Pattern = Pattern;
+	Query.bRegex = bRegex;
+	Query.bMatchCase = bMatchCase;
+
+	TArray<FMarkdownSearchResult> Results;
+	MarkdownFindReplace::Search(Query, Results);
+
+	TArray<FMarkdownSearchMatch> Matches;
+
+	for (FMarkdownSearchResult& Result : Results)
+	{
+		for (FMarkdownSearchHit& Hit : Result.Hits)
+		{
+			FMarkdownSearchMatch& Match = Matches.AddDefaulted_GetRef();
+			Match.Document = Result.Document;
+			Match.Line = Hit.Line;
+			Match.Offset = Hit.Start;
+			Match.Length = Hit.Len;
+			Match.Context = MoveTemp(Hit.Context);
+		}
+	}
+
+	return Matches;
+}
+
+TArray<FMarkdownDuplicateInfo> UMarkdownAssetLibrary::FindNearDuplicateMarkdownAssets(const FString& PackagePath, float MinSimilarity)
+{
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+
+	FARFilter Filter;
+	Filter.ClassPaths.Add(UMarkdownAsset::StaticClass()->GetClassPathName());
+	Filter.bRecursiveClasses = true;
+	Filter.PackagePaths.Add(FName(*PackagePath));
+	Filter.bRecursivePaths = true;
+
+	TArray<FAssetData> Assets;
+	AssetRegistry.GetAssets(Filter, Assets);
+
+	FMarkdownDuplicateFinder Finder;
+	const TArray<FMarkdownDuplicatePair> Pairs = Finder.Find(Assets, MinSimilarity);
+
+	TArray<FMarkdownDuplicateInfo> Duplicates;
+	Duplicates.Reserve(Pairs.Num());
+
+	for (const FMarkdownDuplicatePair& Pair : Pairs)
+	{
+		FMarkdownDuplicateInfo& Info = Duplicates.AddDefaulted_GetRef();
+		Info.DocumentA = Pair.A;
+		Info.DocumentB = Pair.B;
+		Info.Similarity = Pair.Similarity;
+	}
+
+	return Duplicates;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+TArray<UMarkdownAsset*> UMarkdownAssetLibrary::CreateMarkdownAssets(const FString& PackagePath, const TArray<FString>& Names, const TArray<FString>& Texts)
+{
+	TArray<UMarkdownAsset*> Created;
+
+	if (Names.Num() != Texts.Num())
+	{
+		UE_LOG(MarkdownStaticsLog, Error, TEXT("CreateMarkdownAssets: got %d names but %d texts."), Names.Num(), Texts.Num());
+		return Created;
+	}
+
+	IAssetTools& AssetTools = FModuleManager::LoadModuleChecked<FAssetToolsModule>("AssetTools").Get();
+	UMarkdownAssetFactoryNew* Factory = NewObject<UMarkdownAssetFactoryNew>();
+
+	Created.Reserve(Names.Num());
+
+	for (int32 Index = 0; Index < Names.Num(); ++Index)
+	{
+		Factory->Content = FText::FromString(Texts[Index]);
+
+		UMarkdownAsset* Document = Cast<UMarkdownAsset>(AssetTools.CreateAsset(Names[Index], PackagePath, UMarkdownAsset::StaticClass(), Factory));
+		if (!Document)
+		{
+			UE_LOG(MarkdownStaticsLog, Warning, TEXT("CreateMarkdownAssets: failed to create '%s' in '%s'."), *Names[Index], *PackagePath);
+		}
+
+		Created.Add(Document);
+	}
+
+	return Created;
+}
+
+int32 UMarkdownAssetLibrary::ExportMarkdownAssets(const TArray<FSoftObjectPath>& Documents, const FString& Directory)
+{
+	const TArray<FString> Texts = GetMarkdownTexts(Documents);
+
+	// files are laid out like the content folders below the deepest folder all documents share, so documents with the
+	// same name in different folders do not overwrite each other
+	FString Root;
+
+	for (const FSoftObjectPath& Document : Documents)
+	{
+		if (!Document.IsValid())
+		{
+			continue;
+		}
+
+		const FString Folder = FPackageName::GetLongPackagePath(Document.GetLongPackageName()) + TEXT("/");
+
+		if (Root.IsEmpty())
+		{
+			Root = Folder;
+			continue;
+		}
+
+		while (!Folder.StartsWith(Root))
+		{
+			int32 Slash = INDEX_NONE;
+			Root.LeftChopInline(1);
+			Root.FindLastChar(TEXT('/'), Slash);
+			Root.LeftInline(Slash + 1);
+		}
+	}
+
+	TArray<FString> FilePaths;
+	FilePaths.SetNum(Documents.Num());
+
+	TSet<FString> Claimed;
+	TSet<FString> Directories;
+	Directories.Add(Directory);
+
+	for (int32 Index = 0; Index < Documents.Num(); ++Index)
+	{
+		if (!Documents[Index].IsValid() || Texts[Index].IsEmpty())
+		{
+			continue;
+		}
+
+		const FString FilePath = Directory / Documents[Index].GetLongPackageName().RightChop(Root.Len()) + TEXT(".md");
+
+		bool bAlreadyClaimed = false;
+		Claimed.Add(FilePath, &bAlreadyClaimed);
+
+		if (bAlreadyClaimed)
+		{
+			UE_LOG(MarkdownStaticsLog, Warning, TEXT("ExportMarkdownAssets: '%s' was not exported, another document is already written to '%s'."), *Documents[Index].ToString(), *FilePath);
+			continue;
+		}
+
+		FilePaths[Index] = FilePath;
+		Directories.Add(FPaths::GetPath(FilePath));
+	}
+
+	for (const FString& Folder : Directories)
+	{
+		if (!IFileManager::Get().MakeDirectory(*Folder, true))
+		{
+			UE_LOG(MarkdownStaticsLog, Error, TEXT("ExportMarkdownAssets: could not create directory '%s'."), *Folder);
+			return 0;
+		}
+	}
+
+	std::atomic<int32> NumWritten = 0;
+
+	ParallelFor(Documents.Num(), [&](int32 Index)
+	{
+		if (!FilePaths[Index].IsEmpty() && FMarkdownAssetEditorModule::WriteTextToFile(FilePaths[Index], FText::FromString(Texts[Index])))
+		{
+			++NumWritten;
+		}
+	});
+
+	return NumWritten;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+TArray<UMarkdownTranslation*> UMarkdownAssetLibrary::CreateMarkdownTranslations(const TArray<FSoftObjectPath>& Documents, const FString& InCulture)
+{
+	TArray<UMarkdownTranslation*> Translations;
+
+	const FString Culture = GetTranslationCulture(InCulture);
+	if (Culture.IsEmpty())
+	{
+		UE_LOG(MarkdownStaticsLog, Error, TEXT("CreateMarkdownTranslations: no culture given."));
+		return Translations;
+	}
+
+	const TArray<UMarkdownAsset*> Loaded = LoadDocuments(Documents);
+	Translations.Reserve(Loaded.Num());
+
+	for (UMarkdownAsset* Document : Loaded)
+	{
+		if (!Document)
+		{
+			Translations.Add(nullptr);
+			continue;
+		}
+
+		if (const TSoftObjectPtr<UMarkdownTranslation>* Existing = Document->Translations.Find(Culture))
+		{
+			if (UMarkdownTranslation* Translation = Existing->LoadSynchronous())
+			{
+				Translations.Add(Translation);
+				continue;
+			}
+		}
+
+		const FString PackageName = FPackageName::GetLongPackagePath(Document->GetPackage()->GetName()) / Document->GetName() + TEXT("_") + Culture.Replace(TEXT("-"), TEXT("_"));
+
+		UPackage* Package = CreatePackage(*PackageName);
+		UMarkdownTranslation* Translation = NewObject<UMarkdownTranslation>(Package, *FPackageName::GetShortName(PackageName), RF_Public | RF_Standalone | RF_Transactional);
+		Translation->Source = Document;
+		Translation->Culture = Culture;
+
+		FAssetRegistryModule::AssetCreated(Translation);
+		Translation->MarkPackageDirty();
+
+		Document->Modify();
+		Document->Translations.Add(Culture, Translation);
+
+		Translations.Add(Translation);
+	}
+
+	return Translations;
+}
+
+TArray<FString> UMarkdownAssetLibrary::GetUntranslatedMarkdownBlocks(const FSoftObjectPath& Document, const FString& Culture)
+{
+	TArray<FString> Untranslated;
+
+	const UMarkdownAsset* Source = LoadDocuments({ Document })[0];
+	if (!Source)
+	{
+		return Untranslated;
+	}
+
+	const FString Text = Source->Text.ToString();
+
+	// the exact culture, the parent culture fallback of FindTranslation would list the blocks of a translation
+	// that SetMarkdownTranslatedBlocks does not write to
+	const TSoftObjectPtr<UMarkdownTranslation>* Existing = Source->Translations.Find(GetTranslationCulture(Culture));
+
+	TArray<FMarkdownTranslationBlock> Blocks;
+	if (const UMarkdownTranslation* Translation = Existing ? Existing->LoadSynchronous() : nullptr)
+	{
+		Translation->GetUntranslatedBlocks(Text, Blocks);
+	}
+	else
+	{
+		UMarkdownTranslation::SplitBlocks(Text, Blocks);
+	}
+
+	Untranslated.Reserve(Blocks.Num());
+
+	for (const FMarkdownTranslationBlock& Block : Blocks)
+	{
+		Untranslated.Emplace(Text.Mid(Block.Start, Block.Len));
+	}
+
+	return Untranslated;
+}
+
+int32 UMarkdownAssetLibrary::SetMarkdownTranslatedBlocks(const FSoftObjectPath& Document, const FString& Culture, const TArray<FString>& SourceBlocks, const TArray<FString>& Translations)
+{
+	if (SourceBlocks.Num() != Translations.Num())
+	{
+		UE_LOG(MarkdownStaticsLog, Error, TEXT("SetMarkdownTranslatedBlocks: got %d source blocks but %d translations."), SourceBlocks.Num(), Translations.Num());
+		return 0;
+	}
+
+	UMarkdownTranslation* Translation = CreateMarkdownTranslations({ Document }, Culture)[0];
+	if (!Translation)
+	{
+		return 0;
+	}
+
+	const FScopedTransaction Transaction(LOCTEXT("SetTranslatedBlocks", "Set Markdown Translation"));
+	Translation->Modify();
+
+	for (int32 Index = 0; Index < SourceBlocks.Num(); ++Index)
+	{
+		Translation->SetBlock(SourceBlocks[Index], Translations[Index]);
+	}
+
+	if (const UMarkdownAsset* Source = Translation->Source.Get())
+	{
+		Translation->RemoveUnusedBlocks(Source->Text.ToString());
+	}
+
+	return SourceBlocks.Num();
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,190 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "UObject/SoftObjectPath.h"
+#include "MarkdownAssetLibrary.generated.h"
+
+class UMarkdownAsset;
+class UMarkdownTranslation;
+
+/** Output formats of RenderMarkdownAssets, see MarkdownRender. */
+UENUM(BlueprintType)
+enum class EMarkdownRenderFormat : uint8
+{
+	Html,
+	PlainText,
+
+	/** SRichTextBlock markup. */
+	RichText,
+
+	/** The syntax tree. */
+	Json,
+};
+
+USTRUCT(BlueprintType)
+struct FMarkdownHeadingInfo
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Markdown")
+	FSoftObjectPath Document;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Markdown")
+	int32 Level = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Markdown")
+	FString Title;
+
+	/** The anchor the viewer generates for this heading, usable in "#anchor" links. */
+	UPROPERTY(BlueprintReadOnly, Category = "Markdown")
+	FString Anchor;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Markdown")
+	int32 Line = 0;
+};
+
+USTRUCT(BlueprintType)
+struct FMarkdownLinkInfo
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Markdown")
+	FSoftObjectPath Document;
+
+	/** The linked object path, as written in the document. */
+	UPROPERTY(BlueprintReadOnly, Category = "Markdown")
+	FString Target;
+};
+
+USTRUCT(BlueprintType)
+struct FMarkdownSearchMatch
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Markdown")
+	FSoftObjectPath Document;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Markdown")
+	int32 Line = 0;
+
+	/** Character offset of the match in the document text. */
+	UPROPERTY(BlueprintReadOnly, Category = "Markdown")
+	int32 Offset = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Markdown")
+	int32 Length = 0;
+
+	/** The line containing the match. */
+	UPROPERTY(BlueprintReadOnly, Category = "Markdown")
+	FString Context;
+};
+
+USTRUCT(BlueprintType)
+struct FMarkdownDuplicateInfo
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Markdown")
+	FSoftObjectPath DocumentA;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Markdown")
+	FSoftObjectPath DocumentB;
+
+	/** Estimated fraction of shared text, 0 to 1. */
+	UPROPERTY(BlueprintReadOnly, Category = "Markdown")
+	float Similarity = 0.0f;
+};
+
+/**
+ * Batch operations over markdown assets for editor scripting (Python and Editor Utility Blueprints).
+ *
+ * Every function takes the full set of documents at once: registry queries are made once per call, unloaded
+ * documents are streamed in together and text processing runs in parallel, rather than one round trip per asset.
+ */
+UCLASS()
+class MARKDOWNASSETEDITOR_API UMarkdownAssetLibrary : public UBlueprintFunctionLibrary
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Returns every markdown asset under a content path, using a single asset registry query. */
+	UFUNCTION(BlueprintCallable, Category = "Markdown|Query")
+	static TArray<FSoftObjectPath> FindMarkdownAssets(const FString& PackagePath = TEXT("/Game"), bool bRecursive = true);
+
+	/** Returns the text of each document, in the same order. Missing documents return an empty string. */
+	UFUNCTION(BlueprintCallable, Category = "Markdown|Text")
+	static TArray<FString> GetMarkdownTexts(const TArray<FSoftObjectPath>& Documents);
+
+	/** Sets the text of each document in one undoable transaction. Returns the number of documents changed. */
+	UFUNCTION(BlueprintCallable, Category = "Markdown|Text")
+	static int32 SetMarkdownTexts(const TArray<FSoftObjectPath>& Documents, const TArray<FString>& Texts);
+
+	/** Renders each document to the format, in the same order. Missing documents return an empty string. */
+	UFUNCTION(BlueprintCallable, Category = "Markdown|Text")
+	static TArray<FString> RenderMarkdownAssets(const TArray<FSoftObjectPath>& Documents, EMarkdownRenderFormat Format = EMarkdownRenderFormat::Html);
+
+	/** Returns the headings of every document. */
+	UFUNCTION(BlueprintCallable, Category = "Markdown|Query")
+	static TArray<FMarkdownHeadingInfo> GetMarkdownHeadings(const TArray<FSoftObjectPath>& Documents);
+
+	/** Returns the asset links of every document, read from the asset registry without loading the documents. */
+	UFUNCTION(BlueprintCallable, Category = "Markdown|Query")
+	static TArray<FMarkdownLinkInfo> GetMarkdownLinks(const TArray<FSoftObjectPath>& Documents);
+
+	/** Returns the documents linking to the given asset. */
+	UFUNCTION(BlueprintCallable, Category = "Markdown|Query")
+	static TArray<FSoftObjectPath> GetDocumentsLinkingTo(const FSoftObjectPath& Asset);
+
+	/** Searches the text of all markdown documents in the project. */
+	UFUNCTION(BlueprintCallable, Category = "Markdown|Query")
+	static TArray<FMarkdownSearchMatch> SearchMarkdownAssets(const FString& Pattern, bool bRegex = false, bool bMatchCase = false);
+
+	/** Returns the pairs of documents under a content path that are at least MinSimilarity alike, most similar first. */
+	UFUNCTION(BlueprintCallable, Category = "Markdown|Query")
+	static TArray<FMarkdownDuplicateInfo> FindNearDuplicateMarkdownAssets(const FString& PackagePath = TEXT("/Game"), float MinSimilarity = 0.7f);
+
+	/** Creates one markdown asset per name in the given content folder. Names and Texts must have the same length. */
+	UFUNCTION(BlueprintCallable, Category = "Markdown|Assets")
+	static TArray<UMarkdownAsset*> CreateMarkdownAssets(const FString& PackagePath, const TArray<FString>& Names, const TArray<FString>& Texts);
+
+	/**
+	 * Writes each document to "<Directory>/<Path>/<AssetName>.md", where Path is its content folder below the deepest
+	 * folder all the documents share. Documents listed twice are written once. Returns the number of files written.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Markdown|Assets")
+	static int32 ExportMarkdownAssets(const TArray<FSoftObjectPath>& Documents, const FString& Directory);
+
+	/**
+	 * Returns the translation of each document into the culture, creating it as "<Document>_<Culture>" next to the
+	 * document and adding it to the document translations when there is none.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Markdown|Localization")
+	static TArray<UMarkdownTranslation*> CreateMarkdownTranslations(const TArray<FSoftObjectPath>& Documents, const FString& Culture);
+
+	/**
+	 * Returns the blocks of the document that need translating into the culture, i.e. new or edited since they were
+	 * translated. Only a translation into this exact culture counts, not one into its parent culture, as that is the
+	 * translation SetMarkdownTranslatedBlocks stores into.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Markdown|Localization")
+	static TArray<FString> GetUntranslatedMarkdownBlocks(const FSoftObjectPath& Document, const FString& Culture);
+
+	/**
+	 * Stores the translations of source blocks, as returned by GetUntranslatedMarkdownBlocks, and drops the
+	 * translations of blocks no longer in the document. Returns the number of blocks stored.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Markdown|Localization")
+	static int32 SetMarkdownTranslatedBlocks(const FSoftObjectPath& Document, const FString& Culture, const TArray<FString>& SourceBlocks, const TArray<FString>& Translations);
+
+private:
+
+	/** Loads all documents in one streaming request, keeping the input order. */
+	static TArray<UMarkdownAsset*> LoadDocuments(const TArray<FSoftObjectPath>& Documents);
+
+	/** The name translations are stored under for the culture, e.g. "pt-BR" for "pt_br". */
+	static FString GetTranslationCulture(const FString& Culture);
+};
@@ -0,0 +1,84 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Search/MarkdownAssetIndexer.h"
+
+#include "MarkdownAsset.h"
+#include "MarkdownScanner.h"
+#include "MarkdownSyntaxTree.h"
+#include "SearchSerializer.h"
+
+enum class EMarkdownAssetIndexerVersion
+{
+	Empty,
+	Initial,
+	UnderlinedHeadings,
+
+	// -----<new versions can be added above this line>-------------------------------------------------
+	VersionPlusOne,
+	LatestVersion = VersionPlusOne - 1
+};
+
+int32 FMarkdownAssetIndexer::GetVersion() const
+{
+	return static_cast<int32>(EMarkdownAssetIndexerVersion::LatestVersion);
+}
+
+void FMarkdownAssetIndexer::IndexAsset(const UObject* InAssetObject, FSearchSerializer& Serializer) const
+{
+	const UMarkdownAsset* Document = Cast<UMarkdownAsset>(InAssetObject);
+	if (!Document)
+	{
+		return;
+	}
+
+	const FMarkdownSyntaxTree Tree = FMarkdownSyntaxTree::Parse(Document->Text.ToString());
+	const FString& Text = Tree.GetText();
+
+	TArray<FString> Links;
+	MarkdownScanner::ExtractAssetLinks(Text, Links);
+
+	Serializer.BeginIndexingObject(Document, TEXT("$self"));
+
+	if (const UMarkdownLinkAsset* LinkAsset = Cast<UMarkdownLinkAsset>(Document))
+	{
+		Serializer.IndexProperty(TEXT("URL"), LinkAsset->URL);
+	}
+
+	// one entry per section, so a match tells which part of the document it is in
+	int32 SectionStart = 0;
+	FString SectionName = TEXT("Text");
+
+	auto IndexSection = [&](int32 SectionEnd)
+	{
+		const FString Section = FString(FStringView(Text).Mid(SectionStart, SectionEnd - SectionStart).TrimStartAndEnd());
+		if (!Section.IsEmpty())
+		{
+			Serializer.IndexProperty(SectionName, Section);
+		}
+	};
+
+	for (const FMarkdownNode& Heading : Tree.GetNodes())
+	{
+		if (Heading.Type != EMarkdownNodeType::Heading)
+		{
+			continue;
+		}
+
+		IndexSection(Heading.Start);
+
+		SectionName = Tree.GetInlineText(Heading);
+		Serializer.IndexProperty(TEXT("Heading"), SectionName);
+
+		// the span covers the underline of underlined headings too
+		SectionStart = Heading.Start + Heading.Len;
+	}
+
+	IndexSection(Text.Len());
+
+	for (const FString& Link : Links)
+	{
+		Serializer.IndexProperty(TEXT("Link"), Link);
+	}
+
+	Serializer.EndIndexingObject();
+}
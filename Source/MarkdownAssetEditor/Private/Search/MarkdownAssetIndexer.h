@@ -0,0 +1,22 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "IAssetIndexer.h"
+
+/**
+ * Feeds markdown documents to the engine Asset Search index, so the Search tab finds text inside documents.
+ *
+ * Each section is indexed under its heading, along with the headings themselves and the link targets. The asset
+ * search manager only re-indexes an asset when its saved content or the indexer version changes, so bump the
+ * version whenever the indexed fields change.
+ */
+class FMarkdownAssetIndexer : public IAssetIndexer
+{
+public:
+
+	virtual FString GetName() const override { return TEXT("MarkdownAsset"); }
+	virtual int32 GetVersion() const override;
+	virtual void IndexAsset(const UObject* InAssetObject, FSearchSerializer& Serializer) const override;
+};
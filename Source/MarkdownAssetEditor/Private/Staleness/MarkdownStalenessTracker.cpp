@@ -0,0 +1,593 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Staleness/MarkdownStalenessTracker.h"
+
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "ContentBrowserDelegates.h"
+#include "ContentBrowserModule.h"
+#include "Engine/Blueprint.h"
+#include "IO/IoHash.h"
+#include "Links/MarkdownLinkIndex.h"
+#include "LogChannels/MarkdownLogChannels.h"
+#include "Logging/MessageLog.h"
+#include "Logging/TokenizedMessage.h"
+#include "MarkdownAsset.h"
+#include "MarkdownAssetEditorModule.h"
+#include "Scheduling/MarkdownTaskScheduler.h"
+#include "Styling/AppStyle.h"
+#include "Styling/StyleColors.h"
+#include "UObject/ObjectSaveContext.h"
+#include "UObject/UnrealType.h"
+#include "Widgets/Images/SImage.h"
+#include "Widgets/Text/STextBlock.h"
+
+#define LOCTEXT_NAMESPACE "FMarkdownStalenessTracker"
+
+const FName FMarkdownStalenessTracker::SignatureTagName(TEXT("MarkdownSignature"));
+
+namespace MarkdownStalenessTracker
+{
+	/** Registry updates tend to arrive in bursts (saves, source control syncs), wait for them to settle. */
+	static constexpr float CheckDelaySeconds = 1.0f;
+
+	static IAssetRegistry* GetAssetRegistry()
+	{
+		FAssetRegistryModule* AssetRegistryModule = FModuleManager::GetModulePtr<FAssetRegistryModule>("AssetRegistry");
+		return AssetRegistryModule ? &AssetRegistryModule->Get() : nullptr;
+	}
+
+	static bool IsMarkdownAsset(const FAssetData& AssetData)
+	{
+		return AssetData.IsInstanceOf(UMarkdownAsset::StaticClass());
+	}
+
+	/** Hashes the names and types of the functions and properties a Blueprint adds to its parent class. */
+	static FString MakeBlueprintSignature(const UBlueprint* Blueprint)
+	{
+		const UClass* Class = Blueprint->GeneratedClass;
+		if (!Class)
+		{
+			return FString();
+		}
+
+		uint32 Hash = 0;
+
+		for (TFieldIterator<FProperty> It(Class, EFieldIteratorFlags::ExcludeSuper); It; ++It)
+		{
+			Hash = FCrc::StrCrc32(*It->GetName(), Hash);
+			Hash = FCrc::StrCrc32(*It->GetCPPType(), Hash);
+		}
+
+		for (TFieldIterator<UFunction> It(Class, EFieldIteratorFlags::ExcludeSuper); It; ++It)
+		{
+			Hash = FCrc::StrCrc32(*It->GetName(), Hash);
+
+			// parameters come first in a function's property chain, the locals that follow change with the graph
+			for (TFieldIterator<FProperty> Param(*It); Param && Param->HasAnyPropertyFlags(CPF_Parm); ++Param)
+			{
+				Hash = FCrc::StrCrc32(*Param->GetName(), Hash);
+				Hash = FCrc::StrCrc32(*Param->GetCPPType(), Hash);
+			}
+		}
+
+		return FString::Printf(TEXT("%08x"), Hash);
+	}
+
+	/**
+	 * Returns "<package saved hash>[:<signature>]" for the asset as it is on disk. Only reads registry data, so it is
+	 * safe to call from the background pass.
+	 */
+	static bool GetAssetFingerprint(IAssetRegistry& AssetRegistry, const FSoftObjectPath& Target, FString& OutFingerprint)
+	{
+		FAssetData AssetData = AssetRegistry.GetAssetByObjectPath(Target, true);
+
+		if (AssetData.IsValid() && AssetData.IsRedirector())
+		{
+			AssetData = AssetRegistry.GetAssetByObjectPath(AssetRegistry.GetRedirectedObjectPath(Target), true);
+		}
+
+		if (!AssetData.IsValid())
+		{
+			return false;
+		}
+
+		const TOptional<FAssetPackageData> PackageData = AssetRegistry.GetAssetPackageDataCopy(AssetData.PackageName);
+		if (!PackageData.IsSet())
+		{
+			return false;
+		}
+
+		OutFingerprint = LexToString(PackageData->GetPackageSavedHash());
+
+		FString Signature;
+		if (AssetData.GetTagValue(FMarkdownStalenessTracker::SignatureTagName, Signature))
+		{
+			OutFingerprint.AppendChar(TEXT(':'));
+			OutFingerprint.Append(Signature);
+		}
+
+		return true;
+	}
+
+	static void CompareFingerprints(IAssetRegistry& AssetRegistry, const FAssetData& Document, TArray<FMarkdownStaleLink>& OutStaleLinks)
+	{
+		FString TagValue;
+		if (!Document.GetTagValue(UMarkdownAsset::FingerprintsTagName, TagValue))
+		{
+			return;
+		}
+
+		TArray<FString> Entries;
+		TagValue.ParseIntoArray(Entries, TEXT(","));
+
+		FString Current;
+
+		for (const FString& Entry : Entries)
+		{
+			FString Path;
+			FString Recorded;
+			if (!Entry.Split(TEXT("="), &Path, &Recorded, ESearchCase::CaseSensitive, ESearchDir::FromEnd))
+			{
+				continue;
+			}
+
+			const FSoftObjectPath Target(Path);
+
+			if (!GetAssetFingerprint(AssetRegistry, Target, Current))
+			{
+				OutStaleLinks.Add({ Target, EMarkdownStaleReason::Missing });
+				continue;
+			}
+
+			FString RecordedHash, RecordedSignature, CurrentHash, CurrentSignature;
+			if (!Recorded.Split(TEXT(":"), &RecordedHash, &RecordedSignature))
+			{
+				RecordedHash = Recorded;
+			}
+			if (!Current.Split(TEXT(":"), &CurrentHash, &CurrentSignature))
+			{
+				CurrentHash = Current;
+			}
+
+			if (RecordedHash == CurrentHash)
+			{
+				continue;
+			}
+
+			// a Blueprint saved with the same functions and properties still matches its documentation
+			if (!RecordedSignature.IsEmpty() && !CurrentSignature.IsEmpty())
+			{
+				if (RecordedSignature != CurrentSignature)
+				{
+					OutStaleLinks.Add({ Target, EMarkdownStaleReason::SignatureChanged });
+				}
+				continue;
+			}
+
+			OutStaleLinks.Add({ Target, EMarkdownStaleReason::Modified });
+		}
+	}
+
+	static FText DescribeStaleLink(const FMarkdownStaleLink& Link)
+	{
+		const FText Target = FText::FromString(Link.Target.GetAssetName());
+
+		switch (Link.Reason)
+		{
+		case EMarkdownStaleReason::SignatureChanged:
+			return FText::Format(LOCTEXT("SignatureChanged", "'{0}' changed its functions or properties"), Target);
+		case EMarkdownStaleReason::Missing:
+			return FText::Format(LOCTEXT("Missing", "'{0}' no longer exists"), Target);
+		default:
+			return FText::Format(LOCTEXT("Modified", "'{0}' was modified"), Target);
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void FMarkdownStalenessTracker::Initialize()
+{
+	IAssetRegistry* AssetRegistry = MarkdownStalenessTracker::GetAssetRegistry();
+	if (!AssetRegistry)
+	{
+		return;
+	}
+
+	AssetRegistry->OnAssetAdded().AddRaw(this, &FMarkdownStalenessTracker::HandleAssetChanged);
+	AssetRegistry->OnAssetRemoved().AddRaw(this, &FMarkdownStalenessTracker::HandleAssetChanged);
+	AssetRegistry->OnAssetUpdated().AddRaw(this, &FMarkdownStalenessTracker::HandleAssetChanged);
+	AssetRegistry->OnAssetUpdatedOnDisk().AddRaw(this, &FMarkdownStalenessTracker::HandleAssetChanged);
+	AssetRegistry->OnAssetRenamed().AddRaw(this, &FMarkdownStalenessTracker::HandleAssetRenamed);
+
+	FCoreUObjectDelegates::OnObjectPreSave.AddRaw(this, &FMarkdownStalenessTracker::HandleObjectPreSave);
+
+#if UE_VERSION_OLDER_THAN(5, 4, 0)
+	UObject::FAssetRegistryTag::OnGetExtraObjectTags.AddRaw(this, &FMarkdownStalenessTracker::HandleGetExtraObjectTags);
+#else
+	UObject::FAssetRegistryTag::OnGetExtraObjectTagsWithContext.AddRaw(this, &FMarkdownStalenessTracker::HandleGetExtraObjectTags);
+#endif
+
+	FContentBrowserModule& ContentBrowserModule = FModuleManager::LoadModuleChecked<FContentBrowserModule>("ContentBrowser");
+	ExtraStateGeneratorHandle = ContentBrowserModule.AddAssetViewExtraStateGenerator(FAssetViewExtraStateGenerator(
+		FOnGenerateAssetViewExtraStateIndicators::CreateRaw(this, &FMarkdownStalenessTracker::GenerateStateIcon),
+		FOnGenerateAssetViewExtraStateIndicators::CreateRaw(this, &FMarkdownStalenessTracker::GenerateStateTooltip)
+	));
+
+	if (AssetRegistry->IsLoadingAssets())
+	{
+		AssetRegistry->OnFilesLoaded().AddRaw(this, &FMarkdownStalenessTracker::HandleFilesLoaded);
+	}
+	else
+	{
+		HandleFilesLoaded();
+	}
+}
+
+void FMarkdownStalenessTracker::Shutdown()
+{
+	if (IAssetRegistry* AssetRegistry = MarkdownStalenessTracker::GetAssetRegistry())
+	{
+		AssetRegistry->OnAssetAdded().RemoveAll(this);
+		AssetRegistry->OnAssetRemoved().RemoveAll(this);
+		AssetRegistry->OnAssetUpdated().RemoveAll(this);
+		AssetRegistry->OnAssetUpdatedOnDisk().RemoveAll(this);
+		AssetRegistry->OnAssetRenamed().RemoveAll(this);
+		AssetRegistry->OnFilesLoaded().RemoveAll(this);
+	}
+
+	FCoreUObjectDelegates::OnObjectPreSave.RemoveAll(this);
+
+#if UE_VERSION_OLDER_THAN(5, 4, 0)
+	UObject::FAssetRegistryTag::OnGetExtraObjectTags.RemoveAll(this);
+#else
+	UObject::FAssetRegistryTag::OnGetExtraObjectTagsWithContext.RemoveAll(this);
+#endif
+
+	if (FContentBrowserModule* ContentBrowserModule = FModuleManager::GetModulePtr<FContentBrowserModule>("ContentBrowser"))
+	{
+		ContentBrowserModule->RemoveAssetViewExtraStateGenerator(ExtraStateGeneratorHandle);
+	}
+	ExtraStateGeneratorHandle.Reset();
+
+	FTSTicker::GetCoreTicker().RemoveTicker(CheckTickerHandle);
+	CheckTickerHandle.Reset();
+
+	PendingDocuments.Empty();
+	StaleDocuments.Empty();
+	bFilesLoaded = false;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+bool FMarkdownStalenessTracker::IsStale(const FSoftObjectPath& Document) const
+{
+	return StaleDocuments.Contains(Document);
+}
+
+const TArray<FMarkdownStaleLink>* FMarkdownStalenessTracker::FindStaleLinks(const FSoftObjectPath& Document) const
+{
+	return StaleDocuments.Find(Document);
+}
+
+void FMarkdownStalenessTracker::ReportStaleDocuments() const
+{
+	FMessageLog MessageLog(MarkdownMessageLog::LogName);
+	MessageLog.NewPage(LOCTEXT("StalenessReportPage", "Documentation Staleness"));
+
+	TArray<FSoftObjectPath> Documents;
+	StaleDocuments.GetKeys(Documents);
+	Documents.Sort([](const FSoftObjectPath& A, const FSoftObjectPath& B) { return A.LexicalLess(B); });
+
+	for (const FSoftObjectPath& Document : Documents)
+	{
+		for (const FMarkdownStaleLink& Link : StaleDocuments[Document])
+		{
+			MessageLog.Warning()
+				->AddToken(FAssetNameToken::Create(Document.ToString()))
+				->AddToken(FTextToken::Create(FText::Format(LOCTEXT("StaleLink", "is out of date: {0} since it was saved."), MarkdownStalenessTracker::DescribeStaleLink(Link))))
+				->AddToken(FAssetNameToken::Create(Link.Target.ToString()));
+		}
+	}
+
+	if (bCheckInFlight || !PendingDocuments.IsEmpty() || !bFilesLoaded)
+	{
+		MessageLog.Info(LOCTEXT("StalenessCheckRunning", "Some documents are still being checked, run the report again shortly for complete results."));
+	}
+	else if (Documents.IsEmpty())
+	{
+		MessageLog.Info(LOCTEXT("NoStaleDocuments", "All markdown documents are up to date with the assets they link to."));
+	}
+	else
+	{
+		MessageLog.Info(FText::Format(LOCTEXT("StaleDocumentsSummary", "{0} markdown document(s) are out of date. Review them and resave to mark them as up to date."), Documents.Num()));
+	}
+
+	MessageLog.Open(EMessageSeverity::Info, true);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void FMarkdownStalenessTracker::QueueAllDocuments()
+{
+	IAssetRegistry* AssetRegistry = MarkdownStalenessTracker::GetAssetRegistry();
+	if (!AssetRegistry)
+	{
+		return;
+	}
+
+	TArray<FAssetData> Documents;
+	AssetRegistry->GetAssetsByClass(UMarkdownAsset::StaticClass()->GetClassPathName(), Documents, true);
+
+	for (const FAssetData& Document : Documents)
+	{
+		if (Document.FindTag(UMarkdownAsset::FingerprintsTagName))
+		{
+			PendingDocuments.Add(Document.GetSoftObjectPath());
+		}
+	}
+
+	ScheduleCheck();
+}
+
+void FMarkdownStalenessTracker::QueueDocument(const FSoftObjectPath& Document)
+{
+	PendingDocuments.Add(Document);
+	ScheduleCheck();
+}
+
+void FMarkdownStalenessTracker::QueueReferencingDocuments(const FSoftObjectPath& Target)
+{
+	TArray<FSoftObjectPath> Documents;
+	FMarkdownAssetEditorModule::Get().GetLinkIndex().GetReferencingDocuments(Target, Documents);
+
+	if (!Documents.IsEmpty())
+	{
+		PendingDocuments.Append(Documents);
+		ScheduleCheck();
+	}
+}
+
+void FMarkdownStalenessTracker::ScheduleCheck()
+{
+	if (!CheckTickerHandle.IsValid() && !bCheckInFlight)
+	{
+		CheckTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FMarkdownStalenessTracker::StartCheck), MarkdownStalenessTracker::CheckDelaySeconds);
+	}
+}
+
+bool FMarkdownStalenessTracker::StartCheck(float DeltaTime)
+{
+	CheckTickerHandle.Reset();
+
+	IAssetRegistry* AssetRegistry = MarkdownStalenessTracker::GetAssetRegistry();
+	if (!AssetRegistry || PendingDocuments.IsEmpty())
+	{
+		return false;
+	}
+
+	bCheckInFlight = true;
+
+	TWeakPtr<FMarkdownStalenessTracker, ESPMode::ThreadSafe> WeakThis = AsShared();
+
+	FMarkdownAssetEditorModule::Get().GetTaskScheduler().Launch(TEXT("MarkdownStalenessCheck"), EMarkdownTaskPriority::Background,
+		[WeakThis, AssetRegistry, Documents = PendingDocuments.Array()](const FMarkdownTask& Task) -> TUniqueFunction<void()>
+	{
+		const double StartTime = FPlatformTime::Seconds();
+
+		TMap<FSoftObjectPath, TArray<FMarkdownStaleLink>> Results;
+		Results.Reserve(Documents.Num());
+
+		for (const FSoftObjectPath& Document : Documents)
+		{
+			if (Task.IsCancelled())
+			{
+				return nullptr;
+			}
+
+			TArray<FMarkdownStaleLink>& StaleLinks = Results.Add(Document);
+
+			const FAssetData DocumentData = AssetRegistry->GetAssetByObjectPath(Document, true);
+			if (DocumentData.IsValid())
+			{
+				MarkdownStalenessTracker::CompareFingerprints(*AssetRegistry, DocumentData, StaleLinks);
+			}
+		}
+
+		UE_LOG(MarkdownStaticsLog, Verbose, TEXT("Checked %d markdown documents for outdated links (%.2f ms)."),
+			Documents.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+
+		return [WeakThis, Results = MoveTemp(Results)]() mutable
+		{
+			if (TSharedPtr<FMarkdownStalenessTracker, ESPMode::ThreadSafe> This = WeakThis.Pin())
+			{
+				This->FinishCheck(MoveTemp(Results));
+			}
+		};
+	});
+
+	PendingDocuments.Reset();
+	return false;
+}
+
+void FMarkdownStalenessTracker::FinishCheck(TMap<FSoftObjectPath, TArray<FMarkdownStaleLink>>&& Results)
+{
+	bCheckInFlight = false;
+
+	for (TPair<FSoftObjectPath, TArray<FMarkdownStaleLink>>& Result : Results)
+	{
+		if (Result.Value.IsEmpty())
+		{
+			StaleDocuments.Remove(Result.Key);
+		}
+		else
+		{
+			StaleDocuments.Add(Result.Key, MoveTemp(Result.Value));
+		}
+	}
+
+	// changes that arrived while the pass was running
+	if (!PendingDocuments.IsEmpty())
+	{
+		ScheduleCheck();
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void FMarkdownStalenessTracker::HandleFilesLoaded()
+{
+	if (IAssetRegistry* AssetRegistry = MarkdownStalenessTracker::GetAssetRegistry())
+	{
+		AssetRegistry->OnFilesLoaded().RemoveAll(this);
+	}
+
+	bFilesLoaded = true;
+	QueueAllDocuments();
+}
+
+void FMarkdownStalenessTracker::HandleAssetChanged(const FAssetData& AssetData)
+{
+	if (!bFilesLoaded)
+	{
+		return;
+	}
+
+	if (MarkdownStalenessTracker::IsMarkdownAsset(AssetData))
+	{
+		QueueDocument(AssetData.GetSoftObjectPath());
+	}
+	else
+	{
+		QueueReferencingDocuments(AssetData.GetSoftObjectPath());
+	}
+}
+
+void FMarkdownStalenessTracker::HandleAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath)
+{
+	if (!bFilesLoaded)
+	{
+		return;
+	}
+
+	if (MarkdownStalenessTracker::IsMarkdownAsset(AssetData))
+	{
+		StaleDocuments.Remove(FSoftObjectPath(OldObjectPath));
+		QueueDocument(AssetData.GetSoftObjectPath());
+	}
+	else
+	{
+		QueueReferencingDocuments(FSoftObjectPath(OldObjectPath));
+		QueueReferencingDocuments(AssetData.GetSoftObjectPath());
+	}
+}
+
+void FMarkdownStalenessTracker::HandleObjectPreSave(UObject* Object, FObjectPreSaveContext SaveContext)
+{
+	UMarkdownAsset* Document = Cast<UMarkdownAsset>(Object);
+	IAssetRegistry* AssetRegistry = MarkdownStalenessTracker::GetAssetRegistry();
+
+	if (!Document || !AssetRegistry || SaveContext.IsProceduralSave())
+	{
+		return;
+	}
+
+	FMarkdownLinkIndex& LinkIndex = FMarkdownAssetEditorModule::Get().GetLinkIndex();
+	LinkIndex.UpdateDocument(Document);
+
+	TArray<FSoftObjectPath> Links;
+	LinkIndex.GetDocumentLinks(FSoftObjectPath(Document), Links);
+
+	// saving a document is what marks it as reviewed against the current state of the assets it links to
+	Document->LinkFingerprints.Reset();
+
+	FString Fingerprint;
+	for (const FSoftObjectPath& Link : Links)
+	{
+		if (MarkdownStalenessTracker::GetAssetFingerprint(*AssetRegistry, Link, Fingerprint))
+		{
+			Document->LinkFingerprints.Add(Link.ToString(), Fingerprint);
+		}
+	}
+}
+
+#if UE_VERSION_OLDER_THAN(5, 4, 0)
+void FMarkdownStalenessTracker::HandleGetExtraObjectTags(const UObject* Object, TArray<UObject::FAssetRegistryTag>& OutTags)
+{
+	if (const UBlueprint* Blueprint = Cast<UBlueprint>(Object))
+	{
+		OutTags.Add(UObject::FAssetRegistryTag(SignatureTagName, MarkdownStalenessTracker::MakeBlueprintSignature(Blueprint), UObject::FAssetRegistryTag::TT_Hidden));
+	}
+}
+#else
+void FMarkdownStalenessTracker::HandleGetExtraObjectTags(FAssetRegistryTagsContext Context)
+{
+	if (const UBlueprint* Blueprint = Cast<UBlueprint>(Context.GetObject()))
+	{
+		Context.AddTag(UObject::FAssetRegistryTag(SignatureTagName, MarkdownStalenessTracker::MakeBlueprintSignature(Blueprint), UObject::FAssetRegistryTag::TT_Hidden));
+	}
+}
+#endif
+
+//---------------------------------------------------------------------------------------------------------------------
+
+TSharedRef<SWidget> FMarkdownStalenessTracker::GenerateStateIcon(const FAssetData& AssetData)
+{
+	if (!MarkdownStalenessTracker::IsMarkdownAsset(AssetData))
+	{
+		return SNullWidget::NullWidget;
+	}
+
+	TWeakPtr<FMarkdownStalenessTracker, ESPMode::ThreadSafe> WeakThis = AsShared();
+	const FSoftObjectPath Document = AssetData.GetSoftObjectPath();
+
+	// the tile outlives any single check, so the visibility follows the tracker rather than being baked in
+	return SNew(SImage)
+		.Image(FAppStyle::GetBrush("Icons.WarningWithColor"))
+		.Visibility_Lambda([WeakThis, Document]()
+		{
+			TSharedPtr<FMarkdownStalenessTracker, ESPMode::ThreadSafe> This = WeakThis.Pin();
+			return This.IsValid() && This->IsStale(Document) ? EVisibility::Visible : EVisibility::Collapsed;
+		});
+}
+
+TSharedRef<SWidget> FMarkdownStalenessTracker::GenerateStateTooltip(const FAssetData& AssetData)
+{
+	if (!MarkdownStalenessTracker::IsMarkdownAsset(AssetData))
+	{
+		return SNullWidget::NullWidget;
+	}
+
+	TWeakPtr<FMarkdownStalenessTracker, ESPMode::ThreadSafe> WeakThis = AsShared();
+	const FSoftObjectPath Document = AssetData.GetSoftObjectPath();
+
+	return SNew(STextBlock)
+		.ColorAndOpacity(FStyleColors::Warning)
+		.Text_Lambda([WeakThis, Document]()
+		{
+			TSharedPtr<FMarkdownStalenessTracker, ESPMode::ThreadSafe> This = WeakThis.Pin();
+			const TArray<FMarkdownStaleLink>* StaleLinks = This.IsValid() ? This->FindStaleLinks(Document) : nullptr;
+
+			if (!StaleLinks)
+			{
+				return FText::GetEmpty();
+			}
+
+			TArray<FText> Lines;
+			Lines.Add(LOCTEXT("StaleTooltipHeader", "Documentation may be out of date:"));
+			for (const FMarkdownStaleLink& Link : *StaleLinks)
+			{
+				Lines.Add(MarkdownStalenessTracker::DescribeStaleLink(Link));
+			}
+
+			return FText::Join(FText::FromString(TEXT("\n")), Lines);
+		})
+		.Visibility_Lambda([WeakThis, Document]()
+		{
+			TSharedPtr<FMarkdownStalenessTracker, ESPMode::ThreadSafe> This = WeakThis.Pin();
+			return This.IsValid() && This->IsStale(Document) ? EVisibility::Visible : EVisibility::Collapsed;
+		});
+}
+
+#undef LOCTEXT_NAMESPACE
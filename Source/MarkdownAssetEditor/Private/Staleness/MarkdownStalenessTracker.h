@@ -0,0 +1,96 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "Misc/EngineVersionComparison.h"
+#include "UObject/Object.h"
+#include "UObject/SoftObjectPath.h"
+
+struct FAssetData;
+class FObjectPreSaveContext;
+class SWidget;
+
+enum class EMarkdownStaleReason : uint8
+{
+	/** The linked asset was saved since the document was, and it has no signature to tell what changed. */
+	Modified,
+
+	/** The functions or properties of the linked Blueprint changed since the document was saved. */
+	SignatureChanged,
+
+	/** The linked asset no longer exists. */
+	Missing,
+};
+
+struct FMarkdownStaleLink
+{
+	FSoftObjectPath Target;
+	EMarkdownStaleReason Reason = EMarkdownStaleReason::Modified;
+};
+
+/**
+ * Detects documents that are out of date with the assets they describe.
+ *
+ * When a document is saved the fingerprint of each linked asset is stored with it: the package saved hash and, for
+ * Blueprints, a hash of the generated class functions and properties (published as a registry tag when the Blueprint
+ * is saved). Later, registry updates queue the documents linking to the changed asset and a background pass compares
+ * the stored fingerprints against the registry. Only registry data is read, nothing is loaded.
+ */
+class FMarkdownStalenessTracker : public TSharedFromThis<FMarkdownStalenessTracker, ESPMode::ThreadSafe>
+{
+public:
+
+	/** Asset registry tag holding the signature hash of a Blueprint's functions and properties. */
+	static const FName SignatureTagName;
+
+	void Initialize();
+	void Shutdown();
+
+	/** Returns true if the document links to assets that changed since it was saved. */
+	bool IsStale(const FSoftObjectPath& Document) const;
+
+	/** Returns the outdated links of a document, empty if it is up to date. */
+	const TArray<FMarkdownStaleLink>* FindStaleLinks(const FSoftObjectPath& Document) const;
+
+	/** Writes every outdated document to the markdown message log. */
+	void ReportStaleDocuments() const;
+
+private:
+
+	void QueueAllDocuments();
+	void QueueDocument(const FSoftObjectPath& Document);
+	void QueueReferencingDocuments(const FSoftObjectPath& Target);
+	void ScheduleCheck();
+
+	/** Starts a background pass over the queued documents, unless one is already running. */
+	bool StartCheck(float DeltaTime);
+	void FinishCheck(TMap<FSoftObjectPath, TArray<FMarkdownStaleLink>>&& Results);
+
+	void HandleFilesLoaded();
+	void HandleAssetChanged(const FAssetData& AssetData);
+	void HandleAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath);
+	void HandleObjectPreSave(UObject* Object, FObjectPreSaveContext SaveContext);
+
+#if UE_VERSION_OLDER_THAN(5, 4, 0)
+	void HandleGetExtraObjectTags(const UObject* Object, TArray<UObject::FAssetRegistryTag>& OutTags);
+#else
+	void HandleGetExtraObjectTags(FAssetRegistryTagsContext Context);
+#endif
+
+	TSharedRef<SWidget> GenerateStateIcon(const FAssetData& AssetData);
+	TSharedRef<SWidget> GenerateStateTooltip(const FAssetData& AssetData);
+
+private:
+
+	/** Documents with at least one outdated link. Up to date documents are not stored. */
+	TMap<FSoftObjectPath, TArray<FMarkdownStaleLink>> StaleDocuments;
+
+	TSet<FSoftObjectPath> PendingDocuments;
+	FTSTicker::FDelegateHandle CheckTickerHandle;
+	FDelegateHandle ExtraStateGeneratorHandle;
+
+	bool bCheckInFlight = false;
+	bool bFilesLoaded = false;
+};
@@ -1,8 +1,10 @@
 // Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
 
 #include "MarkdownAssetEditorToolkit.h"
+#include "DeveloperSettings/MarkdownAssetDeveloperSettings.h"
 #include "Editor.h"
 #include "EditorReimportHandler.h"
+#include "Formatting/MarkdownFormatter.h"
 #include "SMarkdownAssetEditor.h"
 #include "MarkdownAsset.h"
 #include "MarkdownAssetEditorStyle.h"
@@ -22,6 +24,7 @@ namespace MarkdownAssetEditor
 ///////////////////////////////////////////////////////////////////////////////
 
 const TSharedPtr<ISlateStyle> FMarkdownAssetEditorToolkit::Style = MakeShareable( new FMarkdownAssetEditorStyle());
+const FName FMarkdownAssetEditorToolkit::ToolkitName( "MarkdownAssetEditor" );
 
 FMarkdownAssetEditorToolkit::FMarkdownAssetEditorToolkit()
 	: MarkdownAsset( nullptr )
@@ -96,6 +99,48 @@ void FMarkdownAssetEditorToolkit::UnregisterTabSpawners( const TSharedRef<FTabMa
 	InTabManager->UnregisterTabSpawner( MarkdownAssetEditor::TabId );
 }
 
+void FMarkdownAssetEditorToolkit::SaveAsset_Execute()
+{
+	TSharedPtr<SMarkdownAssetEditor> Editor = EditorWidget.Pin();
+	if( !Editor.IsValid() )
+	{
+		FormatAndSave();
+		return;
+	}
+
+	// the viewer holds edits back between syncs, save once it has sent them
+	TWeakPtr<FMarkdownAssetEditorToolkit> WeakThis = StaticCastSharedRef<FMarkdownAssetEditorToolkit>( AsShared() );
+
+	Editor->FlushText( [WeakThis]()
+	{
+		if( TSharedPtr<FMarkdownAssetEditorToolkit> This = WeakThis.Pin() )
+		{
+			This->FormatAndSave();
+		}
+	});
+}
+
+void FMarkdownAssetEditorToolkit::FormatAndSave()
+{
+	const UMarkdownAssetDeveloperSettings* Settings = UMarkdownAssetDeveloperSettings::Get();
+
+	// formatted documents are skipped by the hash check, saving again costs nothing
+	if( MarkdownAsset && Settings->ShouldFormatOnSave() )
+	{
+		MarkdownFormatter::FormatDocument( MarkdownAsset, Settings->GetFormatOptions() );
+	}
+
+	FAssetEditorToolkit::SaveAsset_Execute();
+}
+
+void FMarkdownAssetEditorToolkit::RevealLine( int32 Line )
+{
+	if( TSharedPtr<SMarkdownAssetEditor> Editor = EditorWidget.Pin() )
+	{
+		Editor->RevealLine( Line );
+	}
+}
+
 FText FMarkdownAssetEditorToolkit::GetBaseToolkitName() const
 {
 	return LOCTEXT( "AppLabel", "Markdown Asset Editor" );
@@ -103,7 +148,7 @@ FText FMarkdownAssetEditorToolkit::GetBaseToolkitName() const
 
 FName FMarkdownAssetEditorToolkit::GetToolkitFName() const
 {
-	return FName( "MarkdownAssetEditor" );
+	return ToolkitName;
 }
 
 FLinearColor FMarkdownAssetEditorToolkit::GetWorldCentricTabColorScale() const
@@ -127,7 +172,9 @@ TSharedRef<SDockTab> FMarkdownAssetEditorToolkit::HandleTabManagerSpawnTab( cons
 
 	if( TabIdentifier == MarkdownAssetEditor::TabId )
 	{
-		TabWidget = SNew( SMarkdownAssetEditor, MarkdownAsset, Style.ToSharedRef() );
+		TSharedRef<SMarkdownAssetEditor> Editor = SNew( SMarkdownAssetEditor, MarkdownAsset, Style.ToSharedRef() );
+		EditorWidget = Editor;
+		TabWidget = Editor;
 	}
 
 	return SNew( SDockTab )
@@ -11,6 +11,7 @@ class FSpawnTabArgs;
 class ISlateStyle;
 class IToolkitHost;
 class SDockTab;
+class SMarkdownAssetEditor;
 class UMarkdownAsset;
 
 class FMarkdownAssetEditorToolkit : public FAssetEditorToolkit, public FGCObject
@@ -23,14 +24,21 @@ class FMarkdownAssetEditorToolkit : public FAssetEditorToolkit, public FGCObject
 
 		static const TSharedPtr<ISlateStyle> Style;
 
+		/** The toolkit name, to tell markdown editors apart from the other asset editors. */
+		static const FName ToolkitName;
+
 	public:
 
 		void Initialize( UMarkdownAsset* InMarkdownAsset, const EToolkitMode::Type InMode, const TSharedPtr<IToolkitHost>& InToolkitHost );
 
+		/** Switches the viewer to the text and selects the line, one based. */
+		void RevealLine( int32 Line );
+
 		//~ FAssetEditorToolkit interface
 		virtual FString GetDocumentationLink() const override;
 		virtual void RegisterTabSpawners( const TSharedRef<FTabManager>& InTabManager ) override;
 		virtual void UnregisterTabSpawners( const TSharedRef<FTabManager>& InTabManager ) override;
+		virtual void SaveAsset_Execute() override;
 
 		//~ IToolkit interface
 		virtual FText GetBaseToolkitName() const override;
@@ -50,6 +58,10 @@ class FMarkdownAssetEditorToolkit : public FAssetEditorToolkit, public FGCObject
 
 		TSharedRef<SDockTab> HandleTabManagerSpawnTab( const FSpawnTabArgs& Args, FName TabIdentifier );
 
+		/** Formats the document if enabled in the settings, then saves it. */
+		void FormatAndSave();
+
 	private:
 		TObjectPtr<UMarkdownAsset> MarkdownAsset;
+		TWeakPtr<SMarkdownAssetEditor> EditorWidget;
 };
@@ -1,7 +1,35 @@
 // Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
 
 #include "MarkdownBinding.h"
+#include "Completion/MarkdownCompletionIndex.h"
+#include "Embeds/MarkdownEmbedExpander.h"
 #include "HelperFunctions/MarkdownAssetEditorStatics.h"
+#include "Images/MarkdownImageStore.h"
+#include "LogChannels/MarkdownLogChannels.h"
+#include "MarkdownAsset.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include "Serialization/JsonWriter.h"
+
+DECLARE_CYCLE_STAT( TEXT( "Sync Text" ), STAT_MarkdownSyncText, STATGROUP_Markdown );
+DECLARE_FLOAT_ACCUMULATOR_STAT( TEXT( "Sync Interval (ms)" ), STAT_MarkdownSyncInterval, STATGROUP_Markdown );
+DECLARE_FLOAT_ACCUMULATOR_STAT( TEXT( "Sync Round Trip (ms)" ), STAT_MarkdownSyncRoundTrip, STATGROUP_Markdown );
+
+bool UMarkdownBinding::SyncText( FText NewText, int32 NewRevision, float IntervalMs, float RoundTripMs )
+{
+	SCOPE_CYCLE_COUNTER( STAT_MarkdownSyncText );
+
+	SET_FLOAT_STAT( STAT_MarkdownSyncInterval, IntervalMs );
+	SET_FLOAT_STAT( STAT_MarkdownSyncRoundTrip, RoundTripMs );
+
+	// the edits were made to a text that has been replaced since, taking them would undo the change made here
+	if( NewRevision != Revision )
+	{
+		return false;
+	}
+
+	SetText( NewText );
+	return true;
+}
 
 void UMarkdownBinding::OpenURL( FString URL )
 {
@@ -13,3 +41,56 @@ void UMarkdownBinding::OpenAsset( FString URL )
 	MarkdownAssetStatics::TryToOpenAsset(URL);
 }
 
+FString UMarkdownBinding::DescribeAsset( FString URL )
+{
+	return FMarkdownAssetEditorModule::Get().GetLinkResolver().Describe( FSoftObjectPath( URL ) );
+}
+
+FString UMarkdownBinding::ExpandEmbeds( FString Text )
+{
+	FMarkdownAssetEditorModule& Module = FMarkdownAssetEditorModule::Get();
+	return Module.GetImageStore().ResolveImageLinks( Module.GetEmbedExpander().Expand( Text, Document ) );
+}
+
+void UMarkdownBinding::PasteImage( FString DataUrl, FWebJSFunction OnPasted )
+{
+	const UMarkdownAsset* MarkdownAsset = Cast<UMarkdownAsset>( Document.ResolveObject() );
+
+	FMarkdownAssetEditorModule::Get().GetImageStore().PasteImage( MarkdownAsset, MoveTemp( DataUrl ), [OnPasted]( const FString& Markdown )
+	{
+		OnPasted( Markdown );
+	});
+}
+
+FString UMarkdownBinding::Suggest( FString Token )
+{
+	static constexpr int32 MaxSuggestions = 20;
+
+	TArray<FMarkdownCompletion> Completions;
+
+	if( Token.StartsWith( TEXT( "#" ) ) )
+	{
+		FMarkdownCompletionIndex::SuggestAnchors( Text.ToString(), FStringView( Token ).RightChop( 1 ), MaxSuggestions, Completions );
+	}
+	else
+	{
+		FMarkdownAssetEditorModule::Get().GetCompletionIndex().Suggest( Token, MaxSuggestions, Completions );
+	}
+
+	FString Output;
+	TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create( &Output );
+
+	Writer->WriteArrayStart();
+	for( const FMarkdownCompletion& Completion : Completions )
+	{
+		Writer->WriteObjectStart();
+		Writer->WriteValue( TEXT( "label" ), Completion.Label );
+		Writer->WriteValue( TEXT( "insert" ), Completion.Insert );
+		Writer->WriteValue( TEXT( "detail" ), Completion.Detail );
+		Writer->WriteObjectEnd();
+	}
+	Writer->WriteArrayEnd();
+	Writer->Close();
+
+	return Output;
+}
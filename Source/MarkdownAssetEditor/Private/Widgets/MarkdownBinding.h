@@ -4,6 +4,8 @@
 
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
+#include "UObject/SoftObjectPath.h"
+#include "WebJSFunction.h"
 #include "MarkdownBinding.generated.h"
 
 UCLASS()
@@ -19,14 +21,55 @@ public:
 	UFUNCTION()
 	void SetText( FText text ) { Text = text; OnSetText.Broadcast(); }
 
+	UFUNCTION()
+	int32 GetRevision() { return Revision; }
+
+	/**
+	 * Called by the viewer as the document is edited, revision being the one of the text it edited. Returns false and
+	 * leaves the text alone if it was changed in the editor since, the viewer then reloads it and sends its edits again.
+	 * The viewer measures the round trip of each sync and spaces them out accordingly, the interval and round trip it
+	 * last used (in ms) are shown under "stat Markdown".
+	 */
+	UFUNCTION()
+	bool SyncText( FText text, int32 revision, float intervalMs, float roundTripMs );
+
+	/** Called by the viewer once a flush requested by the editor has sent the latest text. */
+	UFUNCTION()
+	void FlushComplete() { OnFlushComplete.Broadcast(); }
+
 	UFUNCTION()
 	void OpenURL( FString url );
 
 	UFUNCTION()
 	void OpenAsset( FString url );
 
+	/** Short description of a link target for hover previews in the viewer. */
+	UFUNCTION()
+	FString DescribeAsset( FString url );
+
+	/** Returns the text with its embed blocks (data tables, properties, ...) expanded into markdown. */
+	UFUNCTION()
+	FString ExpandEmbeds( FString text );
+
+	/** Stores a pasted image (a data URL) for the document, then calls back with the markdown that shows it, or "" on failure. */
+	UFUNCTION()
+	void PasteImage( FString dataUrl, FWebJSFunction onPasted );
+
+	/** Returns completions for a partial link (an asset path, an asset name or a "#heading" anchor) as a JSON array. */
+	UFUNCTION()
+	FString Suggest( FString token );
+
 	DECLARE_EVENT( UMarkdownBinding, FOnSetTextEvent )
 	FOnSetTextEvent OnSetText;
 
+	DECLARE_EVENT( UMarkdownBinding, FOnFlushCompleteEvent )
+	FOnFlushCompleteEvent OnFlushComplete;
+
 	FText Text;
+
+	/** Bumped whenever the text is changed in the editor rather than by the viewer, see SyncText. */
+	int32 Revision = 0;
+
+	/** The document shown by the viewer, used to detect documents including themselves. */
+	FSoftObjectPath Document;
 };
@@ -20,13 +20,24 @@
 #include "Widgets/Notifications/SNotificationList.h"
 #include "Styling/AppStyle.h"
 #include "LogChannels/MarkdownLogChannels.h"
+#include "Links/MarkdownLinkIndex.h"
+#include "Embeds/MarkdownEmbedExpander.h"
+#include "FileHelpers.h"
 
 #define LOCTEXT_NAMESPACE "SMarkdownAssetEditor"
 
+namespace MarkdownAssetEditorWidget
+{
+	/** How long a save waits for the viewer to send its last edits before going ahead without them. */
+	static constexpr float MaxFlushWaitSeconds = 1.0f;
+}
 
 SMarkdownAssetEditor::~SMarkdownAssetEditor()
 {
 	FCoreUObjectDelegates::OnObjectPropertyChanged.RemoveAll(this);
+	UPackage::PreSavePackageWithContextEvent.RemoveAll(this);
+
+	CompleteFlush();
 
 	if (WebBrowser.IsValid())
 	{
@@ -59,6 +70,8 @@ void SMarkdownAssetEditor::Construct(const FArguments& InArgs, UMarkdownAsset* I
 	// Setup binding
 	UMarkdownBinding* Binding = NewObject<UMarkdownBinding>();
 	Binding->Text = MarkdownAsset->Text;
+	Binding->Document = FSoftObjectPath(MarkdownAsset);
+	MarkdownBinding = Binding;
 
 	// Only mark dirty & write when text actually changes
 	Binding->OnSetText.AddLambda([this, Binding]()
@@ -71,6 +84,9 @@ void SMarkdownAssetEditor::Construct(const FArguments& InArgs, UMarkdownAsset* I
 			MarkdownAsset->Text = EditedText;
 			MarkdownAsset->MarkPackageDirty();
 
+			FMarkdownAssetEditorModule::Get().GetLinkIndex().UpdateDocument(MarkdownAsset);
+			FMarkdownAssetEditorModule::Get().GetEmbedExpander().InvalidateDocument(FSoftObjectPath(MarkdownAsset));
+
 			UMarkdownLinkAsset* LinkAsset = Cast<UMarkdownLinkAsset>(MarkdownAsset);
 			if (LinkAsset && IsCurrentFileALocalFile())
 			{
@@ -101,6 +117,8 @@ void SMarkdownAssetEditor::Construct(const FArguments& InArgs, UMarkdownAsset* I
 		}
 	});
 
+	Binding->OnFlushComplete.AddSP(this, &SMarkdownAssetEditor::CompleteFlush);
+
 	WebBrowser->BindUObject(TEXT("MarkdownBinding"), Binding, true);
 
 	UMarkdownLinkAsset* LinkAsset = Cast<UMarkdownLinkAsset>(MarkdownAsset);
@@ -148,6 +166,7 @@ void SMarkdownAssetEditor::Construct(const FArguments& InArgs, UMarkdownAsset* I
 	}
 
 	FCoreUObjectDelegates::OnObjectPropertyChanged.AddSP(this, &SMarkdownAssetEditor::HandleMarkdownAssetPropertyChanged);
+	UPackage::PreSavePackageWithContextEvent.AddSP(this, &SMarkdownAssetEditor::HandlePackagePreSave);
 }
 
 //---------------------------------------------------------------------------------------------------------------------
@@ -163,9 +182,108 @@ FReply SMarkdownAssetEditor::OnKeyDown(const FGeometry& MyGeometry, const FKeyEv
 
 //---------------------------------------------------------------------------------------------------------------------
 
+void SMarkdownAssetEditor::FlushText(TFunction<void()> OnFlushed)
+{
+	if (!WebBrowser.IsValid() || !bBrowserTemplateLoaded || !MarkdownBinding.IsValid())
+	{
+		OnFlushed();
+		return;
+	}
+
+	PendingFlushes.Add(MoveTemp(OnFlushed));
+
+	// calls into the binding are handled in order, so FlushComplete arrives after the last SyncText
+	WebBrowser->ExecuteJavascript(TEXT("if(window.flushMarkdown){window.flushMarkdown();}else if(window.ue&&window.ue.markdownbinding){window.ue.markdownbinding.flushcomplete();}"));
+
+	if (!FlushTimeoutHandle.IsValid())
+	{
+		FlushTimeoutHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([this](float)
+		{
+			UE_LOG(MarkdownStaticsLog, Warning, TEXT("The markdown viewer did not respond, continuing without its latest edits."));
+			FlushTimeoutHandle.Reset();
+			CompleteFlush();
+			return false;
+		}), MarkdownAssetEditorWidget::MaxFlushWaitSeconds);
+	}
+}
+
+void SMarkdownAssetEditor::CompleteFlush()
+{
+	if (FlushTimeoutHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(FlushTimeoutHandle);
+		FlushTimeoutHandle.Reset();
+	}
+
+	TArray<TFunction<void()>> Flushed = MoveTemp(PendingFlushes);
+
+	for (TFunction<void()>& OnFlushed : Flushed)
+	{
+		OnFlushed();
+	}
+}
+
+void SMarkdownAssetEditor::RevealLine(int32 Line)
+{
+	if (!WebBrowser.IsValid())
+	{
+		return;
+	}
+
+	if (!bBrowserTemplateLoaded)
+	{
+		PendingRevealLine = Line;
+		return;
+	}
+
+	// the app may not have mounted yet, it picks the line up when it does
+	WebBrowser->ExecuteJavascript(FString::Printf(TEXT("if(window.revealLine){window.revealLine(%d);}else{window.pendingRevealLine=%d;}"), Line, Line));
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
 void SMarkdownAssetEditor::HandleMarkdownAssetPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent)
 {
-	// Currently unused, left for potential future synchronization.
+	// The text was changed outside of this editor (link fixups, find & replace, undo), push it to the viewer
+	if (Object != MarkdownAsset || !MarkdownBinding.IsValid() || MarkdownBinding->Text.EqualTo(MarkdownAsset->Text))
+	{
+		return;
+	}
+
+	MarkdownBinding->Text = MarkdownAsset->Text;
+	++MarkdownBinding->Revision;
+
+	if (WebBrowser.IsValid() && bBrowserTemplateLoaded)
+	{
+		WebBrowser->ExecuteJavascript(TEXT("if(window.reloadMarkdown){window.reloadMarkdown();}"));
+	}
+}
+
+void SMarkdownAssetEditor::HandlePackagePreSave(UPackage* Package, FObjectPreSaveContext Context)
+{
+	// Saves from outside this editor (Save All, the content browser, source control) do not flush first. Cooks and
+	// autosaves write copies and can do without the latest typing
+	if (!MarkdownAsset || Package != MarkdownAsset->GetPackage() || Context.IsProceduralSave() || (Context.GetSaveFlags() & SAVE_FromAutosave) != 0)
+	{
+		return;
+	}
+
+	// the save cannot wait for the viewer, so edits it was still holding back are saved again once they arrive
+	const FText SavedText = MarkdownAsset->Text;
+	TWeakObjectPtr<UPackage> WeakPackage = Package;
+	TWeakPtr<SMarkdownAssetEditor> WeakThis = SharedThis(this);
+
+	FlushText([WeakThis, SavedText, WeakPackage]()
+	{
+		// pending flushes also complete when the editor closes, which is no time to save
+		TSharedPtr<SMarkdownAssetEditor> This = WeakThis.Pin();
+		UPackage* Saved = WeakPackage.Get();
+
+		if (This.IsValid() && Saved && This->MarkdownAsset && !This->MarkdownAsset->Text.EqualTo(SavedText) && Saved->IsDirty())
+		{
+			UEditorLoadingAndSavingUtils::SavePackages({ Saved }, true);
+		}
+	});
 }
 
 void SMarkdownAssetEditor::HandleConsoleMessage(const FString& Message, const FString& Source, int32 Line, EWebBrowserConsoleLogSeverity Serverity)
@@ -218,6 +336,12 @@ void SMarkdownAssetEditor::HandleBrowserLoadCompleted()
 {
 	bBrowserTemplateLoaded = true;
 
+	if (PendingRevealLine > 0)
+	{
+		RevealLine(PendingRevealLine);
+		PendingRevealLine = 0;
+	}
+
 	UMarkdownLinkAsset* LinkAsset = Cast<UMarkdownLinkAsset>(MarkdownAsset);
 	if (!LinkAsset) { return; }
 
@@ -255,6 +379,7 @@ void SMarkdownAssetEditor::OpenMarkdownAssetLink(UMarkdownLinkAsset& LinkAsset,
 
 	// Push into binding (will not mark dirty unless user edits later)
 	Binding.SetText(FileText);
+	++Binding.Revision;
 
 	// If template already loaded inject/refresh base
 	if (bBrowserTemplateLoaded)
@@ -2,7 +2,9 @@
 
 #pragma once
 
+#include "Containers/Ticker.h"
 #include "Templates/SharedPointer.h"
+#include "UObject/ObjectSaveContext.h"
 #include "Widgets/DeclarativeSyntaxSupport.h"
 #include "Widgets/SCompoundWidget.h"
 #include "Widgets/Input/SMultiLineEditableTextBox.h"
@@ -28,9 +30,16 @@ class SMarkdownAssetEditor : public SCompoundWidget
 		void Construct( const FArguments& InArgs, UMarkdownAsset* InMarkdownAsset, const TSharedRef<ISlateStyle>& InStyle );
 		virtual FReply OnKeyDown( const FGeometry& MyGeometry, const FKeyEvent& InKeyEvent ) override;
 
+		/** Has the viewer send any edits it is still holding back, then calls OnFlushed (at once if there is no viewer). */
+		void FlushText( TFunction<void()> OnFlushed );
+
+		/** Shows the text in the viewer with the line selected, once the viewer has loaded if it is still loading. */
+		void RevealLine( int32 Line );
+
 	private:
 
 		void HandleMarkdownAssetPropertyChanged( UObject* Object, FPropertyChangedEvent& PropertyChangedEvent );
+		void HandlePackagePreSave( UPackage* Package, FObjectPreSaveContext Context );
 		void HandleConsoleMessage( const FString& Message, const FString& Source, int32 Line, EWebBrowserConsoleLogSeverity Serverity );
 		void OpenMarkdownAssetLink(UMarkdownLinkAsset& LinkAsset, UMarkdownBinding& Binding, const FString& Url);
 		// Triggered after the browser finishes loading the template html (dark/light)
@@ -40,12 +49,19 @@ class SMarkdownAssetEditor : public SCompoundWidget
 		// Helper method for checking if current file is a local file
 		bool IsCurrentFileALocalFile() const;
 
+		void CompleteFlush();
+
 	private:
 
 		TSharedPtr<SWebBrowserView> WebBrowser;
 		TSharedPtr<SEditableTextBox> LinkTextBox;
 		UMarkdownAsset* MarkdownAsset;
+		TWeakObjectPtr<UMarkdownBinding> MarkdownBinding;
 		bool bBrowserTemplateLoaded = false;
+		int32 PendingRevealLine = 0;
+
+		TArray<TFunction<void()>> PendingFlushes;
+		FTSTicker::FDelegateHandle FlushTimeoutHandle;
 };
 
 static FString ToFileUrl(const FString& Path);
@@ -0,0 +1,216 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#include "Widgets/SMarkdownFindReplace.h"
+
+#include "HelperFunctions/MarkdownAssetEditorStatics.h"
+#include "Styling/AppStyle.h"
+#include "Widgets/Input/SButton.h"
+#include "Widgets/Input/SCheckBox.h"
+#include "Widgets/Input/SEditableTextBox.h"
+#include "Widgets/Layout/SBorder.h"
+#include "Widgets/SBoxPanel.h"
+#include "Widgets/Text/STextBlock.h"
+
+#define LOCTEXT_NAMESPACE "SMarkdownFindReplace"
+
+void SMarkdownFindReplace::Construct( const FArguments& InArgs )
+{
+	ChildSlot
+	[
+		SNew( SVerticalBox )
+
+		+ SVerticalBox::Slot()
+		.AutoHeight()
+		.Padding( 4.0f )
+		[
+			SNew( SHorizontalBox )
+			+ SHorizontalBox::Slot()
+			.FillWidth( 1.0f )
+			[
+				SAssignNew( SearchBox, SEditableTextBox )
+				.HintText( LOCTEXT( "SearchHint", "Find in markdown documents..." ) )
+				.OnTextCommitted( this, &SMarkdownFindReplace::HandleSearchCommitted )
+			]
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.Padding( 4.0f, 0.0f )
+			[
+				SNew( SCheckBox )
+				.IsChecked_Lambda( [this]() { return bMatchCase ? ECheckBoxState::Checked : ECheckBoxState::Unchecked; } )
+				.OnCheckStateChanged_Lambda( [this]( ECheckBoxState State ) { bMatchCase = State == ECheckBoxState::Checked; } )
+				[
+					SNew( STextBlock ).Text( LOCTEXT( "MatchCase", "Match Case" ) )
+				]
+			]
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.Padding( 4.0f, 0.0f )
+			[
+				SNew( SCheckBox )
+				.IsChecked_Lambda( [this]() { return bRegex ? ECheckBoxState::Checked : ECheckBoxState::Unchecked; } )
+				.OnCheckStateChanged_Lambda( [this]( ECheckBoxState State ) { bRegex = State == ECheckBoxState::Checked; } )
+				[
+					SNew( STextBlock ).Text( LOCTEXT( "Regex", "Regex" ) )
+				]
+			]
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			[
+				SNew( SButton )
+				.Text( LOCTEXT( "Search", "Search" ) )
+				.OnClicked( this, &SMarkdownFindReplace::HandleSearchClicked )
+			]
+		]
+
+		+ SVerticalBox::Slot()
+		.AutoHeight()
+		.Padding( 4.0f )
+		[
+			SNew( SHorizontalBox )
+			+ SHorizontalBox::Slot()
+			.FillWidth( 1.0f )
+			[
+				SAssignNew( ReplaceBox, SEditableTextBox )
+				.HintText( LOCTEXT( "ReplaceHint", "Replace with ($1 inserts a regex capture group)..." ) )
+			]
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.Padding( 4.0f, 0.0f, 0.0f, 0.0f )
+			[
+				SNew( SButton )
+				.Text( LOCTEXT( "ReplaceAll", "Replace All" ) )
+				.IsEnabled_Lambda( [this]() { return !MatchedDocuments.IsEmpty(); } )
+				.OnClicked( this, &SMarkdownFindReplace::HandleReplaceAllClicked )
+			]
+		]
+
+		+ SVerticalBox::Slot()
+		.AutoHeight()
+		.Padding( 4.0f )
+		[
+			SNew( STextBlock )
+			.Text_Lambda( [this]() { return StatusText; } )
+		]
+
+		+ SVerticalBox::Slot()
+		.FillHeight( 1.0f )
+		[
+			SNew( SBorder )
+			.BorderImage( FAppStyle::GetBrush( "ToolPanel.GroupBorder" ) )
+			[
+				SAssignNew( ResultsList, SListView<FResultItemPtr> )
+				.ListItemsSource( &Items )
+				.OnGenerateRow( this, &SMarkdownFindReplace::HandleGenerateRow )
+				.OnMouseButtonDoubleClick( this, &SMarkdownFindReplace::HandleResultDoubleClicked )
+			]
+		]
+	];
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+
+FMarkdownSearchQuery SMarkdownFindReplace::MakeQuery() const
+{
+	FMarkdownSearchQuery Query;
+	Query.Pattern = SearchBox->GetText().ToString();
+	Query.bRegex = bRegex;
+	Query.bMatchCase = bMatchCase;
+	return Query;
+}
+
+FReply SMarkdownFindReplace::HandleSearchClicked()
+{
+	SearchedQuery = MakeQuery();
+
+	TArray<FMarkdownSearchResult> Results;
+	FMarkdownSearchStats Stats;
+	MarkdownFindReplace::Search( SearchedQuery, Results, &Stats );
+
+	Items.Reset();
+	MatchedDocuments.Reset();
+
+	int32 NumHits = 0;
+	for( FMarkdownSearchResult& Result : Results )
+	{
+		MatchedDocuments.Add( Result.Document );
+		NumHits += Result.Hits.Num();
+
+		for( FMarkdownSearchHit& Hit : Result.Hits )
+		{
+			Items.Add( MakeShared<FResultItem>( FResultItem{ Result.Document, MoveTemp( Hit ) } ) );
+		}
+	}
+
+	StatusText = FText::Format(
+		LOCTEXT( "SearchStatus", "{0} matches in {1} of {2} documents ({3} loaded, {4} ms)" ),
+		NumHits, Stats.NumMatched, Stats.NumDocuments, Stats.NumLoaded, FMath::RoundToInt( Stats.Seconds * 1000.0 )
+	);
+
+	ResultsList->RequestListRefresh();
+	return FReply::Handled();
+}
+
+FReply SMarkdownFindReplace::HandleReplaceAllClicked()
+{
+	// replace what was previewed, even if the search box was edited since
+	const int32 NumReplaced = MarkdownFindReplace::ReplaceAll( SearchedQuery, ReplaceBox->GetText().ToString(), MatchedDocuments );
+
+	Items.Reset();
+	MatchedDocuments.Reset();
+	ResultsList->RequestListRefresh();
+
+	StatusText = FText::Format( LOCTEXT( "ReplaceStatus", "Replaced {0} matches, use Undo to revert." ), NumReplaced );
+	return FReply::Handled();
+}
+
+void SMarkdownFindReplace::HandleSearchCommitted( const FText& Text, ETextCommit::Type CommitType )
+{
+	if( CommitType == ETextCommit::OnEnter )
+	{
+		HandleSearchClicked();
+	}
+}
+
+void SMarkdownFindReplace::HandleResultDoubleClicked( FResultItemPtr Item )
+{
+	if( Item.IsValid() )
+	{
+		MarkdownAssetStatics::TryToOpenAsset( Item->Document );
+	}
+}
+
+TSharedRef<ITableRow> SMarkdownFindReplace::HandleGenerateRow( FResultItemPtr Item, const TSharedRef<STableViewBase>& OwnerTable )
+{
+	const FText Highlight = SearchedQuery.bRegex ? FText::GetEmpty() : FText::FromString( SearchedQuery.Pattern );
+
+	return SNew( STableRow<FResultItemPtr>, OwnerTable )
+	[
+		SNew( SHorizontalBox )
+		+ SHorizontalBox::Slot()
+		.AutoWidth()
+		.Padding( 4.0f, 2.0f )
+		[
+			SNew( STextBlock )
+			.Text( FText::FromString( Item->Document.GetAssetName() ) )
+			.ToolTipText( FText::FromString( Item->Document.ToString() ) )
+		]
+		+ SHorizontalBox::Slot()
+		.AutoWidth()
+		.Padding( 4.0f, 2.0f )
+		[
+			SNew( STextBlock )
+			.Text( FText::Format( LOCTEXT( "LineNumber", "Ln {0}" ), Item->Hit.Line ) )
+			.ColorAndOpacity( FSlateColor::UseSubduedForeground() )
+		]
+		+ SHorizontalBox::Slot()
+		.FillWidth( 1.0f )
+		.Padding( 4.0f, 2.0f )
+		[
+			SNew( STextBlock )
+			.Text( FText::FromString( Item->Hit.Context ) )
+			.HighlightText( Highlight )
+		]
+	];
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,53 @@
+// Copyright (C) 2024 Gwaredd Mountain - All Rights Reserved.
+
+#pragma once
+
+#include "FindReplace/MarkdownFindReplace.h"
+#include "Widgets/DeclarativeSyntaxSupport.h"
+#include "Widgets/SCompoundWidget.h"
+#include "Widgets/Views/SListView.h"
+
+class SEditableTextBox;
+
+/** Project wide find and replace over the text of every markdown document. */
+class SMarkdownFindReplace : public SCompoundWidget
+{
+	public:
+
+		SLATE_BEGIN_ARGS( SMarkdownFindReplace ) {}
+		SLATE_END_ARGS()
+
+		void Construct( const FArguments& InArgs );
+
+	private:
+
+		struct FResultItem
+		{
+			FSoftObjectPath Document;
+			FMarkdownSearchHit Hit;
+		};
+
+		using FResultItemPtr = TSharedPtr<FResultItem>;
+
+		FMarkdownSearchQuery MakeQuery() const;
+
+		FReply HandleSearchClicked();
+		FReply HandleReplaceAllClicked();
+		void HandleSearchCommitted( const FText& Text, ETextCommit::Type CommitType );
+		void HandleResultDoubleClicked( FResultItemPtr Item );
+		TSharedRef<ITableRow> HandleGenerateRow( FResultItemPtr Item, const TSharedRef<STableViewBase>& OwnerTable );
+
+	private:
+
+		TSharedPtr<SEditableTextBox> SearchBox;
+		TSharedPtr<SEditableTextBox> ReplaceBox;
+		TSharedPtr<SListView<FResultItemPtr>> ResultsList;
+
+		TArray<FResultItemPtr> Items;
+		TArray<FSoftObjectPath> MatchedDocuments;
+		FMarkdownSearchQuery SearchedQuery;
+		FText StatusText;
+
+		bool bRegex = false;
+		bool bMatchCase = false;
+};
@@ -1,10 +1,10 @@
-import { useState, useEffect } from 'react'
+import { useState, useEffect, useMemo, useRef } from 'react'
 import { useTheme } from '@mui/material/styles'
 import Box from '@mui/material/Box'
 import Grid from '@mui/material/Grid'
 import Fab from '@mui/material/Fab'
 import Editor from 'react-simple-code-editor'
-import throttle from 'lodash/throttle'
+import debounce from 'lodash/debounce'
 
 import {
   IconEdit,
@@ -105,62 +105,417 @@ const md = markdownit(md_opts)
 
 
 //-----------------------------------------------------------------------------
+// link autocomplete, suggestions come from a prefix index of the asset registry on the C++ side
+
+const editorId = 'markdown-editor'
+const measure  = document.createElement( 'canvas' ).getContext( '2d' )
+
+// the partial link target before the caret, i.e. whatever follows "](" on the current line
+const linkToken = (text, caret) => {
+  const match = /\]\(([^\s()]*)$/.exec( text.slice( Math.max( 0, caret - 512 ), caret ) )
+  return match && match[1].length > 0 ? match[1] : null
+}
+
+// approximate caret position inside the editor, good enough for a monospace font without wrapping
+const caretPosition = (textarea, text, caret) => {
+  const style      = window.getComputedStyle( textarea )
+  const lines      = text.slice( 0, caret ).split( '\n' )
+  const lineHeight = parseFloat( style.lineHeight ) || parseFloat( style.fontSize ) * 1.2
+
+  measure.font = `${style.fontSize} ${style.fontFamily}`
+
+  return {
+    top : parseFloat( style.paddingTop ) + lines.length * lineHeight,
+    left: parseFloat( style.paddingLeft ) + measure.measureText( lines[ lines.length - 1 ] ).width,
+  }
+}
+
+// the nearest ancestor that scrolls, the editor grows with its text so it never scrolls itself
+const scrollParent = (element) => {
+  for( let node = element.parentElement; node; node = node.parentElement ) {
+    if( /auto|scroll/.test( window.getComputedStyle( node ).overflowY ) && node.scrollHeight > node.clientHeight ) return node
+  }
+  return document.scrollingElement
+}
+
+// selects a line (one based) in the editor and scrolls it into view, e.g. the location of a lint issue
+const selectLine = (textarea, text, line) => {
+  let start = 0
+  for( let n = 1; n < line; ++n ) {
+    const next = text.indexOf( '\n', start )
+    if( next < 0 ) break
+    start = next + 1
+  }
+
+  const end = text.indexOf( '\n', start )
+
+  textarea.focus()
+  textarea.setSelectionRange( start, end < 0 ? text.length : end )
+
+  const parent = scrollParent( textarea )
+  const top    = parent == document.scrollingElement ? 0 : parent.getBoundingClientRect().top
+  const caret  = textarea.getBoundingClientRect().top + caretPosition( textarea, text, start ).top
+
+  parent.scrollTop += caret - top - parent.clientHeight / 3
+}
+
+// pasted images are encoded and stored on the C++ side, a placeholder marks the spot until they are ready
+let pasteCount = 0
 
 const Edit = (props) => {
 
   const {code, setCode} = props
   const theme = useTheme()
+  const [suggest, setSuggest] = useState( null )
+  const request = useRef( 0 )
+  const latest  = useRef( code )
+
+  latest.current = code
+
+  const requestSuggestions = useMemo( () => debounce( (text, caret) => {
+    const textarea = document.getElementById( editorId )
+    const token    = linkToken( text, caret )
+    const id       = ++request.current
+
+    if( !textarea || !token || !window.ue || !window.ue.markdownbinding ) {
+      setSuggest( null )
+      return
+    }
+
+    window.ue.markdownbinding.suggest( token ).then( (json) => {
+      if( id != request.current ) return
+      const items = JSON.parse( json )
+      setSuggest( items.length ? { items, selected: 0, ...caretPosition( textarea, text, caret ) } : null )
+    })
+  }, 50 ), [] )
+
+  useEffect(() => () => requestSuggestions.cancel(), [requestSuggestions])
+
+  const onValueChange = (text) => {
+    setCode( text )
+
+    const textarea = document.getElementById( editorId )
+    if( textarea ) requestSuggestions( text, textarea.selectionStart )
+  }
+
+  const accept = (item) => {
+    const textarea = document.getElementById( editorId )
+    const caret    = textarea ? textarea.selectionStart : code.length
+    const token    = linkToken( code, caret )
+
+    setSuggest( null )
+    if( !token ) return
+
+    const start = caret - token.length
+    const text  = code.slice( 0, start ) + item.insert + code.slice( caret )
+    const end   = start + item.insert.length
+
+    setCode( text )
+
+    requestAnimationFrame( () => {
+      if( !textarea ) return
+      textarea.selectionStart = textarea.selectionEnd = end
+
+      // keep completing after picking a folder
+      if( item.insert.endsWith( '/' ) ) requestSuggestions( text, end )
+    })
+  }
+
+  const onPaste = (event) => {
+    const items = event.clipboardData ? Array.from( event.clipboardData.items ) : []
+    const image = items.find( (item) => item.kind == 'file' && item.type.startsWith( 'image/' ) )
+    const textarea = document.getElementById( editorId )
+
+    if( !image || !textarea || !window.ue || !window.ue.markdownbinding ) return
+    event.preventDefault()
+
+    const placeholder = `![Pasting image ${++pasteCount}...]()`
+    const text = code.slice( 0, textarea.selectionStart ) + placeholder + code.slice( textarea.selectionEnd )
+    setCode( text )
+
+    const reader = new FileReader()
+    reader.onload = () => {
+      window.ue.markdownbinding.pasteimage( reader.result, (markdown) => {
+        setCode( latest.current.replace( placeholder, markdown ) )
+      })
+    }
+    reader.readAsDataURL( image.getAsFile() )
+  }
+
+  const onKeyDown = (event) => {
+    if( !suggest ) return
+
+    const count = suggest.items.length
+
+    switch( event.key ) {
+      case 'ArrowDown': setSuggest( { ...suggest, selected: ( suggest.selected + 1 ) % count } ); break
+      case 'ArrowUp'  : setSuggest( { ...suggest, selected: ( suggest.selected + count - 1 ) % count } ); break
+      case 'Enter'    :
+      case 'Tab'      : accept( suggest.items[ suggest.selected ] ); break
+      case 'Escape'   : setSuggest( null ); break
+      default         : return
+    }
+
+    event.preventDefault()
+  }
 
   return (
-    <Editor
-      value         = {code}
-      onValueChange = {setCode}
-      highlight     = {code => hljs.highlight(code, {language: 'markdown', ignoreIllegals: true }).value}
-      padding       = {theme.spacing(3)}
-      autoFocus     = {true}
-      style         = {{
-        fontFamily: '"Fira code", "Fira Mono", monospace',
-        fontSize  : 12,
-        // width     : '100%',
-        minHeight : '100vh',
-        overflowY : 'auto',
-      }}
-    />
+    <Box position="relative" onPaste={onPaste}>
+      <Editor
+        value         = {code}
+        onValueChange = {onValueChange}
+        onKeyDown     = {onKeyDown}
+        onBlur        = {() => { setSuggest( null ); sync.flush() }}
+        textareaId    = {editorId}
+        highlight     = {code => hljs.highlight(code, {language: 'markdown', ignoreIllegals: true }).value}
+        padding       = {theme.spacing(3)}
+        autoFocus     = {true}
+        style         = {{
+          fontFamily: '"Fira code", "Fira Mono", monospace',
+          fontSize  : 12,
+          // width     : '100%',
+          minHeight : '100vh',
+          overflowY : 'auto',
+        }}
+      />
+      { suggest &&
+        <div className="suggestions" style={{ top: suggest.top, left: suggest.left }}>
+        {
+          suggest.items.map( (item, index) =>
+            <div
+              key         = {item.insert}
+              title       = {item.insert}
+              className   = {index == suggest.selected ? 'selected' : ''}
+              onMouseDown = {(event) => { event.preventDefault(); accept( item ) }}
+            >
+              {item.label} <span className="detail">{item.detail}</span>
+            </div>
+          )
+        }
+        </div>
+      }
+    </Box>
   )
 }
 
 
 //-----------------------------------------------------------------------------
 
+// hover previews for asset links, the description is resolved (and cached) on the C++ side
+
+const onLinkHover = (event) => {
+  const link = event.target.closest && event.target.closest('a')
+  if( !link || link.dataset.described || !window.ue || !window.ue.markdownbinding ) return
+
+  const match = /openasset\('(.*)'\)/.exec( link.getAttribute('href') || '' )
+  if( !match ) return
+
+  link.dataset.described = 'true'
+  window.ue.markdownbinding.describeasset( match[1] ).then( (description) => link.title = description )
+}
+
 const View = (props) => {
 
   const theme = useTheme()
   const {code} = props
+  const [expanded, setExpanded] = useState( code )
+
+  // embed blocks (data tables, properties) are expanded and cached on the C++ side
+  useEffect(() => {
+    if( !window.ue || !window.ue.markdownbinding ) {
+      setExpanded( code )
+      return
+    }
+
+    let current = true
+    window.ue.markdownbinding.expandembeds( code ).then( (text) => { if( current ) setExpanded( text ) } )
+    return () => { current = false }
+  },[code])
 
   return (
     <Box
+      onMouseOver = {onLinkHover}
       style={{
         // width     : '100%',
         minHeight : '100vh',
         padding   : theme.spacing(3),
         overflowY : 'auto',
       }}
-      dangerouslySetInnerHTML={{__html: md.render( code )}}
+      dangerouslySetInnerHTML={{__html: md.render( expanded )}}
     />
   )
 }
 
 
 //-----------------------------------------------------------------------------
-// throttling the update makes the UI more responsive
+// edits are sent to unreal at an interval adapted to what each sync costs, i.e. serializing the text, crossing the
+// bridge and comparing and writing it on the C++ side. Small documents sync almost at once, large ones are held back
+// so syncing takes at most a quarter of the time. The latest edits are sent at once on blur, save or close
+
+const SyncShare       = 0.25
+const SyncMinInterval = 16
+const SyncMaxInterval = 5000
+
+// the part of a text an edit replaced, as the range of the old text and what is there in the new one
+const changedRange = (from, to) => {
+  const max = Math.min( from.length, to.length )
 
-const updateUnreal = (text) => {
-  if( window.ue && window.ue.markdownbinding ) {
-    window.ue.markdownbinding.settext( text )
+  let start = 0
+  while( start < max && from[start] == to[start] ) start++
+
+  let end = 0
+  while( end < max - start && from[from.length - 1 - end] == to[to.length - 1 - end] ) end++
+
+  return { start, end: from.length - end, text: to.slice( start, to.length - end ) }
+}
+
+// applies the edits made to base in mine on top of theirs, or returns null if both changed the same part
+const rebaseEdits = (base, mine, theirs) => {
+  if( mine == base ) return theirs
+  if( theirs == base ) return mine
+
+  const ours  = changedRange( base, mine )
+  const other = changedRange( base, theirs )
+
+  if( ours.end < other.start ) {
+    return theirs.slice( 0, ours.start ) + ours.text + theirs.slice( ours.end )
   }
+
+  if( other.end < ours.start ) {
+    const offset = theirs.length - base.length
+    return theirs.slice( 0, ours.start + offset ) + ours.text + theirs.slice( ours.end + offset )
+  }
+
+  return null
 }
 
-const updateUnrealThrottled = throttle( updateUnreal, 1000, { leading: true, trailing: true } );
+const createSync = () => {
+
+  let pending   = null
+  let latest    = null // the newest text typed, pending or sent
+  let synced    = null // the text unreal has, pending edits are made to it
+  let revision  = 0    // the revision of synced, unreal rejects syncs made to an older one
+  let apply     = null // shows a reloaded text
+  let timer     = null
+  let inFlight  = 0
+  let reloading = false
+  let stale     = false // unreal changed the text, reload once the syncs in flight are answered
+  let flushed   = false // a flush waits for the reload
+  let last      = 0
+  let cost      = 0
+  let interval  = SyncMinInterval
+
+  const bound = () => window.ue && window.ue.markdownbinding
+
+  const measure = (sample) => {
+    cost     = cost ? cost * 0.7 + sample * 0.3 : sample
+    interval = Math.min( SyncMaxInterval, Math.max( SyncMinInterval, cost / SyncShare - cost ) )
+  }
+
+  const send = () => {
+    clearTimeout( timer )
+    timer = null
+
+    if( pending === null || reloading || !bound() ) return
+
+    const text  = pending
+    const start = performance.now()
+
+    pending = null
+    last    = start
+    inFlight++
+
+    window.ue.markdownbinding.synctext( text, revision, interval, cost )
+      .then( (accepted) => {
+        measure( performance.now() - start )
+
+        if( accepted ) {
+          synced = text
+        } else {
+          // the text was changed in unreal before this arrived, the edits are sent again on top of it
+          if( pending === null ) pending = latest
+          stale = true
+        }
+      })
+      .finally( () => {
+        inFlight--
+        if( stale && !inFlight ) reload()
+        else schedule()
+      })
+  }
+
+  // one sync at a time, the next waits for the previous one and the interval since it started
+  const schedule = () => {
+    if( pending === null || inFlight || reloading || timer ) return
+    timer = setTimeout( send, Math.max( 0, last + interval - performance.now() ) )
+  }
+
+  // edits not sent yet are moved on top of the text from unreal, and the result is shown
+  const rebase = (text) => {
+    const mine = pending
+    const base = synced
+
+    synced = text
+    latest = text
+    if( mine === null || base === null ) return text
+
+    const merged = rebaseEdits( base, mine, text )
+    if( merged === null ) {
+      console.warn( 'The document was changed in the editor where it was being typed in, the latest typing was dropped' )
+      pending = null
+      return text
+    }
+
+    pending = merged
+    latest  = merged
+    return merged
+  }
+
+  // a sync in flight may land before or after the change in unreal, only its answer tells, so wait for it
+  const reload = () => {
+    if( !bound() ) return
+    if( inFlight ) { stale = true; return }
+
+    stale     = false
+    reloading = true
+    clearTimeout( timer )
+    timer = null
+
+    // calls into the binding are handled in order, reading the revision first means a text changed in between is
+    // rejected on the next sync rather than taken as the newer revision
+    Promise.all( [window.ue.markdownbinding.getrevision(), window.ue.markdownbinding.gettext()] )
+      .then( ([rev, text]) => {
+        revision = rev
+        const shown = rebase( text )
+        if( apply ) apply( shown )
+      })
+      .finally( () => {
+        reloading = false
+        if( flushed ) flush()
+        else schedule()
+      })
+  }
+
+  // calls into the binding are handled in order, so flushcomplete lands after the last synctext
+  const flush = () => {
+    if( reloading ) { flushed = true; return }
+
+    flushed = false
+    send()
+    if( bound() ) window.ue.markdownbinding.flushcomplete()
+  }
+
+  return {
+    update: (text) => { pending = text; latest = text; schedule() },
+
+    // fetches the text from unreal, e.g. after it was changed there, and hands it to show with the unsent typing on top
+    reload: (show) => { apply = show; reload() },
+
+    flush,
+  }
+}
+
+const sync = createSync()
 
 const Mode = {
   View: 'view',
@@ -175,15 +530,53 @@ export default function App() {
 
   const [mode, setMode] = useState( Mode.View )
   const [text, setText] = useState( '' )
+  const [reveal, setReveal] = useState( null )
 
   useEffect(() => {
-    if( window.ue && window.ue.markdownbinding ) {
-      window.ue.markdownbinding.gettext().then( (text) => setText(text) )
+    sync.reload( setText )
+
+    // called by the editor when the asset text was changed from C++ (link fixups, replace, undo), typing that was
+    // not sent yet is kept
+    window.reloadMarkdown = () => sync.reload( setText )
+
+    // called by the editor before saving
+    window.flushMarkdown = sync.flush
+
+    // called by the editor to show a line, e.g. from the message log, the object makes repeated calls count
+    window.revealLine = (line) => {
+      setMode( (mode) => mode == Mode.View ? Mode.Edit : mode )
+      setReveal( { line } )
+    }
+
+    if( window.pendingRevealLine ) {
+      window.revealLine( window.pendingRevealLine )
+      delete window.pendingRevealLine
+    }
+
+    const onHidden = () => { if( document.visibilityState == 'hidden' ) sync.flush() }
+
+    window.addEventListener( 'blur', sync.flush )
+    window.addEventListener( 'pagehide', sync.flush )
+    document.addEventListener( 'visibilitychange', onHidden )
+
+    return () => {
+      window.removeEventListener( 'blur', sync.flush )
+      window.removeEventListener( 'pagehide', sync.flush )
+      document.removeEventListener( 'visibilitychange', onHidden )
     }
   },[])
 
+  // waits for the text to arrive and the editor to be shown
+  useEffect(() => {
+    const textarea = document.getElementById( editorId )
+    if( !reveal || !text || !textarea ) return
+
+    selectLine( textarea, text, reveal.line )
+    setReveal( null )
+  },[reveal, text, mode])
+
   const onUpdate = (text) => {
-    updateUnrealThrottled( text );
+    sync.update( text )
     setText( text )
   }
 